@@ -0,0 +1,163 @@
+#pragma once
+
+#include "AuthenticFiler.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Authentic {
+
+// Directory listings cached for the file tree and kept current by applying
+// watcher diffs, so edits on disk never force a reload. Listings are sorted
+// directories first, then by name. Not thread-safe: apply diffs on the thread
+// that reads the tree.
+class FileTree {
+public:
+    explicit FileTree(AuthenticFiler& filer) : _filer(filer) {}
+
+    // Listing of `directory`, read through the filer on first use
+    const std::vector<FileNode>& children(const std::string& directory) {
+        auto it = _directories.find(directory);
+        if (it == _directories.end()) {
+            it = _directories.emplace(directory, load(directory)).first;
+        }
+        return it->second;
+    }
+
+    bool isLoaded(const std::string& directory) const {
+        return _directories.count(directory) != 0;
+    }
+
+    // Forget `directory` and every loaded directory below it (collapsed folders)
+    void unload(const std::string& directory) {
+        for (auto it = _directories.begin(); it != _directories.end();) {
+            if (isWithin(it->first, directory)) {
+                it = _directories.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Applies a watcher batch to the loaded directories and returns the ones whose
+    // listing changed, sorted. Changes inside directories that were never loaded
+    // cost nothing; only an overflow re-lists what is loaded.
+    std::vector<std::string> apply(const FileTreeDiff& diff) {
+        std::vector<std::string> changed;
+        if (diff.rescanRequired) {
+            for (auto it = _directories.begin(); it != _directories.end();) {
+                if (!_filer.exists(it->first)) {
+                    it = _directories.erase(it);
+                    continue;
+                }
+                it->second = load(it->first);
+                changed.push_back(it->first);
+                ++it;
+            }
+            std::sort(changed.begin(), changed.end());
+            return changed;
+        }
+
+        // Group by parent so a burst into one directory is merged in one pass.
+        std::unordered_map<std::string, std::vector<const FileChange *>> byParent;
+        for (const FileChange& change : diff.changes) {
+            // A removed or replaced directory takes its loaded subtree with it.
+            if (change.kind != FileChange::Kind::Created &&
+                (change.node.isDirectory || _directories.count(change.node.path))) {
+                unload(change.node.path);
+            }
+            std::string parent = parentOf(change.node.path);
+            if (_directories.count(parent)) {
+                byParent[parent].push_back(&change);
+            }
+        }
+
+        for (auto& group : byParent) {
+            auto it = _directories.find(group.first);
+            if (it == _directories.end()) continue; // Removed itself in this batch
+            merge(it->second, group.second);
+            changed.push_back(group.first);
+        }
+        std::sort(changed.begin(), changed.end());
+        return changed;
+    }
+
+private:
+    // Groups this large are merged by rebuilding the listing instead of
+    // inserting and erasing one node at a time.
+    static constexpr size_t kRebuildThreshold = 32;
+
+    static bool before(const FileNode& a, const FileNode& b) {
+        if (a.isDirectory != b.isDirectory) return a.isDirectory;
+        return a.name < b.name;
+    }
+
+    static bool isWithin(const std::string& path, const std::string& directory) {
+        if (path.size() < directory.size() || path.compare(0, directory.size(), directory) != 0) return false;
+        return path.size() == directory.size() || path[directory.size()] == '/' || directory.back() == '/';
+    }
+
+    static std::string parentOf(const std::string& path) {
+        size_t slash = path.find_last_of('/');
+        if (slash == std::string::npos) return std::string();
+        return slash == 0 ? std::string("/") : path.substr(0, slash);
+    }
+
+    std::vector<FileNode> load(const std::string& directory) {
+        std::vector<FileNode> nodes = _filer.listDirectory(directory);
+        if (!std::is_sorted(nodes.begin(), nodes.end(), before)) {
+            std::sort(nodes.begin(), nodes.end(), before);
+        }
+        return nodes;
+    }
+
+    static void erase(std::vector<FileNode>& nodes, const FileNode& node) {
+        // Try the slot the node would sort into, then both kinds in case it changed.
+        for (bool isDirectory : {node.isDirectory, !node.isDirectory}) {
+            FileNode key;
+            key.name = node.name;
+            key.isDirectory = isDirectory;
+            auto it = std::lower_bound(nodes.begin(), nodes.end(), key, before);
+            for (; it != nodes.end() && it->isDirectory == isDirectory && it->name == node.name; ++it) {
+                if (it->path == node.path) {
+                    nodes.erase(it);
+                    return;
+                }
+            }
+        }
+    }
+
+    static void merge(std::vector<FileNode>& nodes, const std::vector<const FileChange *>& changes) {
+        if (changes.size() < kRebuildThreshold) {
+            for (const FileChange *change : changes) {
+                erase(nodes, change->node);
+                if (change->kind != FileChange::Kind::Removed) {
+                    nodes.insert(std::upper_bound(nodes.begin(), nodes.end(), change->node, before), change->node);
+                }
+            }
+            return;
+        }
+
+        std::unordered_map<std::string, const FileChange *> byPath;
+        byPath.reserve(changes.size());
+        for (const FileChange *change : changes) {
+            byPath[change->node.path] = change;
+        }
+        nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [&](const FileNode& node) {
+            return byPath.count(node.path) != 0;
+        }), nodes.end());
+        for (const auto& entry : byPath) {
+            if (entry.second->kind != FileChange::Kind::Removed) {
+                nodes.push_back(entry.second->node);
+            }
+        }
+        std::sort(nodes.begin(), nodes.end(), before);
+    }
+
+    AuthenticFiler& _filer;
+    std::unordered_map<std::string, std::vector<FileNode>> _directories;
+};
+
+} // namespace Authentic
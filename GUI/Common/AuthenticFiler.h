@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -13,6 +15,37 @@ struct FileNode {
     long long size;
 };
 
+// One net change to a path over a batch of file system events
+struct FileChange {
+    enum class Kind { Created, Removed, Modified };
+    Kind kind;
+    FileNode node; // As listDirectory would report it; only name, path and isDirectory for Removed
+};
+
+// Changes delivered together, sorted by path. When the platform lost events
+// (overflow), `changes` is empty and `rescanRequired` is set: everything cached
+// under the watched root has to be listed again.
+struct FileTreeDiff {
+    std::vector<FileChange> changes;
+    bool rescanRequired = false;
+};
+
+// Timing of one listDirectory call, for spotting slow (e.g. network) mounts
+struct ListingStats {
+    std::string path;
+    size_t entries = 0;
+    size_t metadataLookups = 0;      // stat calls for what the directory entries did not tell
+    double milliseconds = 0;         // The whole listing
+    double metadataMilliseconds = 0; // Of which waiting for the lookups
+    const char *backend = "";        // How the lookups ran, e.g. "io_uring" or "threads"
+};
+
+// Handle for a running watch; stops it when destroyed
+class AuthenticWatcher {
+public:
+    virtual ~AuthenticWatcher() = default;
+};
+
 // Abstract Interface for File System Operations
 class AuthenticFiler {
 public:
@@ -26,6 +59,22 @@ public:
 
     // Create a new directory
     virtual bool createDirectory(const std::string& path) = 0;
+
+    // Called after every listDirectory with its timing, on the listing thread.
+    // Platforms that do not measure never call it.
+    virtual void setListingObserver(std::function<void(const ListingStats&)> observer) {
+        (void)observer;
+    }
+
+    // Watch everything below `root`. Bursts of events are coalesced and handed to
+    // `onChange` from a background thread. Returns null where watching is not
+    // supported.
+    virtual std::unique_ptr<AuthenticWatcher> watch(const std::string& root,
+                                                    std::function<void(const FileTreeDiff&)> onChange) {
+        (void)root;
+        (void)onChange;
+        return nullptr;
+    }
 };
 
 } // namespace Authentic
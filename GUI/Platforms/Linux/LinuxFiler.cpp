@@ -1,26 +1,854 @@
 #include "../../Common/AuthenticFiler.h"
-#include <iostream>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// statx() needs glibc 2.28; older headers fall back to fstatat() below.
+#ifdef STATX_TYPE
+#define AUTHENTIC_HAVE_STATX 1
+#else
+#define STATX_TYPE 0x001U
+#define STATX_SIZE 0x200U
+#endif
+
+// io_uring's statx opcode arrived in Linux 5.6, with IORING_FEAT_CUR_PERSONALITY.
+// Without it, batched lookups run on threads.
+#if defined(AUTHENTIC_HAVE_STATX) && defined(__NR_io_uring_setup) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#ifdef IORING_FEAT_CUR_PERSONALITY
+#define AUTHENTIC_HAVE_IO_URING 1
+#endif
+#endif
 
 namespace Authentic {
 
+namespace {
+
+// Layout of the records getdents64 fills in (not exported by glibc).
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// Large enough for a few thousand entries per syscall; readdir() uses 32 KB.
+constexpr size_t kDirentBufferSize = 256 * 1024;
+
+// getdents64 buffer of the calling thread, so listings on different threads
+// never share one.
+char *direntBuffer() {
+    static thread_local std::unique_ptr<char[]> buffer(new char[kDirentBufferSize]);
+    return buffer.get();
+}
+
+// Entry kinds as far as the tree cares.
+enum class Kind { Unknown, File, Directory, Symlink, Other };
+
+Kind kindOfType(unsigned char type) {
+    switch (type) {
+        case DT_REG: return Kind::File;
+        case DT_DIR: return Kind::Directory;
+        case DT_LNK: return Kind::Symlink;
+        case DT_UNKNOWN: return Kind::Unknown;
+        default: return Kind::Other;
+    }
+}
+
+Kind kindOfMode(unsigned mode) {
+    if (S_ISREG(mode)) return Kind::File;
+    if (S_ISDIR(mode)) return Kind::Directory;
+    if (S_ISLNK(mode)) return Kind::Symlink;
+    return Kind::Other;
+}
+
+#ifdef AUTHENTIC_HAVE_STATX
+int statxFlags(bool follow) {
+    return AT_STATX_DONT_SYNC | (follow ? 0 : AT_SYMLINK_NOFOLLOW);
+}
+
+void readStatx(const struct statx& stx, Kind& kind, long long& size) {
+    if (stx.stx_mask & STATX_TYPE) kind = kindOfMode(stx.stx_mode);
+    if (stx.stx_mask & STATX_SIZE) size = (long long)stx.stx_size;
+}
+#endif
+
+// Stats `name` relative to `dirFd`, asking only for what `mask` needs. Uses statx
+// where the kernel has it and fstatat otherwise. Returns false if the entry is
+// gone or unreadable.
+bool statEntry(int dirFd, const char *name, bool follow, unsigned mask, Kind& kind, long long& size) {
+#ifdef AUTHENTIC_HAVE_STATX
+    static std::atomic<bool> haveStatx{true};
+    if (haveStatx.load(std::memory_order_relaxed)) {
+        struct statx stx;
+        if (statx(dirFd, name, statxFlags(follow), mask, &stx) == 0) {
+            readStatx(stx, kind, size);
+            return true;
+        }
+        if (errno != ENOSYS) return false;
+        haveStatx.store(false, std::memory_order_relaxed);
+    }
+#else
+    (void)mask;
+#endif
+    struct stat sb;
+    if (fstatat(dirFd, name, &sb, follow ? 0 : AT_SYMLINK_NOFOLLOW) != 0) return false;
+    kind = kindOfMode(sb.st_mode);
+    size = (long long)sb.st_size;
+    return true;
+}
+
+// Length of the valid UTF-8 sequence at `s` (at most `length` bytes), or 0.
+size_t utf8SequenceLength(const unsigned char *s, size_t length) {
+    unsigned char c = s[0];
+    size_t need;
+    uint32_t min;
+    uint32_t cp;
+    if (c < 0x80) return 1;
+    if (c >= 0xC2 && c <= 0xDF) { need = 2; min = 0x80; cp = c & 0x1F; }
+    else if (c >= 0xE0 && c <= 0xEF) { need = 3; min = 0x800; cp = c & 0x0F; }
+    else if (c >= 0xF0 && c <= 0xF4) { need = 4; min = 0x10000; cp = c & 0x07; }
+    else return 0;
+    if (length < need) return 0;
+    for (size_t i = 1; i < need; i++) {
+        if ((s[i] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+    return need;
+}
+
+// Linux names are arbitrary bytes. `path` keeps them as they are so the entry
+// can still be opened; the display name replaces each invalid byte with U+FFFD.
+std::string displayName(const char *name, size_t length) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(name);
+    size_t i = 0;
+    while (i < length) {
+        size_t n = utf8SequenceLength(bytes + i, length - i);
+        if (n == 0) break;
+        i += n;
+    }
+    if (i == length) return std::string(name, length);
+
+    std::string out(name, i);
+    while (i < length) {
+        size_t n = utf8SequenceLength(bytes + i, length - i);
+        if (n == 0) {
+            out += "\xEF\xBF\xBD";
+            i++;
+        } else {
+            out.append(name + i, n);
+            i += n;
+        }
+    }
+    return out;
+}
+
+// One metadata lookup of a listing. Lookups are independent, so a batch can run
+// serially, spread over threads or through io_uring.
+struct StatRequest {
+    const char *name; // NUL-terminated, relative to the directory
+    bool follow;
+    unsigned mask;
+    Kind kind;        // From d_type; updated by the lookup
+    long long size;
+    bool ok;
+};
+
+void runRequest(int dirFd, StatRequest& request) {
+    request.ok = statEntry(dirFd, request.name, request.follow, request.mask, request.kind, request.size);
+}
+
+} // namespace
+
+// A few persistent threads for blocking lookups. Network file systems answer
+// each stat in a round trip, so far more threads than cores still pay off.
+// run() is not reentrant.
+class StatPool {
+public:
+    explicit StatPool(size_t threads) {
+        for (size_t i = 0; i < threads; i++) {
+            _threads.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~StatPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_all();
+        for (std::thread& thread : _threads) thread.join();
+    }
+
+    // Calls fn(i) for every i in [0, count) on the pool and the calling thread.
+    void run(size_t count, const std::function<void(size_t)>& fn) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _job = &fn;
+            _count = count;
+            _next.store(0);
+            _generation++;
+        }
+        _wake.notify_all();
+        work();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle.wait(lock, [this] { return _active == 0; });
+        _job = nullptr; // Workers that wake up late find nothing to do
+    }
+
+private:
+    void work() {
+        size_t i;
+        while ((i = _next.fetch_add(1)) < _count) (*_job)(i);
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;) {
+            _wake.wait(lock, [&] { return _stopping || (_job && _generation != seen); });
+            if (_stopping) return;
+            seen = _generation;
+            _active++;
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--_active == 0) _idle.notify_all();
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _idle;
+    const std::function<void(size_t)> *_job = nullptr;
+    size_t _count = 0;
+    std::atomic<size_t> _next{0};
+    uint64_t _generation = 0;
+    size_t _active = 0;
+    bool _stopping = false;
+};
+
+#ifdef AUTHENTIC_HAVE_IO_URING
+// Minimal io_uring for statx, on the raw syscalls (no liburing dependency).
+// Keeps up to kEntries lookups in flight and reaps completions as they arrive,
+// so one slow answer does not hold up the rest of the batch.
+class StatRing {
+public:
+    ~StatRing() {
+        if (_sqes != MAP_FAILED) munmap(_sqes, _sqesSize);
+        if (_cqRing != MAP_FAILED && _cqRing != _sqRing) munmap(_cqRing, _cqRingSize);
+        if (_sqRing != MAP_FAILED) munmap(_sqRing, _sqRingSize);
+        if (_fd >= 0) close(_fd);
+    }
+
+    // False if io_uring is missing, disabled or cannot run statx.
+    bool open() {
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        _fd = (int)syscall(__NR_io_uring_setup, kEntries, &params);
+        if (_fd < 0) return false;
+        if (!(params.features & IORING_FEAT_CUR_PERSONALITY)) return false; // Older than 5.6: no statx
+
+        _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+
+        _sqRing = mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+        if (_sqRing == MAP_FAILED) return false;
+        _cqRing = singleMap ? _sqRing
+                            : mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+        if (_cqRing == MAP_FAILED) return false;
+        _sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+        _sqes = mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+        if (_sqes == MAP_FAILED) return false;
+
+        char *sq = static_cast<char *>(_sqRing);
+        char *cq = static_cast<char *>(_cqRing);
+        _sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        _sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        _sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        _sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        _sqEntries = params.sq_entries;
+        _cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        _cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        _cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+        _buffers.resize(_sqEntries);
+        _freeSlots.clear();
+        for (unsigned slot = 0; slot < _sqEntries; slot++) _freeSlots.push_back(slot);
+
+        // Kernels before 5.6 reject the opcode; a kernel may also filter it.
+        StatRequest probe{".", false, STATX_TYPE, Kind::Unknown, 0, false};
+        return run(AT_FDCWD, &probe, 1) && probe.ok;
+    }
+
+    // Runs every request. Returns false if the ring failed part way, in which
+    // case the caller has to redo the batch some other way.
+    bool run(int dirFd, StatRequest *requests, size_t count) {
+        size_t next = 0;
+        size_t inFlight = 0;
+        while (next < count || inFlight > 0) {
+            unsigned tail = *_sqTail;
+            unsigned head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+            unsigned queued = 0;
+            while (next < count && !_freeSlots.empty() && tail - head < _sqEntries) {
+                unsigned slot = _freeSlots.back();
+                _freeSlots.pop_back();
+                const StatRequest& request = requests[next];
+                unsigned index = tail & _sqMask;
+                struct io_uring_sqe *sqe = static_cast<struct io_uring_sqe *>(_sqes) + index;
+                memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = IORING_OP_STATX;
+                sqe->fd = dirFd;
+                sqe->addr = (uint64_t)(uintptr_t)request.name;
+                sqe->len = request.mask;
+                sqe->off = (uint64_t)(uintptr_t)&_buffers[slot];
+                sqe->statx_flags = (uint32_t)statxFlags(request.follow);
+                sqe->user_data = ((uint64_t)next << 32) | slot;
+                _sqArray[index] = index;
+                tail++;
+                next++;
+                queued++;
+            }
+            __atomic_store_n(_sqTail, tail, __ATOMIC_RELEASE);
+            inFlight += queued;
+
+            // Also resubmits whatever an earlier, partial submit left in the queue.
+            unsigned toSubmit = tail - head;
+            int submitted = (int)syscall(__NR_io_uring_enter, _fd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+
+            unsigned cqHead = *_cqHead;
+            unsigned cqTail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+            for (; cqHead != cqTail; cqHead++) {
+                const struct io_uring_cqe& cqe = _cqes[cqHead & _cqMask];
+                StatRequest& request = requests[cqe.user_data >> 32];
+                unsigned slot = (unsigned)(cqe.user_data & 0xFFFFFFFFu);
+                request.size = 0;
+                request.ok = cqe.res >= 0;
+                if (request.ok) readStatx(_buffers[slot], request.kind, request.size);
+                _freeSlots.push_back(slot);
+                inFlight--;
+            }
+            __atomic_store_n(_cqHead, cqHead, __ATOMIC_RELEASE);
+        }
+        return true;
+    }
+
+private:
+    static constexpr unsigned kEntries = 256;
+
+    int _fd = -1;
+    void *_sqRing = MAP_FAILED;
+    void *_cqRing = MAP_FAILED;
+    void *_sqes = MAP_FAILED;
+    size_t _sqRingSize = 0;
+    size_t _cqRingSize = 0;
+    size_t _sqesSize = 0;
+    unsigned *_sqHead = nullptr;
+    unsigned *_sqTail = nullptr;
+    unsigned *_sqArray = nullptr;
+    unsigned _sqMask = 0;
+    unsigned _sqEntries = 0;
+    unsigned *_cqHead = nullptr;
+    unsigned *_cqTail = nullptr;
+    unsigned _cqMask = 0;
+    struct io_uring_cqe *_cqes = nullptr;
+    // Completion targets; owned by the ring so that lookups still in flight after
+    // a failure never write into freed memory.
+    std::vector<struct statx> _buffers;
+    std::vector<unsigned> _freeSlots;
+};
+#endif
+
+// Recursive inotify watch. inotify only reports direct children, so every
+// directory below the root gets its own watch; directories created later are
+// added (and their contents reported, since they may fill before the watch
+// exists) as they appear. Events are gathered until the tree has been quiet for
+// kQuietMs, or for at most kMaxLatencyMs, then reduced to one net change per
+// path by comparing what the first event implied with what is on disk now.
+class LinuxWatcher : public AuthenticWatcher {
+public:
+    LinuxWatcher(std::string root, std::function<void(const FileTreeDiff&)> onChange)
+        : _root(std::move(root)), _onChange(std::move(onChange)) {
+        while (_root.size() > 1 && _root.back() == '/') _root.pop_back();
+    }
+
+    ~LinuxWatcher() override {
+        if (_thread.joinable()) {
+            uint64_t one = 1;
+            (void)!write(_stopFd, &one, sizeof(one));
+            _thread.join();
+        }
+        if (_inotifyFd >= 0) close(_inotifyFd);
+        if (_stopFd >= 0) close(_stopFd);
+    }
+
+    bool start() {
+        _stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (_stopFd < 0 || !reset()) return false;
+        _thread = std::thread([this] { run(); });
+        return true;
+    }
+
+private:
+    static constexpr int kQuietMs = 50;
+    static constexpr int kMaxLatencyMs = 500;
+    static constexpr uint32_t kMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE |
+                                      IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+    struct Pending {
+        bool existedBefore; // Implied by the first event seen for the path
+        bool isDirectory;   // As of the last event
+    };
+
+    // (Re)creates the inotify instance and watches the whole tree.
+    bool reset() {
+        if (_inotifyFd >= 0) close(_inotifyFd);
+        _paths.clear();
+        _watches.clear();
+        _pending.clear();
+        _inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (_inotifyFd < 0) return false;
+        addTree(_root, false);
+        return !_watches.empty();
+    }
+
+    static bool isWithin(const std::string& path, const std::string& directory) {
+        return path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 &&
+               (path[directory.size()] == '/' || directory == "/");
+    }
+
+    static std::string join(const std::string& directory, const char *name) {
+        std::string path = directory;
+        if (path.empty() || path.back() != '/') path.push_back('/');
+        return path.append(name);
+    }
+
+    // Watches `directory` and everything below it. With `report`, every entry
+    // found is recorded as created.
+    void addTree(const std::string& directory, bool report) {
+        std::vector<std::string> stack{directory};
+        while (!stack.empty()) {
+            std::string path = std::move(stack.back());
+            stack.pop_back();
+
+            int wd = inotify_add_watch(_inotifyFd, path.c_str(), kMask);
+            if (wd < 0) continue; // Gone, not a directory, or out of watches (ENOSPC)
+            _paths[wd] = path;
+            _watches[path] = wd;
+
+            DIR *dir = opendir(path.c_str());
+            if (!dir) continue;
+            while (struct dirent *entry = readdir(dir)) {
+                const char *name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+                bool isDirectory = entry->d_type == DT_DIR;
+                if (entry->d_type == DT_UNKNOWN) {
+                    Kind kind = Kind::Unknown;
+                    long long size = 0;
+                    isDirectory = statEntry(dirfd(dir), name, false, STATX_TYPE, kind, size) && kind == Kind::Directory;
+                }
+                std::string child = join(path, name);
+                if (report) note(child, false, isDirectory);
+                // Repository internals churn constantly and are never shown.
+                if (isDirectory && strcmp(name, ".git") != 0) stack.push_back(std::move(child));
+            }
+            closedir(dir);
+        }
+    }
+
+    // Drops the watches of `directory` and everything below it.
+    void removeTree(const std::string& directory, bool stillWatched) {
+        auto it = _watches.lower_bound(directory);
+        while (it != _watches.end() && (it->first == directory || isWithin(it->first, directory))) {
+            // Deleted directories lose their watch on their own; moved ones keep it.
+            if (stillWatched) inotify_rm_watch(_inotifyFd, it->second);
+            _paths.erase(it->second);
+            it = _watches.erase(it);
+        }
+    }
+
+    void note(const std::string& path, bool existedBefore, bool isDirectory) {
+        auto result = _pending.emplace(path, Pending{existedBefore, isDirectory});
+        if (!result.second) result.first->second.isDirectory = isDirectory;
+    }
+
+    // Returns false on overflow.
+    bool readEvents() {
+        alignas(struct inotify_event) char buffer[64 * 1024];
+        for (;;) {
+            ssize_t length = read(_inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) return true; // EAGAIN: drained
+            for (ssize_t offset = 0; offset < length;) {
+                const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer + offset);
+                offset += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) return false;
+                auto it = _paths.find(event->wd);
+                if (it == _paths.end()) continue;
+                if (event->mask & IN_IGNORED) {
+                    _watches.erase(it->second);
+                    _paths.erase(it);
+                    continue;
+                }
+                if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                    // Reported through the parent, except for the root itself.
+                    if (it->second == _root) note(_root, true, true);
+                    continue;
+                }
+                if (event->len == 0) continue;
+
+                std::string path = join(it->second, event->name);
+                bool isDirectory = (event->mask & IN_ISDIR) != 0;
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    note(path, false, isDirectory);
+                    if (isDirectory && strcmp(event->name, ".git") != 0) addTree(path, true);
+                } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    note(path, true, isDirectory);
+                    if (isDirectory) removeTree(path, (event->mask & IN_MOVED_FROM) != 0);
+                } else if (event->mask & IN_CLOSE_WRITE) {
+                    note(path, true, false);
+                }
+            }
+        }
+    }
+
+    // Current state of `path` as listDirectory would report it.
+    static bool describe(const std::string& path, FileNode& node) {
+        Kind kind = Kind::Unknown;
+        long long size = 0;
+        if (!statEntry(AT_FDCWD, path.c_str(), false, STATX_TYPE | STATX_SIZE, kind, size)) return false;
+        if (kind == Kind::Symlink) {
+            size = 0;
+            statEntry(AT_FDCWD, path.c_str(), true, STATX_TYPE | STATX_SIZE, kind, size);
+        }
+        size_t slash = path.find_last_of('/');
+        const char *name = path.c_str() + slash + 1;
+        node.name = displayName(name, path.size() - slash - 1);
+        node.path = path;
+        node.isDirectory = kind == Kind::Directory;
+        node.size = node.isDirectory ? 0 : size;
+        return true;
+    }
+
+    void flush() {
+        std::vector<std::pair<std::string, Pending>> pending(_pending.begin(), _pending.end());
+        _pending.clear();
+        std::sort(pending.begin(), pending.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        FileTreeDiff diff;
+        const std::string *removedDirectory = nullptr;
+        for (const auto& entry : pending) {
+            // Everything under a removed directory went with it.
+            if (removedDirectory && isWithin(entry.first, *removedDirectory)) continue;
+            removedDirectory = nullptr;
+
+            FileChange change;
+            bool existsNow = describe(entry.first, change.node);
+            if (existsNow) {
+                change.kind = entry.second.existedBefore ? FileChange::Kind::Modified : FileChange::Kind::Created;
+            } else if (entry.second.existedBefore) {
+                change.kind = FileChange::Kind::Removed;
+                size_t slash = entry.first.find_last_of('/');
+                change.node.name = displayName(entry.first.c_str() + slash + 1, entry.first.size() - slash - 1);
+                change.node.path = entry.first;
+                change.node.isDirectory = entry.second.isDirectory;
+                change.node.size = 0;
+                if (entry.second.isDirectory) removedDirectory = &entry.first;
+            } else {
+                continue; // Created and removed within the batch
+            }
+            diff.changes.push_back(std::move(change));
+        }
+        if (!diff.changes.empty()) _onChange(diff);
+    }
+
+    void run() {
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point deadline;
+        for (;;) {
+            int timeout = -1;
+            if (!_pending.empty()) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+                timeout = (int)std::max<long long>(0, std::min<long long>(kQuietMs, left));
+            }
+
+            struct pollfd fds[2] = {{_stopFd, POLLIN, 0}, {_inotifyFd, POLLIN, 0}};
+            int ready = poll(fds, 2, timeout);
+            if (ready < 0 && errno != EINTR) return;
+            if (fds[0].revents) return;
+
+            if (ready > 0 && fds[1].revents) {
+                bool hadPending = !_pending.empty();
+                if (!readEvents()) {
+                    // Events were lost: start over and have the tree re-list.
+                    if (!reset()) return;
+                    FileTreeDiff diff;
+                    diff.rescanRequired = true;
+                    _onChange(diff);
+                    continue;
+                }
+                if (!hadPending && !_pending.empty()) {
+                    deadline = Clock::now() + std::chrono::milliseconds(kMaxLatencyMs);
+                }
+                if (Clock::now() < deadline) continue;
+            }
+            if (!_pending.empty()) flush();
+        }
+    }
+
+    std::string _root;
+    std::function<void(const FileTreeDiff&)> _onChange;
+    int _inotifyFd = -1;
+    int _stopFd = -1;
+    std::thread _thread;
+
+    std::unordered_map<int, std::string> _paths;  // Watch -> directory
+    std::map<std::string, int> _watches;          // Directory -> watch, ordered for subtree removal
+    std::unordered_map<std::string, Pending> _pending;
+};
+
+// How LinuxFiler::listDirectory runs the lookups d_type leaves open.
+enum class MetadataBackend {
+    Serial,  // One statx after another on the listing thread
+    Threads, // Spread over a small thread pool
+    IoUring, // Batched through io_uring; falls back to Threads where unavailable
+};
+
 class LinuxFiler : public AuthenticFiler {
 public:
+    explicit LinuxFiler(MetadataBackend backend = MetadataBackend::IoUring) : _backend(backend) {}
+
+    // Entries other than "." and "..", directories first, then by name. Symlinks
+    // to directories count as directories; `size` is 0 for directories. Returns
+    // an empty list with errno set if the directory cannot be read. Safe to call
+    // from several threads; their batched lookups take turns on the pool or ring.
     std::vector<FileNode> listDirectory(const std::string& path) override {
-        // STUB: Real implementation would use <dirent.h> or std::filesystem
-        std::cout << "[Linux] Listing directory: " << path << std::endl;
-        return {}; 
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point start = Clock::now();
+
+        std::vector<FileNode> nodes;
+        int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) return nodes;
+
+        char *buffer = direntBuffer();
+        std::string prefix = path;
+        if (prefix.empty() || prefix.back() != '/') prefix.push_back('/');
+
+        // Every entry is read before anything is looked up, so the lookups can go
+        // out as one batch.
+        std::vector<Kind> kinds;
+        for (;;) {
+            long bytes = syscall(SYS_getdents64, fd, buffer, kDirentBufferSize);
+            if (bytes <= 0) {
+                if (bytes < 0) {
+                    int saved = errno;
+                    close(fd);
+                    errno = saved;
+                    return {};
+                }
+                break;
+            }
+
+            for (long offset = 0; offset < bytes;) {
+                const LinuxDirent64 *entry = reinterpret_cast<const LinuxDirent64 *>(buffer + offset);
+                offset += entry->d_reclen;
+
+                const char *name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+                size_t length = strlen(name);
+                FileNode node;
+                node.name = displayName(name, length);
+                node.path.reserve(prefix.size() + length);
+                node.path.assign(prefix).append(name, length);
+                node.isDirectory = false;
+                node.size = 0;
+                nodes.push_back(std::move(node));
+                kinds.push_back(kindOfType(entry->d_type));
+            }
+        }
+
+        // Only stat what d_type leaves open: sizes of files, the type of unknown
+        // entries, and where symlinks point. Names point into `nodes`, which no
+        // longer moves.
+        std::vector<StatRequest> requests;
+        std::vector<uint32_t> owners;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const char *name = nodes[i].path.c_str() + prefix.size();
+            switch (kinds[i]) {
+                case Kind::File:
+                    requests.push_back({name, false, STATX_SIZE, Kind::File, 0, false});
+                    break;
+                case Kind::Unknown:
+                    requests.push_back({name, false, STATX_TYPE | STATX_SIZE, Kind::Unknown, 0, false});
+                    break;
+                case Kind::Symlink:
+                    requests.push_back({name, true, STATX_TYPE | STATX_SIZE, Kind::Symlink, 0, false});
+                    break;
+                default:
+                    continue;
+            }
+            owners.push_back((uint32_t)i);
+        }
+
+        ListingStats stats;
+        stats.backend = "none";
+        Clock::time_point lookupStart = Clock::now();
+        runRequests(fd, requests, stats.backend);
+
+        // Unknown entries that turned out to be symlinks need a second lookup.
+        std::vector<StatRequest> links;
+        std::vector<uint32_t> linkOwners;
+        std::vector<bool> gone(nodes.size(), false);
+        for (size_t r = 0; r < requests.size(); r++) {
+            const StatRequest& request = requests[r];
+            uint32_t i = owners[r];
+            if (kinds[i] == Kind::Unknown && !request.ok) {
+                gone[i] = true;
+                continue;
+            }
+            kinds[i] = request.kind;
+            nodes[i].size = request.size;
+            if (!request.follow && request.kind == Kind::Symlink) {
+                links.push_back({request.name, true, STATX_TYPE | STATX_SIZE, Kind::Symlink, 0, false});
+                linkOwners.push_back(i);
+            }
+        }
+        const char *linkBackend = stats.backend;
+        runRequests(fd, links, linkBackend);
+        for (size_t r = 0; r < links.size(); r++) {
+            // Dangling links stay symlinks and are listed as empty files.
+            kinds[linkOwners[r]] = links[r].kind;
+            nodes[linkOwners[r]].size = links[r].size;
+        }
+        Clock::time_point lookupEnd = Clock::now();
+        close(fd);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (gone[i]) continue;
+            FileNode& node = nodes[i];
+            node.isDirectory = kinds[i] == Kind::Directory;
+            if (node.isDirectory) node.size = 0;
+            if (kept != i) nodes[kept] = std::move(node);
+            kept++;
+        }
+        nodes.resize(kept);
+
+        std::sort(nodes.begin(), nodes.end(), [](const FileNode& a, const FileNode& b) {
+            if (a.isDirectory != b.isDirectory) return a.isDirectory;
+            return a.name < b.name;
+        });
+
+        if (_observer) {
+            stats.path = path;
+            stats.entries = nodes.size();
+            stats.metadataLookups = requests.size() + links.size();
+            stats.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            stats.metadataMilliseconds = std::chrono::duration<double, std::milli>(lookupEnd - lookupStart).count();
+            _observer(stats);
+        }
+        return nodes;
+    }
+
+    void setListingObserver(std::function<void(const ListingStats&)> observer) override {
+        _observer = std::move(observer);
     }
 
     bool exists(const std::string& path) override {
-        // STUB: Real implementation would use stat()
-        return false;
+        return faccessat(AT_FDCWD, path.c_str(), F_OK, 0) == 0;
     }
 
+    // Succeeds if `path` is a directory afterwards, including when it already was.
     bool createDirectory(const std::string& path) override {
-        // STUB: Real implementation would use mkdir()
-        std::cout << "[Linux] Creating directory: " << path << std::endl;
-        return true;
+        if (mkdir(path.c_str(), 0777) == 0) return true;
+        if (errno != EEXIST) return false;
+        struct stat sb;
+        return stat(path.c_str(), &sb) == 0 && S_ISDIR(sb.st_mode);
+    }
+
+    std::unique_ptr<AuthenticWatcher> watch(const std::string& root,
+                                            std::function<void(const FileTreeDiff&)> onChange) override {
+        std::unique_ptr<LinuxWatcher> watcher(new LinuxWatcher(root, std::move(onChange)));
+        if (!watcher->start()) return nullptr;
+        return watcher;
     }
+
+private:
+    // Smaller batches are cheaper to stat in place than to hand off.
+    static constexpr size_t kBatchThreshold = 64;
+    static constexpr size_t kStatThreads = 16;
+
+    // Runs `requests` relative to `dirFd` on the configured backend and names it
+    // in `backend`.
+    void runRequests(int dirFd, std::vector<StatRequest>& requests, const char *&backend) {
+        if (requests.empty()) return;
+        if (_backend == MetadataBackend::Serial || requests.size() < kBatchThreshold) {
+            for (StatRequest& request : requests) runRequest(dirFd, request);
+            backend = "serial";
+            return;
+        }
+        std::lock_guard<std::mutex> lock(_batchMutex); // StatPool::run and StatRing are not reentrant
+#ifdef AUTHENTIC_HAVE_IO_URING
+        if (_backend == MetadataBackend::IoUring && !_ringFailed) {
+            if (!_ring) {
+                _ring.reset(new StatRing());
+                if (!_ring->open()) {
+                    _ring.reset();
+                    _ringFailed = true;
+                }
+            }
+            if (_ring && _ring->run(dirFd, requests.data(), requests.size())) {
+                backend = "io_uring";
+                return;
+            }
+            // A ring that failed part way is kept (not reused) until the filer
+            // goes away: lookups still in flight write into its buffers.
+            _ringFailed = true;
+        }
+#endif
+        if (!_pool) _pool.reset(new StatPool(kStatThreads));
+        _pool->run(requests.size(), [&](size_t i) { runRequest(dirFd, requests[i]); });
+        backend = "threads";
+    }
+
+    MetadataBackend _backend;
+    std::function<void(const ListingStats&)> _observer;
+    std::mutex _batchMutex; // Guards the pool and ring below
+    std::unique_ptr<StatPool> _pool;
+#ifdef AUTHENTIC_HAVE_IO_URING
+    std::unique_ptr<StatRing> _ring;
+    bool _ringFailed = false;
+#endif
 };
 
 } // namespace Authentic
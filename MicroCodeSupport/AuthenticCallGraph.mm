@@ -0,0 +1,134 @@
+//
+//  AuthenticCallGraph.mm
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#import "AuthenticCallGraph.h"
+#include "Core/MicroCallGraph.h"
+#include "Core/MicroLexer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+@implementation AuthenticCallSite
+@end
+
+@implementation AuthenticImpactEntry
+@end
+
+static std::string AuthenticFunctionName(NSString *function) {
+    const char *utf8 = [function UTF8String];
+    return utf8 ? utf8 : "";
+}
+
+@interface AuthenticCallGraph () {
+    std::unique_ptr<MicroIndex::CallGraph> _graph;
+}
+@end
+
+@implementation AuthenticCallGraph
+
+- (instancetype)initWithIndexPath:(NSString *)indexPath {
+    self = [super init];
+    if (self) {
+        _graph.reset(new MicroIndex::CallGraph([indexPath fileSystemRepresentation]));
+    }
+    return self;
+}
+
+- (BOOL)open {
+    return _graph->open();
+}
+
+- (void)indexWorkspace:(NSString *)rootPath completion:(void (^)(NSUInteger))completion {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        std::vector<std::string> paths;
+        NSURL *rootURL = [NSURL fileURLWithPath:rootPath isDirectory:YES];
+        NSDirectoryEnumerator<NSURL *> *enumerator =
+            [[NSFileManager defaultManager] enumeratorAtURL:rootURL
+                                 includingPropertiesForKeys:@[NSURLIsRegularFileKey]
+                                                    options:NSDirectoryEnumerationSkipsHiddenFiles | NSDirectoryEnumerationSkipsPackageDescendants
+                                               errorHandler:nil];
+        for (NSURL *url in enumerator) {
+            const char *cPath = url.fileSystemRepresentation;
+            if (!cPath) continue;
+            if (MicroLexer::LanguageSpec::languageForPath(cPath).empty()) continue;
+            paths.emplace_back(cPath);
+        }
+
+        NSUInteger parsed = self->_graph->indexFiles(paths);
+        if (!self->_graph->save()) {
+            NSLog(@"[AuthenticCallGraph] Failed to persist call graph");
+        }
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(parsed);
+            });
+        }
+    });
+}
+
+- (void)fileDidChange:(NSString *)path {
+    _graph->updateFile([path fileSystemRepresentation]);
+}
+
+- (void)fileWasRemoved:(NSString *)path {
+    _graph->removeFile([path fileSystemRepresentation]);
+}
+
+- (BOOL)save {
+    return _graph->save();
+}
+
+- (NSUInteger)callCount {
+    return _graph->callCount();
+}
+
+- (BOOL)isFunctionDefined:(NSString *)function {
+    return _graph->isDefined(AuthenticFunctionName(function));
+}
+
+- (NSArray<AuthenticCallSite *> *)callersOfFunction:(NSString *)function limit:(NSUInteger)limit {
+    std::vector<MicroIndex::CallSite> sites = _graph->callers(AuthenticFunctionName(function), limit);
+    NSMutableArray<AuthenticCallSite *> *results = [NSMutableArray arrayWithCapacity:sites.size()];
+    for (const auto& site : sites) {
+        AuthenticCallSite *call = [[AuthenticCallSite alloc] init];
+        call.caller = [NSString stringWithUTF8String:site.caller.c_str()] ?: @"";
+        call.callee = [NSString stringWithUTF8String:site.callee.c_str()] ?: @"";
+        call.path = [NSString stringWithUTF8String:site.file.c_str()] ?: @"";
+        call.byteOffset = site.offset;
+        call.line = site.line;
+        [results addObject:call];
+    }
+    return results;
+}
+
+- (NSArray<NSString *> *)calleesOfFunction:(NSString *)function {
+    std::vector<std::string> names = _graph->callees(AuthenticFunctionName(function));
+    NSMutableArray<NSString *> *results = [NSMutableArray arrayWithCapacity:names.size()];
+    for (const auto& name : names) {
+        NSString *string = [NSString stringWithUTF8String:name.c_str()];
+        if (string) [results addObject:string];
+    }
+    return results;
+}
+
+- (NSArray<AuthenticImpactEntry *> *)impactOfFunction:(NSString *)function maxDepth:(NSUInteger)maxDepth limit:(NSUInteger)limit {
+    std::vector<MicroIndex::ImpactEntry> entries =
+        _graph->impact(AuthenticFunctionName(function), (uint32_t)MIN(maxDepth, (NSUInteger)UINT32_MAX), limit);
+    NSMutableArray<AuthenticImpactEntry *> *results = [NSMutableArray arrayWithCapacity:entries.size()];
+    for (const auto& entry : entries) {
+        AuthenticImpactEntry *impact = [[AuthenticImpactEntry alloc] init];
+        impact.function = [NSString stringWithUTF8String:entry.function.c_str()] ?: @"";
+        impact.path = [NSString stringWithUTF8String:entry.file.c_str()] ?: @"";
+        impact.depth = entry.depth;
+        [results addObject:impact];
+    }
+    return results;
+}
+
+@end
@@ -7,15 +7,52 @@
 //
 
 #import "AuthenticFileTreeController.h"
+#include "Core/MicroDirectoryScanner.h"
+#include "Core/MicroFlatTree.h"
+#include "Core/MicroIgnore.h"
+#include "Core/MicroNaturalSort.h"
+#include "Core/MicroTreeSnapshot.h"
 #include <sys/stat.h>
 #include <dirent.h>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <atomic>
+#include <memory>
 
 @implementation AuthenticFileNode
 @end
 
+// Directories first, then Finder order. Collation keys are computed once per
+// name instead of a localized comparison per compare.
+static void AuthenticSortNodes(NSMutableArray<AuthenticFileNode *> *nodes) {
+    NSUInteger count = nodes.count;
+    if (count < 2) return;
+
+    std::vector<std::string_view> names;
+    std::vector<bool> directories;
+    names.reserve(count);
+    directories.reserve(count);
+    for (AuthenticFileNode *node in nodes) {
+        const char *utf8 = node.name.UTF8String;
+        names.emplace_back(utf8 ? utf8 : "");
+        directories.push_back(node.isDirectory);
+    }
+
+    std::vector<uint32_t> order = MicroFiles::naturalOrder(names, &directories, &MicroCore::ThreadPool::shared());
+    NSMutableArray<AuthenticFileNode *> *sorted = [NSMutableArray arrayWithCapacity:count];
+    for (uint32_t index : order) {
+        [sorted addObject:nodes[index]];
+    }
+    [nodes setArray:sorted];
+}
+
+@interface AuthenticFileTreeController () {
+    std::unique_ptr<MicroFiles::TreeSnapshot> _snapshot;
+    NSUInteger _snapshotGeneration;
+}
+@end
+
 @implementation AuthenticFileTreeController
 
 + (instancetype)sharedController {
@@ -97,12 +134,7 @@
         closedir(dir);
         
         // Sort: Directories first, then Files. Alphabetical.
-        [nodes sortUsingComparator:^NSComparisonResult(AuthenticFileNode *node1, AuthenticFileNode *node2) {
-            if (node1.isDirectory != node2.isDirectory) {
-                return node1.isDirectory ? NSOrderedAscending : NSOrderedDescending;
-            }
-            return [node1.name localizedStandardCompare:node2.name];
-        }];
+        AuthenticSortNodes(nodes);
         
         return nodes;
     } @catch (NSException *exception) {
@@ -124,4 +156,232 @@
     });
 }
 
+- (void)scanDirectoryRecursively:(NSString *)path
+                    batchHandler:(BOOL (^)(NSArray<AuthenticFileNode *> *))batchHandler
+                      completion:(void (^)(NSUInteger, NSError * _Nullable))completion {
+    const char *cPath = [path fileSystemRepresentation];
+    if (!cPath) {
+        completion(0, [NSError errorWithDomain:NSPOSIXErrorDomain code:EINVAL userInfo:nil]);
+        return;
+    }
+    std::string root(cPath);
+
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        // Batches are handed to the main queue without waiting for it; the answer
+        // from the handler stops the crawl on the next batch.
+        auto keepGoing = std::make_shared<std::atomic<bool>>(true);
+
+        // Ignored directories are pruned before they are opened.
+        MicroFiles::IgnoreMatcher ignore(root);
+        MicroFiles::ScanOptions options;
+        options.batchSize = 1024;
+        options.exclude = ignore.scanFilter();
+        MicroFiles::ScanResult result = MicroFiles::scanDirectory(root, options, [&](const MicroFiles::Entry *entries, size_t count) {
+            // Called on pool threads, which have no autorelease pool of their own.
+            @autoreleasepool {
+                NSMutableArray<AuthenticFileNode *> *batch = [NSMutableArray arrayWithCapacity:count];
+                for (size_t i = 0; i < count; i++) {
+                    const MicroFiles::Entry& entry = entries[i];
+                    NSString *fullPath = [[NSFileManager defaultManager] stringWithFileSystemRepresentation:entry.path.c_str()
+                                                                                                     length:entry.path.size()];
+                    if (!fullPath) continue;
+
+                    AuthenticFileNode *node = [[AuthenticFileNode alloc] init];
+                    node.name = [fullPath lastPathComponent];
+                    node.path = fullPath;
+                    node.isDirectory = entry.type == MicroFiles::EntryType::Directory || entry.linksToDirectory;
+                    node.isExpanded = NO;
+                    node.depth = (NSInteger)entry.depth;
+                    node.children = @[];
+                    [batch addObject:node];
+                }
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    if (keepGoing->load() && !batchHandler(batch)) keepGoing->store(false);
+                });
+            }
+            return keepGoing->load();
+        });
+
+        NSError *error = nil;
+        if (result.files + result.directories == 0 && result.errors > 0) {
+            error = [NSError errorWithDomain:NSPOSIXErrorDomain code:EACCES userInfo:nil];
+        }
+        NSUInteger entryCount = result.files + result.directories;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(entryCount, error);
+        });
+    });
+}
+
+- (BOOL)loadSnapshotAtPath:(NSString *)snapshotPath
+                   forRoot:(NSString *)root
+                completion:(void (^)(BOOL))completion {
+    const char *cSnapshot = [snapshotPath fileSystemRepresentation];
+    const char *cRoot = [[root stringByStandardizingPath] fileSystemRepresentation];
+    if (!cSnapshot || !cRoot) return NO;
+    std::string snapshotFile(cSnapshot);
+    std::string rootPath(cRoot);
+
+    _snapshot = std::make_unique<MicroFiles::TreeSnapshot>(snapshotFile);
+    BOOL loaded = _snapshot->open() && _snapshot->root() == rootPath;
+    if (!loaded) _snapshot->close();
+    NSUInteger generation = ++_snapshotGeneration;
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        // A private mapping of the same file: the main thread keeps reading its own
+        // until the rewritten snapshot is swapped in below.
+        MicroFiles::TreeSnapshot current(snapshotFile);
+        MicroFiles::IgnoreMatcher ignore(rootPath);
+        MicroFiles::ScanOptions options;
+        options.exclude = ignore.scanFilter();
+        // What IgnoreMatcher reads: an edit there re-crawls the subtree it governs.
+        MicroFiles::FilterFiles ignoreFiles;
+        ignoreFiles.everyDirectory = {".gitignore", ".ignore"};
+        ignoreFiles.rootOnly = {".git/info/exclude"};
+        BOOL refreshed = NO;
+        if (current.open() && current.root() == rootPath) {
+            refreshed = current.revalidate(options, ignoreFiles);
+        }
+        if (!refreshed) {
+            refreshed = current.build(rootPath, options, ignoreFiles);
+        }
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (generation != self->_snapshotGeneration) return; // Superseded
+            BOOL mapped = refreshed && self->_snapshot->open();
+            if (completion) completion(mapped);
+        });
+    });
+    return loaded;
+}
+
+- (NSArray<AuthenticFileNode *> *)cachedContentsOfDirectory:(NSString *)path {
+    if (!_snapshot || !_snapshot->isOpen()) return nil;
+    const char *cPath = [[path stringByStandardizingPath] fileSystemRepresentation];
+    if (!cPath) return nil;
+
+    MicroFiles::TreeNode directory;
+    uint32_t index = _snapshot->find(cPath);
+    if (!_snapshot->node(index, directory) || directory.type != MicroFiles::EntryType::Directory) return nil;
+
+    NSMutableArray<AuthenticFileNode *> *nodes = [NSMutableArray arrayWithCapacity:directory.childCount];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    for (uint32_t i = 0; i < directory.childCount; i++) {
+        MicroFiles::TreeNode child;
+        if (!_snapshot->node(directory.firstChild + i, child)) break;
+        NSString *name = [fileManager stringWithFileSystemRepresentation:child.name.data() length:child.name.size()];
+        if (!name) continue;
+
+        AuthenticFileNode *node = [[AuthenticFileNode alloc] init];
+        node.name = name;
+        node.path = [path stringByAppendingPathComponent:name];
+        node.isDirectory = child.type == MicroFiles::EntryType::Directory || child.linksToDirectory;
+        node.isExpanded = NO;
+        node.depth = 0;
+        node.children = @[];
+        [nodes addObject:node];
+    }
+    AuthenticSortNodes(nodes);
+    return nodes;
+}
+
+@end
+
+// MARK: - AuthenticFileOutline
+
+static NSRange AuthenticRowRange(uint32_t row, uint32_t count) {
+    return row == MicroFiles::FlatTree::kNoRow ? NSMakeRange(NSNotFound, 0) : NSMakeRange(row, count);
+}
+
+@interface AuthenticFileOutline () {
+    std::unique_ptr<MicroFiles::FlatTree> _tree;
+}
+@end
+
+@implementation AuthenticFileOutline
+
+- (instancetype)initWithRootPath:(NSString *)rootPath {
+    if (self = [super init]) {
+        _rootPath = [[rootPath stringByStandardizingPath] copy];
+        const char *cRoot = [_rootPath fileSystemRepresentation];
+        _tree = std::make_unique<MicroFiles::FlatTree>(cRoot ? cRoot : "/");
+        [self loadDirectory:_tree->root() change:nullptr];
+    }
+    return self;
+}
+
+- (BOOL)loadDirectory:(const std::string&)path change:(MicroFiles::FlatTree::RowChange *)change {
+    std::vector<MicroFiles::Entry> entries;
+    if (!MicroFiles::listDirectory(path, MicroFiles::ScanOptions(), entries)) return NO;
+
+    std::vector<MicroFiles::FlatTree::Child> children;
+    children.reserve(entries.size());
+    for (const MicroFiles::Entry& entry : entries) {
+        bool isDirectory = entry.type == MicroFiles::EntryType::Directory || entry.linksToDirectory;
+        children.push_back({std::string(entry.name()), isDirectory});
+    }
+    return _tree->setChildren(path, std::move(children), change);
+}
+
+- (NSUInteger)numberOfRows {
+    return _tree->rowCount();
+}
+
+- (NSString *)nameAtRow:(NSUInteger)row {
+    std::string_view name = _tree->row((uint32_t)row).name;
+    return [[NSFileManager defaultManager] stringWithFileSystemRepresentation:name.data() length:name.size()] ?: @"";
+}
+
+- (NSString *)pathAtRow:(NSUInteger)row {
+    std::string path = _tree->path((uint32_t)row);
+    return [[NSFileManager defaultManager] stringWithFileSystemRepresentation:path.c_str() length:path.size()] ?: @"";
+}
+
+- (NSInteger)depthAtRow:(NSUInteger)row {
+    return (NSInteger)_tree->row((uint32_t)row).depth;
+}
+
+- (BOOL)isDirectoryAtRow:(NSUInteger)row {
+    return _tree->row((uint32_t)row).isDirectory;
+}
+
+- (BOOL)isExpandedAtRow:(NSUInteger)row {
+    return _tree->row((uint32_t)row).isExpanded;
+}
+
+- (NSUInteger)rowForPath:(NSString *)path {
+    const char *cPath = [[path stringByStandardizingPath] fileSystemRepresentation];
+    if (!cPath) return NSNotFound;
+    uint32_t row = _tree->rowOf(cPath);
+    return row == MicroFiles::FlatTree::kNoRow ? NSNotFound : row;
+}
+
+- (NSUInteger)parentRowOfRow:(NSUInteger)row {
+    uint32_t parent = _tree->parentRow((uint32_t)row);
+    return parent == MicroFiles::FlatTree::kNoRow ? NSNotFound : parent;
+}
+
+- (NSRange)expandRow:(NSUInteger)row {
+    MicroFiles::FlatTree::Row info = _tree->row((uint32_t)row);
+    if (!info.isDirectory || info.isExpanded) return NSMakeRange(row + 1, 0);
+
+    // Expanded first, so listing the directory splices its rows in directly.
+    MicroFiles::FlatTree::RowChange change = _tree->expand((uint32_t)row);
+    if (!info.isLoaded) [self loadDirectory:_tree->path((uint32_t)row) change:&change];
+    return AuthenticRowRange(change.row, change.inserted);
+}
+
+- (NSRange)collapseRow:(NSUInteger)row {
+    MicroFiles::FlatTree::RowChange change = _tree->collapse((uint32_t)row);
+    return AuthenticRowRange(change.row, change.removed);
+}
+
+- (BOOL)reloadDirectory:(NSString *)directory removedRows:(NSRange *)removed insertedRows:(NSRange *)inserted {
+    const char *cPath = [[directory stringByStandardizingPath] fileSystemRepresentation];
+    MicroFiles::FlatTree::RowChange change;
+    BOOL reloaded = cPath && _tree->isLoaded(cPath) && [self loadDirectory:std::string(cPath) change:&change];
+    if (removed) *removed = AuthenticRowRange(change.row, change.removed);
+    if (inserted) *inserted = AuthenticRowRange(change.row, change.inserted);
+    return reloaded;
+}
+
 @end
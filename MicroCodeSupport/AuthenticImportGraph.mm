@@ -0,0 +1,111 @@
+//
+//  AuthenticImportGraph.mm
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#import "AuthenticImportGraph.h"
+#include "Core/MicroImportGraph.h"
+#include "Core/MicroLexer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+static NSArray<NSString *> *AuthenticPathArray(const std::vector<std::string>& paths) {
+    NSMutableArray<NSString *> *results = [NSMutableArray arrayWithCapacity:paths.size()];
+    for (const auto& path : paths) {
+        NSString *string = [NSString stringWithUTF8String:path.c_str()];
+        if (string) [results addObject:string];
+    }
+    return results;
+}
+
+@interface AuthenticImportGraph () {
+    std::unique_ptr<MicroIndex::ImportGraph> _graph;
+}
+@end
+
+@implementation AuthenticImportGraph
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _graph.reset(new MicroIndex::ImportGraph());
+    }
+    return self;
+}
+
+- (void)indexWorkspace:(NSString *)rootPath completion:(void (^)(NSUInteger))completion {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        std::vector<std::string> paths;
+        NSURL *rootURL = [NSURL fileURLWithPath:rootPath isDirectory:YES];
+        NSDirectoryEnumerator<NSURL *> *enumerator =
+            [[NSFileManager defaultManager] enumeratorAtURL:rootURL
+                                 includingPropertiesForKeys:@[NSURLIsRegularFileKey]
+                                                    options:NSDirectoryEnumerationSkipsHiddenFiles | NSDirectoryEnumerationSkipsPackageDescendants
+                                               errorHandler:nil];
+        for (NSURL *url in enumerator) {
+            const char *cPath = url.fileSystemRepresentation;
+            if (!cPath) continue;
+            if (MicroLexer::LanguageSpec::languageForPath(cPath).empty()) continue;
+            paths.emplace_back(cPath);
+        }
+
+        NSUInteger scanned = self->_graph->indexFiles(paths);
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(scanned);
+            });
+        }
+    });
+}
+
+- (void)fileDidChange:(NSString *)path {
+    _graph->updateFile([path fileSystemRepresentation]);
+}
+
+- (void)fileWasRemoved:(NSString *)path {
+    _graph->removeFile([path fileSystemRepresentation]);
+}
+
+- (NSArray<NSString *> *)dependenciesOfFile:(NSString *)path {
+    return AuthenticPathArray(_graph->dependencies([path fileSystemRepresentation]));
+}
+
+- (NSArray<NSString *> *)dependentsOfFile:(NSString *)path {
+    return AuthenticPathArray(_graph->dependents([path fileSystemRepresentation]));
+}
+
+- (NSArray<NSString *> *)transitiveDependenciesOfFile:(NSString *)path maxDepth:(NSUInteger)maxDepth {
+    return AuthenticPathArray(_graph->transitiveDependencies([path fileSystemRepresentation], (uint32_t)MIN(maxDepth, (NSUInteger)UINT32_MAX)));
+}
+
+- (NSArray<NSString *> *)transitiveDependentsOfFile:(NSString *)path maxDepth:(NSUInteger)maxDepth {
+    return AuthenticPathArray(_graph->transitiveDependents([path fileSystemRepresentation], (uint32_t)MIN(maxDepth, (NSUInteger)UINT32_MAX)));
+}
+
+- (NSArray<NSString *> *)buildOrderForFiles:(NSArray<NSString *> *)paths {
+    std::vector<std::string> roots;
+    roots.reserve(paths.count);
+    for (NSString *path in paths) {
+        roots.emplace_back([path fileSystemRepresentation]);
+    }
+    return AuthenticPathArray(_graph->buildOrder(roots));
+}
+
+- (NSArray<NSString *> *)unresolvedImportsOfFile:(NSString *)path {
+    return AuthenticPathArray(_graph->unresolvedImports([path fileSystemRepresentation]));
+}
+
+- (NSUInteger)fileCount {
+    return _graph->fileCount();
+}
+
+- (NSUInteger)edgeCount {
+    return _graph->edgeCount();
+}
+
+@end
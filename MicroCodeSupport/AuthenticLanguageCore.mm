@@ -1,167 +1,92 @@
 #import "AuthenticLanguageCore.h"
 #import "AuthenticAIContext.h"
 #import "AuthenticSyntaxEngine.h"
+#import "AuthenticSyntaxEngine+Native.h"
 
+#include "Core/MicroDiagnostics.h"
+#include "Core/MicroFolding.h"
+#include "Core/MicroFuzzy.h"
+#include "Core/MicroHash.h"
+#include "Core/MicroIncrementalLexer.h"
+#include "Core/MicroOccurrenceIndex.h"
+#include "Core/MicroParseCache.h"
+#include "Core/MicroParser.h"
+#include "Core/MicroSelection.h"
+
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <iostream>
-#include <stack>
-
-// MARK: - MicroParser (C++)
-// A lightweight, fault-tolerant parser to extract structure from tokens.
-
-namespace MicroParser {
-
-    struct Symbol {
-        std::string name;
-        std::string type; // "function", "class", "variable"
-        std::string signature;
-        NSInteger line;
-    };
-
-    struct Scope {
-        std::string name; // Function or Class name
-        std::string type;
-        NSInteger startLine;
-        NSInteger endLine;
-        std::vector<Symbol> variables;
-    };
-
-    class Engine {
-    public:
-        std::vector<Scope> scopes;
-        std::vector<std::string> imports;
-        
-        Engine() {}
-        
-        void parse(NSArray<AuthenticToken *> *tokens, NSString *language) {
-            scopes.clear();
-            imports.clear();
-            
-            // Basic global scope
-            scopes.push_back({"Global", "global", 0, NSIntegerMax, {}});
-            
-            std::string lang = [language UTF8String];
-            bool isSwift = (lang == "swift");
-            bool isCpp = (lang == "cpp" || lang == "c" || lang == "objectivec");
-            
-            std::stack<size_t> scopeStack;
-            scopeStack.push(0); // Index of global scope
-            
-            for (NSInteger i = 0; i < tokens.count; i++) {
-                AuthenticToken *t = tokens[i];
-                std::string text = [t.content UTF8String];
-                
-                // 1. Detect Functions (Very naive for now, but fast)
-                if (t.type == AuthenticTokenTypeKeywordDeclaration) {
-                    if ((isSwift && text == "func") || (isCpp && (text == "void" || text == "int"))) {
-                        // Look ahead for name
-                        if (i + 1 < tokens.count) {
-                            AuthenticToken *nameToken = tokens[i+1];
-                            if (nameToken.type == AuthenticTokenTypeIdentifier || nameToken.type == AuthenticTokenTypeFunction) {
-                                std::string funcName = [nameToken.content UTF8String];
-                                
-                                // Create new scope
-                                Scope funcScope;
-                                funcScope.name = funcName;
-                                funcScope.type = "function";
-                                funcScope.startLine = t.range.location; // Approximation
-                                funcScope.endLine = NSIntegerMax;
-                                
-                                scopes.push_back(funcScope);
-                                // Note: Real parser would push to stack only on '{'
-                            }
-                        }
-                    }
-                }
-                
-                // 2. Detect Variables
-                if (t.type == AuthenticTokenTypeKeywordDeclaration) { // var, let, auto
-                     if ((isSwift && (text == "var" || text == "let")) || (isCpp && text == "auto")) {
-                         if (i + 1 < tokens.count) {
-                             AuthenticToken *nameToken = tokens[i+1];
-                             if (nameToken.type == AuthenticTokenTypeIdentifier) {
-                                  Symbol varSym;
-                                  varSym.name = [nameToken.content UTF8String];
-                                  varSym.type = "variable";
-                                  varSym.line = t.range.location; // line-ish
-                                  
-                                  // Add to current scope (top of stack)
-                                  if (!scopeStack.empty()) {
-                                      scopes[scopeStack.top()].variables.push_back(varSym);
-                                  }
-                             }
-                         }
-                     }
-                }
-                
-                // 3. Detect Imports
-                if (t.type == AuthenticTokenTypeKeyword) {
-                    if (text == "import" || text == "#include") {
-                        if (i + 1 < tokens.count) {
-                             imports.push_back([tokens[i+1].content UTF8String]);
-                        }
-                    }
-                }
-                
-                // 4. Bracket Scope Management (Crucial for "Am I in function X?")
-                if (text == "{") {
-                    // In a real parser, we'd link this '{' to the recently declared function
-                    // For now, if we just saw a func declaration, we assume this opens it.
-                    // This is "heuristic parsing".
-                    if (scopes.size() > 1 && scopes.back().startLine < (NSInteger)t.range.location + 50 /* locality */) {
-                         // Assume this brace belongs to the last detected symbol scope
-                         scopeStack.push(scopes.size() - 1);
-                    } else {
-                         // Anonymous scope
-                         Scope anon;
-                         anon.name = "Anonymous";
-                         anon.type = "block";
-                         anon.startLine = t.range.location;
-                         scopes.push_back(anon);
-                         scopeStack.push(scopes.size() - 1);
-                    }
-                } else if (text == "}") {
-                    if (scopeStack.size() > 1) { // Don't pop global
-                        size_t endingScopeIdx = scopeStack.top();
-                        scopes[endingScopeIdx].endLine = t.range.location + t.range.length;
-                        scopeStack.pop();
-                    }
-                }
-            }
-        }
-        
-        // Query
-        Scope* findScopeAt(NSInteger line) {
-            // Find the most specific scope (deepest) that contains this line
-            Scope* bestMatch = &scopes[0]; // Global
-            
-            for (size_t i = 1; i < scopes.size(); i++) {
-                // Determine 'line' from range location (very rough approx, needs real line mapping)
-                // Assuming range.location is character index. We need line index.
-                // TODO: Fix line mapping. For now, we assume simple character index check if possible, or we need line map.
-                // Wait, the Tokenizer gives us Ranges (char indices).
-                // The input 'line' is a line number.
-                // We need to know which char indices correspond to 'line'.
-                // AuthenticLanguageCore should manage Line <-> Char Index map.
-            }
-            return bestMatch; 
-        }
-    };
+
+// Rough cost of one materialized AuthenticToken (object header, NSRange, content pointer).
+static const NSUInteger kAuthenticTokenObjectBytes = 48;
+// Rough cost of one summary entry (NSString + array slot).
+static const NSUInteger kAuthenticSummaryEntryBytes = 32;
+
+// Tokens and scope trees of large files, keyed by content hash (~/Library/Caches/MicroCode/ParseCache).
+static MicroCache::ParseCache *AuthenticSharedParseCache(void) {
+    static MicroCache::ParseCache *cache = nullptr;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *caches = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+        NSURL *directory = [[caches ?: [NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:@"MicroCode" isDirectory:YES]
+                            URLByAppendingPathComponent:@"ParseCache" isDirectory:YES];
+        cache = new MicroCache::ParseCache(std::string(directory.fileSystemRepresentation));
+    });
+    return cache;
+}
+
+static NSString *AuthenticScopeKindName(MicroParser::ScopeKind kind) {
+    switch (kind) {
+        case MicroParser::ScopeKind::Global: return @"global";
+        case MicroParser::ScopeKind::Function: return @"function";
+        case MicroParser::ScopeKind::Class: return @"class";
+        case MicroParser::ScopeKind::Block: return @"block";
+    }
+    return @"";
+}
+
+// Native offsets are treated as UTF-16 like token ranges, clamped to the string.
+static NSRange AuthenticClampedRange(NSUInteger start, NSUInteger end, NSUInteger length) {
+    start = MIN(start, length);
+    end = MIN(MAX(start, end), length);
+    return NSMakeRange(start, end - start);
 }
 
+@interface AuthenticLanguageCoreRegistry ()
+- (void)enforceBudgetSparing:(AuthenticLanguageCore *)core;
+@end
 
-@interface AuthenticLanguageCore ()
-@property (nonatomic, strong) NSString *currentLanguage;
+@interface AuthenticLanguageCore () {
+    MicroFuzzy::Corpus _symbolCorpus;
+    std::vector<uint32_t> _scopeStartLines; // Line of each parser scope's start, empty when stale
+}
+@property (nonatomic, readwrite, copy) NSString *language;
+@property (nonatomic, readwrite, copy) NSString *documentIdentifier;
+@property (nonatomic, readwrite, getter=isResident) BOOL resident;
 @property (nonatomic, strong) NSArray<AuthenticToken *> *currentTokens;
 @property (nonatomic, strong) NSString *sourceCode;
+@property (nonatomic, copy) NSArray<NSString *> *summarySymbols;
+@property (nonatomic, copy) NSArray<NSString *> *summaryImports;
+@property (nonatomic, copy) NSArray<NSString *> *corpusSymbols; // Names backing _symbolCorpus, nil when stale
+@property (nonatomic, copy) NSArray<NSDictionary *> *cachedDiagnostics; // nil when stale
+@property (nonatomic, weak) AuthenticLanguageCoreRegistry *registry;
+@property (nonatomic, assign) MicroLexer::IncrementalLexer *lexer; // Owns the UTF-8 source and native tokens
 @property (nonatomic, assign) MicroParser::Engine *parser;
+@property (nonatomic, assign) MicroDiagnostics::Engine *diagnosticsEngine;
+@property (nonatomic, assign) MicroFolding::Engine *foldingEngine;
+@property (nonatomic, assign) MicroIndex::OccurrenceIndex *occurrenceIndex;
+@property (nonatomic, assign) MicroSelection::Tree *selectionTree;
 @end
 
 @implementation AuthenticLanguageCore
 
 + (instancetype)shared {
+    AuthenticLanguageCore *active = [[AuthenticLanguageCoreRegistry sharedRegistry] activeCore];
+    if (active) {
+        return active;
+    }
     static AuthenticLanguageCore *sharedInstance = nil;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
@@ -180,93 +105,563 @@ namespace MicroParser {
 - (instancetype)initWithLanguage:(NSString *)language {
     self = [super init];
     if (self) {
-        _currentLanguage = [language copy];
-        _currentTokens = @[];
+        _language = [language copy] ?: @"text";
+        _resident = YES;
+        _memoryBudget = 8 * 1024 * 1024;
+        _summarySymbols = @[];
+        _summaryImports = @[];
+        // The lexer only holds a reference to the shared per-language tables.
+        _lexer = new MicroLexer::IncrementalLexer(std::string([_language UTF8String]));
         _parser = new MicroParser::Engine();
+        _diagnosticsEngine = new MicroDiagnostics::Engine(std::string([_language UTF8String]));
+        _foldingEngine = new MicroFolding::Engine(std::string([_language UTF8String]));
+        _occurrenceIndex = new MicroIndex::OccurrenceIndex();
+        _selectionTree = new MicroSelection::Tree();
     }
     return self;
 }
 
 - (void)dealloc {
+    delete _lexer;
     delete _parser;
+    delete _diagnosticsEngine;
+    delete _foldingEngine;
+    delete _occurrenceIndex;
+    delete _selectionTree;
 }
 
 - (void)updateSource:(NSString *)source {
+    @synchronized (self) {
+        if (![self applySource:source]) {
+            return;
+        }
+    }
+    // Outside this core's lock: the registry takes its own lock and then those of
+    // the cores it compacts, so a core never waits on the registry while locked.
+    [self.registry enforceBudgetSparing:self];
+}
+
+// Caller holds @synchronized (self). Returns NO when the text did not change.
+- (BOOL)applySource:(NSString *)source {
+    if (_resident && _sourceCode && [source isEqualToString:_sourceCode]) {
+        return NO;
+    }
+    BOOL wasResident = _resident && _sourceCode != nil;
     _sourceCode = [source copy];
-    
+    _currentTokens = nil;
+    _corpusSymbols = nil;
+    _cachedDiagnostics = nil;
+    _resident = YES;
+
+    const char *utf8 = [_sourceCode UTF8String];
+    std::string_view text(utf8 ? utf8 : "");
+
     // 1. Tokenize (Syntax)
-    _currentTokens = [AuthenticSyntaxEngine tokenizeSource:source language:_currentLanguage];
-    
+    // Native tokens only; AuthenticToken objects are materialized lazily by -tokens.
+    // An edit is the span between the common prefix and suffix of the old and new
+    // text; only the lines it touches are relexed and re-checked.
+    if (wasResident) {
+        std::string_view old(_lexer->source());
+        size_t prefix = 0;
+        size_t maxPrefix = std::min(old.size(), text.size());
+        while (prefix < maxPrefix && old[prefix] == text[prefix]) prefix++;
+        size_t suffix = 0;
+        size_t maxSuffix = maxPrefix - prefix;
+        while (suffix < maxSuffix && old[old.size() - 1 - suffix] == text[text.size() - 1 - suffix]) suffix++;
+
+        MicroLexer::EditResult edit = _lexer->applyEdit(prefix, old.size() - prefix - suffix,
+                                                        text.substr(prefix, text.size() - prefix - suffix));
+        [self applyLineEdit:edit];
+    } else if (text.size() >= MicroCache::ParseCache::kMinSourceBytes) {
+        // Opening a large file: tokens and scopes come from the parse cache when
+        // this exact text was seen before; otherwise they are stored for next time.
+        [self loadLargeSource:text];
+        return YES;
+    } else {
+        _lexer->reset(text);
+        [self resetLineState];
+    }
+
     // 2. Parse (Semantics)
+    // Results are string_views into the lexer's source, which stays untouched until the next parse.
     // Note: This runs on the calling thread. For large files, should use GCD.
-    _parser->parse(_currentTokens, _currentLanguage);
+    _parser->parse(_lexer->tokens(), _lexer->source(), std::string([_language UTF8String]));
+    [self scopesDidChange];
+    return YES;
+}
+
+- (void)loadLargeSource:(std::string_view)text {
+    MicroCache::ParseCache *cache = AuthenticSharedParseCache();
+    uint64_t hash = MicroCore::hash64(text);
+    std::string lang([_language UTF8String]);
+
+    if (cache->load(text, hash, lang, *_lexer, *_parser)) {
+        [self resetLineState];
+        [self scopesDidChange];
+
+        // Verify off the main thread; on a mismatch the entry is dropped and this
+        // core re-parses if it still shows the same text.
+        NSString *snapshot = _sourceCode;
+        __weak AuthenticLanguageCore *weakSelf = self;
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+            const char *bytes = [snapshot UTF8String];
+            if (cache->verify(bytes ? bytes : "", hash, lang)) {
+                return;
+            }
+            dispatch_async(dispatch_get_main_queue(), ^{
+                AuthenticLanguageCore *core = weakSelf;
+                if (!core) {
+                    return;
+                }
+                @synchronized (core) {
+                    if (core.isResident && [core.sourceCode isEqualToString:snapshot]) {
+                        [core rebuildFromSource];
+                    }
+                }
+            });
+        });
+        return;
+    }
+
+    [self rebuildFromSource];
+    auto blob = std::make_shared<std::string>(MicroCache::ParseCache::encode(hash, lang, *_lexer, *_parser));
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        cache->store(hash, lang, *blob);
+    });
+}
+
+// Per-line engines follow the lexer: after an edit only the relexed lines are redone.
+- (void)applyLineEdit:(const MicroLexer::EditResult&)edit {
+    _diagnosticsEngine->applyEdit(*_lexer, edit);
+    _foldingEngine->applyEdit(*_lexer, edit);
+    _occurrenceIndex->applyEdit(*_lexer, edit);
+}
+
+- (void)resetLineState {
+    _diagnosticsEngine->reset(*_lexer);
+    _foldingEngine->reset(*_lexer);
+    _occurrenceIndex->reset(*_lexer);
+}
+
+// Scope-derived state is rebuilt lazily after each parse or cache load.
+- (void)scopesDidChange {
+    _foldingEngine->scopesDidChange();
+    _selectionTree->invalidate();
+    _scopeStartLines.clear();
+}
+
+// Full tokenize and parse of _sourceCode, bypassing the parse cache.
+- (void)rebuildFromSource {
+    @synchronized (self) {
+        const char *utf8 = [_sourceCode UTF8String];
+        _lexer->reset(utf8 ? utf8 : "");
+        _parser->parse(_lexer->tokens(), _lexer->source(), std::string([_language UTF8String]));
+        [self resetLineState];
+        [self scopesDidChange];
+        _currentTokens = nil;
+        _corpusSymbols = nil;
+        _cachedDiagnostics = nil;
+    }
 }
 
 - (NSArray<AuthenticToken *> *)tokens {
-    return _currentTokens;
+    @synchronized (self) {
+        if (!_resident) {
+            return @[];
+        }
+        if (_currentTokens) {
+            return _currentTokens;
+        }
+        NSArray<AuthenticToken *> *tokens = AuthenticTokensFromNative(_lexer->tokens(), _sourceCode.length);
+        // Keep the materialized array only if it fits in this instance's budget.
+        if (self.estimatedMemoryUsage + tokens.count * kAuthenticTokenObjectBytes <= _memoryBudget) {
+            _currentTokens = tokens;
+        }
+        return tokens;
+    }
+}
+
+- (NSUInteger)estimatedMemoryUsage {
+    @synchronized (self) {
+        NSUInteger bytes = (_summarySymbols.count + _summaryImports.count) * kAuthenticSummaryEntryBytes;
+        if (!_resident) {
+            return bytes;
+        }
+        bytes += _sourceCode.length * sizeof(unichar);
+        bytes += _lexer->memoryFootprint();
+        bytes += _parser->memoryFootprint();
+        bytes += _diagnosticsEngine->memoryFootprint();
+        bytes += _foldingEngine->memoryFootprint();
+        bytes += _occurrenceIndex->memoryFootprint();
+        bytes += _selectionTree->memoryFootprint();
+        bytes += _scopeStartLines.capacity() * sizeof(uint32_t);
+        bytes += _currentTokens.count * kAuthenticTokenObjectBytes;
+        return bytes;
+    }
+}
+
+- (void)compact {
+    @synchronized (self) {
+        if (!_resident) {
+            return;
+        }
+        _summarySymbols = [self symbols];
+        _summaryImports = [self currentImports];
+
+        _sourceCode = nil;
+        _currentTokens = nil;
+        _corpusSymbols = nil;
+        _cachedDiagnostics = nil;
+        _symbolCorpus = MicroFuzzy::Corpus();
+        std::vector<uint32_t>().swap(_scopeStartLines);
+        std::string lang([_language UTF8String]);
+        delete _lexer;
+        _lexer = new MicroLexer::IncrementalLexer(lang);
+        delete _parser;
+        _parser = new MicroParser::Engine();
+        delete _diagnosticsEngine;
+        _diagnosticsEngine = new MicroDiagnostics::Engine(lang);
+        delete _foldingEngine;
+        _foldingEngine = new MicroFolding::Engine(lang);
+        delete _occurrenceIndex;
+        _occurrenceIndex = new MicroIndex::OccurrenceIndex();
+        delete _selectionTree;
+        _selectionTree = new MicroSelection::Tree();
+        _resident = NO;
+    }
+}
+
+- (NSArray<NSString *> *)currentImports {
+    @synchronized (self) {
+        NSMutableArray *imps = [NSMutableArray array];
+        for (const auto& imp : _parser->imports) {
+            [imps addObject:AuthenticStringFromView(imp)];
+        }
+        return [imps copy];
+    }
 }
 
 - (AuthenticAIContext *)contextForLine:(NSInteger)line column:(NSInteger)column {
-    AuthenticAIContext *ctx = [[AuthenticAIContext alloc] init];
+    @synchronized (self) {
+        AuthenticAIContext *ctx = [[AuthenticAIContext alloc] init];
+        if (!_resident) {
+            ctx.imports = _summaryImports;
+            return ctx;
+        }
     
-    // Convert Line/Col to Char Index (Need a helper for this)
-    NSRange lineRange = [self rangeForLine:line];
-    if (lineRange.location == NSNotFound) {
-        return ctx;
-    }
-    NSUInteger charIndex = lineRange.location + column;
+        // Convert Line/Col to Char Index (Need a helper for this)
+        NSRange lineRange = [self rangeForLine:line];
+        if (lineRange.location == NSNotFound) {
+            return ctx;
+        }
+        NSUInteger charIndex = lineRange.location + column;
     
-    // 1. Find Scope
-    // Iterate parsed scopes to find the deepest one wrapping charIndex
-    if (_parser->scopes.empty()) {
-        return ctx;
-    }
-    MicroParser::Scope *foundScope = &_parser->scopes[0]; // Global
+        // 1. Find Scope
+        // The deepest named scope wrapping charIndex (startLine is actually a char index in the parser)
+        if (_parser->scopes.empty()) {
+            return ctx;
+        }
+        size_t scopeIndex = _parser->scopeAt((int64_t)charIndex);
+        while (scopeIndex != 0 && !_parser->scopes[scopeIndex].isNamed()) {
+            scopeIndex = (size_t)_parser->scopes[scopeIndex].parent;
+        }
+        const MicroParser::Scope *foundScope = &_parser->scopes[scopeIndex];
     
-    // Heuristic: Find last declared scope started BEFORE this charIndex and NOT ended
-    for (const auto& scope : _parser->scopes) {
-        if (scope.type == "function" || scope.type == "class") {
-            // Check start (approx via startLine which is actually char index in my parser)
-             if ((NSUInteger)scope.startLine <= charIndex && (NSUInteger)scope.endLine >= charIndex) {
-                 foundScope = (MicroParser::Scope*)&scope;
-             }
+        if (foundScope->kind != MicroParser::ScopeKind::Global) {
+            ctx.currentFunctionSignature = AuthenticStringFromView(foundScope->name);
+            ctx.enclosingType = AuthenticScopeKindName(foundScope->kind); // e.g. "function"
         }
-    }
     
-    if (foundScope->name != "Global") {
-        ctx.currentFunctionSignature = [NSString stringWithUTF8String:foundScope->name.c_str()];
-        ctx.enclosingType = [NSString stringWithUTF8String:foundScope->type.c_str()]; // e.g. "function"
-    }
+        // 2. Variables
+        NSMutableArray *vars = [NSMutableArray array];
+        for (const MicroParser::Symbol *v = foundScope->variables; v; v = v->next) {
+            [vars addObject:AuthenticStringFromView(v->name)];
+        }
+        ctx.scopeVariables = [vars copy];
     
-    // 2. Variables
-    NSMutableArray *vars = [NSMutableArray array];
-    for (const auto& v : foundScope->variables) {
-        [vars addObject:[NSString stringWithUTF8String:v.name.c_str()]];
-    }
-    ctx.scopeVariables = [vars copy];
+        // 3. Imports
+        ctx.imports = [self currentImports];
     
-    // 3. Imports
-    NSMutableArray *imps = [NSMutableArray array];
-    for (const auto& imp : _parser->imports) {
-        [imps addObject:[NSString stringWithUTF8String:imp.c_str()]];
+        return ctx;
     }
-    ctx.imports = [imps copy];
-    
-    return ctx;
 }
 
 - (NSArray<NSString *> *)symbols {
-    NSMutableArray *syms = [NSMutableArray array];
-    for (const auto& scope : _parser->scopes) {
-        if (scope.name != "Global" && scope.name != "Anonymous") {
-             [syms addObject:[NSString stringWithUTF8String:scope.name.c_str()]];
+    @synchronized (self) {
+        if (!_resident) {
+            return _summarySymbols;
+        }
+        NSMutableArray *syms = [NSMutableArray array];
+        for (const auto& scope : _parser->scopes) {
+            if (scope.isNamed()) {
+                 [syms addObject:AuthenticStringFromView(scope.name)];
+            }
+        }
+        return syms;
+    }
+}
+
+- (NSArray<NSString *> *)symbolsMatchingQuery:(NSString *)query limit:(NSUInteger)limit {
+    @synchronized (self) {
+        if (!_corpusSymbols) {
+            _corpusSymbols = [self symbols];
+            _symbolCorpus.clear();
+            for (NSString *name in _corpusSymbols) {
+                _symbolCorpus.add(name.UTF8String ?: "");
+            }
+        }
+        const char *utf8 = [query UTF8String];
+        std::vector<MicroFuzzy::Match> matches = MicroFuzzy::Matcher().topMatches(_symbolCorpus, utf8 ? utf8 : "", limit);
+
+        NSMutableArray<NSString *> *results = [NSMutableArray arrayWithCapacity:matches.size()];
+        for (const auto& match : matches) {
+            [results addObject:_corpusSymbols[match.index]];
         }
+        return results;
     }
-    return syms;
 }
 
 - (NSArray<NSDictionary *> *)diagnostics {
-    return @[]; // TODO: Integrate LSP diagnostics
+    @synchronized (self) {
+        if (!_resident) {
+            return @[];
+        }
+        if (_cachedDiagnostics) {
+            return _cachedDiagnostics;
+        }
+        // Keys follow LSP's Diagnostic; offsets are treated as UTF-16 like token ranges.
+        NSUInteger length = _sourceCode.length;
+        NSMutableArray<NSDictionary *> *results = [NSMutableArray array];
+        for (const auto& d : _diagnosticsEngine->collect(*_lexer, *_parser)) {
+            NSUInteger start = MIN((NSUInteger)d.start, length);
+            NSUInteger end = MIN((NSUInteger)d.start + d.length, length);
+            [results addObject:@{
+                @"message": [NSString stringWithUTF8String:d.message.c_str()] ?: @"",
+                @"severity": @((NSInteger)d.severity),
+                @"code": @(MicroDiagnostics::codeName(d.code)),
+                @"source": @"local",
+                @"line": @(d.line),
+                @"column": @(d.column),
+                @"range": [NSValue valueWithRange:NSMakeRange(start, end - start)]
+            }];
+        }
+        _cachedDiagnostics = [results copy];
+        return _cachedDiagnostics;
+    }
+}
+
+- (NSArray<NSDictionary *> *)foldingRangesInLines:(NSRange)lines {
+    @synchronized (self) {
+        if (!_resident || lines.length == 0) {
+            return @[];
+        }
+        std::vector<MicroFolding::FoldingRange> folds;
+        _foldingEngine->foldsInLines(*_lexer, *_parser, lines.location, NSMaxRange(lines) - 1, folds);
+
+        NSMutableArray<NSDictionary *> *results = [NSMutableArray arrayWithCapacity:folds.size()];
+        for (const auto& fold : folds) {
+            [results addObject:@{
+                @"startLine": @(fold.startLine),
+                @"endLine": @(fold.endLine),
+                @"kind": fold.kind == MicroFolding::FoldKind::Comment ? @"comment" : @"block"
+            }];
+        }
+        return results;
+    }
+}
+
+- (NSArray<NSNumber *> *)indentGuideLevelsInLines:(NSRange)lines {
+    @synchronized (self) {
+        if (!_resident || lines.length == 0) {
+            return @[];
+        }
+        std::vector<uint8_t> levels;
+        _foldingEngine->guidesInLines(lines.location, NSMaxRange(lines) - 1, levels);
+
+        NSMutableArray<NSNumber *> *results = [NSMutableArray arrayWithCapacity:levels.size()];
+        for (uint8_t level : levels) {
+            [results addObject:@(level)];
+        }
+        return results;
+    }
+}
+
+- (NSArray<NSValue *> *)rangesForOccurrences:(const std::vector<MicroIndex::OccurrenceIndex::Occurrence>&)occurrences {
+    NSUInteger length = _sourceCode.length;
+    NSMutableArray<NSValue *> *ranges = [NSMutableArray arrayWithCapacity:occurrences.size()];
+    for (const auto& occurrence : occurrences) {
+        NSUInteger start = MIN((NSUInteger)occurrence.start, length);
+        NSUInteger end = MIN((NSUInteger)occurrence.start + occurrence.length, length);
+        [ranges addObject:[NSValue valueWithRange:NSMakeRange(start, end - start)]];
+    }
+    return ranges;
+}
+
+- (NSArray<NSValue *> *)occurrenceRangesOfIdentifierAtIndex:(NSUInteger)index {
+    @synchronized (self) {
+        if (!_resident) {
+            return @[];
+        }
+        uint32_t identifier = _occurrenceIndex->identifierAt(*_lexer, index);
+        if (identifier == MicroIndex::OccurrenceIndex::kNoIdentifier) {
+            return @[];
+        }
+        std::vector<MicroIndex::OccurrenceIndex::Occurrence> occurrences;
+        _occurrenceIndex->occurrences(*_lexer, identifier, occurrences);
+        return [self rangesForOccurrences:occurrences];
+    }
+}
+
+- (NSArray<NSValue *> *)renameRangesForIdentifierAtIndex:(NSUInteger)index {
+    @synchronized (self) {
+        if (!_resident) {
+            return @[];
+        }
+        uint32_t identifier = _occurrenceIndex->identifierAt(*_lexer, index);
+        if (identifier == MicroIndex::OccurrenceIndex::kNoIdentifier) {
+            return @[];
+        }
+
+        // A variable declared in an enclosing scope is renamed within that scope only;
+        // anything else (types, functions, globals) across the document.
+        std::string_view name = _occurrenceIndex->name(identifier);
+        const MicroParser::Scope *declaring = nullptr;
+        for (size_t i = _parser->scopes.empty() ? 0 : _parser->scopeAt((int64_t)index); i != 0 && !declaring;
+             i = (size_t)_parser->scopes[i].parent) {
+            for (const MicroParser::Symbol *v = _parser->scopes[i].variables; v; v = v->next) {
+                if (v->name == name) {
+                    declaring = &_parser->scopes[i];
+                    break;
+                }
+            }
+        }
+
+        std::vector<MicroIndex::OccurrenceIndex::Occurrence> occurrences;
+        if (declaring) {
+            size_t firstLine = _lexer->lineForOffset((size_t)declaring->startLine);
+            size_t lastLine = _lexer->lineForOffset(std::min((size_t)declaring->endLine, _lexer->source().size()));
+            _occurrenceIndex->occurrencesInLines(*_lexer, identifier, firstLine, lastLine, occurrences);
+        } else {
+            _occurrenceIndex->occurrences(*_lexer, identifier, occurrences);
+        }
+        return [self rangesForOccurrences:occurrences];
+    }
+}
+
+// MARK: - Structural Selection
+
+- (NSRange)expandedSelectionRange:(NSRange)selection {
+    @synchronized (self) {
+        if (!_resident) {
+            return selection;
+        }
+        NSUInteger length = _sourceCode.length;
+        NSUInteger start = MIN(selection.location, length);
+        NSUInteger end = MIN(NSMaxRange(selection), length);
+        MicroSelection::Range range = _selectionTree->expand(*_lexer, *_parser, {(uint32_t)start, (uint32_t)end});
+        return AuthenticClampedRange(range.start, range.end, length);
+    }
+}
+
+- (NSRange)shrunkSelectionRange:(NSRange)selection {
+    @synchronized (self) {
+        if (!_resident) {
+            return selection;
+        }
+        NSUInteger length = _sourceCode.length;
+        NSUInteger start = MIN(selection.location, length);
+        NSUInteger end = MIN(NSMaxRange(selection), length);
+        MicroSelection::Range range = _selectionTree->shrink(*_lexer, *_parser, {(uint32_t)start, (uint32_t)end});
+        return AuthenticClampedRange(range.start, range.end, length);
+    }
+}
+
+// MARK: - Scope Chain
+
+- (void)prepareScopeStartLines {
+    if (_scopeStartLines.size() == _parser->scopes.size()) {
+        return;
+    }
+    _scopeStartLines.clear();
+    _scopeStartLines.reserve(_parser->scopes.size());
+    size_t sourceSize = _lexer->source().size();
+    for (const auto& scope : _parser->scopes) {
+        _scopeStartLines.push_back((uint32_t)_lexer->lineForOffset(std::min((size_t)scope.startLine, sourceSize)));
+    }
+}
+
+- (AuthenticScopeInfo)scopeInfoAtIndex:(size_t)i {
+    const MicroParser::Scope& scope = _parser->scopes[i];
+    NSUInteger length = _sourceCode.length;
+    NSUInteger start = MIN((NSUInteger)scope.startLine, length);
+    NSUInteger end = MIN((NSUInteger)std::max(scope.startLine, scope.endLine), length);
+
+    AuthenticScopeInfo info;
+    info.range = NSMakeRange(start, end - start);
+    info.nameRange = NSMakeRange(NSNotFound, 0);
+    if (scope.isNamed()) { // Other scope names are literals, not views into the source
+        NSUInteger nameStart = MIN((NSUInteger)(scope.name.data() - _lexer->source().data()), length);
+        info.nameRange = NSMakeRange(nameStart, MIN((NSUInteger)scope.name.size(), length - nameStart));
+    }
+    info.headerLine = _scopeStartLines[i];
+    info.kind = (AuthenticScopeKind)scope.kind;
+    return info;
+}
+
+- (NSUInteger)getScopeChain:(AuthenticScopeInfo *)chain maxCount:(NSUInteger)maxCount atIndex:(NSUInteger)index {
+    @synchronized (self) {
+        if (!_resident || !chain || maxCount == 0 || _parser->scopes.empty()) {
+            return 0;
+        }
+        [self prepareScopeStartLines];
+
+        // Walk innermost-out, then put the outermost first.
+        NSUInteger count = 0;
+        for (size_t i = _parser->scopeAt((int64_t)index); i != 0 && count < maxCount; i = (size_t)_parser->scopes[i].parent) {
+            chain[count++] = [self scopeInfoAtIndex:i];
+        }
+        std::reverse(chain, chain + count);
+        return count;
+    }
+}
+
+- (NSUInteger)getStickyHeaderLines:(NSUInteger *)lines maxCount:(NSUInteger)maxCount forFirstVisibleLine:(NSUInteger)firstVisibleLine {
+    @synchronized (self) {
+        if (!_resident || !lines || maxCount == 0 || _parser->scopes.empty() || firstVisibleLine >= _lexer->lineCount()) {
+            return 0;
+        }
+        [self prepareScopeStartLines];
+        size_t innermost = _parser->scopeAt((int64_t)_lexer->lineStart(firstVisibleLine));
+
+        // Header lines only decrease going outwards, so equal lines are adjacent. The
+        // first pass counts them; the second keeps the outermost maxCount.
+        NSUInteger total = 0;
+        uint32_t previous = UINT32_MAX;
+        for (size_t i = innermost; i != 0; i = (size_t)_parser->scopes[i].parent) {
+            uint32_t line = _scopeStartLines[i];
+            if (line < firstVisibleLine && line != previous) {
+                total++;
+                previous = line;
+            }
+        }
+        NSUInteger count = MIN(total, maxCount);
+        NSUInteger skip = total - count;
+        NSUInteger slot = count;
+        previous = UINT32_MAX;
+        for (size_t i = innermost; i != 0; i = (size_t)_parser->scopes[i].parent) {
+            uint32_t line = _scopeStartLines[i];
+            if (line >= firstVisibleLine || line == previous) {
+                continue;
+            }
+            previous = line;
+            if (skip > 0) {
+                skip--;
+            } else {
+                lines[--slot] = line;
+            }
+        }
+        return count;
+    }
 }
 
 // Helper: Naive O(N) line finder. In production, cache this.
@@ -286,3 +681,151 @@ namespace MicroParser {
 }
 
 @end
+
+// MARK: - AuthenticLanguageCoreRegistry
+
+@interface AuthenticLanguageCoreRegistry ()
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AuthenticLanguageCore *> *cores;
+@property (nonatomic, strong) NSMutableOrderedSet<NSString *> *recency; // Least recently used first
+@property (nonatomic, copy) NSString *activeDocument;
+@end
+
+@implementation AuthenticLanguageCoreRegistry
+
++ (instancetype)sharedRegistry {
+    static AuthenticLanguageCoreRegistry *shared = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        shared = [[AuthenticLanguageCoreRegistry alloc] init];
+    });
+    return shared;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _cores = [NSMutableDictionary dictionary];
+        _recency = [NSMutableOrderedSet orderedSet];
+        _totalMemoryBudget = 64 * 1024 * 1024;
+        _maxResidentCores = 16;
+        _maxCores = 512;
+    }
+    return self;
+}
+
+- (void)touch:(NSString *)documentIdentifier {
+    [_recency removeObject:documentIdentifier];
+    [_recency addObject:documentIdentifier];
+}
+
+- (AuthenticLanguageCore *)coreForDocument:(NSString *)documentIdentifier language:(NSString *)language {
+    if (!documentIdentifier) return nil;
+    AuthenticLanguageCore *core = nil;
+    @synchronized (self) {
+        core = _cores[documentIdentifier];
+        if (!core || (language && ![core.language isEqualToString:language])) {
+            core = [[AuthenticLanguageCore alloc] initWithLanguage:language];
+            core.documentIdentifier = documentIdentifier;
+            core.registry = self;
+            _cores[documentIdentifier] = core;
+        }
+        [self touch:documentIdentifier];
+        [self enforceBudgetSparing:core];
+    }
+    return core;
+}
+
+- (void)activateDocument:(NSString *)documentIdentifier {
+    if (!documentIdentifier) return;
+    @synchronized (self) {
+        self.activeDocument = documentIdentifier;
+        if (_cores[documentIdentifier]) {
+            [self touch:documentIdentifier];
+        }
+        [self enforceBudgetSparing:nil];
+    }
+}
+
+- (void)closeDocument:(NSString *)documentIdentifier {
+    if (!documentIdentifier) return;
+    @synchronized (self) {
+        if ([_activeDocument isEqualToString:documentIdentifier]) {
+            self.activeDocument = nil;
+        }
+        [_cores[documentIdentifier] compact];
+    }
+}
+
+- (void)removeDocument:(NSString *)documentIdentifier {
+    if (!documentIdentifier) return;
+    @synchronized (self) {
+        if ([_activeDocument isEqualToString:documentIdentifier]) {
+            self.activeDocument = nil;
+        }
+        [_cores removeObjectForKey:documentIdentifier];
+        [_recency removeObject:documentIdentifier];
+    }
+}
+
+- (AuthenticLanguageCore *)activeCore {
+    @synchronized (self) {
+        return _activeDocument ? _cores[_activeDocument] : nil;
+    }
+}
+
+- (NSUInteger)estimatedMemoryUsage {
+    @synchronized (self) {
+        NSUInteger bytes = 0;
+        for (AuthenticLanguageCore *core in _cores.allValues) {
+            bytes += core.estimatedMemoryUsage;
+        }
+        return bytes;
+    }
+}
+
+- (void)enforceBudget {
+    [self enforceBudgetSparing:nil];
+}
+
+- (void)enforceBudgetSparing:(AuthenticLanguageCore *)spared {
+    @synchronized (self) {
+        // 1. Hard cap on registered documents: forget the oldest ones entirely.
+        NSUInteger index = 0;
+        while (_cores.count > _maxCores && index < _recency.count) {
+            NSString *docID = _recency[index];
+            AuthenticLanguageCore *core = _cores[docID];
+            if (core == spared || [docID isEqualToString:_activeDocument]) {
+                index++;
+                continue;
+            }
+            [_cores removeObjectForKey:docID];
+            [_recency removeObjectAtIndex:index];
+        }
+
+        // 2. Resident budget: compact least recently used cores first.
+        NSUInteger residentCount = 0;
+        NSUInteger residentBytes = 0;
+        for (AuthenticLanguageCore *core in _cores.allValues) {
+            if (core.isResident) {
+                residentCount++;
+                residentBytes += core.estimatedMemoryUsage;
+            }
+        }
+
+        for (NSString *docID in _recency) {
+            if (residentCount <= _maxResidentCores && residentBytes <= _totalMemoryBudget) {
+                break;
+            }
+            AuthenticLanguageCore *core = _cores[docID];
+            if (!core.isResident || core == spared || [docID isEqualToString:_activeDocument]) {
+                continue;
+            }
+            NSUInteger before = core.estimatedMemoryUsage;
+            [core compact];
+            residentCount--;
+            residentBytes -= MIN(residentBytes, before);
+        }
+    }
+}
+
+@end
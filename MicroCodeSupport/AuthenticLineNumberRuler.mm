@@ -1,11 +1,37 @@
 #import "AuthenticLineNumberRuler.h"
+#import <CoreText/CoreText.h>
+#include "Core/MicroGutter.h"
+#include "Core/MicroGutterAnnotations.h"
+#include "Core/MicroLineIndex.h"
+
+#include <vector>
+
+@interface AuthenticLineNumberRuler () {
+    // Line starts of the client's text, patched from its text storage's edits.
+    MicroCore::LineIndex _lineIndex;
+    __weak NSTextStorage *_indexedStorage;
+
+    // Markers by line, renumbered along with the line index.
+    MicroGutter::AnnotationStore _annotations;
+
+    // Label layout, and the font's digit glyphs it was measured with.
+    MicroGutter::Layout _gutter;
+    CGGlyph _digitGlyphs[10];
+    BOOL _digitsMeasured;
+
+    // Per-draw scratch
+    std::vector<MicroGutter::Row> _rows;
+    std::vector<CGGlyph> _glyphs;
+    std::vector<CGPoint> _positions;
+}
+@end
 
 @implementation AuthenticLineNumberRuler
 
 - (instancetype)initWithScrollView:(nullable NSScrollView *)scrollView orientation:(NSRulerOrientation)orientation {
     self = [super initWithScrollView:scrollView orientation:orientation];
     if (self) {
-        self.ruleThickness = 40.0;
+        self.ruleThickness = _gutter.widthForLineCount(1);
         // Default colors if not set
         self.backgroundColor = [NSColor textBackgroundColor];
         self.textColor = [NSColor secondaryLabelColor];
@@ -48,74 +74,255 @@
     NSRect visibleRect = self.scrollView.contentView.bounds;
     NSRange glyphRange = [layoutManager glyphRangeForBoundingRect:visibleRect inTextContainer:textContainer];
     
-    NSString *string = textView.string;
-    NSUInteger length = string.length;
-    
-    // 4. Calculate starting line number
-    // Count newlines before the visible range start
-    NSUInteger startCharIndex = [layoutManager characterIndexForGlyphAtIndex:glyphRange.location];
-    
-    __block NSInteger lineNumber = 1;
-    if (startCharIndex > 0) {
-        // Linear scan for newlines (simple but effective for now)
-        // In minimal optimized C++ we could do this faster with direct buffer access if needed
-        NSString *precedingText = [string substringToIndex:startCharIndex];
-        
-        NSUInteger count = 0, length = [precedingText length];
-        NSRange range = NSMakeRange(0, length);
-        while(range.location != NSNotFound)
-        {
-            range = [precedingText rangeOfString:@"\n" options:0 range:range];
-            if(range.location != NSNotFound)
-            {
-                range = NSMakeRange(range.location + range.length, length - (range.location + range.length));
-                count++; 
-            }
-        }
-        lineNumber += count;
-    }
-    
-    NSDictionary *attributes = @{
-        NSFontAttributeName: self.font,
-        NSForegroundColorAttributeName: self.textColor
-    };
-    
-    // 5. Enumerate Lines
+    // 4. Line index for the client's text (built once, then patched on edits)
+    [self syncLineIndexWithTextStorage:textView.textStorage];
+
+    // 5. Collect the visible rows, then number and lay them out natively
+    [self measureDigitsIfNeeded];
+    _rows.clear();
     [layoutManager enumerateLineFragmentsForGlyphRange:glyphRange usingBlock:^(NSRect rect, NSRect usedRect, NSTextContainer * _Nonnull textContainer, NSRange glyphRange, BOOL * _Nonnull stop) {
-        
         NSRange charRange = [layoutManager characterRangeForGlyphRange:glyphRange actualGlyphRange:NULL];
-        BOOL isNewLine = YES;
-        
-        if (charRange.location > 0) {
-            if (charRange.location - 1 < length) {
-                unichar prevChar = [string characterAtIndex:charRange.location - 1];
-                if (prevChar != 10) { // '\n'
-                    isNewLine = NO;
-                }
-            }
+        // rect.origin.y is in container coordinates; map it to the ruler's.
+        CGFloat yPos = rect.origin.y + textView.textContainerInset.height;
+        NSPoint pt = [self convertPoint:NSMakePoint(0, yPos) fromView:textView];
+        self->_rows.push_back({(uint32_t)charRange.location, (float)pt.y, (float)rect.size.height});
+    }];
+    _gutter.layout(_lineIndex, _rows.data(), _rows.size(), (float)self.ruleThickness);
+
+    // 6. Markers of the visible lines only, under the numbers
+    [self drawMarkersForLabels:_gutter.labels()];
+
+    // 7. Every digit of every label in one glyph run
+    const std::vector<MicroGutter::Glyph>& digits = _gutter.glyphs();
+    if (digits.empty()) {
+        return;
+    }
+    _glyphs.resize(digits.size());
+    _positions.resize(digits.size());
+    const CGFloat flip = self.isFlipped ? -1.0 : 1.0;
+    for (size_t i = 0; i < digits.size(); i++) {
+        _glyphs[i] = _digitGlyphs[digits[i].digit];
+        // Positions are applied through the text matrix, which flips y back.
+        _positions[i] = CGPointMake(digits[i].x, digits[i].baseline * flip);
+    }
+    CGContextRef context = [NSGraphicsContext currentContext].CGContext;
+    CGContextSaveGState(context);
+    CGContextSetFillColorWithColor(context, self.textColor.CGColor);
+    CGContextSetTextMatrix(context, CGAffineTransformMakeScale(1.0, flip));
+    CTFontDrawGlyphs((__bridge CTFontRef)self.font, _glyphs.data(), _positions.data(), _glyphs.size(), context);
+    CGContextRestoreGState(context);
+}
+
+// MARK: - Markers
+
+static_assert((uint8_t)AuthenticGutterMarkerBookmark == (uint8_t)MicroGutter::Layer::Bookmark,
+              "AuthenticGutterMarker mirrors MicroGutter::Layer");
+
+static MicroGutter::Layer AuthenticLayerForMarker(AuthenticGutterMarker marker) {
+    return static_cast<MicroGutter::Layer>(MIN((uint32_t)marker, MicroGutter::kLayerCount - 1));
+}
+
+- (void)addMarker:(AuthenticGutterMarker)marker atLine:(NSUInteger)line {
+    _annotations.add((uint32_t)MIN(line, (NSUInteger)UINT32_MAX - 1), AuthenticLayerForMarker(marker));
+    [self setNeedsDisplay:YES];
+}
+
+- (void)removeMarker:(AuthenticGutterMarker)marker atLine:(NSUInteger)line {
+    _annotations.remove((uint32_t)MIN(line, (NSUInteger)UINT32_MAX - 1), AuthenticLayerForMarker(marker));
+    [self setNeedsDisplay:YES];
+}
+
+- (void)setMarker:(AuthenticGutterMarker)marker lines:(NSIndexSet *)lines {
+    std::vector<uint32_t> values;
+    values.reserve(lines.count);
+    [lines enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        if (index < UINT32_MAX) values.push_back((uint32_t)index);
+    }];
+    _annotations.setLayer(AuthenticLayerForMarker(marker), std::move(values));
+    [self setNeedsDisplay:YES];
+}
+
+- (NSIndexSet *)linesWithMarker:(AuthenticGutterMarker)marker {
+    NSMutableIndexSet *lines = [NSMutableIndexSet indexSet];
+    for (uint32_t line : _annotations.linesWith(AuthenticLayerForMarker(marker))) {
+        [lines addIndex:line];
+    }
+    return lines;
+}
+
+- (void)drawMarkersForLabels:(const std::vector<MicroGutter::Label>&)labels {
+    if (labels.empty() || _annotations.size() == 0) {
+        return;
+    }
+    auto visible = _annotations.range(labels.front().line, labels.back().line + 1);
+    const MicroGutter::Annotation *annotation = visible.first;
+    const CGFloat width = self.ruleThickness;
+
+    for (const MicroGutter::Label& label : labels) {
+        if (label.continuation) continue;
+        while (annotation != visible.second && annotation->line < label.line) annotation++;
+        if (annotation == visible.second) break;
+        if (annotation->line != label.line) continue;
+
+        const uint32_t layers = annotation->layers;
+        const NSRect row = NSMakeRect(0, label.top, width, label.height);
+        auto has = [layers](MicroGutter::Layer layer) { return (layers & MicroGutter::layerBit(layer)) != 0; };
+
+        if (has(MicroGutter::Layer::Breakpoint)) {
+            [[[NSColor systemBlueColor] colorWithAlphaComponent:0.35] setFill];
+            [[NSBezierPath bezierPathWithRoundedRect:NSInsetRect(NSMakeRect(2, NSMinY(row), width - 6, NSHeight(row)), 0, 1)
+                                             xRadius:3 yRadius:3] fill];
         }
-        
-        if (isNewLine) {
-            NSString *numStr = [NSString stringWithFormat:@"%ld", (long)lineNumber];
-            NSSize size = [numStr sizeWithAttributes:attributes];
-            
-            // Calculate Y
-            // rect.origin.y is in container coordinates
-            CGFloat yPos = rect.origin.y + textView.textContainerInset.height;
-            
-            // Map to ruler view coordinates
-            NSPoint pt = [self convertPoint:NSMakePoint(0, yPos) fromView:textView];
-            
-            // Center vertically
-            CGFloat centeredY = pt.y + (rect.size.height - size.height) / 2.0;
-            
-            NSPoint drawPoint = NSMakePoint(self.ruleThickness - size.width - 8, centeredY);
-            
-            [numStr drawAtPoint:drawPoint withAttributes:attributes];
-            
-            lineNumber++;
+
+        // Diagnostics (most severe first), else a bookmark: a dot in the leading padding
+        NSColor *dot = has(MicroGutter::Layer::Error) ? [NSColor systemRedColor]
+            : has(MicroGutter::Layer::Warning) ? [NSColor systemYellowColor]
+            : has(MicroGutter::Layer::Info) ? [NSColor systemBlueColor]
+            : has(MicroGutter::Layer::Bookmark) ? [NSColor systemOrangeColor] : nil;
+        if (dot) {
+            [dot setFill];
+            [[NSBezierPath bezierPathWithOvalInRect:NSMakeRect(3, NSMidY(row) - 3, 6, 6)] fill];
         }
-    }];
+
+        // Git changes: a bar along the separator; deletions a wedge at the row's top
+        NSColor *git = has(MicroGutter::Layer::GitAdded) ? [NSColor systemGreenColor]
+            : has(MicroGutter::Layer::GitModified) ? [NSColor systemBlueColor] : nil;
+        if (git) {
+            [git setFill];
+            NSRectFill(NSMakeRect(width - 4, NSMinY(row), 2, NSHeight(row)));
+        }
+        if (has(MicroGutter::Layer::GitDeleted)) {
+            [[NSColor systemRedColor] setFill];
+            NSBezierPath *wedge = [NSBezierPath bezierPath];
+            const CGFloat top = self.isFlipped ? NSMinY(row) : NSMaxY(row);
+            const CGFloat tip = self.isFlipped ? 3 : -3;
+            [wedge moveToPoint:NSMakePoint(width - 6, top - tip)];
+            [wedge lineToPoint:NSMakePoint(width - 1, top)];
+            [wedge lineToPoint:NSMakePoint(width - 6, top + tip)];
+            [wedge closePath];
+            [wedge fill];
+        }
+    }
+}
+
+// MARK: - Digit Metrics
+
+- (void)setFont:(NSFont *)font {
+    _font = font;
+    _digitsMeasured = NO;
+    [self setNeedsDisplay:YES];
+}
+
+- (void)measureDigitsIfNeeded {
+    if (_digitsMeasured || !self.font) {
+        return;
+    }
+    CTFontRef font = (__bridge CTFontRef)self.font;
+    UniChar characters[10];
+    for (int i = 0; i < 10; i++) {
+        characters[i] = (UniChar)('0' + i);
+    }
+    CTFontGetGlyphsForCharacters(font, characters, _digitGlyphs, 10);
+    CGSize advances[10];
+    CTFontGetAdvancesForGlyphs(font, kCTFontOrientationHorizontal, _digitGlyphs, advances, 10);
+
+    MicroGutter::DigitMetrics metrics = {};
+    for (int i = 0; i < 10; i++) {
+        metrics.advances[i] = (float)advances[i].width;
+    }
+    metrics.ascent = (float)CTFontGetAscent(font);
+    metrics.descent = (float)CTFontGetDescent(font);
+    _gutter.setMetrics(metrics);
+    _digitsMeasured = YES;
+    [self updateRuleThicknessDeferred:YES];
+}
+
+/// Resizes the gutter to the document's digit count. Resizing re-tiles the
+/// scroll view, so from inside drawing it waits for the next run loop pass.
+- (void)updateRuleThicknessDeferred:(BOOL)deferred {
+    CGFloat thickness = _gutter.widthForLineCount(_lineIndex.lineCount());
+    if (thickness == self.ruleThickness) {
+        return;
+    }
+    if (!deferred) {
+        self.ruleThickness = thickness;
+        return;
+    }
+    __weak AuthenticLineNumberRuler *weakSelf = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [weakSelf updateRuleThicknessDeferred:NO];
+    });
+}
+
+// MARK: - Line Index
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)syncLineIndexWithTextStorage:(NSTextStorage *)textStorage {
+    if (textStorage == _indexedStorage && _lineIndex.length() == textStorage.length) {
+        return;
+    }
+    // Any storage: the weak reference may already be nil for the one observed.
+    NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+    [center removeObserver:self name:NSTextStorageDidProcessEditingNotification object:nil];
+    _indexedStorage = textStorage;
+    [center addObserver:self
+               selector:@selector(textStorageDidProcessEditing:)
+                   name:NSTextStorageDidProcessEditingNotification
+                 object:textStorage];
+
+    // Full scan, in chunks so a large document is never copied whole.
+    _lineIndex.clear();
+    NSString *string = textStorage.string;
+    const NSUInteger length = string.length;
+    std::vector<unichar> buffer(MIN(length, (NSUInteger)65536));
+    for (NSUInteger location = 0; location < length; location += buffer.size()) {
+        NSRange range = NSMakeRange(location, MIN((NSUInteger)buffer.size(), length - location));
+        [string getCharacters:buffer.data() range:range];
+        _lineIndex.append(reinterpret_cast<const char16_t *>(buffer.data()), range.length);
+    }
+    [self updateRuleThicknessDeferred:YES];
+}
+
+- (void)textStorageDidProcessEditing:(NSNotification *)notification {
+    NSTextStorage *textStorage = notification.object;
+    if (textStorage != _indexedStorage || !(textStorage.editedMask & NSTextStorageEditedCharacters)) {
+        return;
+    }
+    NSRange edited = textStorage.editedRange;
+    NSInteger delta = textStorage.changeInLength;
+    if (edited.location == NSNotFound || (NSInteger)edited.length < delta ||
+        (NSInteger)_lineIndex.length() + delta != (NSInteger)textStorage.length) {
+        // Out of step: rescan on the next draw.
+        [[NSNotificationCenter defaultCenter] removeObserver:self
+                                                        name:NSTextStorageDidProcessEditingNotification
+                                                      object:textStorage];
+        _indexedStorage = nil;
+        return;
+    }
+    std::vector<unichar> inserted(edited.length);
+    [textStorage.string getCharacters:inserted.data() range:edited];
+    const char16_t *units = reinterpret_cast<const char16_t *>(inserted.data());
+    const size_t removedLength = (size_t)((NSInteger)edited.length - delta);
+
+    // Markers follow their lines: lines joined by the edit lose theirs, lines after it move.
+    const size_t firstLine = _lineIndex.lineForOffset(edited.location);
+    const size_t removedLines = _lineIndex.lineForOffset(edited.location + removedLength) - firstLine;
+    const size_t insertedLines = MicroCore::LineIndex::countNewlines(units, inserted.size());
+    if (removedLines > 0) {
+        _annotations.removeLines((uint32_t)firstLine + 1, (uint32_t)removedLines);
+    }
+    if (insertedLines > 0) {
+        // Whole lines typed or pasted at the start of a line push that line down.
+        BOOL pushesLine = removedLines == 0 && edited.location == _lineIndex.lineStart(firstLine) &&
+                          !inserted.empty() && inserted.back() == '\n';
+        _annotations.insertLines((uint32_t)firstLine + (pushesLine ? 0 : 1), (uint32_t)insertedLines);
+    }
+
+    _lineIndex.applyEdit(edited.location, removedLength, units, inserted.size());
+    [self updateRuleThicknessDeferred:YES];
 }
 
 @end
@@ -0,0 +1,141 @@
+//
+//  AuthenticQuickOpen.mm
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#import "AuthenticQuickOpen.h"
+#include "Core/MicroIgnore.h"
+#include "Core/MicroPathFinder.h"
+#include "Core/MicroTreeSnapshot.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+@implementation AuthenticQuickOpenResult
+@end
+
+/// UTF-16 offsets of the UTF-8 byte `positions` (ascending) in `text`.
+static NSIndexSet *AuthenticUTF16Indexes(std::string_view text, const std::vector<uint32_t>& positions) {
+    NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+    size_t next = 0;
+    NSUInteger utf16 = 0;
+    for (size_t byte = 0; byte < text.size() && next < positions.size(); byte++) {
+        unsigned char c = (unsigned char)text[byte];
+        if ((c & 0xC0) == 0x80) continue; // Continuation byte
+        while (next < positions.size() && positions[next] < byte) next++;
+        if (next < positions.size() && positions[next] == byte) [indexes addIndex:utf16];
+        utf16 += c >= 0xF0 ? 2 : 1;
+    }
+    return indexes;
+}
+
+/// Every file of the snapshot at `snapshotPath`, if it is one of `root`.
+static std::shared_ptr<MicroFiles::PathFinder> AuthenticFinderFromSnapshot(const std::string& snapshotPath,
+                                                                           const std::string& root) {
+    MicroFiles::TreeSnapshot snapshot(snapshotPath);
+    if (!snapshot.open() || snapshot.root() != root) return nullptr;
+
+    // Breadth first: a directory's relative path is known before its children.
+    auto finder = std::make_shared<MicroFiles::PathFinder>();
+    const size_t count = snapshot.nodeCount();
+    std::vector<std::string> directories(count);
+    MicroFiles::TreeNode node;
+    for (uint32_t i = 1; i < count; i++) {
+        if (!snapshot.node(i, node) || node.parent >= i) continue;
+        std::string path = directories[node.parent];
+        if (!path.empty()) path.push_back('/');
+        path.append(node.name);
+        if (node.type == MicroFiles::EntryType::Directory) directories[i] = std::move(path);
+        else if (!node.linksToDirectory) finder->add(path);
+    }
+    return finder;
+}
+
+@interface AuthenticQuickOpen () {
+    std::shared_ptr<MicroFiles::PathFinder> _finder;
+    NSUInteger _generation;
+}
+@end
+
+@implementation AuthenticQuickOpen
+
+- (instancetype)initWithRootPath:(NSString *)rootPath {
+    if (self = [super init]) {
+        _rootPath = [[rootPath stringByStandardizingPath] copy];
+        _finder = std::make_shared<MicroFiles::PathFinder>();
+    }
+    return self;
+}
+
+- (NSUInteger)fileCount {
+    return _finder->size();
+}
+
+- (void)indexWorkspaceWithCompletion:(void (^)(NSUInteger))completion {
+    [self indexWorkspaceWithSnapshotAtPath:nil completion:completion];
+}
+
+- (void)indexWorkspaceWithSnapshotAtPath:(NSString *)snapshotPath completion:(void (^)(NSUInteger))completion {
+    const char *cRoot = [_rootPath fileSystemRepresentation];
+    if (!cRoot) {
+        if (completion) completion(0);
+        return;
+    }
+    std::string root(cRoot);
+    const char *cSnapshot = snapshotPath.length ? [snapshotPath fileSystemRepresentation] : NULL;
+    std::string snapshotFile(cSnapshot ? cSnapshot : "");
+    NSUInteger generation = ++_generation;
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        // Searchable within milliseconds; the crawl below replaces it.
+        if (!snapshotFile.empty()) {
+            std::shared_ptr<MicroFiles::PathFinder> seeded = AuthenticFinderFromSnapshot(snapshotFile, root);
+            if (seeded) {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    if (generation == self->_generation) self->_finder = seeded;
+                });
+            }
+        }
+
+        auto finder = std::make_shared<MicroFiles::PathFinder>();
+        MicroFiles::IgnoreMatcher ignore(root);
+        MicroFiles::ScanOptions options;
+        options.batchSize = 4096;
+        options.exclude = ignore.scanFilter();
+        NSUInteger count = finder->scan(root, options);
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (generation != self->_generation) return; // Superseded
+            self->_finder = finder;
+            if (completion) completion(count);
+        });
+    });
+}
+
+- (NSArray<AuthenticQuickOpenResult *> *)search:(NSString *)query limit:(NSUInteger)limit {
+    const char *utf8 = [query UTF8String];
+    std::vector<MicroFiles::PathMatch> matches = _finder->search(utf8 ? utf8 : "", limit);
+
+    NSMutableArray<AuthenticQuickOpenResult *> *results = [NSMutableArray arrayWithCapacity:matches.size()];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    for (const MicroFiles::PathMatch& match : matches) {
+        std::string_view relative = _finder->path(match.index);
+        NSString *relativePath = [fileManager stringWithFileSystemRepresentation:relative.data() length:relative.size()];
+        if (!relativePath) continue;
+
+        AuthenticQuickOpenResult *result = [[AuthenticQuickOpenResult alloc] init];
+        result.relativePath = relativePath;
+        result.path = [_rootPath stringByAppendingPathComponent:relativePath];
+        result.name = [relativePath lastPathComponent];
+        result.score = match.score;
+        result.matchedIndexes = AuthenticUTF16Indexes(relative, _finder->matchPositions(match.index, utf8 ? utf8 : ""));
+        [results addObject:result];
+    }
+    return results;
+}
+
+@end
@@ -0,0 +1,117 @@
+//
+//  AuthenticSymbolIndex.mm
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#import "AuthenticSymbolIndex.h"
+#include "Core/MicroLexer.h"
+#include "Core/MicroSymbolIndex.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+@implementation AuthenticWorkspaceSymbol
+@end
+
+static NSString *AuthenticSymbolKindName(MicroIndex::SymbolKind kind) {
+    switch (kind) {
+        case MicroIndex::SymbolKind::Function: return @"function";
+        case MicroIndex::SymbolKind::Class: return @"class";
+        case MicroIndex::SymbolKind::Variable: return @"variable";
+    }
+    return @"unknown";
+}
+
+@interface AuthenticSymbolIndex () {
+    std::unique_ptr<MicroIndex::SymbolIndex> _index;
+}
+@end
+
+@implementation AuthenticSymbolIndex
+
+- (instancetype)initWithIndexPath:(NSString *)indexPath {
+    self = [super init];
+    if (self) {
+        _index.reset(new MicroIndex::SymbolIndex([indexPath fileSystemRepresentation]));
+    }
+    return self;
+}
+
+- (BOOL)open {
+    return _index->open();
+}
+
+- (void)indexWorkspace:(NSString *)rootPath completion:(void (^)(NSUInteger))completion {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        std::vector<std::string> paths;
+        NSURL *rootURL = [NSURL fileURLWithPath:rootPath isDirectory:YES];
+        NSDirectoryEnumerator<NSURL *> *enumerator =
+            [[NSFileManager defaultManager] enumeratorAtURL:rootURL
+                                 includingPropertiesForKeys:@[NSURLIsRegularFileKey]
+                                                    options:NSDirectoryEnumerationSkipsHiddenFiles | NSDirectoryEnumerationSkipsPackageDescendants
+                                               errorHandler:nil];
+        for (NSURL *url in enumerator) {
+            const char *cPath = url.fileSystemRepresentation;
+            if (!cPath) continue;
+            if (MicroLexer::LanguageSpec::languageForPath(cPath).empty()) continue;
+            paths.emplace_back(cPath);
+        }
+
+        NSUInteger parsed = self->_index->indexFiles(paths);
+        if (!self->_index->save()) {
+            NSLog(@"[AuthenticSymbolIndex] Failed to persist symbol index");
+        }
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(parsed);
+            });
+        }
+    });
+}
+
+- (void)fileDidChange:(NSString *)path {
+    _index->updateFile([path fileSystemRepresentation]);
+}
+
+- (void)fileWasRemoved:(NSString *)path {
+    _index->removeFile([path fileSystemRepresentation]);
+}
+
+- (BOOL)save {
+    return _index->save();
+}
+
+- (NSUInteger)symbolCount {
+    return _index->symbolCount();
+}
+
+- (NSArray<AuthenticWorkspaceSymbol *> *)symbolsFromHits:(const std::vector<MicroIndex::SymbolHit>&)hits {
+    NSMutableArray<AuthenticWorkspaceSymbol *> *results = [NSMutableArray arrayWithCapacity:hits.size()];
+    for (const auto& hit : hits) {
+        AuthenticWorkspaceSymbol *symbol = [[AuthenticWorkspaceSymbol alloc] init];
+        symbol.name = [NSString stringWithUTF8String:hit.name.c_str()] ?: @"";
+        symbol.path = [NSString stringWithUTF8String:hit.file.c_str()] ?: @"";
+        symbol.kind = AuthenticSymbolKindName(hit.kind);
+        symbol.line = hit.line;
+        symbol.byteRange = NSMakeRange(hit.start, hit.end - hit.start);
+        symbol.score = hit.score;
+        [results addObject:symbol];
+    }
+    return results;
+}
+
+- (NSArray<AuthenticWorkspaceSymbol *> *)searchSymbols:(NSString *)query limit:(NSUInteger)limit {
+    const char *utf8 = [query UTF8String];
+    return [self symbolsFromHits:_index->search(utf8 ? utf8 : "", limit)];
+}
+
+- (NSArray<AuthenticWorkspaceSymbol *> *)fuzzySearchSymbols:(NSString *)query limit:(NSUInteger)limit {
+    const char *utf8 = [query UTF8String];
+    return [self symbolsFromHits:_index->fuzzySearch(utf8 ? utf8 : "", limit)];
+}
+
+@end
@@ -0,0 +1,25 @@
+//
+//  AuthenticSyntaxEngine+Native.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+//  Private ObjC++ bridge between the C++ core (Core/) and the public Objective-C API.
+//
+
+#pragma once
+
+#import "AuthenticSyntaxEngine.h"
+#include "Core/MicroLexer.h"
+
+#include <string_view>
+#include <vector>
+
+/// Wraps native byte-offset tokens as AuthenticTokens, clamped to the NSString length.
+NSArray<AuthenticToken *> *AuthenticTokensFromNative(const std::vector<MicroLexer::Token>& cppTokens, NSUInteger sourceLength);
+
+/// NSString copy of a UTF-8 view (e.g. a parser name pointing into the source snapshot).
+static inline NSString *AuthenticStringFromView(std::string_view view) {
+    return [[NSString alloc] initWithBytes:view.data() length:view.size() encoding:NSUTF8StringEncoding] ?: @"";
+}
@@ -0,0 +1,106 @@
+//
+//  MicroArena.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace MicroCore {
+
+    /// Monotonic bump allocator. Everything allocated since the last reset() is
+    /// released at once; nothing is destroyed individually, so only trivially
+    /// destructible types may live here.
+    ///
+    /// reset() keeps a single block large enough for the previous round, so a
+    /// workload that repeats (e.g. reparsing the same document) stops calling
+    /// malloc after the first pass.
+    class Arena {
+    public:
+        explicit Arena(size_t blockSize = 64 * 1024) : _blockSize(blockSize) {}
+        ~Arena() { release(); }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+            uintptr_t aligned = (_cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            if (_cursor == 0 || aligned + bytes > _limit) {
+                grow(bytes + alignment);
+                aligned = (_cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            }
+            _cursor = aligned + bytes;
+            _used += bytes;
+            return reinterpret_cast<void *>(aligned);
+        }
+
+        template <class T, class... Args>
+        T *make(Args&&... args) {
+            static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        void reset() {
+            size_t needed = 0;
+            for (const auto& block : _blocks) needed += block.size;
+            if (_blocks.size() > 1) {
+                release();
+                grow(needed);
+            }
+            if (!_blocks.empty()) {
+                _cursor = reinterpret_cast<uintptr_t>(_blocks.front().data);
+                _limit = _cursor + _blocks.front().size;
+            }
+            _used = 0;
+        }
+
+        /// Bytes handed out since the last reset.
+        size_t bytesUsed() const { return _used; }
+
+        /// Bytes held from the system.
+        size_t bytesReserved() const {
+            size_t total = 0;
+            for (const auto& block : _blocks) total += block.size;
+            return total;
+        }
+
+    private:
+        struct Block {
+            void *data;
+            size_t size;
+        };
+
+        void grow(size_t minimum) {
+            size_t size = _blockSize;
+            while (size < minimum) size *= 2;
+            void *data = std::malloc(size);
+            if (!data) throw std::bad_alloc();
+            _blocks.push_back({data, size});
+            _cursor = reinterpret_cast<uintptr_t>(data);
+            _limit = _cursor + size;
+        }
+
+        void release() {
+            for (const auto& block : _blocks) std::free(block.data);
+            _blocks.clear();
+            _cursor = 0;
+            _limit = 0;
+        }
+
+        size_t _blockSize;
+        std::vector<Block> _blocks;
+        uintptr_t _cursor = 0;
+        uintptr_t _limit = 0;
+        size_t _used = 0;
+    };
+}
@@ -0,0 +1,792 @@
+//
+//  MicroCallGraph.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroCallGraph.h"
+#include "MicroLexer.h"
+#include "MicroParser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+
+namespace MicroIndex {
+
+    using MicroLexer::Token;
+    using MicroLexer::TokenType;
+
+    namespace {
+
+        constexpr char kMagic[8] = {'M', 'C', 'C', 'A', 'L', 'L', 'G', 'R'};
+        constexpr uint32_t kVersion = 1;
+        constexpr uint32_t kNoDefinition = UINT32_MAX; // Site in top-level code
+
+        // Generated or minified files beyond this size are not worth indexing.
+        constexpr size_t kMaxIndexedFileBytes = 4 * 1024 * 1024;
+
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t fileCount;
+            uint32_t nodeCount;
+            uint32_t definitionCount;
+            uint32_t siteCount;
+            uint32_t edgeCount;
+            uint32_t reserved[2];
+            uint64_t stringPoolSize;
+        };
+
+        struct FileRecord {
+            uint32_t pathOffset;
+            uint32_t pathLength;
+            int64_t mtime;
+            uint64_t size;
+        };
+
+        // One distinct function name, defined in the workspace or only called.
+        struct NodeRecord {
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            uint32_t firstDefinition;
+            uint32_t definitionCount;
+        };
+
+        struct DefinitionRecord {
+            uint32_t node;
+            uint32_t file;
+            uint32_t start;
+            uint32_t end;
+            uint32_t line;
+        };
+
+        struct SiteRecord {
+            uint32_t caller; // Definition index, or kNoDefinition
+            uint32_t file;
+            uint32_t offset;
+            uint32_t line;
+        };
+
+        static_assert(sizeof(Header) == 48 && sizeof(FileRecord) == 24 && sizeof(NodeRecord) == 16 &&
+                      sizeof(DefinitionRecord) == 20 && sizeof(SiteRecord) == 16,
+                      "On-disk records must keep their size");
+
+        struct Table {
+            const Header *header = nullptr;
+            const FileRecord *files = nullptr;
+            const NodeRecord *nodes = nullptr;
+            const DefinitionRecord *definitions = nullptr;
+            const uint32_t *siteOffsets = nullptr;   // nodeCount + 1
+            const SiteRecord *sites = nullptr;
+            const uint32_t *calleeOffsets = nullptr; // definitionCount + 1
+            const uint32_t *callees = nullptr;
+            const char *pool = nullptr;
+            uint64_t poolSize = 0;
+
+            std::string_view string(uint32_t offset, uint32_t length) const {
+                if ((uint64_t)offset + length > poolSize) return {};
+                return std::string_view(pool + offset, length);
+            }
+
+            std::string_view name(uint32_t node) const {
+                return string(nodes[node].nameOffset, nodes[node].nameLength);
+            }
+
+            std::string_view path(uint32_t file) const {
+                return string(files[file].pathOffset, files[file].pathLength);
+            }
+
+            /// Node named `name`, or UINT32_MAX.
+            uint32_t find(std::string_view name) const {
+                if (!header) return UINT32_MAX;
+                uint32_t low = 0, high = header->nodeCount;
+                while (low < high) {
+                    uint32_t mid = low + (high - low) / 2;
+                    if (this->name(mid) < name) low = mid + 1;
+                    else high = mid;
+                }
+                return low < header->nodeCount && this->name(low) == name ? low : UINT32_MAX;
+            }
+        };
+
+        uint64_t tableSize(const Header& header) {
+            return sizeof(Header)
+                + (uint64_t)header.fileCount * sizeof(FileRecord)
+                + (uint64_t)header.nodeCount * sizeof(NodeRecord)
+                + (uint64_t)header.definitionCount * sizeof(DefinitionRecord)
+                + ((uint64_t)header.nodeCount + 1) * sizeof(uint32_t)
+                + (uint64_t)header.siteCount * sizeof(SiteRecord)
+                + ((uint64_t)header.definitionCount + 1) * sizeof(uint32_t)
+                + (uint64_t)header.edgeCount * sizeof(uint32_t)
+                + header.stringPoolSize;
+        }
+
+        Table tableFor(const MicroCore::MappedFile& mapping) {
+            Table table;
+            if (!mapping.isOpen()) return table;
+            const uint8_t *base = mapping.data();
+            table.header = reinterpret_cast<const Header *>(base);
+            table.files = reinterpret_cast<const FileRecord *>(base + sizeof(Header));
+            table.nodes = reinterpret_cast<const NodeRecord *>(table.files + table.header->fileCount);
+            table.definitions = reinterpret_cast<const DefinitionRecord *>(table.nodes + table.header->nodeCount);
+            table.siteOffsets = reinterpret_cast<const uint32_t *>(table.definitions + table.header->definitionCount);
+            table.sites = reinterpret_cast<const SiteRecord *>(table.siteOffsets + table.header->nodeCount + 1);
+            table.calleeOffsets = reinterpret_cast<const uint32_t *>(table.sites + table.header->siteCount);
+            table.callees = table.calleeOffsets + table.header->definitionCount + 1;
+            table.pool = reinterpret_cast<const char *>(table.callees + table.header->edgeCount);
+            table.poolSize = table.header->stringPoolSize;
+            return table;
+        }
+
+        // CSR row offsets must start at 0, never decrease and end at `total`.
+        bool validOffsets(const uint32_t *offsets, uint32_t rows, uint32_t total) {
+            if (offsets[0] != 0 || offsets[rows] != total) return false;
+            for (uint32_t i = 0; i < rows; i++) {
+                if (offsets[i] > offsets[i + 1]) return false;
+            }
+            return true;
+        }
+
+        bool readFile(const std::string& path, size_t size, std::string& out) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return false;
+            out.resize(size);
+            size_t total = 0;
+            while (total < size) {
+                ssize_t n = ::read(fd, &out[total], size - total);
+                if (n <= 0) break;
+                total += (size_t)n;
+            }
+            ::close(fd);
+            out.resize(total);
+            return true;
+        }
+
+        // Words that make the following `name(` a declaration rather than a call,
+        // for languages whose functions the parser does not scope (Python, Ruby).
+        bool declaresName(std::string_view word) {
+            return word == "def" || word == "fn" || word == "func" || word == "fun" || word == "function" ||
+                   word == "class" || word == "struct";
+        }
+    }
+
+    CallGraph::CallGraph(std::string indexPath) : _indexPath(std::move(indexPath)) {}
+
+    bool CallGraph::open() {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        _overlay.clear();
+        _overlayCalls.clear();
+        _overlayDefinitions.clear();
+        _basePaths.clear();
+        _shadowed.clear();
+        _baseLookupBuilt = false;
+
+        if (!_mapping.open(_indexPath)) return false;
+        if (!validateMapping()) {
+            _mapping.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool CallGraph::validateMapping() const {
+        if (_mapping.size() < sizeof(Header)) return false;
+        const Header *header = reinterpret_cast<const Header *>(_mapping.data());
+        if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion) return false;
+        if (tableSize(*header) != _mapping.size()) return false;
+
+        // Queries index straight into the arrays, so check every reference once here.
+        Table table = tableFor(_mapping);
+        for (uint32_t f = 0; f < header->fileCount; f++) {
+            if ((uint64_t)table.files[f].pathOffset + table.files[f].pathLength > table.poolSize) return false;
+        }
+        for (uint32_t n = 0; n < header->nodeCount; n++) {
+            const NodeRecord& node = table.nodes[n];
+            if ((uint64_t)node.nameOffset + node.nameLength > table.poolSize) return false;
+            if ((uint64_t)node.firstDefinition + node.definitionCount > header->definitionCount) return false;
+        }
+        for (uint32_t d = 0; d < header->definitionCount; d++) {
+            if (table.definitions[d].node >= header->nodeCount || table.definitions[d].file >= header->fileCount) return false;
+        }
+        for (uint32_t s = 0; s < header->siteCount; s++) {
+            const SiteRecord& site = table.sites[s];
+            if (site.file >= header->fileCount) return false;
+            if (site.caller != kNoDefinition && site.caller >= header->definitionCount) return false;
+        }
+        for (uint32_t e = 0; e < header->edgeCount; e++) {
+            if (table.callees[e] >= header->nodeCount) return false;
+        }
+        return validOffsets(table.siteOffsets, header->nodeCount, header->siteCount) &&
+               validOffsets(table.calleeOffsets, header->definitionCount, header->edgeCount);
+    }
+
+    void CallGraph::buildBaseLookup() {
+        if (_baseLookupBuilt) return;
+        _baseLookupBuilt = true;
+        Table table = tableFor(_mapping);
+        if (!table.header) return;
+        _basePaths.reserve(table.header->fileCount);
+        _shadowed.assign(table.header->fileCount, false);
+        for (uint32_t i = 0; i < table.header->fileCount; i++) {
+            _basePaths.emplace(table.path(i), i);
+        }
+    }
+
+    bool CallGraph::baseStamp(const std::string& path, FileStamp& stamp) const {
+        auto it = _basePaths.find(path);
+        if (it == _basePaths.end()) return false;
+        const FileRecord& record = tableFor(_mapping).files[it->second];
+        stamp = {record.mtime, record.size};
+        return true;
+    }
+
+    bool CallGraph::statFile(const std::string& path, FileStamp& stamp) {
+        struct stat sb;
+        if (stat(path.c_str(), &sb) != 0 || !S_ISREG(sb.st_mode)) return false;
+#ifdef __APPLE__
+        int64_t nanos = sb.st_mtimespec.tv_nsec;
+#else
+        int64_t nanos = sb.st_mtim.tv_nsec;
+#endif
+        stamp.mtime = (int64_t)sb.st_mtime * 1000000000LL + nanos;
+        stamp.size = (uint64_t)sb.st_size;
+        return true;
+    }
+
+    CallGraph::FileCalls CallGraph::parseFile(const std::string& path, const FileStamp& stamp) {
+        FileCalls result;
+        result.path = path;
+        result.mtime = stamp.mtime;
+        result.size = stamp.size;
+
+        std::string language = MicroLexer::LanguageSpec::languageForPath(path);
+        if (language.empty() || stamp.size > kMaxIndexedFileBytes) return result;
+
+        std::string source;
+        if (!readFile(path, (size_t)stamp.size, source)) return result;
+
+        MicroLexer::Engine lexer(language);
+        std::vector<Token> tokens = lexer.tokenize(source);
+        MicroParser::Engine parser;
+        parser.parse(tokens, source, language);
+
+        std::vector<uint32_t> lineStarts;
+        lineStarts.push_back(0);
+        for (size_t i = 0; i < source.size(); i++) {
+            if (source[i] == '\n') lineStarts.push_back((uint32_t)(i + 1));
+        }
+        auto lineOf = [&lineStarts](int64_t offset) -> uint32_t {
+            auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), (uint32_t)offset);
+            return (uint32_t)(it - lineStarts.begin() - 1);
+        };
+        auto isOpenParen = [&source](const Token& t) {
+            return t.type == TokenType::Punctuation && t.length == 1 && source[t.start] == '(';
+        };
+
+        // Function bodies become definitions; the name of every function scope,
+        // prototypes included, is a declaration and not a call.
+        std::vector<int32_t> scopeDefinition(parser.scopes.size(), kTopLevel);
+        std::vector<uint32_t> declaredNames;
+        for (size_t i = 1; i < parser.scopes.size(); i++) {
+            const MicroParser::Scope& scope = parser.scopes[i];
+            if (scope.kind != MicroParser::ScopeKind::Function) continue;
+            declaredNames.push_back((uint32_t)(scope.name.data() - source.data()));
+            if (scope.isEmpty()) continue;
+            scopeDefinition[i] = (int32_t)result.definitions.size();
+            result.definitions.push_back({std::string(scope.name), (uint32_t)scope.startLine,
+                                          (uint32_t)std::min<int64_t>(scope.endLine, (int64_t)source.size()),
+                                          lineOf(scope.startLine)});
+        }
+        std::sort(declaredNames.begin(), declaredNames.end());
+
+        for (size_t i = 0; i < tokens.size(); i++) {
+            const Token& t = tokens[i];
+            // The lexer tags lowercase `name(` as a function; capitalized names are
+            // types, so `Foo(` is a constructor call or an exported Go function.
+            bool isCall = t.type == TokenType::Function ||
+                          (t.type == TokenType::Type && i + 1 < tokens.size() && isOpenParen(tokens[i + 1]));
+            if (!isCall || std::binary_search(declaredNames.begin(), declaredNames.end(), t.start)) continue;
+            if (i > 0 && declaresName(std::string_view(source).substr(tokens[i - 1].start, tokens[i - 1].length))) continue;
+
+            size_t scope = parser.scopeAt(t.start);
+            while (scope != 0 && scopeDefinition[scope] == kTopLevel) {
+                scope = (size_t)parser.scopes[scope].parent;
+            }
+            result.calls.push_back({source.substr(t.start, t.length), scopeDefinition[scope], t.start, lineOf(t.start)});
+        }
+        return result;
+    }
+
+    // MARK: - Overlay
+
+    void CallGraph::unlinkOverlayLocked(const FileCalls& file) {
+        auto unlink = [&file](std::unordered_map<std::string, std::vector<OverlayRef>>& map, const std::string& name) {
+            auto it = map.find(name);
+            if (it == map.end()) return;
+            auto& refs = it->second;
+            refs.erase(std::remove_if(refs.begin(), refs.end(), [&file](const OverlayRef& ref) { return ref.file == &file; }),
+                       refs.end());
+            if (refs.empty()) map.erase(it);
+        };
+        for (const auto& definition : file.definitions) {
+            unlink(_overlayDefinitions, definition.name);
+        }
+        // Each name once: a file may call the same function many times.
+        std::vector<std::string_view> callees;
+        callees.reserve(file.calls.size());
+        for (const auto& call : file.calls) callees.push_back(call.callee);
+        std::sort(callees.begin(), callees.end());
+        callees.erase(std::unique(callees.begin(), callees.end()), callees.end());
+        for (std::string_view callee : callees) {
+            unlink(_overlayCalls, std::string(callee));
+        }
+    }
+
+    void CallGraph::linkOverlayLocked(const FileCalls& file) {
+        for (uint32_t i = 0; i < file.definitions.size(); i++) {
+            _overlayDefinitions[file.definitions[i].name].push_back({&file, i});
+        }
+        for (uint32_t i = 0; i < file.calls.size(); i++) {
+            _overlayCalls[file.calls[i].callee].push_back({&file, i});
+        }
+    }
+
+    void CallGraph::applyLocked(FileCalls&& file) {
+        buildBaseLookup();
+        auto base = _basePaths.find(file.path);
+        if (base != _basePaths.end()) {
+            _shadowed[base->second] = true;
+        }
+        auto it = _overlay.find(file.path);
+        if (it != _overlay.end()) {
+            unlinkOverlayLocked(it->second);
+            if (base == _basePaths.end() && file.removed) {
+                _overlay.erase(it);
+                return;
+            }
+        } else if (base == _basePaths.end() && file.removed) {
+            return;
+        }
+        FileCalls& slot = it != _overlay.end() ? it->second : _overlay[file.path];
+        slot = std::move(file);
+        linkOverlayLocked(slot);
+    }
+
+    size_t CallGraph::indexFiles(const std::vector<std::string>& paths, MicroCore::ThreadPool& pool) {
+        {
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            buildBaseLookup();
+        }
+
+        std::vector<FileCalls> parsed(paths.size());
+        std::vector<char> changed(paths.size(), 0);
+        std::vector<char> missing(paths.size(), 0); // Gone since it was listed
+
+        pool.parallelFor(paths.size(), 64, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                FileStamp stamp;
+                if (!statFile(paths[i], stamp)) {
+                    missing[i] = 1;
+                    continue;
+                }
+
+                bool upToDate = false;
+                {
+                    std::shared_lock<std::shared_mutex> lock(_mutex);
+                    auto it = _overlay.find(paths[i]);
+                    FileStamp known;
+                    if (it != _overlay.end()) {
+                        upToDate = !it->second.removed && it->second.mtime == stamp.mtime && it->second.size == stamp.size;
+                    } else if (baseStamp(paths[i], known)) {
+                        upToDate = known.mtime == stamp.mtime && known.size == stamp.size;
+                    }
+                }
+                if (upToDate) continue;
+
+                parsed[i] = parseFile(paths[i], stamp);
+                changed[i] = 1;
+            }
+        });
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        size_t parsedCount = 0;
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!changed[i]) continue;
+            applyLocked(std::move(parsed[i]));
+            parsedCount++;
+        }
+
+        // Files that are indexed but no longer part of the workspace, or were
+        // deleted after being listed.
+        std::unordered_set<std::string_view> listed;
+        listed.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!missing[i]) listed.insert(paths[i]);
+        }
+        std::vector<std::string> stale;
+        for (const auto& entry : _basePaths) {
+            if (!_shadowed[entry.second] && !listed.count(entry.first)) stale.emplace_back(entry.first);
+        }
+        for (const auto& entry : _overlay) {
+            if (!entry.second.removed && !listed.count(entry.first)) stale.push_back(entry.first);
+        }
+        for (auto& path : stale) {
+            FileCalls removed;
+            removed.path = std::move(path);
+            removed.removed = true;
+            applyLocked(std::move(removed));
+        }
+        return parsedCount;
+    }
+
+    void CallGraph::updateFile(const std::string& path) {
+        FileStamp stamp;
+        if (!statFile(path, stamp)) {
+            removeFile(path);
+            return;
+        }
+        FileCalls file = parseFile(path, stamp);
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        applyLocked(std::move(file));
+    }
+
+    void CallGraph::removeFile(const std::string& path) {
+        FileCalls file;
+        file.path = path;
+        file.removed = true;
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        applyLocked(std::move(file));
+    }
+
+    // MARK: - Persistence
+
+    bool CallGraph::save() {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        Table table = tableFor(_mapping);
+
+        struct PendingDefinition {
+            uint32_t name;
+            uint32_t file;
+            uint32_t start;
+            uint32_t end;
+            uint32_t line;
+        };
+        struct PendingSite {
+            uint32_t callee;
+            uint32_t caller; // Index into `definitions`, or kNoDefinition
+            uint32_t file;
+            uint32_t offset;
+            uint32_t line;
+        };
+
+        std::vector<FileRecord> files;
+        std::vector<PendingDefinition> definitions;
+        std::vector<PendingSite> sites;
+        std::vector<std::string_view> names;
+        std::unordered_map<std::string_view, uint32_t> nameIds;
+        std::string pool;
+
+        // Views into the mapping and overlay, both alive until the end of save().
+        auto nameId = [&](std::string_view name) -> uint32_t {
+            auto it = nameIds.find(name);
+            if (it != nameIds.end()) return it->second;
+            nameIds.emplace(name, (uint32_t)names.size());
+            names.push_back(name);
+            return (uint32_t)names.size() - 1;
+        };
+        auto addFile = [&](std::string_view path, int64_t mtime, uint64_t size) {
+            files.push_back({(uint32_t)pool.size(), (uint32_t)path.size(), mtime, size});
+            pool.append(path.data(), path.size());
+            return (uint32_t)files.size() - 1;
+        };
+
+        // 1. Everything still valid, with file and definition indices renumbered.
+        if (table.header) {
+            std::vector<uint32_t> fileIds(table.header->fileCount, UINT32_MAX);
+            for (uint32_t f = 0; f < table.header->fileCount; f++) {
+                if (isShadowed(f)) continue;
+                fileIds[f] = addFile(table.path(f), table.files[f].mtime, table.files[f].size);
+            }
+            std::vector<uint32_t> definitionIds(table.header->definitionCount, kNoDefinition);
+            for (uint32_t n = 0; n < table.header->nodeCount; n++) {
+                const NodeRecord& node = table.nodes[n];
+                for (uint32_t d = node.firstDefinition; d < node.firstDefinition + node.definitionCount; d++) {
+                    const DefinitionRecord& def = table.definitions[d];
+                    if (fileIds[def.file] == UINT32_MAX) continue;
+                    definitionIds[d] = (uint32_t)definitions.size();
+                    definitions.push_back({nameId(table.name(n)), fileIds[def.file], def.start, def.end, def.line});
+                }
+            }
+            for (uint32_t n = 0; n < table.header->nodeCount; n++) {
+                for (uint32_t s = table.siteOffsets[n]; s < table.siteOffsets[n + 1]; s++) {
+                    const SiteRecord& site = table.sites[s];
+                    if (fileIds[site.file] == UINT32_MAX) continue;
+                    uint32_t caller = site.caller == kNoDefinition ? kNoDefinition : definitionIds[site.caller];
+                    sites.push_back({nameId(table.name(n)), caller, fileIds[site.file], site.offset, site.line});
+                }
+            }
+        }
+        for (const auto& entry : _overlay) {
+            const FileCalls& file = entry.second;
+            if (file.removed) continue;
+            uint32_t fileId = addFile(file.path, file.mtime, file.size);
+            uint32_t firstDefinition = (uint32_t)definitions.size();
+            for (const auto& def : file.definitions) {
+                definitions.push_back({nameId(def.name), fileId, def.start, def.end, def.line});
+            }
+            for (const auto& call : file.calls) {
+                uint32_t caller = call.caller == kTopLevel ? kNoDefinition : firstDefinition + (uint32_t)call.caller;
+                sites.push_back({nameId(call.callee), caller, fileId, call.offset, call.line});
+            }
+        }
+
+        // 2. Nodes sorted by name; definitions and sites grouped by node.
+        std::vector<uint32_t> order(names.size());
+        for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+        std::sort(order.begin(), order.end(), [&names](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+        std::vector<uint32_t> rank(names.size());
+        for (uint32_t i = 0; i < order.size(); i++) rank[order[i]] = i;
+
+        std::vector<uint32_t> definitionOrder(definitions.size());
+        for (uint32_t i = 0; i < definitionOrder.size(); i++) definitionOrder[i] = i;
+        std::sort(definitionOrder.begin(), definitionOrder.end(), [&](uint32_t a, uint32_t b) {
+            const PendingDefinition& x = definitions[a];
+            const PendingDefinition& y = definitions[b];
+            if (rank[x.name] != rank[y.name]) return rank[x.name] < rank[y.name];
+            return x.file != y.file ? x.file < y.file : x.start < y.start;
+        });
+        std::vector<uint32_t> definitionIndex(definitions.size());
+        for (uint32_t i = 0; i < definitionOrder.size(); i++) definitionIndex[definitionOrder[i]] = i;
+
+        std::sort(sites.begin(), sites.end(), [&rank](const PendingSite& a, const PendingSite& b) {
+            if (rank[a.callee] != rank[b.callee]) return rank[a.callee] < rank[b.callee];
+            return a.file != b.file ? a.file < b.file : a.offset < b.offset;
+        });
+
+        std::vector<NodeRecord> nodes(names.size());
+        for (uint32_t n = 0; n < nodes.size(); n++) {
+            std::string_view name = names[order[n]];
+            nodes[n] = {(uint32_t)pool.size(), (uint32_t)name.size(), 0, 0};
+            pool.append(name.data(), name.size());
+        }
+        std::vector<DefinitionRecord> definitionRecords(definitions.size());
+        for (uint32_t i = 0; i < definitionOrder.size(); i++) {
+            const PendingDefinition& def = definitions[definitionOrder[i]];
+            NodeRecord& node = nodes[rank[def.name]];
+            if (node.definitionCount++ == 0) node.firstDefinition = i;
+            definitionRecords[i] = {rank[def.name], def.file, def.start, def.end, def.line};
+        }
+
+        // 3. Callers of each node, callees of each definition.
+        std::vector<uint32_t> siteOffsets(nodes.size() + 1, 0);
+        std::vector<SiteRecord> siteRecords(sites.size());
+        std::vector<std::pair<uint32_t, uint32_t>> edges; // (definition, callee node)
+        for (uint32_t s = 0; s < sites.size(); s++) {
+            const PendingSite& site = sites[s];
+            uint32_t caller = site.caller == kNoDefinition ? kNoDefinition : definitionIndex[site.caller];
+            siteOffsets[rank[site.callee] + 1]++;
+            siteRecords[s] = {caller, site.file, site.offset, site.line};
+            if (caller != kNoDefinition) edges.push_back({caller, rank[site.callee]});
+        }
+        for (size_t n = 0; n < nodes.size(); n++) siteOffsets[n + 1] += siteOffsets[n];
+
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        std::vector<uint32_t> calleeOffsets(definitions.size() + 1, 0);
+        std::vector<uint32_t> callees(edges.size());
+        for (size_t e = 0; e < edges.size(); e++) {
+            calleeOffsets[edges[e].first + 1]++;
+            callees[e] = edges[e].second;
+        }
+        for (size_t d = 0; d < definitions.size(); d++) calleeOffsets[d + 1] += calleeOffsets[d];
+
+        if (pool.size() > std::numeric_limits<uint32_t>::max() || sites.size() > std::numeric_limits<uint32_t>::max() ||
+            edges.size() > std::numeric_limits<uint32_t>::max()) return false;
+
+        Header header = {};
+        memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.fileCount = (uint32_t)files.size();
+        header.nodeCount = (uint32_t)nodes.size();
+        header.definitionCount = (uint32_t)definitionRecords.size();
+        header.siteCount = (uint32_t)siteRecords.size();
+        header.edgeCount = (uint32_t)callees.size();
+        header.stringPoolSize = pool.size();
+
+        std::string blob;
+        blob.reserve((size_t)tableSize(header));
+        auto append = [&blob](const void *data, size_t size) {
+            blob.append(reinterpret_cast<const char *>(data), size);
+        };
+        append(&header, sizeof(header));
+        append(files.data(), files.size() * sizeof(FileRecord));
+        append(nodes.data(), nodes.size() * sizeof(NodeRecord));
+        append(definitionRecords.data(), definitionRecords.size() * sizeof(DefinitionRecord));
+        append(siteOffsets.data(), siteOffsets.size() * sizeof(uint32_t));
+        append(siteRecords.data(), siteRecords.size() * sizeof(SiteRecord));
+        append(calleeOffsets.data(), calleeOffsets.size() * sizeof(uint32_t));
+        append(callees.data(), callees.size() * sizeof(uint32_t));
+        blob.append(pool);
+
+        if (!MicroCore::writeFileAtomically(_indexPath, blob.data(), blob.size())) return false;
+
+        // A rewritten table that does not validate is never queried: the previous
+        // mapping and the overlay keep answering, and the next save() retries.
+        MicroCore::MappedFile previous = std::move(_mapping);
+        if (!_mapping.open(_indexPath) || !validateMapping()) {
+            _mapping = std::move(previous);
+            return false;
+        }
+        _overlay.clear();
+        _overlayCalls.clear();
+        _overlayDefinitions.clear();
+        _basePaths.clear();
+        _shadowed.clear();
+        _baseLookupBuilt = false;
+        return true;
+    }
+
+    // MARK: - Queries
+
+    size_t CallGraph::fileCount() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        Table table = tableFor(_mapping);
+        size_t count = 0;
+        if (table.header) {
+            for (uint32_t f = 0; f < table.header->fileCount; f++) {
+                if (!isShadowed(f)) count++;
+            }
+        }
+        for (const auto& entry : _overlay) {
+            if (!entry.second.removed) count++;
+        }
+        return count;
+    }
+
+    size_t CallGraph::callCount() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        Table table = tableFor(_mapping);
+        size_t count = 0;
+        if (table.header) {
+            for (uint32_t s = 0; s < table.header->siteCount; s++) {
+                if (!isShadowed(table.sites[s].file)) count++;
+            }
+        }
+        for (const auto& entry : _overlay) {
+            count += entry.second.calls.size();
+        }
+        return count;
+    }
+
+    bool CallGraph::isDefinedLocked(std::string_view function) const {
+        Table table = tableFor(_mapping);
+        uint32_t node = table.find(function);
+        if (node != UINT32_MAX) {
+            const NodeRecord& record = table.nodes[node];
+            for (uint32_t d = record.firstDefinition; d < record.firstDefinition + record.definitionCount; d++) {
+                if (!isShadowed(table.definitions[d].file)) return true;
+            }
+        }
+        return _overlayDefinitions.count(std::string(function)) != 0;
+    }
+
+    bool CallGraph::isDefined(std::string_view function) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return isDefinedLocked(function);
+    }
+
+    template <typename Visit>
+    void CallGraph::forEachCallerLocked(std::string_view function, Visit&& visit) const {
+        Table table = tableFor(_mapping);
+        uint32_t node = table.find(function);
+        if (node != UINT32_MAX) {
+            for (uint32_t s = table.siteOffsets[node]; s < table.siteOffsets[node + 1]; s++) {
+                const SiteRecord& site = table.sites[s];
+                if (isShadowed(site.file)) continue;
+                std::string_view caller = site.caller == kNoDefinition ? std::string_view()
+                                                                       : table.name(table.definitions[site.caller].node);
+                if (!visit(caller, table.path(site.file), site.offset, site.line)) return;
+            }
+        }
+        auto it = _overlayCalls.find(std::string(function));
+        if (it == _overlayCalls.end()) return;
+        for (const OverlayRef& ref : it->second) {
+            const OwnedCall& call = ref.file->calls[ref.index];
+            std::string_view caller = call.caller == kTopLevel ? std::string_view()
+                                                               : std::string_view(ref.file->definitions[call.caller].name);
+            if (!visit(caller, std::string_view(ref.file->path), call.offset, call.line)) return;
+        }
+    }
+
+    std::vector<CallSite> CallGraph::callers(std::string_view function, size_t limit) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        std::vector<CallSite> results;
+        if (limit == 0) return results;
+        forEachCallerLocked(function, [&](std::string_view caller, std::string_view file, uint32_t offset, uint32_t line) {
+            results.push_back({std::string(caller), std::string(function), std::string(file), offset, line});
+            return results.size() < limit;
+        });
+        return results;
+    }
+
+    std::vector<std::string> CallGraph::callees(std::string_view function) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        std::vector<std::string> results;
+        Table table = tableFor(_mapping);
+        uint32_t node = table.find(function);
+        if (node != UINT32_MAX) {
+            const NodeRecord& record = table.nodes[node];
+            for (uint32_t d = record.firstDefinition; d < record.firstDefinition + record.definitionCount; d++) {
+                if (isShadowed(table.definitions[d].file)) continue;
+                for (uint32_t e = table.calleeOffsets[d]; e < table.calleeOffsets[d + 1]; e++) {
+                    results.emplace_back(table.name(table.callees[e]));
+                }
+            }
+        }
+        auto it = _overlayDefinitions.find(std::string(function));
+        if (it != _overlayDefinitions.end()) {
+            for (const OverlayRef& ref : it->second) {
+                for (const auto& call : ref.file->calls) {
+                    if (call.caller == (int32_t)ref.index) results.push_back(call.callee);
+                }
+            }
+        }
+        std::sort(results.begin(), results.end());
+        results.erase(std::unique(results.begin(), results.end()), results.end());
+        return results;
+    }
+
+    std::vector<ImpactEntry> CallGraph::impact(std::string_view function, uint32_t maxDepth, size_t limit) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        std::vector<ImpactEntry> results;
+        std::unordered_set<std::string> seenFunctions = {std::string(function)};
+        std::unordered_set<std::string> seenFiles; // Top-level code, which nothing calls
+        std::vector<std::string> frontier = {std::string(function)};
+        std::vector<std::string> next;
+
+        for (uint32_t depth = 1; !frontier.empty() && (maxDepth == 0 || depth <= maxDepth); depth++) {
+            next.clear();
+            for (const auto& name : frontier) {
+                forEachCallerLocked(name, [&](std::string_view caller, std::string_view file, uint32_t, uint32_t) {
+                    if (caller.empty()) {
+                        if (seenFiles.emplace(file).second) results.push_back({std::string(), std::string(file), depth});
+                    } else if (seenFunctions.emplace(caller).second) {
+                        results.push_back({std::string(caller), std::string(file), depth});
+                        next.emplace_back(caller);
+                    }
+                    return results.size() < limit;
+                });
+                if (results.size() >= limit) return results;
+            }
+            frontier.swap(next);
+        }
+        return results;
+    }
+}
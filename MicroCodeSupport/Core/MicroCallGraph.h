@@ -0,0 +1,166 @@
+//
+//  MicroCallGraph.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroMappedFile.h"
+#include "MicroThreadPool.h"
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// MARK: - MicroIndex (C++)
+// Workspace call graph: which function calls which, by name. Files are lexed and
+// parsed on a thread pool; every call (a name followed by '(') is attributed to
+// the innermost MicroParser function scope around it, or to the file's top level.
+// Callee names are resolved against the functions the same parse defines across
+// the workspace, so library calls stay unresolved rather than being dropped.
+//
+// The graph is persisted as a flat, memory-mappable table of CSR (compressed
+// sparse row) arrays keyed by name:
+//
+//   [Header][FileRecord x fileCount][NodeRecord x nodeCount, sorted by name]
+//   [DefinitionRecord x definitionCount, grouped by node]
+//   [siteOffsets x nodeCount + 1][SiteRecord x siteCount]     callers of each node
+//   [calleeOffsets x definitionCount + 1][node x edgeCount]   callees of each definition
+//   [string pool]
+//
+// "Find callers" is a binary search over the nodes plus one row of sites, read
+// straight from the mapping. As with SymbolIndex, changed files are re-indexed
+// into an in-memory overlay that shadows their mapped records until save().
+
+namespace MicroIndex {
+
+    /// One call, as an owned copy.
+    struct CallSite {
+        std::string caller;  // Enclosing function; empty for top-level code
+        std::string callee;
+        std::string file;
+        uint32_t offset;     // Byte offset of the callee name
+        uint32_t line;       // 0-based
+    };
+
+    /// A function (or file, for top-level code) affected by a change to another.
+    struct ImpactEntry {
+        std::string function; // Empty for a file's top-level code
+        std::string file;     // File of the first call found
+        uint32_t depth;       // 1: calls the function directly
+    };
+
+    class CallGraph {
+    public:
+        explicit CallGraph(std::string indexPath);
+
+        /// Maps the on-disk graph. Returns false if it is missing or unreadable,
+        /// in which case the graph starts empty.
+        bool open();
+
+        /// Re-indexes every path whose size or mtime differs from the indexed copy
+        /// and drops indexed files that are no longer listed. Returns the number of
+        /// files parsed.
+        size_t indexFiles(const std::vector<std::string>& paths,
+                          MicroCore::ThreadPool& pool = MicroCore::ThreadPool::shared());
+
+        /// File-change hooks. Cheap; call from a watcher.
+        void updateFile(const std::string& path);
+        void removeFile(const std::string& path);
+
+        /// Writes the merged graph atomically and re-maps it.
+        bool save();
+
+        size_t fileCount() const;
+        size_t callCount() const;
+
+        /// Whether a function named `function` is defined in the workspace.
+        bool isDefined(std::string_view function) const;
+
+        /// Calls to `function` from anywhere in the workspace, grouped by file in
+        /// offset order; at most `limit` results. O(log n + results).
+        std::vector<CallSite> callers(std::string_view function, size_t limit = SIZE_MAX) const;
+
+        /// Names called by the functions named `function`, sorted.
+        std::vector<std::string> callees(std::string_view function) const;
+
+        /// Everything that calls `function` directly or through other functions,
+        /// nearest first, up to `maxDepth` hops (0: unlimited) and `limit` entries.
+        std::vector<ImpactEntry> impact(std::string_view function, uint32_t maxDepth = 0, size_t limit = SIZE_MAX) const;
+
+    private:
+        static constexpr int32_t kTopLevel = -1;
+
+        struct OwnedDefinition {
+            std::string name;
+            uint32_t start;
+            uint32_t end;
+            uint32_t line;
+        };
+
+        struct OwnedCall {
+            std::string callee;
+            int32_t caller; // Index into the file's definitions, or kTopLevel
+            uint32_t offset;
+            uint32_t line;
+        };
+
+        struct FileCalls {
+            std::string path;
+            int64_t mtime = 0;
+            uint64_t size = 0;
+            bool removed = false;
+            std::vector<OwnedDefinition> definitions;
+            std::vector<OwnedCall> calls;
+        };
+
+        struct FileStamp {
+            int64_t mtime;
+            uint64_t size;
+        };
+
+        // Overlay entry, indexed by name alongside the overlay itself.
+        struct OverlayRef {
+            const FileCalls *file;
+            uint32_t index;
+        };
+
+        static bool statFile(const std::string& path, FileStamp& stamp);
+        static FileCalls parseFile(const std::string& path, const FileStamp& stamp);
+
+        bool validateMapping() const;
+        void buildBaseLookup();
+        bool baseStamp(const std::string& path, FileStamp& stamp) const;
+        bool isShadowed(uint32_t file) const { return !_shadowed.empty() && _shadowed[file]; }
+        void applyLocked(FileCalls&& file);
+        void unlinkOverlayLocked(const FileCalls& file);
+        void linkOverlayLocked(const FileCalls& file);
+        bool isDefinedLocked(std::string_view function) const;
+
+        /// Calls `visit(caller, file, offset, line)` for every call to `function`
+        /// until it returns false.
+        template <typename Visit>
+        void forEachCallerLocked(std::string_view function, Visit&& visit) const;
+
+        std::string _indexPath;
+        MicroCore::MappedFile _mapping;
+        mutable std::shared_mutex _mutex;
+
+        // Base (mapped) graph; lookup is built lazily on the first mutation.
+        std::unordered_map<std::string_view, uint32_t> _basePaths;
+        bool _baseLookupBuilt = false;
+        std::vector<bool> _shadowed;
+
+        // Overlay of files changed since the mapping was written.
+        std::unordered_map<std::string, FileCalls> _overlay;
+        // The overlay by name, kept in step with it.
+        std::unordered_map<std::string, std::vector<OverlayRef>> _overlayCalls;       // Callee -> calls
+        std::unordered_map<std::string, std::vector<OverlayRef>> _overlayDefinitions; // Name -> definitions
+    };
+}
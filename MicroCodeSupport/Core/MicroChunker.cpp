@@ -0,0 +1,598 @@
+//
+//  MicroChunker.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroChunker.h"
+
+#include "MicroHash.h"
+#include "MicroLexer.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+
+namespace MicroChunker {
+
+    using MicroLexer::State;
+    using MicroLexer::Token;
+    using MicroLexer::TokenType;
+
+    namespace {
+
+        constexpr uint32_t kNoLine = UINT32_MAX;
+        constexpr size_t kNoToken = SIZE_MAX;
+        constexpr int kMaxSplitDepth = 32; // Deeper declarations fall back to line windows
+
+        const std::unordered_set<std::string_view> kTypeWords = {
+            "class", "struct", "enum", "union", "interface", "implementation", "protocol", "trait", "impl",
+            "extension", "module", "mod", "namespace", "object", "record", "actor", "type"
+        };
+
+        const std::unordered_set<std::string_view> kFunctionWords = {
+            "func", "fn", "def", "function", "fun", "macro", "init", "deinit", "subscript", "constructor"
+        };
+
+        // Declarations whose keyword is also the name (`init(...)`).
+        const std::unordered_set<std::string_view> kSelfNamedWords = {
+            "init", "deinit", "subscript", "constructor"
+        };
+
+        // A statement starting with one of these is never a function definition.
+        const std::unordered_set<std::string_view> kControlWords = {
+            "if", "for", "while", "switch", "match", "return", "do", "try", "guard", "else", "case",
+            "loop", "when", "unless", "until", "with", "throw", "defer", "await"
+        };
+
+        // A line starting with one of these continues the statement above it.
+        const std::unordered_set<std::string_view> kBraceContinuations = {
+            "else", "catch", "finally", "where"
+        };
+        const std::unordered_set<std::string_view> kIndentContinuations = {
+            "else", "elif", "except", "finally", "end", "elsif", "elseif", "rescue", "ensure", "when", "catch"
+        };
+
+        enum class LineClass : uint8_t {
+            Blank,
+            Comment,
+            Code
+        };
+
+        struct Line {
+            uint32_t start;
+            uint32_t end;        // Newline excluded
+            uint32_t firstToken; // The line's tokens are [firstToken, next line's firstToken)
+            int32_t depthStart;  // Bracket depth before and after the line
+            int32_t depthEnd;
+            uint16_t indent;     // Columns, tabs to multiples of 4
+            LineClass kind;
+            bool continued;      // Starts inside a multi-line string or comment
+        };
+
+        /// A run of lines that belongs together at one nesting level: a
+        /// declaration or statement with its leading comments and attributes.
+        struct Unit {
+            uint32_t first;
+            uint32_t head;     // First code line
+            uint32_t last;
+            bool attributesOnly;
+            ChunkKind kind;
+            std::string_view name;
+            uint32_t bodyLine; // Line holding the body's '{' (brace languages), or kNoLine
+        };
+
+        class Chunker {
+        public:
+            Chunker(std::string_view source, const std::string& language, const Options& options)
+                : _source(source),
+                  _maxLines(std::max<uint32_t>(options.maxLines, 4)) {
+                if (!language.empty()) {
+                    std::string canonical = MicroLexer::LanguageSpec::canonicalLanguage(language);
+                    _engine = std::make_unique<MicroLexer::Engine>(canonical);
+                    _indentMode = (canonical == "python" || canonical == "ruby" || canonical == "julia");
+                    _objc = (canonical == "objc");
+                    _cpp = (canonical == "cpp");
+                    _implicitFunctions = (_cpp || _objc || canonical == "java" || canonical == "javascript");
+                } else {
+                    _indentMode = true;
+                }
+            }
+
+            std::vector<Chunk> run() {
+                scanLines();
+                emitLevel(0, static_cast<uint32_t>(_lines.size() - 1), 0, -1, 0);
+                return std::move(_chunks);
+            }
+
+        private:
+            std::string_view _source;
+            uint32_t _maxLines;
+            std::unique_ptr<MicroLexer::Engine> _engine; // Null for text
+            bool _indentMode = false;
+            bool _objc = false;
+            bool _cpp = false;
+            bool _implicitFunctions = false; // `name(...) {` defines a function (no keyword)
+
+            std::vector<Token> _tokens;
+            std::vector<Line> _lines;
+            std::vector<Chunk> _chunks;
+
+            std::string_view textOf(const Token& t) const { return _source.substr(t.start, t.length); }
+
+            size_t tokenEnd(uint32_t line) const {
+                return line + 1 < _lines.size() ? _lines[line + 1].firstToken : _tokens.size();
+            }
+
+            // First and last non-comment tokens of a code line.
+            size_t firstCodeToken(uint32_t line) const {
+                for (size_t i = _lines[line].firstToken; i < tokenEnd(line); i++) {
+                    if (_tokens[i].type != TokenType::Comment) return i;
+                }
+                return kNoToken;
+            }
+
+            size_t lastCodeToken(uint32_t line) const {
+                for (size_t i = tokenEnd(line); i > _lines[line].firstToken; i--) {
+                    if (_tokens[i - 1].type != TokenType::Comment) return i - 1;
+                }
+                return kNoToken;
+            }
+
+            // First non-space byte of a line.
+            char leadingChar(uint32_t line) const {
+                size_t i = _lines[line].start;
+                while (i < _lines[line].end && (_source[i] == ' ' || _source[i] == '\t')) i++;
+                return i < _lines[line].end ? _source[i] : '\0';
+            }
+
+            bool isPunct(size_t i, char c) const {
+                return i < _tokens.size() && _tokens[i].type == TokenType::Punctuation && _source[_tokens[i].start] == c;
+            }
+
+            void scanLines();
+            bool isAttributeLine(uint32_t line) const;
+            bool continues(const Unit& unit, uint32_t previous, uint32_t line, int32_t base) const;
+            void collectUnits(uint32_t first, uint32_t last, int32_t base, std::vector<Unit>& units) const;
+            void addCommentUnits(uint32_t from, uint32_t to, std::vector<Unit>& units) const;
+            size_t nameAfter(size_t i, size_t end, bool skipParens) const;
+            void classify(Unit& unit) const;
+            void emitLevel(uint32_t first, uint32_t last, int32_t base, int32_t parent, int level);
+            void emitUnit(const Unit& unit, int32_t base, int32_t parent, int level);
+            void emitWindows(uint32_t first, uint32_t last, ChunkKind kind, std::string_view name, int32_t parent);
+            int32_t emit(uint32_t first, uint32_t last, ChunkKind kind, std::string_view name, int32_t parent);
+        };
+
+        // MARK: - Lines
+
+        void Chunker::scanLines() {
+            State state = State::Normal;
+            int32_t depth = 0;
+            size_t lineStart = 0;
+            while (true) {
+                size_t newline = _source.find('\n', lineStart);
+                size_t lineEnd = (newline == std::string_view::npos) ? _source.size() : newline;
+
+                Line line = {};
+                line.start = static_cast<uint32_t>(lineStart);
+                line.end = static_cast<uint32_t>(lineEnd);
+                line.firstToken = static_cast<uint32_t>(_tokens.size());
+                line.depthStart = depth;
+                line.continued = (state != State::Normal);
+                if (_engine) {
+                    state = _engine->tokenizeLine(_source, lineStart, lineEnd, state, _tokens);
+                }
+
+                uint32_t columns = 0;
+                size_t i = lineStart;
+                for (; i < lineEnd && (_source[i] == ' ' || _source[i] == '\t' || _source[i] == '\r'); i++) {
+                    if (_source[i] == ' ') columns++;
+                    else if (_source[i] == '\t') columns += 4 - columns % 4;
+                }
+                line.indent = static_cast<uint16_t>(std::min<uint32_t>(columns, UINT16_MAX));
+
+                if (i == lineEnd) {
+                    line.kind = LineClass::Blank;
+                } else if (!_engine) {
+                    line.kind = LineClass::Code;
+                } else {
+                    line.kind = LineClass::Comment;
+                    for (size_t t = line.firstToken; t < _tokens.size(); t++) {
+                        const Token& token = _tokens[t];
+                        if (token.type == TokenType::Comment) continue;
+                        line.kind = LineClass::Code;
+                        if (token.type != TokenType::Punctuation) continue;
+                        char c = _source[token.start];
+                        if (c == '(' || c == '[' || c == '{') depth++;
+                        else if ((c == ')' || c == ']' || c == '}') && depth > 0) depth--;
+                    }
+                }
+                line.depthEnd = depth;
+                _lines.push_back(line);
+
+                if (newline == std::string_view::npos) break;
+                lineStart = newline + 1;
+            }
+        }
+
+        // `@attr(...)` / `@a.b` decorators and `template <...>` prefixes alone on a line.
+        bool Chunker::isAttributeLine(uint32_t line) const {
+            if (!_engine || _objc || _lines[line].kind != LineClass::Code) {
+                return false;
+            }
+            size_t i = firstCodeToken(line);
+            const size_t end = tokenEnd(line);
+            if (_cpp && textOf(_tokens[i]) == "template") {
+                int angle = 0;
+                for (i++; i < end; i++) {
+                    if (isPunct(i, '<')) angle++;
+                    else if (isPunct(i, '>')) angle--;
+                    else if (angle <= 0 && _tokens[i].type != TokenType::Comment) return false;
+                }
+                return true;
+            }
+            while (i < end) {
+                if (!isPunct(i, '@')) return false;
+                i++;
+                // Dotted name
+                while (i < end && (_tokens[i].type == TokenType::Identifier || _tokens[i].type == TokenType::Type ||
+                                   _tokens[i].type == TokenType::Function || _tokens[i].type == TokenType::Keyword ||
+                                   _tokens[i].type == TokenType::KeywordDeclaration || isPunct(i, '.'))) {
+                    i++;
+                }
+                // Arguments, possibly continuing on the next lines
+                if (isPunct(i, '(')) {
+                    int depth = 0;
+                    for (; i < end; i++) {
+                        if (isPunct(i, '(')) depth++;
+                        else if (isPunct(i, ')') && --depth == 0) break;
+                    }
+                    if (i == end) return true;
+                    i++;
+                }
+                while (i < end && _tokens[i].type == TokenType::Comment) i++;
+            }
+            return true;
+        }
+
+        // MARK: - Units
+
+        bool Chunker::continues(const Unit& unit, uint32_t previous, uint32_t line, int32_t base) const {
+            const Line& l = _lines[line];
+            if (l.depthStart > base || l.continued || unit.attributesOnly) {
+                return true;
+            }
+            const uint16_t headIndent = _lines[unit.head].indent;
+            if (!_engine) {
+                // Paragraphs, and anything indented under the first line
+                return line == previous + 1 || l.indent > headIndent;
+            }
+            const Token& first = _tokens[firstCodeToken(line)];
+            std::string_view text = textOf(first);
+            if (first.type == TokenType::Punctuation) {
+                char c = text[0];
+                if (c == ')' || c == ']' || c == '}' || c == '{' || c == '.') return true;
+            }
+            if (_indentMode) {
+                return kIndentContinuations.count(text) || l.indent > headIndent;
+            }
+            if (kBraceContinuations.count(text)) {
+                return true;
+            }
+            // A more indented line continues an unterminated statement.
+            const Token& last = _tokens[lastCodeToken(previous)];
+            char end = _source[last.start + last.length - 1];
+            return l.indent > headIndent && !(last.type == TokenType::Punctuation && (end == ';' || end == '}'));
+        }
+
+        void Chunker::addCommentUnits(uint32_t from, uint32_t to, std::vector<Unit>& units) const {
+            for (uint32_t line = from; line < to; line++) {
+                if (_lines[line].kind != LineClass::Comment) continue;
+                uint32_t last = line;
+                while (last + 1 < to && _lines[last + 1].kind == LineClass::Comment) last++;
+                units.push_back({line, line, last, false, ChunkKind::Other, {}, kNoLine});
+                line = last;
+            }
+        }
+
+        void Chunker::collectUnits(uint32_t first, uint32_t last, int32_t base, std::vector<Unit>& units) const {
+            units.clear();
+            uint32_t previous = kNoLine; // Last code line seen
+            size_t open = SIZE_MAX;      // Unit being extended
+            for (uint32_t line = first; line <= last; line++) {
+                if (_lines[line].kind != LineClass::Code) continue;
+                if (open != SIZE_MAX && continues(units[open], previous, line, base)) {
+                    units[open].last = line;
+                    units[open].attributesOnly = units[open].attributesOnly && isAttributeLine(line);
+                    previous = line;
+                    continue;
+                }
+
+                uint32_t from = (previous == kNoLine) ? first : previous + 1;
+                if (open != SIZE_MAX && _indentMode) {
+                    // Indented comments still belong to the block above.
+                    const uint16_t headIndent = _lines[units[open].head].indent;
+                    for (uint32_t l = from; l < line && _lines[l].kind != LineClass::Code; l++) {
+                        if (_lines[l].kind == LineClass::Comment) {
+                            if (_lines[l].indent <= headIndent) break;
+                            units[open].last = l;
+                            from = l + 1;
+                        }
+                    }
+                }
+                // Comments directly above a unit document it.
+                uint32_t prefix = line;
+                while (prefix > from && _lines[prefix - 1].kind == LineClass::Comment) prefix--;
+                addCommentUnits(from, prefix, units);
+                units.push_back({prefix, line, line, isAttributeLine(line), ChunkKind::Other, {}, kNoLine});
+                open = units.size() - 1;
+                previous = line;
+            }
+            addCommentUnits((previous == kNoLine) ? first : previous + 1, last + 1, units);
+        }
+
+        // Index of the declared name following a declaration keyword at `i`, or
+        // kNoToken when the keyword is not followed by a name (`module.exports`).
+        size_t Chunker::nameAfter(size_t i, size_t end, bool skipParens) const {
+            while (i < end && _tokens[i].type == TokenType::Comment) i++;
+            if (skipParens && isPunct(i, '(')) { // Go receivers: func (r *T) Name()
+                int depth = 0;
+                for (; i < end; i++) {
+                    if (isPunct(i, '(')) depth++;
+                    else if (isPunct(i, ')') && --depth == 0) break;
+                }
+                i++;
+            }
+            int angle = 0;
+            for (; i < end; i++) {
+                const Token& t = _tokens[i];
+                if (t.type == TokenType::Comment) continue;
+                if (isPunct(i, '<')) { angle++; continue; }
+                if (isPunct(i, '>')) { angle--; continue; }
+                if (angle > 0) continue;
+                if (t.type == TokenType::Identifier || t.type == TokenType::Type || t.type == TokenType::Function) {
+                    return i;
+                }
+                // `enum class Name`, `data class Name`
+                if ((t.type == TokenType::Keyword || t.type == TokenType::KeywordDeclaration) && kTypeWords.count(textOf(t))) {
+                    continue;
+                }
+                return kNoToken;
+            }
+            return kNoToken;
+        }
+
+        void Chunker::classify(Unit& unit) const {
+            if (!_engine || _lines[unit.head].kind != LineClass::Code) {
+                return;
+            }
+            // Only the declaration line (after attributes) names the unit; brace
+            // languages scan on for the '{' that opens the body.
+            uint32_t declLine = unit.head;
+            while (declLine < unit.last && isAttributeLine(declLine)) declLine++;
+
+            int32_t depth = 0;
+            bool control = false, assigned = false, arrow = false, first = true, objcMethod = false;
+            size_t candidate = kNoToken, firstName = kNoToken;
+            for (uint32_t line = declLine; line <= unit.last; line++) {
+                // The declaration line and its continuation inside brackets
+                const bool declaring = (line == declLine || depth > 0);
+                if (_indentMode && !declaring) {
+                    return;
+                }
+                for (size_t i = _lines[line].firstToken; i < tokenEnd(line); i++) {
+                    const Token& t = _tokens[i];
+                    if (t.type == TokenType::Comment) continue;
+                    std::string_view text = textOf(t);
+
+                    if (t.type == TokenType::Punctuation) {
+                        char c = text[0];
+                        if (c == '{' && depth == 0 && !_indentMode) {
+                            if (unit.kind == ChunkKind::Other && !control) {
+                                if (candidate != kNoToken && !assigned) {
+                                    unit.kind = ChunkKind::Function;
+                                    unit.name = textOf(_tokens[candidate]);
+                                } else if (arrow && firstName != kNoToken) {
+                                    unit.kind = ChunkKind::Function;
+                                    unit.name = textOf(_tokens[firstName]);
+                                }
+                            }
+                            unit.bodyLine = line;
+                            return;
+                        }
+                        if (c == '(' || c == '[' || c == '{') {
+                            depth++;
+                        } else if (c == ')' || c == ']' || c == '}') {
+                            if (depth > 0) depth--;
+                            if (objcMethod && depth == 0 && unit.name.empty()) {
+                                size_t n = nameAfter(i + 1, tokenEnd(line), false);
+                                if (n != kNoToken) unit.name = textOf(_tokens[n]);
+                            }
+                        } else if (c == '.' && depth == 0) {
+                            candidate = kNoToken; // `call(...).then {`
+                        } else if (c == '=' && depth == 0) {
+                            if (isPunct(i + 1, '>')) arrow = true;
+                            else assigned = true;
+                        } else if (c == ';' && depth == 0) {
+                            return; // Statement ended without a body
+                        } else if (first && _objc && (c == '-' || c == '+') && line == declLine) {
+                            objcMethod = true;
+                            unit.kind = ChunkKind::Function;
+                        }
+                        first = false;
+                        continue;
+                    }
+
+                    if (declaring && depth == 0 && unit.kind == ChunkKind::Other) {
+                        if (first && kControlWords.count(text)) {
+                            control = true;
+                        }
+                        if (kTypeWords.count(text)) {
+                            size_t n = nameAfter(i + 1, tokenEnd(line), false);
+                            if (n != kNoToken) {
+                                unit.kind = ChunkKind::Type;
+                                unit.name = textOf(_tokens[n]);
+                            }
+                        } else if (kFunctionWords.count(text) && !control) {
+                            unit.kind = ChunkKind::Function;
+                            size_t n = nameAfter(i + 1, tokenEnd(line), true);
+                            if (kSelfNamedWords.count(text)) unit.name = text;
+                            else if (n != kNoToken) unit.name = textOf(_tokens[n]);
+                            else if (assigned && firstName != kNoToken) unit.name = textOf(_tokens[firstName]);
+                        } else if (t.type == TokenType::Identifier || t.type == TokenType::Function || t.type == TokenType::Type) {
+                            if (firstName == kNoToken) firstName = i;
+                            if (_implicitFunctions && candidate == kNoToken && isPunct(i + 1, '(')) candidate = i;
+                        }
+                    }
+                    first = false;
+                }
+            }
+        }
+
+        // MARK: - Chunks
+
+        int32_t Chunker::emit(uint32_t first, uint32_t last, ChunkKind kind, std::string_view name, int32_t parent) {
+            while (first <= last && _lines[first].kind == LineClass::Blank) first++;
+            while (last > first && _lines[last].kind == LineClass::Blank) last--;
+            if (first > last || _lines[first].kind == LineClass::Blank) {
+                return -1;
+            }
+            Chunk chunk;
+            chunk.startLine = first;
+            chunk.endLine = last;
+            chunk.start = _lines[first].start;
+            chunk.end = _lines[last].end;
+            chunk.name = name;
+            chunk.kind = kind;
+            chunk.parent = parent;
+            chunk.hash = MicroCore::hash64(_source.substr(chunk.start, chunk.end - chunk.start));
+            _chunks.push_back(chunk);
+            return static_cast<int32_t>(_chunks.size() - 1);
+        }
+
+        void Chunker::emitWindows(uint32_t first, uint32_t last, ChunkKind kind, std::string_view name, int32_t parent) {
+            int32_t owner = -1;
+            for (uint32_t line = first; line <= last;) {
+                uint32_t end = std::min(last, line + _maxLines - 1);
+                if (end < last) {
+                    // Prefer to cut at a blank line in the second half of the window.
+                    for (uint32_t l = end; l > line + _maxLines / 2; l--) {
+                        if (_lines[l].kind == LineClass::Blank) {
+                            end = l;
+                            break;
+                        }
+                    }
+                }
+                int32_t index = (owner < 0) ? emit(line, end, kind, name, parent) : emit(line, end, ChunkKind::Other, {}, owner);
+                if (owner < 0) owner = index;
+                line = end + 1;
+            }
+        }
+
+        void Chunker::emitUnit(const Unit& unit, int32_t base, int32_t parent, int level) {
+            if (unit.last - unit.first < _maxLines) {
+                emit(unit.first, unit.last, unit.kind, unit.name, parent);
+                return;
+            }
+
+            // Too long: emit the header, then the body's own units one level down.
+            // The body is the indented block or the '{' block; failing that, the
+            // contents of the first bracket left open (a long call or literal).
+            uint32_t bodyFirst = kNoLine;
+            int32_t bodyBase = base;
+            if (level < kMaxSplitDepth) {
+                if (_indentMode) {
+                    const uint16_t headIndent = _lines[unit.head].indent;
+                    for (uint32_t line = unit.head + 1; line <= unit.last; line++) {
+                        const Line& l = _lines[line];
+                        if (l.kind == LineClass::Code && !l.continued && l.depthStart == base && l.indent > headIndent) {
+                            bodyFirst = line;
+                            break;
+                        }
+                    }
+                } else if (unit.bodyLine != kNoLine && _lines[unit.bodyLine].depthEnd > base) {
+                    bodyFirst = unit.bodyLine + 1;
+                    bodyBase = _lines[unit.bodyLine].depthEnd;
+                }
+                for (uint32_t line = unit.head + 1; bodyFirst == kNoLine && line <= unit.last; line++) {
+                    if (_lines[line].depthStart > base) {
+                        bodyFirst = line;
+                        bodyBase = _lines[line].depthStart;
+                    }
+                }
+            }
+            if (bodyFirst == kNoLine || bodyFirst > unit.last) {
+                emitWindows(unit.first, unit.last, unit.kind, unit.name, parent);
+                return;
+            }
+            int32_t header = emit(unit.first, bodyFirst - 1, unit.kind, unit.name, parent);
+            emitLevel(bodyFirst, unit.last, bodyBase, header, level + 1);
+        }
+
+        void Chunker::emitLevel(uint32_t first, uint32_t last, int32_t base, int32_t parent, int level) {
+            std::vector<Unit> units;
+            collectUnits(first, last, base, units);
+
+            // Consecutive small statements share a chunk. Groups are cut where a
+            // statement's hash says so (once the group has some size), so an edit
+            // only regroups the statements up to the next such cut.
+            uint32_t groupFirst = kNoLine, groupLast = 0;
+            bool commentsOnly = true;
+            auto flush = [&]() {
+                if (groupFirst != kNoLine) {
+                    emit(groupFirst, groupLast, ChunkKind::Other, {}, parent);
+                    groupFirst = kNoLine;
+                }
+            };
+            for (Unit& unit : units) {
+                classify(unit);
+                if (unit.kind != ChunkKind::Other || unit.last - unit.first >= _maxLines) {
+                    // Section comments (`// MARK:`) go with the declaration below them.
+                    if (groupFirst != kNoLine && commentsOnly &&
+                        (unit.last - groupFirst < _maxLines || unit.last - unit.first >= _maxLines)) {
+                        unit.first = groupFirst;
+                        groupFirst = kNoLine;
+                    }
+                    flush();
+                    emitUnit(unit, base, parent, level);
+                    continue;
+                }
+                if (groupFirst != kNoLine && unit.last - groupFirst >= _maxLines) {
+                    flush();
+                }
+                if (!_engine && leadingChar(unit.head) == '#') {
+                    flush(); // Markdown heading
+                }
+                if (groupFirst == kNoLine) {
+                    groupFirst = unit.first;
+                    commentsOnly = true;
+                }
+                commentsOnly = commentsOnly && _lines[unit.head].kind == LineClass::Comment;
+                groupLast = unit.last;
+                uint64_t hash = MicroCore::hash64(_source.substr(_lines[unit.first].start, _lines[unit.last].end - _lines[unit.first].start));
+                if (groupLast - groupFirst + 1 >= _maxLines / 4 && (hash & 3) == 0) {
+                    flush();
+                }
+            }
+            flush();
+        }
+    }
+
+    std::vector<Chunk> chunk(std::string_view source, const std::string& language, const Options& options) {
+        if (source.empty()) {
+            return {};
+        }
+        return Chunker(source, language, options).run();
+    }
+
+    const char *kindName(ChunkKind kind) {
+        switch (kind) {
+            case ChunkKind::Function: return "function";
+            case ChunkKind::Type: return "type";
+            case ChunkKind::Other: break;
+        }
+        return "other";
+    }
+}
@@ -0,0 +1,60 @@
+//
+//  MicroChunker.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - MicroChunker (C++)
+// Splits a source file into retrieval chunks that follow its structure rather
+// than fixed line windows. Every top-level function and type becomes its own
+// chunk; the statements between them (imports, globals, comments) are grouped.
+// A declaration longer than maxLines is split into its header plus its members,
+// recursively, and only falls back to line windows when it has no structure.
+//
+// Each chunk carries the XXH64 of its text. Editing one function changes that
+// function's hash only: boundaries come from the code itself and groups of
+// glue statements are cut at content-defined points, so inserting lines above
+// a chunk moves it without changing its hash. Embedding caches key on it.
+//
+// Units come from brackets and indentation in the lexer's tokens, so nesting is
+// found for every language the lexer knows; prose and data files ("" language)
+// are split at blank lines and indentation.
+
+namespace MicroChunker {
+
+    enum class ChunkKind : uint8_t {
+        Other = 0,    // Imports, globals, statements, prose
+        Function = 1, // Functions, methods, initializers
+        Type = 2      // Classes, structs, enums, protocols, impls, namespaces
+    };
+
+    struct Chunk {
+        uint32_t startLine;    // 0-based
+        uint32_t endLine;      // Inclusive
+        uint32_t start;        // Byte offset of startLine
+        uint32_t end;          // End of endLine, newline excluded
+        std::string_view name; // Declared name (points into the source), or empty
+        ChunkKind kind;
+        int32_t parent;        // Chunk this one was split out of, or -1
+        uint64_t hash;         // XXH64 of source[start, end)
+    };
+
+    struct Options {
+        uint32_t maxLines = 60;
+    };
+
+    /// Chunks in document order. `language` is a MicroLexer language id (aliases
+    /// accepted) or "" for text; see LanguageSpec::languageForPath.
+    std::vector<Chunk> chunk(std::string_view source, const std::string& language, const Options& options = {});
+
+    const char *kindName(ChunkKind kind);
+}
@@ -0,0 +1,68 @@
+//
+//  MicroChunkerFFI.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "../include/MicroChunkerFFI.h"
+
+#include "MicroChunker.h"
+#include "MicroLexer.h"
+
+#include <new>
+
+extern "C" MCCodeChunkList* mc_chunk_source(const char* path, const char* source, size_t length, uint32_t max_lines) {
+    if ((!source && length > 0) || length > UINT32_MAX) {
+        return nullptr;
+    }
+    std::string_view text(source ? source : "", length);
+    std::string language = path ? MicroLexer::LanguageSpec::languageForPath(path) : "";
+
+    MicroChunker::Options options;
+    if (max_lines > 0) {
+        options.maxLines = max_lines;
+    }
+    std::vector<MicroChunker::Chunk> chunks;
+    try {
+        chunks = MicroChunker::chunk(text, language, options);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+
+    auto* list = new (std::nothrow) MCCodeChunkList{nullptr, 0};
+    if (!list) {
+        return nullptr;
+    }
+    if (!chunks.empty()) {
+        list->chunks = new (std::nothrow) MCCodeChunk[chunks.size()];
+        if (!list->chunks) {
+            delete list;
+            return nullptr;
+        }
+        list->count = chunks.size();
+    }
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const auto& c = chunks[i];
+        MCCodeChunk& out = list->chunks[i];
+        out.start_line = c.startLine;
+        out.end_line = c.endLine;
+        out.start = c.start;
+        out.end = c.end;
+        out.name_start = c.name.empty() ? c.start : static_cast<uint32_t>(c.name.data() - text.data());
+        out.name_length = static_cast<uint32_t>(c.name.size());
+        out.parent = c.parent;
+        out.kind = static_cast<uint32_t>(c.kind);
+        out.hash = c.hash;
+    }
+    return list;
+}
+
+extern "C" void mc_free_chunk_list(MCCodeChunkList* list) {
+    if (!list) {
+        return;
+    }
+    delete[] list->chunks;
+    delete list;
+}
@@ -0,0 +1,331 @@
+//
+//  MicroDiagnostics.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroDiagnostics.h"
+
+#include <algorithm>
+
+namespace MicroDiagnostics {
+
+    using MicroLexer::IncrementalLexer;
+    using MicroLexer::State;
+    using MicroLexer::Token;
+    using MicroLexer::TokenType;
+
+    namespace {
+        char closerFor(char open) {
+            switch (open) {
+                case '(': return ')';
+                case '[': return ']';
+                case '{': return '}';
+            }
+            return 0;
+        }
+
+        bool isOpener(char c) { return c == '(' || c == '[' || c == '{'; }
+        bool isCloser(char c) { return c == ')' || c == ']' || c == '}'; }
+
+        std::string_view textOf(const IncrementalLexer& lexer, const Token& t) {
+            return std::string_view(lexer.source()).substr(t.start, t.length);
+        }
+
+        bool isPunct(const IncrementalLexer& lexer, const Token& t, char c) {
+            return t.type == TokenType::Punctuation && t.length == 1 && lexer.source()[t.start] == c;
+        }
+
+        std::string quoted(char c) {
+            return std::string("'") + c + "'";
+        }
+    }
+
+    const char *codeName(Code code) {
+        switch (code) {
+            case Code::UnterminatedString: return "unterminated-string";
+            case Code::UnterminatedComment: return "unterminated-comment";
+            case Code::UnmatchedBracket: return "unmatched-bracket";
+            case Code::UnclosedBracket: return "unclosed-bracket";
+            case Code::DuplicateDeclaration: return "duplicate-declaration";
+            case Code::UnreachableCode: return "unreachable-code";
+        }
+        return "";
+    }
+
+    Engine::Engine(const std::string& language)
+        : _language(MicroLexer::LanguageSpec::canonicalLanguage(language)) {
+        auto spec = MicroLexer::LanguageSpec::forLanguage(_language);
+        _braceLanguage = spec->blockComments && _language != "sql";
+        _singleQuoteStrings = (_language != "rust");
+    }
+
+    // MARK: - Per-line facts
+
+    void Engine::computeLine(const IncrementalLexer& lexer, size_t line, std::vector<Fact>& facts) const {
+        facts.clear();
+        const auto& tokens = lexer.tokens();
+        const size_t lineStart = lexer.lineStart(line);
+        for (size_t i = lexer.firstTokenOfLine(line); i < lexer.firstTokenOfLine(line + 1); i++) {
+            const Token& t = tokens[i];
+            const uint32_t column = static_cast<uint32_t>(t.start - lineStart);
+            if (t.type == TokenType::Punctuation && t.length == 1) {
+                char c = lexer.source()[t.start];
+                if (isOpener(c)) {
+                    facts.push_back({FactKind::Open, c, column, 1});
+                } else if (isCloser(c)) {
+                    if (!facts.empty() && facts.back().kind == FactKind::Open && closerFor(facts.back().bracket) == c) {
+                        facts.pop_back();
+                    } else {
+                        facts.push_back({FactKind::Close, c, column, 1});
+                    }
+                }
+            } else if (t.type == TokenType::String && (t.flags & MicroLexer::TokenFlagUnterminated)) {
+                // Always the line's last token, so it never sits between brackets.
+                if (_singleQuoteStrings || lexer.source()[t.start] != '\'') {
+                    facts.push_back({FactKind::Unterminated, 0, column, t.length});
+                }
+            }
+        }
+    }
+
+    void Engine::reset(const IncrementalLexer& lexer) {
+        _lines.clear();
+        _lines.resize(lexer.lineCount());
+        for (size_t line = 0; line < _lines.size(); line++) {
+            computeLine(lexer, line, _lines[line]);
+        }
+    }
+
+    void Engine::applyEdit(const IncrementalLexer& lexer, const MicroLexer::EditResult& edit) {
+        if (_lines.size() != lexer.lineCount() - edit.lineDelta) {
+            reset(lexer);
+            return;
+        }
+        auto first = _lines.begin() + edit.firstLine;
+        if (edit.newLineCount > edit.oldLineCount) {
+            _lines.insert(first + edit.oldLineCount, edit.newLineCount - edit.oldLineCount, std::vector<Fact>());
+        } else {
+            _lines.erase(first + edit.newLineCount, first + edit.oldLineCount);
+        }
+        for (size_t i = 0; i < edit.newLineCount; i++) {
+            computeLine(lexer, edit.firstLine + i, _lines[edit.firstLine + i]);
+        }
+    }
+
+    // MARK: - Collection
+
+    std::vector<Diagnostic> Engine::collect(const IncrementalLexer& lexer, const MicroParser::Engine& parser) {
+        std::vector<Diagnostic> out;
+        if (_lines.size() != lexer.lineCount()) {
+            reset(lexer);
+        }
+        collectBrackets(lexer, out);
+        collectDuplicates(lexer, parser, out);
+        collectUnreachable(lexer, out);
+
+        std::sort(out.begin(), out.end(), [](const Diagnostic& a, const Diagnostic& b) {
+            return a.start < b.start;
+        });
+        if (out.size() > kMaxDiagnostics) {
+            out.resize(kMaxDiagnostics);
+        }
+        for (Diagnostic& d : out) {
+            d.line = static_cast<uint32_t>(lexer.lineForOffset(d.start));
+            d.column = static_cast<uint32_t>(d.start - lexer.lineStart(d.line));
+        }
+        return out;
+    }
+
+    void Engine::collectBrackets(const IncrementalLexer& lexer, std::vector<Diagnostic>& out) const {
+        struct Item {
+            FactKind kind;
+            char bracket;
+            uint32_t start;
+        };
+
+        // 1. Merge per-line residues. The result is the file's irreducible bracket
+        //    sequence, exactly what a full scan would leave over.
+        std::vector<Item> residue;
+        for (size_t line = 0; line < _lines.size(); line++) {
+            const uint32_t lineStart = static_cast<uint32_t>(lexer.lineStart(line));
+            for (const Fact& fact : _lines[line]) {
+                if (fact.kind == FactKind::Unterminated) {
+                    out.push_back({Code::UnterminatedString, Severity::Error, lineStart + fact.column, fact.length, 0, 0,
+                                   "Unterminated string literal"});
+                } else if (fact.kind == FactKind::Close && !residue.empty() && residue.back().kind == FactKind::Open &&
+                           closerFor(residue.back().bracket) == fact.bracket) {
+                    residue.pop_back();
+                } else {
+                    residue.push_back({fact.kind, fact.bracket, lineStart + fact.column});
+                }
+            }
+        }
+
+        // 2. Explain what is left. A closer that matches an opener further down the
+        //    stack closes it, and the openers above it are reported as unclosed.
+        std::vector<Item> open;
+        auto reportUnclosed = [&out](const Item& item) {
+            out.push_back({Code::UnclosedBracket, Severity::Error, item.start, 1, 0, 0,
+                           "Unclosed " + quoted(item.bracket) + "; expected " + quoted(closerFor(item.bracket))});
+        };
+        for (const Item& item : residue) {
+            if (item.kind == FactKind::Open) {
+                open.push_back(item);
+                continue;
+            }
+            auto match = std::find_if(open.rbegin(), open.rend(), [&item](const Item& o) {
+                return closerFor(o.bracket) == item.bracket;
+            });
+            if (match == open.rend()) {
+                out.push_back({Code::UnmatchedBracket, Severity::Error, item.start, 1, 0, 0,
+                               "Unexpected " + quoted(item.bracket)});
+                continue;
+            }
+            size_t keep = static_cast<size_t>(open.rend() - match) - 1;
+            for (size_t i = keep + 1; i < open.size(); i++) {
+                reportUnclosed(open[i]);
+            }
+            open.resize(keep);
+        }
+        for (const Item& item : open) {
+            reportUnclosed(item);
+        }
+
+        // 3. A block comment or multi-line string still open at the end of the file.
+        size_t last = lexer.lineCount() - 1;
+        State endState = lexer.lineEndState(last);
+        if (endState != State::Normal) {
+            size_t line = last;
+            while (line > 0 && lexer.lineEndState(line - 1) == endState) {
+                line--;
+            }
+            size_t tokenIndex = lexer.firstTokenOfLine(line + 1);
+            if (tokenIndex > lexer.firstTokenOfLine(line)) {
+                const Token& opener = lexer.tokens()[tokenIndex - 1];
+                bool comment = (endState == State::InCommentBlock);
+                out.push_back({comment ? Code::UnterminatedComment : Code::UnterminatedString, Severity::Error,
+                               opener.start, comment ? 2u : 3u, 0, 0,
+                               comment ? "Unterminated block comment" : "Unterminated multi-line string"});
+            }
+        }
+    }
+
+    void Engine::collectDuplicates(const IncrementalLexer& lexer, const MicroParser::Engine& parser, std::vector<Diagnostic>& out) {
+        const std::string& source = lexer.source();
+        const auto& tokens = lexer.tokens();
+
+        // `if let x`, `for (auto x : ...)` and friends bind into the following block,
+        // even though the parser files them under the enclosing scope.
+        auto bindsIntoNextBlock = [&](const MicroParser::Symbol *symbol) {
+            auto it = std::lower_bound(tokens.begin(), tokens.end(), static_cast<uint32_t>(symbol->line),
+                                       [](const Token& t, uint32_t offset) { return t.start < offset; });
+            size_t declIndex = static_cast<size_t>(it - tokens.begin());
+            size_t lineFirst = lexer.firstTokenOfLine(lexer.lineForOffset(static_cast<size_t>(symbol->line)));
+            for (size_t i = lineFirst; i < declIndex; i++) {
+                if (tokens[i].type != TokenType::Keyword) continue;
+                std::string_view text = textOf(lexer, tokens[i]);
+                if (text == "if" || text == "while" || text == "for" || text == "case" || text == "catch" || text == "switch") {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (const auto& scope : parser.scopes) {
+            if (scope.variableCount < 2) continue;
+            _seenNames.clear();
+            for (const MicroParser::Symbol *v = scope.variables; v; v = v->next) {
+                if (v->name.data() < source.data() || v->name.data() > source.data() + source.size()) continue;
+                if (bindsIntoNextBlock(v)) continue;
+                if (_seenNames.insert(v->name).second) continue;
+
+                uint32_t start = static_cast<uint32_t>(v->name.data() - source.data());
+                out.push_back({Code::DuplicateDeclaration, Severity::Error, start, static_cast<uint32_t>(v->name.size()), 0, 0,
+                               "Invalid redeclaration of '" + std::string(v->name) + "' in the same scope"});
+            }
+        }
+        _seenNames.clear();
+    }
+
+    void Engine::collectUnreachable(const IncrementalLexer& lexer, std::vector<Diagnostic>& out) const {
+        if (!_braceLanguage) {
+            return;
+        }
+        // Languages where a line break ends a statement (and `if` always needs braces).
+        const bool newlineEnds = (_language == "swift" || _language == "go");
+        const auto& tokens = lexer.tokens();
+
+        auto nextCode = [&tokens](size_t i) {
+            while (i < tokens.size() && tokens[i].type == TokenType::Comment) i++;
+            return i;
+        };
+        auto sameLine = [&lexer](const Token& a, const Token& b) {
+            return lexer.lineForOffset(a.start) == lexer.lineForOffset(b.start);
+        };
+
+        size_t prev = SIZE_MAX; // Previous non-comment token
+        for (size_t i = 0; i < tokens.size(); i++) {
+            const Token& t = tokens[i];
+            if (t.type == TokenType::Comment) continue;
+            size_t before = prev;
+            prev = i;
+            if (t.type != TokenType::Keyword || textOf(lexer, t) != "return") continue;
+
+            // Only a `return` that starts a statement: `if (x) return;` is conditional.
+            if (before != SIZE_MAX) {
+                const Token& p = tokens[before];
+                bool statementStart = isPunct(lexer, p, '{') || isPunct(lexer, p, ';') || isPunct(lexer, p, '}');
+                if (!statementStart && !(newlineEnds && !sameLine(p, t))) continue;
+            }
+
+            // Skip the returned expression.
+            int depth = 0;
+            size_t j = i + 1;
+            size_t last = i;
+            bool blockEnds = false;
+            for (; j < tokens.size(); j++) {
+                const Token& u = tokens[j];
+                if (u.type == TokenType::Comment) continue;
+                if (depth == 0) {
+                    if (isPunct(lexer, u, ';')) { j++; break; }
+                    if (isPunct(lexer, u, '}')) { blockEnds = true; break; }
+                    if (newlineEnds && !sameLine(tokens[last], u)) {
+                        const Token& l = tokens[last];
+                        bool continues = l.type == TokenType::Punctuation && !isPunct(lexer, l, ')') && !isPunct(lexer, l, ']');
+                        if (!continues) break;
+                    }
+                }
+                if (u.type == TokenType::Punctuation && u.length == 1) {
+                    char c = lexer.source()[u.start];
+                    if (isOpener(c)) depth++;
+                    else if (isCloser(c) && depth > 0) depth--;
+                }
+                last = j;
+            }
+            if (blockEnds) continue;
+
+            size_t k = nextCode(j);
+            if (k >= tokens.size()) continue;
+            const Token& next = tokens[k];
+            std::string_view text = textOf(lexer, next);
+            if (isPunct(lexer, next, '}') || text == "case" || text == "default" || next.type == TokenType::KeywordDeclaration) {
+                continue;
+            }
+            size_t line = lexer.lineForOffset(next.start);
+            out.push_back({Code::UnreachableCode, Severity::Warning, next.start,
+                           static_cast<uint32_t>(lexer.lineEnd(line) - next.start), 0, 0,
+                           "Code after 'return' will never be executed"});
+        }
+    }
+
+    size_t Engine::memoryFootprint() const {
+        size_t bytes = _lines.capacity() * sizeof(std::vector<Fact>);
+        for (const auto& facts : _lines) {
+            bytes += facts.capacity() * sizeof(Fact);
+        }
+        return bytes;
+    }
+}
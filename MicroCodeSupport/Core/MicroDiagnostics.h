@@ -0,0 +1,103 @@
+//
+//  MicroDiagnostics.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroIncrementalLexer.h"
+#include "MicroParser.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// MARK: - MicroDiagnostics (C++)
+// Local checks that need no language server:
+//
+// - Lexical (unterminated strings/comments, unbalanced brackets): kept per line and
+//   updated only for the lines an edit relexed. Each line stores its bracket
+//   residue (what is left after cancelling matched pairs within the line), so the
+//   file-wide balance is a stack merge over residues, not a token scan.
+// - Structural (duplicate declarations in one scope, code after `return`): derived
+//   from the parse result and tokens after each parse.
+
+namespace MicroDiagnostics {
+
+    enum class Severity : uint8_t {
+        Error = 1,   // LSP DiagnosticSeverity values
+        Warning = 2
+    };
+
+    enum class Code : uint8_t {
+        UnterminatedString,
+        UnterminatedComment,
+        UnmatchedBracket,
+        UnclosedBracket,
+        DuplicateDeclaration,
+        UnreachableCode
+    };
+
+    /// Stable identifier for `code` ("unterminated-string", ...).
+    const char *codeName(Code code);
+
+    struct Diagnostic {
+        Code code;
+        Severity severity;
+        uint32_t start;  // Byte offset
+        uint32_t length;
+        uint32_t line;   // 0-based
+        uint32_t column; // Bytes from the line start
+        std::string message;
+    };
+
+    /// Results are capped so a badly broken file cannot flood the editor.
+    constexpr size_t kMaxDiagnostics = 200;
+
+    class Engine {
+    public:
+        explicit Engine(const std::string& language);
+
+        /// Recomputes the per-line facts for every line.
+        void reset(const MicroLexer::IncrementalLexer& lexer);
+
+        /// Recomputes the lines `edit` relexed; other lines are only renumbered.
+        void applyEdit(const MicroLexer::IncrementalLexer& lexer, const MicroLexer::EditResult& edit);
+
+        /// All diagnostics, ordered by position. `parser` must have parsed lexer.tokens().
+        std::vector<Diagnostic> collect(const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser);
+
+        size_t memoryFootprint() const;
+
+    private:
+        enum class FactKind : uint8_t {
+            Open,
+            Close,
+            Unterminated
+        };
+
+        /// Columns are line-relative, so facts survive edits on other lines unchanged.
+        struct Fact {
+            FactKind kind;
+            char bracket;
+            uint32_t column;
+            uint32_t length;
+        };
+
+        void computeLine(const MicroLexer::IncrementalLexer& lexer, size_t line, std::vector<Fact>& facts) const;
+        void collectBrackets(const MicroLexer::IncrementalLexer& lexer, std::vector<Diagnostic>& out) const;
+        void collectDuplicates(const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser, std::vector<Diagnostic>& out);
+        void collectUnreachable(const MicroLexer::IncrementalLexer& lexer, std::vector<Diagnostic>& out) const;
+
+        std::string _language;
+        bool _braceLanguage;
+        bool _singleQuoteStrings; // False where ' also starts lifetimes/labels (Rust)
+        std::vector<std::vector<Fact>> _lines; // Empty for lines with nothing to report
+        std::unordered_set<std::string_view> _seenNames;
+    };
+}
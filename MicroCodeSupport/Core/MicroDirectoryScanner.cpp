@@ -0,0 +1,349 @@
+//
+//  MicroDirectoryScanner.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroDirectoryScanner.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace MicroFiles {
+
+    namespace {
+
+        // Parent descriptors kept open for openat(). Past this, subdirectories are
+        // opened by full path instead so deep or wide trees cannot exhaust fds.
+        constexpr int kMaxOpenHandles = 128;
+
+        struct State;
+
+        struct DirectoryHandle {
+            DIR *dir;
+            State *state;
+            ~DirectoryHandle();
+        };
+
+        struct Task {
+            std::shared_ptr<DirectoryHandle> parent; // Null: open by full path
+            std::string path;
+            uint32_t nameOffset;
+            uint32_t depth;                          // Depth of the entries inside
+        };
+
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        struct State {
+            const ScanOptions *options;
+            const ScanBatchHandler *handler;
+
+            std::vector<WorkerQueue> queues;
+            std::atomic<size_t> nextSlot{1};         // Slot 0 is the calling thread
+            std::atomic<size_t> pending{0};          // Tasks queued or running
+            std::atomic<int> openHandles{0};
+            std::atomic<bool> stop{false};
+
+            // Helpers that start after the scan is over must not touch the options
+            // or the handler, which belong to the caller's frame.
+            std::atomic<bool> finished{false};
+            std::atomic<size_t> active{0};
+            std::mutex doneMutex;
+            std::condition_variable doneCV;
+
+            std::mutex idleMutex;
+            std::condition_variable idleCV;
+            std::atomic<int> sleepers{0};
+
+            std::mutex handlerMutex;
+            std::atomic<size_t> files{0};
+            std::atomic<size_t> directories{0};
+            std::atomic<size_t> errors{0};
+
+            explicit State(size_t slots) : queues(slots) {}
+        };
+
+        DirectoryHandle::~DirectoryHandle() {
+            closedir(dir);
+            state->openHandles.fetch_sub(1);
+        }
+
+        int64_t mtimeOf(const struct stat& sb) {
+#ifdef __APPLE__
+            int64_t nanos = sb.st_mtimespec.tv_nsec;
+#else
+            int64_t nanos = sb.st_mtim.tv_nsec;
+#endif
+            return (int64_t)sb.st_mtime * 1000000000LL + nanos;
+        }
+
+        EntryType typeOfMode(mode_t mode) {
+            if (S_ISDIR(mode)) return EntryType::Directory;
+            if (S_ISREG(mode)) return EntryType::File;
+            if (S_ISLNK(mode)) return EntryType::Symlink;
+            return EntryType::Other;
+        }
+
+        // Calls `fn(Entry&&)` for every entry of `dir` the options let through.
+        template <typename Fn>
+        void readEntries(DIR *dir, const std::string& path, uint32_t depth, const ScanOptions& options, Fn&& fn) {
+            std::string prefix = path;
+            if (prefix.empty() || prefix.back() != '/') prefix.push_back('/');
+
+            struct dirent *entry;
+            while ((entry = readdir(dir)) != nullptr) {
+                const char *entryName = entry->d_name;
+                if (entryName[0] == '.') {
+                    if (entryName[1] == '\0' || (entryName[1] == '.' && entryName[2] == '\0')) continue;
+                    if (!options.includeHidden) continue;
+                }
+
+                Entry out;
+                out.nameOffset = (uint32_t)prefix.size();
+                out.depth = depth;
+                out.linksToDirectory = false;
+                out.size = 0;
+                out.mtime = 0;
+
+                bool known = true;
+                switch (entry->d_type) {
+                    case DT_DIR: out.type = EntryType::Directory; break;
+                    case DT_REG: out.type = EntryType::File; break;
+                    case DT_LNK: out.type = EntryType::Symlink; break;
+                    case DT_UNKNOWN: known = false; out.type = EntryType::Other; break;
+                    default: out.type = EntryType::Other; break;
+                }
+
+                if (!known || options.statEntries) {
+                    struct stat sb;
+                    if (fstatat(dirfd(dir), entryName, &sb, AT_SYMLINK_NOFOLLOW) == 0) {
+                        out.type = typeOfMode(sb.st_mode);
+                        out.size = (uint64_t)sb.st_size;
+                        out.mtime = mtimeOf(sb);
+                    } else if (!known) {
+                        continue; // Vanished between readdir() and fstatat()
+                    }
+                }
+                if (out.type == EntryType::Symlink) {
+                    struct stat sb;
+                    out.linksToDirectory = fstatat(dirfd(dir), entryName, &sb, 0) == 0 && S_ISDIR(sb.st_mode);
+                }
+
+                out.path.reserve(prefix.size() + strlen(entryName));
+                out.path.assign(prefix).append(entryName);
+
+                if (options.exclude && options.exclude(out.path, out.type == EntryType::Directory)) continue;
+                fn(std::move(out));
+            }
+        }
+
+        class Worker {
+        public:
+            Worker(State& state, size_t slot) : _state(state), _slot(slot) {
+                _batch.reserve(_state.options->batchSize);
+            }
+
+            void run() {
+                Task task;
+                while (!_state.stop.load(std::memory_order_relaxed)) {
+                    if (pop(task) || steal(task)) {
+                        scan(task);
+                        task = Task();
+                        if (_state.pending.fetch_sub(1) == 1) wakeAll();
+                        continue;
+                    }
+                    if (_state.pending.load() == 0) break;
+                    idle();
+                }
+                flush();
+            }
+
+        private:
+            bool pop(Task& task) {
+                WorkerQueue& queue = _state.queues[_slot];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.tasks.empty()) return false;
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                return true;
+            }
+
+            bool steal(Task& task) {
+                size_t count = _state.queues.size();
+                for (size_t i = 1; i < count; i++) {
+                    WorkerQueue& queue = _state.queues[(_slot + i) % count];
+                    std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+                    if (!lock.owns_lock() || queue.tasks.empty()) continue;
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                    return true;
+                }
+                return false;
+            }
+
+            void idle() {
+                // Short timed wait: a missed wakeup only costs a millisecond, and the
+                // steal loop above retries try_lock failures on the next pass.
+                std::unique_lock<std::mutex> lock(_state.idleMutex);
+                _state.sleepers.fetch_add(1);
+                _state.idleCV.wait_for(lock, std::chrono::milliseconds(1));
+                _state.sleepers.fetch_sub(1);
+            }
+
+            void wakeAll() {
+                std::lock_guard<std::mutex> lock(_state.idleMutex);
+                _state.idleCV.notify_all();
+            }
+
+            void push(std::vector<Task>& children) {
+                _state.pending.fetch_add(children.size());
+                {
+                    WorkerQueue& queue = _state.queues[_slot];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    for (Task& child : children) {
+                        queue.tasks.push_back(std::move(child));
+                    }
+                }
+                if (_state.sleepers.load() > 0) wakeAll();
+            }
+
+            void scan(const Task& task) {
+                const ScanOptions& options = *_state.options;
+                const char *name = task.path.c_str() + task.nameOffset;
+
+                int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+                int fd;
+                if (task.parent) {
+                    fd = openat(dirfd(task.parent->dir), name, flags | O_NOFOLLOW);
+                } else {
+                    // The root may itself be a symlink; nothing below it is followed.
+                    fd = open(task.path.c_str(), task.depth == 0 ? flags : flags | O_NOFOLLOW);
+                }
+                if (fd < 0) {
+                    _state.errors.fetch_add(1);
+                    return;
+                }
+                DIR *dir = fdopendir(fd);
+                if (!dir) {
+                    close(fd);
+                    _state.errors.fetch_add(1);
+                    return;
+                }
+
+                std::vector<Task> children;
+                readEntries(dir, task.path, task.depth, options, [&](Entry&& out) {
+                    if (out.type == EntryType::Directory) {
+                        _state.directories.fetch_add(1);
+                        if (task.depth < options.maxDepth) {
+                            children.push_back(Task{nullptr, out.path, out.nameOffset, task.depth + 1});
+                        }
+                    } else {
+                        _state.files.fetch_add(1);
+                    }
+
+                    _batch.push_back(std::move(out));
+                    if (_batch.size() >= options.batchSize) flush();
+                });
+
+                if (children.empty()) {
+                    closedir(dir);
+                    return;
+                }
+                if (_state.openHandles.fetch_add(1) < kMaxOpenHandles) {
+                    std::shared_ptr<DirectoryHandle> handle(new DirectoryHandle{dir, &_state});
+                    for (Task& child : children) child.parent = handle;
+                } else {
+                    _state.openHandles.fetch_sub(1);
+                    closedir(dir);
+                }
+                push(children);
+            }
+
+            void flush() {
+                if (_batch.empty()) return;
+                {
+                    std::lock_guard<std::mutex> lock(_state.handlerMutex);
+                    if (!_state.stop.load() && !(*_state.handler)(_batch.data(), _batch.size())) {
+                        _state.stop.store(true);
+                    }
+                }
+                _batch.clear();
+                if (_state.stop.load()) wakeAll();
+            }
+
+            State& _state;
+            size_t _slot;
+            std::vector<Entry> _batch;
+        };
+    }
+
+    ScanResult scanDirectory(const std::string& root, const ScanOptions& options,
+                             const ScanBatchHandler& handler, MicroCore::ThreadPool& pool) {
+        ScanResult result;
+        if (root.empty()) return result;
+
+        size_t helpers = pool.size();
+        auto state = std::make_shared<State>(helpers + 1);
+        state->options = &options;
+        state->handler = &handler;
+
+        state->pending.store(1);
+        state->queues[0].tasks.push_back(Task{nullptr, root, 0, 0});
+
+        for (size_t h = 0; h < helpers; h++) {
+            pool.submit([state] {
+                state->active.fetch_add(1);
+                if (!state->finished.load()) {
+                    Worker(*state, state->nextSlot.fetch_add(1)).run();
+                }
+                if (state->active.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(state->doneMutex);
+                    state->doneCV.notify_all();
+                }
+            });
+        }
+        Worker(*state, 0).run();
+
+        // Pending work is either done or abandoned; wait for helpers still running.
+        state->finished.store(true);
+        {
+            std::unique_lock<std::mutex> lock(state->doneMutex);
+            state->doneCV.wait(lock, [&] { return state->active.load() == 0; });
+        }
+
+        // Abandoned tasks hold parent handles; release them before the caller returns.
+        for (WorkerQueue& queue : state->queues) {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.clear();
+        }
+
+        result.files = state->files.load();
+        result.directories = state->directories.load();
+        result.errors = state->errors.load();
+        result.cancelled = state->stop.load();
+        return result;
+    }
+
+    bool listDirectory(const std::string& path, const ScanOptions& options, std::vector<Entry>& out) {
+        DIR *dir = opendir(path.c_str());
+        if (!dir) return false;
+        readEntries(dir, path, 0, options, [&](Entry&& entry) {
+            out.push_back(std::move(entry));
+        });
+        closedir(dir);
+        return true;
+    }
+}
@@ -0,0 +1,86 @@
+//
+//  MicroDirectoryScanner.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroThreadPool.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - MicroFiles (C++)
+// Recursive directory scanner for whole-workspace crawls.
+//
+// Every directory is one task. Each worker keeps its own deque: it pushes the
+// subdirectories it finds and pops the newest (depth first, so parent handles
+// are released quickly), while idle workers steal the oldest task of another
+// worker, which tends to be the largest unexplored subtree.
+//
+// Directories are opened with openat() relative to their parent's descriptor and
+// entries are only stat'ed (fstatat, relative to the same descriptor) when
+// d_type does not already answer the question or when the caller asks for sizes
+// and times. Results are streamed in batches rather than collected.
+
+namespace MicroFiles {
+
+    enum class EntryType : uint8_t {
+        File,
+        Directory,
+        Symlink, // Never followed; see Entry::linksToDirectory
+        Other    // Sockets, devices, FIFOs
+    };
+
+    struct Entry {
+        std::string path;     // Root joined with the relative path
+        uint32_t nameOffset;  // Start of the last component in `path`
+        uint32_t depth;       // 0 for the root's direct children
+        EntryType type;
+        bool linksToDirectory; // Symlink whose target is a directory
+        uint64_t size;        // Only with ScanOptions::statEntries
+        int64_t mtime;        // Nanoseconds since the epoch; only with statEntries
+
+        std::string_view name() const { return std::string_view(path).substr(nameOffset); }
+    };
+
+    struct ScanOptions {
+        bool includeHidden = false;   // Names starting with '.'
+        bool statEntries = false;     // Fill size and mtime for every entry
+        uint32_t maxDepth = UINT32_MAX; // Deepest level reported; 0: the root's children only
+        size_t batchSize = 512;
+
+        /// Optional. Entries for which this returns true are neither reported nor,
+        /// for directories, descended into. Called concurrently from the workers.
+        std::function<bool(std::string_view path, bool isDirectory)> exclude;
+    };
+
+    struct ScanResult {
+        size_t files = 0;        // Every non-directory entry reported
+        size_t directories = 0;
+        size_t errors = 0;       // Directories that could not be opened or read
+        bool cancelled = false;
+    };
+
+    /// Batch callback. Calls are serialized, but come from the pool's threads in no
+    /// particular order; a directory's entries may be split across batches.
+    /// Return false to stop the scan.
+    using ScanBatchHandler = std::function<bool(const Entry *entries, size_t count)>;
+
+    /// Crawls everything below `root` (not `root` itself). Blocks until the scan is
+    /// finished or cancelled. The calling thread takes part, so it is safe to call
+    /// from inside a pool task.
+    ScanResult scanDirectory(const std::string& root, const ScanOptions& options,
+                             const ScanBatchHandler& handler,
+                             MicroCore::ThreadPool& pool = MicroCore::ThreadPool::shared());
+
+    /// Appends the entries directly inside `path` (depth 0) to `out`, on the calling
+    /// thread. Returns false if the directory cannot be opened.
+    bool listDirectory(const std::string& path, const ScanOptions& options, std::vector<Entry>& out);
+}
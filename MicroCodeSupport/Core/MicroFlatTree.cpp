@@ -0,0 +1,348 @@
+//
+//  MicroFlatTree.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroFlatTree.h"
+#include "MicroNaturalSort.h"
+
+#include <algorithm>
+
+namespace MicroFiles {
+
+    namespace {
+
+        // Names of released nodes are reclaimed once they make up half the pool.
+        constexpr size_t kMinCompactBytes = 64 * 1024;
+
+        bool relativeTo(std::string_view path, std::string_view directory, std::string_view& relative) {
+            if (path.size() <= directory.size() || path.compare(0, directory.size(), directory) != 0) return false;
+            if (directory.back() == '/') {
+                relative = path.substr(directory.size());
+                return true;
+            }
+            if (path[directory.size()] != '/') return false;
+            relative = path.substr(directory.size() + 1);
+            return true;
+        }
+    }
+
+    FlatTree::FlatTree(std::string root) : _root(std::move(root)) {
+        while (_root.size() > 1 && _root.back() == '/') _root.pop_back();
+        _nodes.push_back(Node{kNone, 0, 0, 0, 0, 0, 0, true});
+        _directories.emplace_back();
+    }
+
+    // MARK: - Rows
+
+    FlatTree::Row FlatTree::row(uint32_t index) const {
+        if (index >= _rows.size()) return Row{std::string_view(), 0, 0, false, false, false};
+        const VisibleRow& visible = _rows[index];
+        const Node& node = _nodes[visible.node];
+        bool isDirectory = node.directory != kNone;
+        return Row{nameOf(visible.node), visible.depth, node.expanded ? node.visible : 0, isDirectory,
+                   node.expanded, isDirectory && _directories[node.directory].loaded};
+    }
+
+    std::string FlatTree::path(uint32_t index) const {
+        if (index >= _rows.size()) return std::string();
+        std::vector<uint32_t> chain;
+        for (uint32_t node = _rows[index].node; node != kRootNode; node = _nodes[node].parent) {
+            chain.push_back(node);
+        }
+        std::string result = _root;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            if (result.empty() || result.back() != '/') result.push_back('/');
+            result.append(nameOf(*it));
+        }
+        return result;
+    }
+
+    uint32_t FlatTree::rowOf(std::string_view path) const {
+        uint32_t node = findNode(path);
+        return node == kNone ? kNoRow : rowOfNode(node);
+    }
+
+    uint32_t FlatTree::parentRow(uint32_t index) const {
+        if (index >= _rows.size()) return kNoRow;
+        uint32_t parent = _nodes[_rows[index].node].parent;
+        return parent == kRootNode ? kNoRow : rowOfNode(parent);
+    }
+
+    // MARK: - Lookup
+
+    uint32_t FlatTree::findChild(uint32_t directory, std::string_view name) const {
+        uint32_t index = _nodes[directory].directory;
+        if (index == kNone) return kNone;
+        const std::vector<uint32_t>& byName = _directories[index].byName;
+        auto it = std::lower_bound(byName.begin(), byName.end(), name, [&](uint32_t child, std::string_view value) {
+            return nameOf(child) < value;
+        });
+        return it != byName.end() && nameOf(*it) == name ? *it : kNone;
+    }
+
+    uint32_t FlatTree::findNode(std::string_view path) const {
+        while (path.size() > 1 && path.back() == '/') path.remove_suffix(1);
+        if (path == _root) return kRootNode;
+        std::string_view relative;
+        if (!relativeTo(path, _root, relative)) return kNone;
+
+        uint32_t node = kRootNode;
+        while (!relative.empty() && node != kNone) {
+            size_t slash = relative.find('/');
+            std::string_view component = relative.substr(0, slash);
+            if (!component.empty()) node = findChild(node, component);
+            relative = slash == std::string_view::npos ? std::string_view() : relative.substr(slash + 1);
+        }
+        return node;
+    }
+
+    bool FlatTree::precedes(uint32_t a, uint32_t b) const {
+        // Display order is preorder: an ancestor comes first, otherwise the order of
+        // the two siblings below the closest common ancestor decides.
+        while (_nodes[a].depth > _nodes[b].depth) {
+            a = _nodes[a].parent;
+            if (a == b) return false;
+        }
+        while (_nodes[b].depth > _nodes[a].depth) {
+            b = _nodes[b].parent;
+            if (a == b) return true;
+        }
+        if (a == b) return false;
+        while (_nodes[a].parent != _nodes[b].parent) {
+            a = _nodes[a].parent;
+            b = _nodes[b].parent;
+        }
+        return _nodes[a].order < _nodes[b].order;
+    }
+
+    bool FlatTree::isShown(uint32_t node) const {
+        for (uint32_t parent = _nodes[node].parent; parent != kRootNode; parent = _nodes[parent].parent) {
+            if (!_nodes[parent].expanded) return false;
+        }
+        return true;
+    }
+
+    uint32_t FlatTree::rowOfNode(uint32_t node) const {
+        if (node == kRootNode || !isShown(node)) return kNoRow;
+        auto it = std::lower_bound(_rows.begin(), _rows.end(), node, [&](const VisibleRow& row, uint32_t value) {
+            return precedes(row.node, value);
+        });
+        return it != _rows.end() && it->node == node ? (uint32_t)(it - _rows.begin()) : kNoRow;
+    }
+
+    bool FlatTree::isLoaded(std::string_view directory) const {
+        uint32_t node = findNode(directory);
+        return node != kNone && _nodes[node].directory != kNone && _directories[_nodes[node].directory].loaded;
+    }
+
+    // MARK: - Nodes
+
+    uint32_t FlatTree::newNode(uint32_t parent, std::string_view name, bool isDirectory) {
+        uint32_t directory = kNone;
+        if (isDirectory) {
+            if (_freeDirectories.empty()) {
+                directory = (uint32_t)_directories.size();
+                _directories.emplace_back();
+            } else {
+                directory = _freeDirectories.back();
+                _freeDirectories.pop_back();
+            }
+        }
+
+        Node node{parent, directory, (uint32_t)_names.size(), (uint32_t)name.size(), 0, 0,
+                  _nodes[parent].depth + 1, false};
+        _names.append(name);
+        if (_freeNodes.empty()) {
+            _nodes.push_back(node);
+            return (uint32_t)_nodes.size() - 1;
+        }
+        uint32_t index = _freeNodes.back();
+        _freeNodes.pop_back();
+        _nodes[index] = node;
+        return index;
+    }
+
+    void FlatTree::releaseSubtree(uint32_t node) {
+        std::vector<uint32_t> stack{node};
+        while (!stack.empty()) {
+            uint32_t current = stack.back();
+            stack.pop_back();
+            Node& record = _nodes[current];
+            if (record.directory != kNone) {
+                Directory& directory = _directories[record.directory];
+                stack.insert(stack.end(), directory.children.begin(), directory.children.end());
+                directory = Directory();
+                _freeDirectories.push_back(record.directory);
+            }
+            _deadNameBytes += record.nameLength;
+            record.depth = kNone; // Marks the record free
+            _freeNodes.push_back(current);
+        }
+    }
+
+    void FlatTree::compactNames() {
+        if (_deadNameBytes < kMinCompactBytes || _deadNameBytes * 2 < _names.size()) return;
+        std::string names;
+        names.reserve(_names.size() - _deadNameBytes);
+        for (Node& node : _nodes) {
+            if (node.depth == kNone) continue;
+            uint32_t offset = (uint32_t)names.size();
+            names.append(_names, node.nameOffset, node.nameLength);
+            node.nameOffset = offset;
+        }
+        _names.swap(names);
+        _deadNameBytes = 0;
+    }
+
+    // MARK: - Changes
+
+    void FlatTree::adjustVisible(uint32_t node, int64_t delta) {
+        // A collapsed directory still counts its rows, but shows as one row to its
+        // parent, so the change stops there.
+        for (; node != kNone; node = _nodes[node].parent) {
+            _nodes[node].visible = (uint32_t)((int64_t)_nodes[node].visible + delta);
+            if (!_nodes[node].expanded) break;
+        }
+    }
+
+    void FlatTree::appendRows(uint32_t node, std::vector<VisibleRow>& out) const {
+        struct Frame {
+            const std::vector<uint32_t> *children;
+            size_t next;
+        };
+        std::vector<Frame> stack;
+        stack.push_back({&_directories[_nodes[node].directory].children, 0});
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            if (frame.next == frame.children->size()) {
+                stack.pop_back();
+                continue;
+            }
+            uint32_t child = (*frame.children)[frame.next++];
+            const Node& record = _nodes[child];
+            out.push_back({child, record.depth - 1});
+            if (record.expanded && record.directory != kNone) {
+                stack.push_back({&_directories[record.directory].children, 0});
+            }
+        }
+    }
+
+    FlatTree::RowChange FlatTree::setExpandedNode(uint32_t node, bool expanded) {
+        if (node == kNone || node == kRootNode) return RowChange();
+        Node& record = _nodes[node];
+        if (record.directory == kNone || record.expanded == expanded) return RowChange();
+
+        uint32_t row = rowOfNode(node);
+        uint32_t count = record.visible;
+        record.expanded = expanded;
+        adjustVisible(record.parent, expanded ? (int64_t)count : -(int64_t)count);
+        if (row == kNoRow) return RowChange();
+
+        auto first = _rows.begin() + row + 1;
+        if (expanded) {
+            std::vector<VisibleRow> rows;
+            rows.reserve(count);
+            appendRows(node, rows);
+            _rows.insert(first, rows.begin(), rows.end());
+            return RowChange{row + 1, 0, count};
+        }
+        _rows.erase(first, first + count);
+        return RowChange{row + 1, count, 0};
+    }
+
+    FlatTree::RowChange FlatTree::expand(uint32_t index) {
+        return index < _rows.size() ? setExpandedNode(_rows[index].node, true) : RowChange();
+    }
+
+    FlatTree::RowChange FlatTree::collapse(uint32_t index) {
+        return index < _rows.size() ? setExpandedNode(_rows[index].node, false) : RowChange();
+    }
+
+    FlatTree::RowChange FlatTree::setExpanded(std::string_view directory, bool expanded) {
+        return setExpandedNode(findNode(directory), expanded);
+    }
+
+    bool FlatTree::setChildren(std::string_view path, std::vector<Child> children, RowChange *change) {
+        if (change) *change = RowChange();
+        uint32_t node = findNode(path);
+        if (node == kNone || _nodes[node].directory == kNone) return false;
+        uint32_t directory = _nodes[node].directory;
+
+        // Where the rows go, found before the old children are released.
+        bool showsRows = node == kRootNode || (_nodes[node].expanded && isShown(node));
+        uint32_t firstRow = node == kRootNode ? 0 : (showsRows ? rowOfNode(node) + 1 : kNoRow);
+        uint32_t oldVisible = _nodes[node].visible;
+
+        // Keep every old child whose name and kind are unchanged; `order` is still
+        // its old position.
+        std::vector<uint32_t> previous = _directories[directory].children;
+        std::vector<bool> reused(previous.size(), false);
+        std::vector<uint32_t> matched(children.size(), kNone);
+        for (size_t i = 0; i < children.size(); i++) {
+            uint32_t existing = findChild(node, children[i].name);
+            if (existing == kNone || (_nodes[existing].directory != kNone) != children[i].isDirectory) continue;
+            uint32_t position = _nodes[existing].order;
+            if (reused[position]) continue; // Duplicate name
+            reused[position] = true;
+            matched[i] = existing;
+        }
+        for (size_t i = 0; i < previous.size(); i++) {
+            if (!reused[i]) releaseSubtree(previous[i]);
+        }
+        for (size_t i = 0; i < children.size(); i++) {
+            if (matched[i] == kNone) matched[i] = newNode(node, children[i].name, children[i].isDirectory);
+        }
+
+        std::vector<std::string_view> names;
+        std::vector<bool> directories;
+        names.reserve(children.size());
+        directories.reserve(children.size());
+        for (const Child& child : children) {
+            names.emplace_back(child.name);
+            directories.push_back(child.isDirectory);
+        }
+        std::vector<uint32_t> order = naturalOrder(names, &directories, &MicroCore::ThreadPool::shared());
+
+        Directory& entries = _directories[directory];
+        entries.children.resize(children.size());
+        uint32_t visible = 0;
+        for (uint32_t i = 0; i < order.size(); i++) {
+            uint32_t child = matched[order[i]];
+            entries.children[i] = child;
+            _nodes[child].order = i;
+            visible += 1 + (_nodes[child].expanded ? _nodes[child].visible : 0);
+        }
+        entries.byName = entries.children;
+        std::sort(entries.byName.begin(), entries.byName.end(), [&](uint32_t a, uint32_t b) {
+            return nameOf(a) < nameOf(b);
+        });
+        entries.loaded = true;
+
+        _nodes[node].visible = visible;
+        if (_nodes[node].expanded && node != kRootNode) {
+            adjustVisible(_nodes[node].parent, (int64_t)visible - (int64_t)oldVisible);
+        }
+
+        if (showsRows) {
+            std::vector<VisibleRow> rows;
+            rows.reserve(visible);
+            appendRows(node, rows);
+            auto first = _rows.begin() + firstRow;
+            size_t overlap = std::min<size_t>(oldVisible, rows.size());
+            std::copy(rows.begin(), rows.begin() + overlap, first);
+            if (rows.size() > oldVisible) {
+                _rows.insert(first + overlap, rows.begin() + overlap, rows.end());
+            } else {
+                _rows.erase(first + overlap, first + oldVisible);
+            }
+            if (change) *change = RowChange{firstRow, oldVisible, visible};
+        }
+
+        compactNames();
+        return true;
+    }
+}
@@ -0,0 +1,145 @@
+//
+//  MicroFlatTree.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - MicroFiles (C++)
+// Flattened model of the file navigator: the visible rows of an outline are one
+// contiguous array in display order, so row N is an index rather than a walk.
+//
+// Behind the rows is a node table (one record per loaded entry, children by
+// index, names in a shared pool). Every node keeps the number of rows its
+// subtree shows when expanded, also while it is collapsed, so expanding or
+// collapsing splices exactly that many rows into or out of the array and only
+// the counts of its expanded ancestors change. Nested expansion state survives a
+// collapse, as in NSOutlineView.
+//
+// Siblings are in Finder order, directories first. Path lookup descends by name
+// (binary search per level); the row of a node is then found by binary search
+// over the rows, which are sorted in tree order.
+
+namespace MicroFiles {
+
+    class FlatTree {
+    public:
+        static constexpr uint32_t kNoRow = UINT32_MAX;
+
+        struct Child {
+            std::string name;
+            bool isDirectory;
+        };
+
+        struct Row {
+            std::string_view name; // Valid until the tree changes
+            uint32_t depth;        // 0 for the root's children
+            uint32_t descendants;  // Rows shown below this one; 0 unless expanded
+            bool isDirectory;
+            bool isExpanded;
+            bool isLoaded;         // Children known; an expanded, unloaded row shows none
+        };
+
+        /// A splice of the row array: `removed` rows at `row` were replaced by
+        /// `inserted` rows. `row` is kNoRow when nothing visible changed.
+        struct RowChange {
+            uint32_t row = kNoRow;
+            uint32_t removed = 0;
+            uint32_t inserted = 0;
+        };
+
+        /// An empty tree of `root`; its children become rows once set.
+        explicit FlatTree(std::string root);
+
+        const std::string& root() const { return _root; }
+        size_t rowCount() const { return _rows.size(); }
+
+        /// O(1).
+        Row row(uint32_t index) const;
+        std::string path(uint32_t index) const;
+
+        /// Row of the entry at `path`, or kNoRow if it is not loaded or hidden in a
+        /// collapsed directory. O(depth · log rows).
+        uint32_t rowOf(std::string_view path) const;
+
+        /// Row of the directory containing row `index`, or kNoRow at depth 0.
+        uint32_t parentRow(uint32_t index) const;
+
+        /// Replaces the children of `directory` (the root or a loaded directory).
+        /// Children that keep their name and kind keep their subtrees and expansion
+        /// state. Returns false if `directory` is not in the tree.
+        bool setChildren(std::string_view directory, std::vector<Child> children, RowChange *change = nullptr);
+
+        /// Whether the children of `directory` have been set.
+        bool isLoaded(std::string_view directory) const;
+
+        /// Show or hide the children of row `index`. No-ops for files and rows
+        /// already in that state.
+        RowChange expand(uint32_t index);
+        RowChange collapse(uint32_t index);
+
+        /// Expansion by path, also for directories inside collapsed ones.
+        RowChange setExpanded(std::string_view directory, bool expanded);
+
+    private:
+        static constexpr uint32_t kNone = UINT32_MAX;
+        static constexpr uint32_t kRootNode = 0;
+
+        struct Node {
+            uint32_t parent;
+            uint32_t directory;    // Index into _directories; kNone for files
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            uint32_t order;        // Position among its siblings
+            uint32_t visible;      // Rows below this node when it is expanded
+            uint32_t depth;
+            bool expanded;
+        };
+
+        struct Directory {
+            std::vector<uint32_t> children; // Display order
+            std::vector<uint32_t> byName;   // Bytewise name order, for lookup
+            bool loaded = false;
+        };
+
+        struct VisibleRow {
+            uint32_t node;
+            uint32_t depth;
+        };
+
+        std::string_view nameOf(uint32_t node) const {
+            return std::string_view(_names).substr(_nodes[node].nameOffset, _nodes[node].nameLength);
+        }
+
+        uint32_t findNode(std::string_view path) const;
+        uint32_t findChild(uint32_t directory, std::string_view name) const;
+        uint32_t rowOfNode(uint32_t node) const;
+        bool precedes(uint32_t a, uint32_t b) const;
+        bool isShown(uint32_t node) const;
+
+        uint32_t newNode(uint32_t parent, std::string_view name, bool isDirectory);
+        void releaseSubtree(uint32_t node);
+        void compactNames();
+
+        void adjustVisible(uint32_t node, int64_t delta);
+        void appendRows(uint32_t node, std::vector<VisibleRow>& out) const;
+        RowChange setExpandedNode(uint32_t node, bool expanded);
+
+        std::string _root;
+        std::vector<Node> _nodes;
+        std::vector<Directory> _directories;
+        std::vector<uint32_t> _freeNodes;
+        std::vector<uint32_t> _freeDirectories;
+        std::string _names;
+        size_t _deadNameBytes = 0;
+        std::vector<VisibleRow> _rows;
+    };
+}
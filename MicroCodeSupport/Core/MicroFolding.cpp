@@ -0,0 +1,356 @@
+//
+//  MicroFolding.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroFolding.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace MicroFolding {
+
+    using MicroLexer::IncrementalLexer;
+    using MicroLexer::State;
+    using MicroLexer::Token;
+    using MicroLexer::TokenType;
+
+    namespace {
+        template <typename T>
+        void spliceLines(std::vector<T>& vec, const MicroLexer::EditResult& edit) {
+            auto first = vec.begin() + edit.firstLine;
+            if (edit.newLineCount > edit.oldLineCount) {
+                vec.insert(first + edit.oldLineCount, edit.newLineCount - edit.oldLineCount, T());
+            } else {
+                vec.erase(first + edit.newLineCount, first + edit.oldLineCount);
+            }
+        }
+
+        bool opensRubyBlock(std::string_view word, bool statementStart) {
+            if (word == "def" || word == "class" || word == "module" || word == "do" || word == "begin" || word == "case") {
+                return true;
+            }
+            // if/unless/while/until also work as trailing modifiers (`x if y`).
+            return statementStart && (word == "if" || word == "unless" || word == "while" || word == "until" || word == "for");
+        }
+
+        bool opensJuliaBlock(std::string_view word, std::string_view previous) {
+            if (word == "type") {
+                return previous == "abstract" || previous == "primitive";
+            }
+            return word == "function" || word == "macro" || word == "module" || word == "baremodule" || word == "struct" ||
+                   word == "quote" || word == "let" || word == "begin" || word == "if" || word == "for" ||
+                   word == "while" || word == "try" || word == "do";
+        }
+    }
+
+    Engine::Engine(const std::string& language, uint32_t tabSize)
+        : _language(MicroLexer::LanguageSpec::canonicalLanguage(language)),
+          _tabSize(tabSize ? tabSize : 4),
+          _indentUnit(_tabSize) {
+        if (_language == "python") {
+            _mode = Mode::Indentation;
+        } else if (_language == "ruby" || _language == "julia") {
+            _mode = Mode::EndKeyword;
+        } else {
+            _mode = Mode::Braces;
+        }
+    }
+
+    // MARK: - Per-line facts
+
+    void Engine::computeLine(const IncrementalLexer& lexer, size_t line) {
+        const std::string& source = lexer.source();
+        const size_t lineStart = lexer.lineStart(line);
+        const size_t lineEnd = lexer.lineEnd(line);
+        const bool continued = line > 0 && lexer.lineEndState(line - 1) != State::Normal;
+
+        // 1. Indent width (tabs advance to the next tab stop)
+        uint16_t indent = kNoIndent;
+        if (!continued) {
+            uint32_t columns = 0;
+            size_t i = lineStart;
+            for (; i < lineEnd && (source[i] == ' ' || source[i] == '\t' || source[i] == '\r'); i++) {
+                if (source[i] == ' ') columns++;
+                else if (source[i] == '\t') columns += _tabSize - columns % _tabSize;
+            }
+            if (i < lineEnd) {
+                indent = static_cast<uint16_t>(std::min<uint32_t>(columns, kNoIndent - 1));
+            }
+        }
+        _indent[line] = indent;
+
+        // 2. `end` blocks: cancel openers against `end`s within the line
+        if (_mode != Mode::EndKeyword) {
+            return;
+        }
+        const bool ruby = (_language == "ruby");
+        EndResidue residue = {0, 0};
+        int depth = 0;
+        bool statementStart = true;
+        bool loopOpened = false; // Ruby `while x do`: the `do` is part of the loop
+        std::string_view previous;
+        for (size_t i = lexer.firstTokenOfLine(line); i < lexer.firstTokenOfLine(line + 1); i++) {
+            const Token& t = lexer.tokens()[i];
+            std::string_view text(source.data() + t.start, t.length);
+            if (t.type == TokenType::Comment || t.type == TokenType::String) {
+                statementStart = false;
+                continue;
+            }
+            if (t.type == TokenType::Punctuation) {
+                char c = text[0];
+                if (c == '(' || c == '[' || c == '{') depth++;
+                else if ((c == ')' || c == ']' || c == '}') && depth > 0) depth--;
+                statementStart = (c == ';' || c == '=');
+                previous = text;
+                continue;
+            }
+            if (depth == 0) {
+                if (text == "end") {
+                    if (residue.opens > 0) residue.opens--;
+                    else if (residue.closes < UINT16_MAX) residue.closes++;
+                } else if (ruby ? opensRubyBlock(text, statementStart) : opensJuliaBlock(text, previous)) {
+                    bool isLoop = ruby && (text == "while" || text == "until" || text == "for");
+                    if (!(ruby && text == "do" && loopOpened) && residue.opens < UINT16_MAX) {
+                        residue.opens++;
+                    }
+                    loopOpened = isLoop;
+                }
+            }
+            statementStart = false;
+            previous = text;
+        }
+        _ends[line] = residue;
+    }
+
+    void Engine::reset(const IncrementalLexer& lexer) {
+        const size_t lines = lexer.lineCount();
+        _indent.assign(lines, kNoIndent);
+        _guide.assign(lines, 0);
+        if (_mode == Mode::EndKeyword) {
+            _ends.assign(lines, EndResidue{0, 0});
+        }
+        for (size_t line = 0; line < lines; line++) {
+            computeLine(lexer, line);
+        }
+        detectIndentUnit();
+        updateGuides(0, lines - 1);
+        _foldsValid = false;
+    }
+
+    void Engine::applyEdit(const IncrementalLexer& lexer, const MicroLexer::EditResult& edit) {
+        if (_indent.size() != lexer.lineCount() - edit.lineDelta) {
+            reset(lexer);
+            return;
+        }
+        spliceLines(_indent, edit);
+        spliceLines(_guide, edit);
+        if (_mode == Mode::EndKeyword) {
+            spliceLines(_ends, edit);
+        }
+        for (size_t i = 0; i < edit.newLineCount; i++) {
+            computeLine(lexer, edit.firstLine + i);
+        }
+        updateGuides(edit.firstLine, edit.firstLine + edit.newLineCount - 1);
+        _foldsValid = false;
+    }
+
+    void Engine::detectIndentUnit() {
+        // Most common indent increase between consecutive code lines.
+        size_t votes[9] = {};
+        uint16_t previous = 0;
+        for (uint16_t indent : _indent) {
+            if (indent == kNoIndent) continue;
+            if (indent > previous && indent - previous <= 8) {
+                votes[indent - previous]++;
+            }
+            previous = indent;
+        }
+        size_t best = 0;
+        for (uint32_t unit : {2u, 3u, 4u, 8u}) {
+            if (votes[unit] > best) {
+                best = votes[unit];
+                _indentUnit = unit;
+            }
+        }
+        if (best == 0) {
+            _indentUnit = _tabSize;
+        }
+    }
+
+    uint8_t Engine::levelOf(uint16_t indent) const {
+        return static_cast<uint8_t>(std::min<uint32_t>(indent / _indentUnit, UINT8_MAX));
+    }
+
+    void Engine::updateGuides(size_t firstLine, size_t lastLine) {
+        // Widen to the code lines around the range: blank lines between them
+        // depend on both neighbours.
+        if (firstLine > 0) firstLine--;
+        while (firstLine > 0 && _indent[firstLine] == kNoIndent) firstLine--;
+        if (lastLine + 1 < _indent.size()) lastLine++;
+        while (lastLine + 1 < _indent.size() && _indent[lastLine] == kNoIndent) lastLine++;
+
+        size_t line = firstLine;
+        uint8_t above = (_indent[line] == kNoIndent) ? 0 : levelOf(_indent[line]);
+        while (line <= lastLine) {
+            if (_indent[line] != kNoIndent) {
+                above = _guide[line] = levelOf(_indent[line]);
+                line++;
+                continue;
+            }
+            size_t next = line;
+            while (next <= lastLine && _indent[next] == kNoIndent) next++;
+            uint8_t below = (next <= lastLine) ? levelOf(_indent[next]) : 0;
+            std::fill(_guide.begin() + line, _guide.begin() + next, std::min(above, below));
+            line = next;
+        }
+    }
+
+    void Engine::guidesInLines(size_t firstLine, size_t lastLine, std::vector<uint8_t>& out) const {
+        out.clear();
+        if (_guide.empty() || firstLine >= _guide.size()) return;
+        lastLine = std::min(lastLine, _guide.size() - 1);
+        out.assign(_guide.begin() + firstLine, _guide.begin() + lastLine + 1);
+    }
+
+    // MARK: - Folds
+
+    void Engine::rebuildFolds(const IncrementalLexer& lexer, const MicroParser::Engine& parser) {
+        _folds.clear();
+        const size_t lines = _indent.size();
+        auto addFold = [this](size_t start, size_t end, FoldKind kind) {
+            if (end > start) {
+                _folds.push_back({static_cast<uint32_t>(start), static_cast<uint32_t>(end), kind, -1});
+            }
+        };
+
+        // 1. Blocks
+        switch (_mode) {
+            case Mode::Braces:
+                for (const auto& scope : parser.scopes) {
+                    if (scope.kind == MicroParser::ScopeKind::Global || scope.isEmpty() ||
+                        scope.endLine == std::numeric_limits<int64_t>::max()) {
+                        continue;
+                    }
+                    addFold(lexer.lineForOffset(static_cast<size_t>(scope.startLine)),
+                            lexer.lineForOffset(static_cast<size_t>(scope.endLine - 1)), FoldKind::Block);
+                }
+                break;
+
+            case Mode::Indentation: {
+                // A block runs until the next code line indented no deeper than its
+                // header; trailing blank lines stay outside the fold.
+                _stack.clear();
+                size_t lastContent = 0;
+                for (size_t line = 0; line < lines; line++) {
+                    uint16_t indent = _indent[line];
+                    bool continued = line > 0 && lexer.lineEndState(line - 1) != State::Normal;
+                    if (indent == kNoIndent) {
+                        if (continued) lastContent = line;
+                        continue;
+                    }
+                    while (!_stack.empty() && _indent[_stack.back()] >= indent) {
+                        addFold(_stack.back(), lastContent, FoldKind::Block);
+                        _stack.pop_back();
+                    }
+                    _stack.push_back(static_cast<uint32_t>(line));
+                    lastContent = line;
+                }
+                while (!_stack.empty()) {
+                    addFold(_stack.back(), lastContent, FoldKind::Block);
+                    _stack.pop_back();
+                }
+                break;
+            }
+
+            case Mode::EndKeyword:
+                _stack.clear();
+                for (size_t line = 0; line < lines; line++) {
+                    for (uint16_t i = 0; i < _ends[line].closes && !_stack.empty(); i++) {
+                        addFold(_stack.back(), line, FoldKind::Block);
+                        _stack.pop_back();
+                    }
+                    _stack.insert(_stack.end(), _ends[line].opens, static_cast<uint32_t>(line));
+                }
+                break;
+        }
+
+        // 2. Block comments and multi-line strings (only once they are closed)
+        for (size_t line = 0; line < lines; line++) {
+            if (lexer.lineEndState(line) == State::Normal || (line > 0 && lexer.lineEndState(line - 1) != State::Normal)) {
+                continue;
+            }
+            size_t end = line + 1;
+            while (end < lines && lexer.lineEndState(end) != State::Normal) end++;
+            if (end < lines) {
+                addFold(line, end, FoldKind::Comment);
+            }
+            line = end;
+        }
+
+        // 3. Sort outer-first, keep one fold per start line, link parents.
+        std::sort(_folds.begin(), _folds.end(), [](const FoldingRange& a, const FoldingRange& b) {
+            if (a.startLine != b.startLine) return a.startLine < b.startLine;
+            if (a.endLine != b.endLine) return a.endLine > b.endLine;
+            return a.kind > b.kind; // A docstring is a comment fold, not an indented block
+        });
+        _folds.erase(std::unique(_folds.begin(), _folds.end(), [](const FoldingRange& a, const FoldingRange& b) {
+            return a.startLine == b.startLine;
+        }), _folds.end());
+
+        _stack.clear();
+        for (size_t i = 0; i < _folds.size(); i++) {
+            FoldingRange& fold = _folds[i];
+            while (!_stack.empty() && _folds[_stack.back()].endLine < fold.startLine) {
+                _stack.pop_back();
+            }
+            if (!_stack.empty()) {
+                const FoldingRange& parent = _folds[_stack.back()];
+                fold.parent = static_cast<int32_t>(_stack.back());
+                fold.endLine = std::min(fold.endLine, parent.endLine); // Heuristic ranges may overlap
+            }
+            _stack.push_back(static_cast<uint32_t>(i));
+        }
+        _foldsValid = true;
+    }
+
+    const std::vector<FoldingRange>& Engine::folds(const IncrementalLexer& lexer, const MicroParser::Engine& parser) {
+        if (!_foldsValid) {
+            rebuildFolds(lexer, parser);
+        }
+        return _folds;
+    }
+
+    void Engine::foldsInLines(const IncrementalLexer& lexer, const MicroParser::Engine& parser,
+                              size_t firstLine, size_t lastLine, std::vector<FoldingRange>& out) {
+        out.clear();
+        const auto& all = folds(lexer, parser);
+        auto byStart = [](const FoldingRange& fold, size_t line) { return fold.startLine < line; };
+        size_t begin = static_cast<size_t>(std::lower_bound(all.begin(), all.end(), firstLine, byStart) - all.begin());
+
+        // Any fold enclosing firstLine is an ancestor of (or is) the last fold
+        // starting before it.
+        if (begin > 0) {
+            for (int32_t i = static_cast<int32_t>(begin) - 1; i >= 0; i = all[i].parent) {
+                if (all[i].endLine >= firstLine) {
+                    out.push_back(all[i]);
+                }
+            }
+            std::reverse(out.begin(), out.end());
+        }
+        for (size_t i = begin; i < all.size() && all[i].startLine <= lastLine; i++) {
+            out.push_back(all[i]);
+        }
+    }
+
+    size_t Engine::memoryFootprint() const {
+        return _indent.capacity() * sizeof(uint16_t)
+            + _guide.capacity()
+            + _ends.capacity() * sizeof(EndResidue)
+            + _folds.capacity() * sizeof(FoldingRange)
+            + _stack.capacity() * sizeof(uint32_t);
+    }
+}
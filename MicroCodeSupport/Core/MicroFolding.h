@@ -0,0 +1,108 @@
+//
+//  MicroFolding.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroIncrementalLexer.h"
+#include "MicroParser.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// MARK: - MicroFolding (C++)
+// Folding ranges and indentation guides for one document.
+//
+// Folds come from the MicroParser scope tree for brace languages, from indentation
+// for Python, and from `end`-terminated blocks for Ruby and Julia; multi-line
+// comments and strings fold everywhere. Per-line facts (indent width, `end`-block
+// residue) are the only part that reads text and are updated just for the lines
+// an edit relexed. The fold list is rebuilt from those facts on the next query.
+//
+// Folds nest properly and are kept sorted by start line with a parent link, so a
+// visible-range query is a binary search plus a walk up the enclosing folds.
+
+namespace MicroFolding {
+
+    enum class FoldKind : uint8_t {
+        Block,
+        Comment
+    };
+
+    struct FoldingRange {
+        uint32_t startLine;
+        uint32_t endLine; // Inclusive; for brace blocks, the line holding '}'
+        FoldKind kind;
+        int32_t parent;   // Index of the enclosing fold in folds(), or -1
+    };
+
+    class Engine {
+    public:
+        explicit Engine(const std::string& language, uint32_t tabSize = 4);
+
+        /// Recomputes the per-line facts of every line.
+        void reset(const MicroLexer::IncrementalLexer& lexer);
+
+        /// Recomputes the lines `edit` relexed; other lines are only renumbered.
+        void applyEdit(const MicroLexer::IncrementalLexer& lexer, const MicroLexer::EditResult& edit);
+
+        /// Call after every parse; brace folds come from the scope tree.
+        void scopesDidChange() { _foldsValid = false; }
+
+        /// All folds, sorted by start line (outer before inner on the same line).
+        const std::vector<FoldingRange>& folds(const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser);
+
+        /// Folds that start in, or enclose, lines [firstLine, lastLine]; enclosing
+        /// folds first, outermost first. O(log n + depth + results).
+        void foldsInLines(const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser,
+                          size_t firstLine, size_t lastLine, std::vector<FoldingRange>& out);
+
+        /// Indentation guide level (indent / indentUnit) of lines [firstLine, lastLine].
+        /// Blank lines take the smaller level of the nearest code lines around them.
+        void guidesInLines(size_t firstLine, size_t lastLine, std::vector<uint8_t>& out) const;
+
+        /// Indent step in columns, detected on reset() (2, 3, 4, 8 or the tab size).
+        uint32_t indentUnit() const { return _indentUnit; }
+
+        size_t memoryFootprint() const;
+
+    private:
+        enum class Mode : uint8_t {
+            Braces,
+            Indentation,
+            EndKeyword
+        };
+
+        /// Leading unmatched `end`s, then trailing unmatched block openers.
+        struct EndResidue {
+            uint16_t closes;
+            uint16_t opens;
+        };
+
+        static constexpr uint16_t kNoIndent = UINT16_MAX; // Blank line or inside a multi-line construct
+
+        void computeLine(const MicroLexer::IncrementalLexer& lexer, size_t line);
+        void detectIndentUnit();
+        void updateGuides(size_t firstLine, size_t lastLine);
+        uint8_t levelOf(uint16_t indent) const;
+        void rebuildFolds(const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser);
+
+        std::string _language;
+        Mode _mode;
+        uint32_t _tabSize;
+        uint32_t _indentUnit;
+
+        std::vector<uint16_t> _indent;  // Columns, or kNoIndent
+        std::vector<uint8_t> _guide;
+        std::vector<EndResidue> _ends;  // EndKeyword mode only
+
+        bool _foldsValid = false;
+        std::vector<FoldingRange> _folds;
+        std::vector<uint32_t> _stack; // Scratch for rebuildFolds()
+    };
+}
@@ -0,0 +1,349 @@
+//
+//  MicroFuzzy.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroFuzzy.h"
+
+#include <algorithm>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MICRO_FUZZY_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MICRO_FUZZY_NEON 1
+#endif
+
+namespace MicroFuzzy {
+
+    namespace {
+
+        constexpr int32_t kScoreMatch = 16;
+        constexpr int32_t kGapStart = -3;
+        constexpr int32_t kGapExtension = -1;
+        constexpr int32_t kBonusBoundary = 8;
+        constexpr int32_t kBonusCamel = 7;
+        constexpr int32_t kBonusConsecutive = 4;
+        constexpr int32_t kBonusFirstCharMultiplier = 2;
+        constexpr int32_t kBonusExactCase = 1;
+        constexpr int32_t kNoMatch = -1000000;
+
+        // Names per parallel chunk; large enough to amortize heap merging.
+        constexpr size_t kChunkSize = 16384;
+
+        inline char fold(char c) {
+            return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+        }
+
+        inline int bitFor(char c) {
+            unsigned char u = (unsigned char)fold(c);
+            if (u >= 'a' && u <= 'z') return u - 'a';
+            if (u >= '0' && u <= '9') return 26 + (u - '0');
+            if (u == '_') return 36;
+            if (u == ' ') return -1;
+            if (u >= 0x80) return 38;
+            return 37;
+        }
+
+        enum CharKind { KindOther, KindLower, KindUpper, KindDigit };
+
+        inline CharKind kindOf(char c) {
+            if (c >= 'a' && c <= 'z') return KindLower;
+            if (c >= 'A' && c <= 'Z') return KindUpper;
+            if (c >= '0' && c <= '9') return KindDigit;
+            return KindOther;
+        }
+
+        inline int32_t bonusAt(std::string_view name, size_t j) {
+            CharKind cur = kindOf(name[j]);
+            if (cur == KindOther) return 0;
+            if (j == 0) return kBonusBoundary;
+            CharKind prev = kindOf(name[j - 1]);
+            if (prev == KindOther) return kBonusBoundary;
+            if (prev == KindLower && cur == KindUpper) return kBonusCamel;
+            if (prev != KindDigit && cur == KindDigit) return kBonusCamel;
+            return 0;
+        }
+
+        inline bool isSubsequence(std::string_view name, std::string_view foldedQuery) {
+            size_t qi = 0;
+            for (size_t j = 0; j < name.size() && qi < foldedQuery.size(); j++) {
+                if (fold(name[j]) == foldedQuery[qi]) qi++;
+            }
+            return qi == foldedQuery.size();
+        }
+
+        /// Per-thread DP rows; sized once, reused for every candidate.
+        struct Scratch {
+            int32_t previous[kMaxNameLength + 1];
+            int32_t current[kMaxNameLength + 1];
+        };
+
+        Scratch& scratch() {
+            static thread_local Scratch buffer;
+            return buffer;
+        }
+
+        /// `query` is the raw (case-preserved) query, `folded` its lowercase form.
+        int32_t scoreFolded(std::string_view name, std::string_view query, std::string_view folded) {
+            if (folded.empty()) return 0;
+            if (name.size() > kMaxNameLength) name = name.substr(0, kMaxNameLength);
+            if (name.size() < folded.size() || !isSubsequence(name, folded)) return kNoMatch;
+
+            Scratch& s = scratch();
+            int32_t *prev = s.previous;
+            int32_t *cur = s.current;
+            const size_t n = folded.size();
+            const size_t m = name.size();
+
+            for (size_t i = 0; i < n; i++) {
+                int32_t gapRun = kNoMatch; // best H[i-1][j'] for j' <= j-2, with gap costs applied
+                for (size_t j = 0; j < m; j++) {
+                    if (i > 0 && j >= 2) {
+                        gapRun = std::max(gapRun + kGapExtension, prev[j - 2] + kGapStart);
+                    }
+                    int32_t value = kNoMatch;
+                    if (j >= i && fold(name[j]) == folded[i]) {
+                        int32_t bonus = bonusAt(name, j);
+                        int32_t base;
+                        if (i == 0) {
+                            base = 0;
+                            bonus *= kBonusFirstCharMultiplier;
+                        } else {
+                            int32_t diagonal = (j >= 1 && prev[j - 1] > kNoMatch) ? prev[j - 1] + kBonusConsecutive : kNoMatch;
+                            base = std::max(diagonal, gapRun);
+                        }
+                        if (base > kNoMatch / 2) {
+                            value = base + kScoreMatch + bonus + (name[j] == query[i] ? kBonusExactCase : 0);
+                        }
+                    }
+                    cur[j] = value;
+                }
+                std::swap(prev, cur);
+            }
+
+            int32_t best = kNoMatch;
+            for (size_t j = n - 1; j < m; j++) best = std::max(best, prev[j]);
+            return best;
+        }
+
+        /// Indices in [begin, end) whose mask contains every bit of `queryMask`.
+        size_t prefilter(const uint64_t *masks, size_t begin, size_t end, uint64_t queryMask, uint32_t *out) {
+            size_t count = 0;
+            size_t i = begin;
+#if MICRO_FUZZY_SSE2
+            const __m128i q = _mm_set1_epi64x((long long)queryMask);
+            for (; i + 4 <= end; i += 4) {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(masks + i));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(masks + i + 2));
+                // A 64-bit lane matches when both of its 32-bit halves compare equal.
+                int ma = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(a, q), q));
+                int mb = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(b, q), q));
+                if ((ma | mb) == 0) continue;
+                if ((ma & 0x00FF) == 0x00FF) out[count++] = (uint32_t)i;
+                if ((ma & 0xFF00) == 0xFF00) out[count++] = (uint32_t)(i + 1);
+                if ((mb & 0x00FF) == 0x00FF) out[count++] = (uint32_t)(i + 2);
+                if ((mb & 0xFF00) == 0xFF00) out[count++] = (uint32_t)(i + 3);
+            }
+#elif MICRO_FUZZY_NEON
+            const uint64x2_t q = vdupq_n_u64(queryMask);
+            for (; i + 4 <= end; i += 4) {
+                uint64x2_t a = vceqq_u64(vandq_u64(vld1q_u64(masks + i), q), q);
+                uint64x2_t b = vceqq_u64(vandq_u64(vld1q_u64(masks + i + 2), q), q);
+                if ((vgetq_lane_u64(a, 0) | vgetq_lane_u64(a, 1) | vgetq_lane_u64(b, 0) | vgetq_lane_u64(b, 1)) == 0) continue;
+                if (vgetq_lane_u64(a, 0)) out[count++] = (uint32_t)i;
+                if (vgetq_lane_u64(a, 1)) out[count++] = (uint32_t)(i + 1);
+                if (vgetq_lane_u64(b, 0)) out[count++] = (uint32_t)(i + 2);
+                if (vgetq_lane_u64(b, 1)) out[count++] = (uint32_t)(i + 3);
+            }
+#endif
+            for (; i < end; i++) {
+                if ((masks[i] & queryMask) == queryMask) out[count++] = (uint32_t)i;
+            }
+            return count;
+        }
+
+        struct Ranked {
+            int32_t score;
+            uint32_t length;
+            uint32_t index;
+        };
+
+        /// Strict "a ranks above b".
+        inline bool ranksAbove(const Ranked& a, const Ranked& b) {
+            if (a.score != b.score) return a.score > b.score;
+            if (a.length != b.length) return a.length < b.length;
+            return a.index < b.index;
+        }
+
+        /// Bounded heap whose top is the worst kept entry.
+        class TopK {
+        public:
+            explicit TopK(size_t limit) : _limit(limit) { _heap.reserve(limit); }
+
+            void offer(const Ranked& entry) {
+                if (_heap.size() < _limit) {
+                    _heap.push_back(entry);
+                    std::push_heap(_heap.begin(), _heap.end(), ranksAbove);
+                } else if (ranksAbove(entry, _heap.front())) {
+                    std::pop_heap(_heap.begin(), _heap.end(), ranksAbove);
+                    _heap.back() = entry;
+                    std::push_heap(_heap.begin(), _heap.end(), ranksAbove);
+                }
+            }
+
+            /// False when nothing scoring at most `bestPossible` with this length could be kept.
+            bool accepts(int32_t bestPossible, uint32_t length) const {
+                if (_heap.size() < _limit) return true;
+                const Ranked& worst = _heap.front();
+                return bestPossible > worst.score || (bestPossible == worst.score && length < worst.length);
+            }
+
+            std::vector<Ranked>& entries() { return _heap; }
+
+        private:
+            size_t _limit;
+            std::vector<Ranked> _heap;
+        };
+
+        /// Highest score any name can reach for a query of `n` characters.
+        int32_t scoreCeiling(size_t n) {
+            if (n == 0) return 0;
+            int32_t first = kScoreMatch + kBonusBoundary * kBonusFirstCharMultiplier + kBonusExactCase;
+            int32_t rest = kScoreMatch + kBonusConsecutive + kBonusBoundary + kBonusExactCase;
+            return first + (int32_t)(n - 1) * rest;
+        }
+
+        std::string foldQuery(std::string_view query, std::string& raw) {
+            raw.clear();
+            std::string folded;
+            for (char c : query) {
+                if (c == ' ') continue; // Spaces only separate words while typing
+                if (raw.size() == kMaxQueryLength) break;
+                raw.push_back(c);
+                folded.push_back(fold(c));
+            }
+            return folded;
+        }
+    }
+
+    uint64_t characterMask(std::string_view text) {
+        uint64_t mask = 0;
+        for (char c : text) {
+            int bit = bitFor(c);
+            if (bit >= 0) mask |= (1ULL << bit);
+        }
+        return mask;
+    }
+
+    void Corpus::clear() {
+        _bytes.clear();
+        _offsets.clear();
+        _lengths.clear();
+        _masks.clear();
+    }
+
+    void Corpus::reserve(size_t names, size_t bytes) {
+        _bytes.reserve(bytes);
+        _offsets.reserve(names);
+        _lengths.reserve(names);
+        _masks.reserve(names);
+    }
+
+    uint32_t Corpus::add(std::string_view name) {
+        if (name.size() > 0xFFFF) name = name.substr(0, 0xFFFF);
+        uint32_t index = (uint32_t)_offsets.size();
+        _offsets.push_back((uint32_t)_bytes.size());
+        _lengths.push_back((uint16_t)name.size());
+        _masks.push_back(characterMask(name));
+        _bytes.append(name.data(), name.size());
+        return index;
+    }
+
+    int32_t score(std::string_view name, std::string_view query) {
+        std::string raw;
+        std::string folded = foldQuery(query, raw);
+        int32_t value = scoreFolded(name, raw, folded);
+        return value > kNoMatch / 2 ? value : -1;
+    }
+
+    std::vector<uint32_t> matchPositions(std::string_view name, std::string_view query) {
+        std::string raw;
+        std::string folded = foldQuery(query, raw);
+        std::vector<uint32_t> positions;
+        if (folded.empty() || !isSubsequence(name, folded)) return positions;
+
+        // Right-to-left greedy pass, then left-to-right tightening: picks the
+        // shortest window that ends at the last possible match.
+        size_t qi = folded.size();
+        size_t end = name.size();
+        for (size_t j = name.size(); j-- > 0 && qi > 0;) {
+            if (fold(name[j]) == folded[qi - 1]) {
+                if (qi == folded.size()) end = j;
+                qi--;
+            }
+        }
+        size_t start = 0;
+        qi = 0;
+        for (size_t j = 0; j <= end && qi < folded.size(); j++) {
+            if (fold(name[j]) == folded[qi]) {
+                if (qi == 0) start = j;
+                qi++;
+            }
+        }
+        qi = folded.size();
+        for (size_t j = end + 1; j-- > start && qi > 0;) {
+            if (fold(name[j]) == folded[qi - 1]) {
+                positions.push_back((uint32_t)j);
+                qi--;
+            }
+        }
+        std::reverse(positions.begin(), positions.end());
+        return positions;
+    }
+
+    std::vector<Match> Matcher::topMatches(const Corpus& corpus, std::string_view query, size_t limit) const {
+        std::vector<Match> results;
+        if (limit == 0 || corpus.size() == 0) return results;
+
+        std::string raw;
+        std::string folded = foldQuery(query, raw);
+        const uint64_t queryMask = characterMask(folded);
+        const int32_t ceiling = scoreCeiling(folded.size());
+
+        std::mutex mergeMutex;
+        TopK global(limit);
+
+        _pool.parallelFor(corpus.size(), kChunkSize, [&](size_t begin, size_t end) {
+            static thread_local std::vector<uint32_t> candidates;
+            candidates.resize(kChunkSize);
+            TopK local(limit);
+
+            size_t count = prefilter(corpus.masks(), begin, end, queryMask, candidates.data());
+            for (size_t c = 0; c < count; c++) {
+                uint32_t index = candidates[c];
+                std::string_view name = corpus.name(index);
+                if (name.size() < folded.size()) continue;
+                // Once the heap is full, skip the DP for names that cannot displace its worst entry.
+                if (!local.accepts(ceiling, (uint32_t)name.size())) continue;
+                int32_t value = scoreFolded(name, raw, folded);
+                if (value <= kNoMatch / 2) continue;
+                local.offer({value, (uint32_t)name.size(), index});
+            }
+
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            for (const auto& entry : local.entries()) global.offer(entry);
+        });
+
+        std::vector<Ranked>& best = global.entries();
+        std::sort(best.begin(), best.end(), ranksAbove);
+        results.reserve(best.size());
+        for (const auto& entry : best) results.push_back({entry.index, entry.score});
+        return results;
+    }
+}
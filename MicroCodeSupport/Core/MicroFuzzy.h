@@ -0,0 +1,84 @@
+//
+//  MicroFuzzy.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroThreadPool.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - MicroFuzzy (C++)
+// fzf-style fuzzy matching for "Go to symbol" / "Quick outline".
+//
+// 1. Prefilter: every name carries a 64-bit character-presence mask. A candidate
+//    survives only if it contains every query character, checked two masks per
+//    SIMD instruction (SSE2 / NEON, scalar fallback).
+// 2. Score: an ordered-subsequence check, then a two-row affine-gap DP with
+//    word-boundary, camelCase and consecutive-run bonuses. Rows live in
+//    per-thread scratch buffers, so matching never allocates per candidate.
+// 3. Select: each chunk keeps a bounded heap of the best `limit` matches; the
+//    heaps are merged once at the end.
+
+namespace MicroFuzzy {
+
+    /// Contiguous, append-only name storage with precomputed masks.
+    class Corpus {
+    public:
+        void clear();
+        void reserve(size_t names, size_t bytes);
+
+        /// Returns the index of the added name.
+        uint32_t add(std::string_view name);
+
+        size_t size() const { return _offsets.size(); }
+        std::string_view name(uint32_t index) const {
+            return std::string_view(_bytes.data() + _offsets[index], _lengths[index]);
+        }
+
+        const uint64_t *masks() const { return _masks.data(); }
+
+    private:
+        std::string _bytes;
+        std::vector<uint32_t> _offsets;
+        std::vector<uint16_t> _lengths;
+        std::vector<uint64_t> _masks;
+    };
+
+    struct Match {
+        uint32_t index;
+        int32_t score;
+    };
+
+    /// Names longer than this are scored on their first kMaxNameLength bytes.
+    constexpr size_t kMaxNameLength = 256;
+    /// Longer queries are truncated.
+    constexpr size_t kMaxQueryLength = 64;
+
+    /// Character-presence mask used by the prefilter (case-folded).
+    uint64_t characterMask(std::string_view text);
+
+    /// Score of `name` for `query`, or a negative value if it does not match.
+    int32_t score(std::string_view name, std::string_view query);
+
+    /// Matched byte positions in `name`, for highlighting the few rows on screen.
+    std::vector<uint32_t> matchPositions(std::string_view name, std::string_view query);
+
+    class Matcher {
+    public:
+        explicit Matcher(MicroCore::ThreadPool& pool = MicroCore::ThreadPool::shared()) : _pool(pool) {}
+
+        /// Best `limit` matches, highest score first (ties: shorter name, then index).
+        std::vector<Match> topMatches(const Corpus& corpus, std::string_view query, size_t limit) const;
+
+    private:
+        MicroCore::ThreadPool& _pool;
+    };
+}
@@ -0,0 +1,84 @@
+//
+//  MicroGutter.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroGutter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MicroGutter {
+
+    Layout::Layout() {
+        // Placeholder until the view measures its font: 11 pt monospaced digits.
+        DigitMetrics metrics = {};
+        std::fill(std::begin(metrics.advances), std::end(metrics.advances), 6.6f);
+        metrics.ascent = 10.5f;
+        metrics.descent = 2.5f;
+        setMetrics(metrics);
+    }
+
+    void Layout::setMetrics(const DigitMetrics& metrics) {
+        _metrics = metrics;
+        _widestDigit = *std::max_element(std::begin(metrics.advances), std::end(metrics.advances));
+    }
+
+    void Layout::setPadding(float leading, float trailing) {
+        _leading = leading;
+        _trailing = trailing;
+    }
+
+    void Layout::setMinimumDigits(uint32_t digits) {
+        _minimumDigits = std::max<uint32_t>(digits, 1);
+    }
+
+    uint32_t Layout::digitCount(size_t number) {
+        uint32_t digits = 1;
+        while (number >= 10) {
+            number /= 10;
+            digits++;
+        }
+        return digits;
+    }
+
+    float Layout::widthForLineCount(size_t lineCount) const {
+        uint32_t digits = std::max(_minimumDigits, digitCount(std::max<size_t>(lineCount, 1)));
+        return std::ceil(_leading + (float)digits * _widestDigit + _trailing);
+    }
+
+    void Layout::layout(const MicroCore::LineIndex& lines, const Row *rows, size_t count, float gutterWidth) {
+        _labels.clear();
+        _glyphs.clear();
+        const float textHeight = _metrics.ascent + _metrics.descent;
+        const float right = gutterWidth - _trailing;
+
+        for (size_t i = 0; i < count; i++) {
+            const Row& row = rows[i];
+            const size_t line = lines.lineForOffset(row.offset);
+            Label label = {(uint32_t)line, row.top, row.height, (uint32_t)_glyphs.size(), 0, false};
+            if (lines.lineStart(line) != row.offset) {
+                label.continuation = true;
+                _labels.push_back(label);
+                continue;
+            }
+
+            // Digits least significant first, placed right to left.
+            const float baseline = row.top + (row.height - textHeight) / 2 + _metrics.ascent;
+            float x = right;
+            size_t number = line + 1;
+            do {
+                uint8_t digit = (uint8_t)(number % 10);
+                x -= _metrics.advances[digit];
+                _glyphs.push_back({digit, x, baseline});
+                number /= 10;
+            } while (number > 0);
+            label.glyphCount = (uint32_t)(_glyphs.size() - label.firstGlyph);
+            std::reverse(_glyphs.begin() + label.firstGlyph, _glyphs.end());
+            _labels.push_back(label);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+//
+//  MicroGutter.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroLineIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// MARK: - MicroGutter (C++)
+// Platform-neutral layout of the line-number gutter. The view reports its visible
+// rows (visual line fragments); the layout numbers them from a MicroCore::LineIndex,
+// marks wrapped continuations and places every digit of every label using digit
+// advances measured once per font. The view then draws the digits as one glyph run:
+// no per-line strings, formatting or text measurement.
+//
+// Coordinates are y-down, in the gutter's own space.
+
+namespace MicroGutter {
+
+    /// Measured once per font.
+    struct DigitMetrics {
+        float advances[10];
+        float ascent;
+        float descent;
+    };
+
+    /// One visual row of the text view.
+    struct Row {
+        uint32_t offset; // First code unit shown on the row
+        float top;
+        float height;
+    };
+
+    struct Label {
+        uint32_t line;        // 0-based; the number shown is line + 1
+        float top;            // The row's box
+        float height;
+        uint32_t firstGlyph;  // Digits in glyphs(); none for continuations
+        uint32_t glyphCount;
+        bool continuation;    // Wrapped part of the previous row's line
+    };
+
+    struct Glyph {
+        uint8_t digit;
+        float x;              // Left edge
+        float baseline;
+    };
+
+    class Layout {
+    public:
+        Layout();
+
+        void setMetrics(const DigitMetrics& metrics);
+        const DigitMetrics& metrics() const { return _metrics; }
+
+        /// Space left of the widest label and right of every label.
+        void setPadding(float leading, float trailing);
+        /// Labels are never narrower than this many digits, so the gutter does not
+        /// resize for the first few lines typed.
+        void setMinimumDigits(uint32_t digits);
+
+        /// Gutter width that fits every line number of a `lineCount`-line
+        /// document. Changes only when the digit count does.
+        float widthForLineCount(size_t lineCount) const;
+
+        /// Numbers `rows` (sorted top to bottom) and right-aligns their digits in a
+        /// gutter `gutterWidth` wide. Results stay valid until the next call.
+        void layout(const MicroCore::LineIndex& lines, const Row *rows, size_t count, float gutterWidth);
+
+        const std::vector<Label>& labels() const { return _labels; }
+        const std::vector<Glyph>& glyphs() const { return _glyphs; }
+
+        static uint32_t digitCount(size_t number);
+
+    private:
+        DigitMetrics _metrics;
+        float _widestDigit = 0;
+        float _leading = 12;
+        float _trailing = 8;
+        uint32_t _minimumDigits = 3;
+        std::vector<Label> _labels;
+        std::vector<Glyph> _glyphs;
+    };
+}
@@ -0,0 +1,129 @@
+//
+//  MicroGutterAnnotations.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroGutterAnnotations.h"
+
+#include <algorithm>
+
+namespace MicroGutter {
+
+    namespace {
+        bool lineBefore(const Annotation& entry, uint32_t line) {
+            return entry.line < line;
+        }
+    }
+
+    std::vector<Annotation>::iterator AnnotationStore::find(uint32_t line) {
+        return std::lower_bound(_entries.begin(), _entries.end(), line, lineBefore);
+    }
+
+    std::vector<Annotation>::const_iterator AnnotationStore::find(uint32_t line) const {
+        return std::lower_bound(_entries.begin(), _entries.end(), line, lineBefore);
+    }
+
+    void AnnotationStore::add(uint32_t line, Layer layer) {
+        auto it = find(line);
+        if (it != _entries.end() && it->line == line) {
+            it->layers |= layerBit(layer);
+        } else {
+            _entries.insert(it, {line, layerBit(layer)});
+        }
+    }
+
+    void AnnotationStore::remove(uint32_t line, Layer layer) {
+        auto it = find(line);
+        if (it == _entries.end() || it->line != line) return;
+        it->layers &= ~layerBit(layer);
+        if (it->layers == 0) {
+            _entries.erase(it);
+        }
+    }
+
+    void AnnotationStore::setLayer(Layer layer, std::vector<uint32_t> lines) {
+        const uint32_t bit = layerBit(layer);
+        std::sort(lines.begin(), lines.end());
+        lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+
+        // One merge of the existing entries (without the layer) and the new lines.
+        _merged.clear();
+        _merged.reserve(_entries.size() + lines.size());
+        size_t j = 0;
+        for (const Annotation& entry : _entries) {
+            while (j < lines.size() && lines[j] < entry.line) {
+                _merged.push_back({lines[j++], bit});
+            }
+            uint32_t layers = entry.layers & ~bit;
+            if (j < lines.size() && lines[j] == entry.line) {
+                layers |= bit;
+                j++;
+            }
+            if (layers != 0) {
+                _merged.push_back({entry.line, layers});
+            }
+        }
+        for (; j < lines.size(); j++) {
+            _merged.push_back({lines[j], bit});
+        }
+        _entries.swap(_merged);
+    }
+
+    uint32_t AnnotationStore::layersAt(uint32_t line) const {
+        auto it = find(line);
+        return it != _entries.end() && it->line == line ? it->layers : 0;
+    }
+
+    std::pair<const Annotation *, const Annotation *> AnnotationStore::range(uint32_t first, uint32_t last) const {
+        const Annotation *begin = _entries.data() + (find(first) - _entries.begin());
+        const Annotation *end = begin;
+        const Annotation *limit = _entries.data() + _entries.size();
+        if (last > first) {
+            end = std::lower_bound(begin, limit, last, lineBefore);
+        }
+        return {begin, end};
+    }
+
+    uint32_t AnnotationStore::nextLine(uint32_t line, uint32_t mask) const {
+        if (line == UINT32_MAX) return UINT32_MAX;
+        for (auto it = find(line + 1); it != _entries.end(); ++it) {
+            if (it->layers & mask) return it->line;
+        }
+        return UINT32_MAX;
+    }
+
+    std::vector<uint32_t> AnnotationStore::linesWith(Layer layer) const {
+        std::vector<uint32_t> lines;
+        for (const Annotation& entry : _entries) {
+            if (entry.layers & layerBit(layer)) lines.push_back(entry.line);
+        }
+        return lines;
+    }
+
+    void AnnotationStore::insertLines(uint32_t at, uint32_t count) {
+        if (count == 0) return;
+        // Annotations pushed past the last representable line (UINT32_MAX means
+        // "none") fall off the end rather than wrap to the top.
+        auto it = find(at);
+        for (; it != _entries.end(); ++it) {
+            uint64_t moved = (uint64_t)it->line + count;
+            if (moved >= UINT32_MAX) break;
+            it->line = (uint32_t)moved;
+        }
+        _entries.erase(it, _entries.end());
+    }
+
+    void AnnotationStore::removeLines(uint32_t at, uint32_t count) {
+        if (count == 0) return;
+        uint32_t end = (uint32_t)std::min<uint64_t>((uint64_t)at + count, UINT32_MAX);
+        auto first = find(at);
+        auto last = std::lower_bound(first, _entries.end(), end, lineBefore);
+        for (auto it = last; it != _entries.end(); ++it) {
+            it->line -= count;
+        }
+        _entries.erase(first, last);
+    }
+}
@@ -0,0 +1,91 @@
+//
+//  MicroGutterAnnotations.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// MARK: - MicroGutter Annotations (C++)
+// Per-line gutter markers (diagnostics, git changes, breakpoints, ...) for one
+// document, shared by every feature that marks lines. Only annotated lines are
+// stored: a flat map sorted by line, each entry a bitset of the layers present.
+//
+// The visible lines' markers are a binary search plus the entries in range, so
+// off-screen markers cost nothing while drawing. Line edits renumber the entries
+// after the edit in one pass, no feature has to track its own lines.
+
+namespace MicroGutter {
+
+    /// Built-in layers; values 8-31 are free for other features.
+    enum class Layer : uint8_t {
+        Error = 0,
+        Warning = 1,
+        Info = 2,
+        GitAdded = 3,
+        GitModified = 4,
+        GitDeleted = 5,   // Lines were deleted just above this one
+        Breakpoint = 6,
+        Bookmark = 7
+    };
+
+    constexpr uint32_t kLayerCount = 32;
+
+    constexpr uint32_t layerBit(Layer layer) {
+        return 1u << static_cast<uint32_t>(layer);
+    }
+
+    struct Annotation {
+        uint32_t line;   // 0-based
+        uint32_t layers; // Bit i set: layer i is present; never 0
+    };
+
+    class AnnotationStore {
+    public:
+        void add(uint32_t line, Layer layer);
+        void remove(uint32_t line, Layer layer);
+
+        /// Replaces every line of `layer` with `lines` (any order, duplicates
+        /// allowed), e.g. after a new diagnostics or git-diff pass.
+        void setLayer(Layer layer, std::vector<uint32_t> lines);
+        void clearLayer(Layer layer) { setLayer(layer, {}); }
+
+        /// Layer bits on `line`, 0 if none.
+        uint32_t layersAt(uint32_t line) const;
+
+        /// Annotated lines in [first, last), in order. O(log n); the range stays
+        /// valid until the next mutation.
+        std::pair<const Annotation *, const Annotation *> range(uint32_t first, uint32_t last) const;
+
+        /// First annotated line after `line` with any layer in `mask`, or UINT32_MAX.
+        uint32_t nextLine(uint32_t line, uint32_t mask) const;
+
+        /// Lines carrying `layer`, in order.
+        std::vector<uint32_t> linesWith(Layer layer) const;
+
+        /// Document edits. `count` lines were inserted before line `at`, so
+        /// annotations there and below move down.
+        void insertLines(uint32_t at, uint32_t count);
+        /// Lines [at, at + count) were deleted: their annotations go, later ones
+        /// move up.
+        void removeLines(uint32_t at, uint32_t count);
+
+        void clear() { _entries.clear(); }
+        size_t size() const { return _entries.size(); }
+        size_t memoryFootprint() const { return _entries.capacity() * sizeof(Annotation); }
+
+    private:
+        std::vector<Annotation>::iterator find(uint32_t line);
+        std::vector<Annotation>::const_iterator find(uint32_t line) const;
+
+        std::vector<Annotation> _entries; // Sorted by line
+        std::vector<Annotation> _merged;  // Scratch for setLayer()
+    };
+}
@@ -0,0 +1,27 @@
+//
+//  MicroHash.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// MARK: - MicroCore Hash
+// XXH64 (https://github.com/Cyan4973/xxHash), reimplemented so the core needs no
+// third-party code. Output matches the reference implementation, so hashes stay
+// stable across builds and can key on-disk caches.
+
+namespace MicroCore {
+
+    uint64_t hash64(const void *data, size_t length, uint64_t seed = 0);
+
+    inline uint64_t hash64(std::string_view text, uint64_t seed = 0) {
+        return hash64(text.data(), text.size(), seed);
+    }
+}
@@ -0,0 +1,397 @@
+//
+//  MicroIgnore.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroIgnore.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <mutex>
+
+namespace MicroFiles {
+
+    namespace {
+
+        // Ignore files beyond this size are generated, not written by hand.
+        constexpr size_t kMaxIgnoreFileBytes = 1024 * 1024;
+
+        enum WildResult { WildMatch, WildNoMatch, WildAbortAll, WildAbortToStarStar };
+
+        bool isGlobSpecial(char c) {
+            return c == '*' || c == '?' || c == '[' || c == '\\';
+        }
+
+        bool hasGlob(std::string_view pattern) {
+            return std::any_of(pattern.begin(), pattern.end(), isGlobSpecial);
+        }
+
+        /// Matches a bracket expression starting after '['. Advances `p` to its ']'.
+        /// Returns false for a malformed class, which then matches nothing.
+        bool matchClass(const char *&p, const char *pe, unsigned char t, bool& matched) {
+            bool negated = p < pe && (*p == '!' || *p == '^');
+            if (negated) p++;
+            matched = false;
+            unsigned char previous = 0;
+            bool first = true;
+            for (; p < pe && (first || *p != ']'); first = false, p++) {
+                unsigned char c = (unsigned char)*p;
+                if (c == '\\') {
+                    if (++p >= pe) return false;
+                    c = (unsigned char)*p;
+                    if (t == c) matched = true;
+                } else if (c == '-' && previous && p + 1 < pe && p[1] != ']') {
+                    unsigned char high = (unsigned char)*++p;
+                    if (high == '\\') {
+                        if (++p >= pe) return false;
+                        high = (unsigned char)*p;
+                    }
+                    if (t >= previous && t <= high) matched = true;
+                    c = 0;
+                } else if (c == '[' && p + 1 < pe && p[1] == ':') {
+                    const char *close = p + 2;
+                    while (close + 1 < pe && !(close[0] == ':' && close[1] == ']')) close++;
+                    if (close + 1 >= pe) return false;
+                    std::string_view name(p + 2, close - (p + 2));
+                    if ((name == "alnum" && isalnum(t)) || (name == "alpha" && isalpha(t)) ||
+                        (name == "digit" && isdigit(t)) || (name == "lower" && islower(t)) ||
+                        (name == "upper" && isupper(t)) || (name == "space" && isspace(t)) ||
+                        (name == "punct" && ispunct(t)) || (name == "xdigit" && isxdigit(t))) {
+                        matched = true;
+                    }
+                    p = close + 1;
+                    c = 0;
+                } else if (t == c) {
+                    matched = true;
+                }
+                previous = c;
+            }
+            if (p >= pe) return false;
+            if (negated) matched = !matched;
+            return true;
+        }
+
+        // A port of git's wildmatch() with WM_PATHNAME, over bounded strings. The
+        // abort results stop outer '*' loops from retrying what cannot match, which
+        // keeps patterns like "*a*a*a*b" linear-ish instead of exponential.
+        WildResult wild(const char *p, const char *pe, const char *t, const char *te, const char *patternStart) {
+            for (; p < pe; p++, t++) {
+                if (t >= te && *p != '*') return WildAbortAll;
+                unsigned char tc = t < te ? (unsigned char)*t : 0;
+                switch (*p) {
+                    case '\\':
+                        if (++p >= pe || tc != (unsigned char)*p) return WildNoMatch;
+                        continue;
+                    case '?':
+                        if (tc == '/') return WildNoMatch;
+                        continue;
+                    case '[': {
+                        if (tc == '/') return WildNoMatch;
+                        p++;
+                        bool matched;
+                        if (!matchClass(p, pe, tc, matched) || !matched) return WildNoMatch;
+                        continue;
+                    }
+                    case '*': {
+                        bool matchSlash;
+                        if (p + 1 < pe && p[1] == '*') {
+                            const char *before = p - 1;
+                            while (p + 1 < pe && p[1] == '*') p++;
+                            p++;
+                            if ((before < patternStart || *before == '/') && (p >= pe || *p == '/')) {
+                                // "**/" also matches zero directories.
+                                if (p < pe && wild(p + 1, pe, t, te, patternStart) == WildMatch) return WildMatch;
+                                matchSlash = true;
+                            } else {
+                                matchSlash = false;
+                            }
+                        } else {
+                            p++;
+                            matchSlash = false;
+                        }
+                        if (p >= pe) {
+                            // Trailing "**" matches everything; "*" only within a component.
+                            if (!matchSlash && std::find(t, te, '/') != te) return WildNoMatch;
+                            return WildMatch;
+                        }
+                        for (;;) {
+                            if (t >= te) break;
+                            if (!isGlobSpecial(*p)) {
+                                // Skip ahead to the next occurrence of the literal.
+                                while (t < te && (matchSlash || *t != '/') && *t != *p) t++;
+                                if (t >= te || *t != *p) return matchSlash ? WildAbortAll : WildAbortToStarStar;
+                            }
+                            WildResult result = wild(p, pe, t, te, patternStart);
+                            if (result != WildNoMatch) {
+                                if (!matchSlash || result != WildAbortToStarStar) return result;
+                            } else if (!matchSlash && *t == '/') {
+                                return WildAbortToStarStar;
+                            }
+                            t++;
+                        }
+                        return WildAbortAll;
+                    }
+                    default:
+                        if (tc != (unsigned char)*p) return WildNoMatch;
+                        continue;
+                }
+            }
+            return t < te ? WildNoMatch : WildMatch;
+        }
+
+        bool readSmallFile(const std::string& path, std::string& out) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return false;
+            struct stat sb;
+            bool ok = fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && (size_t)sb.st_size <= kMaxIgnoreFileBytes;
+            if (ok) {
+                out.resize((size_t)sb.st_size);
+                size_t done = 0;
+                while (done < out.size()) {
+                    ssize_t n = read(fd, &out[done], out.size() - done);
+                    if (n <= 0) break;
+                    done += (size_t)n;
+                }
+                out.resize(done);
+            }
+            ::close(fd);
+            return ok;
+        }
+
+        std::string_view parentOf(std::string_view path) {
+            size_t slash = path.find_last_of('/');
+            if (slash == std::string_view::npos) return std::string_view();
+            return slash == 0 ? path.substr(0, 1) : path.substr(0, slash);
+        }
+
+        /// Sets `relative` to `path` relative to `directory` if it is below it.
+        bool relativeTo(std::string_view path, std::string_view directory, std::string_view& relative) {
+            if (path.size() <= directory.size() || path.compare(0, directory.size(), directory) != 0) return false;
+            if (directory.back() == '/') {
+                relative = path.substr(directory.size());
+                return true;
+            }
+            if (path[directory.size()] != '/') return false;
+            relative = path.substr(directory.size() + 1);
+            return true;
+        }
+    }
+
+    // MARK: - IgnoreRules
+
+    bool IgnoreRules::globMatch(std::string_view pattern, std::string_view text) {
+        const char *p = pattern.data();
+        return wild(p, p + pattern.size(), text.data(), text.data() + text.size(), p) == WildMatch;
+    }
+
+    void IgnoreRules::parse(std::string_view text) {
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string_view::npos) end = text.size();
+            addPattern(text.substr(start, end - start));
+            start = end + 1;
+        }
+    }
+
+    void IgnoreRules::addPattern(std::string_view line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        // Trailing spaces are dropped unless escaped.
+        while (!line.empty() && line.back() == ' ' && !(line.size() >= 2 && line[line.size() - 2] == '\\')) {
+            line.remove_suffix(1);
+        }
+        if (line.empty() || line.front() == '#') return;
+
+        Rule rule{std::string(), false, false};
+        if (line.front() == '!') {
+            rule.negated = true;
+            line.remove_prefix(1);
+        } else if (line.front() == '\\' && line.size() > 1 && (line[1] == '#' || line[1] == '!')) {
+            line.remove_prefix(1);
+        }
+        if (!line.empty() && line.back() == '/') {
+            rule.directoryOnly = true;
+            line.remove_suffix(1);
+        }
+        bool anchored = false;
+        if (!line.empty() && line.front() == '/') {
+            anchored = true;
+            line.remove_prefix(1);
+        }
+        if (line.empty()) return;
+
+        // "**/name" is just "name"; any other inner slash anchors the pattern.
+        if (line.size() > 3 && line.compare(0, 3, "**/") == 0 && line.find('/', 3) == std::string_view::npos) {
+            line.remove_prefix(3);
+        } else if (line.find('/') != std::string_view::npos) {
+            anchored = true;
+        }
+
+        rule.pattern.assign(line);
+        uint32_t index = (uint32_t)_rules.size();
+        _rules.push_back(rule);
+
+        const std::string& pattern = _rules.back().pattern;
+        if (anchored) {
+            if (hasGlob(pattern)) _pathGlobs.push_back(index);
+            else _paths[pattern].push_back(index);
+        } else if (!hasGlob(pattern)) {
+            _names[pattern].push_back(index);
+        } else if (pattern.size() > 2 && pattern[0] == '*' && pattern[1] == '.' && !hasGlob(std::string_view(pattern).substr(1))) {
+            _extensions[pattern.substr(1)].push_back(index);
+        } else {
+            _nameGlobs.push_back(index);
+        }
+    }
+
+    IgnoreRules::Match IgnoreRules::match(std::string_view relativePath, std::string_view name, bool isDirectory) const {
+        if (_rules.empty()) return Match::None;
+        int64_t best = -1;
+        auto consider = [&](const std::vector<uint32_t>& rules) {
+            for (auto it = rules.rbegin(); it != rules.rend(); ++it) {
+                if ((int64_t)*it <= best) break;
+                if (better(*it, isDirectory, best)) {
+                    best = *it;
+                    break;
+                }
+            }
+        };
+
+        if (!_names.empty()) {
+            auto it = _names.find(std::string(name));
+            if (it != _names.end()) consider(it->second);
+        }
+        if (!_paths.empty()) {
+            auto it = _paths.find(std::string(relativePath));
+            if (it != _paths.end()) consider(it->second);
+        }
+        if (!_extensions.empty()) {
+            // "*.gz" and "*.tar.gz" both match "a.tar.gz".
+            for (size_t dot = name.find('.'); dot != std::string_view::npos; dot = name.find('.', dot + 1)) {
+                auto it = _extensions.find(std::string(name.substr(dot)));
+                if (it != _extensions.end()) consider(it->second);
+            }
+        }
+        for (auto it = _nameGlobs.rbegin(); it != _nameGlobs.rend() && (int64_t)*it > best; ++it) {
+            if (better(*it, isDirectory, best) && globMatch(_rules[*it].pattern, name)) {
+                best = *it;
+                break;
+            }
+        }
+        for (auto it = _pathGlobs.rbegin(); it != _pathGlobs.rend() && (int64_t)*it > best; ++it) {
+            if (better(*it, isDirectory, best) && globMatch(_rules[*it].pattern, relativePath)) {
+                best = *it;
+                break;
+            }
+        }
+
+        if (best < 0) return Match::None;
+        return _rules[best].negated ? Match::Include : Match::Ignore;
+    }
+
+    // MARK: - IgnoreMatcher
+
+    IgnoreMatcher::IgnoreMatcher(std::string root, IgnoreOptions options)
+        : _root(std::move(root)), _options(std::move(options)) {
+        while (_root.size() > 1 && _root.back() == '/') _root.pop_back();
+    }
+
+    std::shared_ptr<const IgnoreMatcher::Level> IgnoreMatcher::loadLevel(const std::string& directory) const {
+        auto level = std::make_shared<Level>();
+        level->directory = directory;
+
+        bool isRoot = directory == _root;
+        if (isRoot) {
+            // Lowest precedence first: extra patterns, then .git/info/exclude.
+            for (const std::string& pattern : _options.extraPatterns) {
+                level->rules.addPattern(pattern);
+            }
+        } else {
+            level->parent = levelFor(parentOf(directory));
+        }
+
+        std::string prefix = directory;
+        if (prefix.back() != '/') prefix.push_back('/');
+        std::string text;
+        if (isRoot && _options.gitExclude && readSmallFile(prefix + ".git/info/exclude", text)) {
+            level->rules.parse(text);
+        }
+        if (_options.gitignore && readSmallFile(prefix + ".gitignore", text)) {
+            level->rules.parse(text);
+        }
+        if (_options.ignoreFiles && readSmallFile(prefix + ".ignore", text)) {
+            level->rules.parse(text);
+        }
+        return level;
+    }
+
+    std::shared_ptr<const IgnoreMatcher::Level> IgnoreMatcher::levelFor(std::string_view directory) const {
+        std::string_view relative;
+        if (directory != _root && !relativeTo(directory, _root, relative)) return nullptr;
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            auto it = _levels.find(directory);
+            if (it != _levels.end()) return it->second;
+        }
+
+        // Loaded outside the lock; a racing thread may load the same level, and the
+        // first one stored wins.
+        std::shared_ptr<const Level> level = loadLevel(std::string(directory));
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        auto result = _levels.emplace(level->directory, level);
+        return result.first->second;
+    }
+
+    bool IgnoreMatcher::isExcluded(std::string_view path, bool isDirectory) const {
+        size_t slash = path.find_last_of('/');
+        std::string_view name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+        // Git never tracks its own directory.
+        if (isDirectory && name == ".git") return true;
+
+        for (std::shared_ptr<const Level> level = levelFor(parentOf(path)); level; level = level->parent) {
+            std::string_view relative;
+            if (!relativeTo(path, level->directory, relative)) continue;
+            IgnoreRules::Match match = level->rules.match(relative, name, isDirectory);
+            if (match != IgnoreRules::Match::None) return match == IgnoreRules::Match::Ignore;
+        }
+        return false;
+    }
+
+    bool IgnoreMatcher::isIgnored(std::string_view path, bool isDirectory) const {
+        std::string_view relative;
+        if (!relativeTo(path, _root, relative)) return false;
+
+        // Every directory on the way down, then the path itself.
+        size_t base = path.size() - relative.size();
+        for (size_t slash = relative.find('/'); slash != std::string_view::npos; slash = relative.find('/', slash + 1)) {
+            if (isExcluded(path.substr(0, base + slash), true)) return true;
+        }
+        return isExcluded(path, isDirectory);
+    }
+
+    std::function<bool(std::string_view, bool)> IgnoreMatcher::scanFilter() const {
+        return [this](std::string_view path, bool isDirectory) {
+            return isExcluded(path, isDirectory);
+        };
+    }
+
+    void IgnoreMatcher::invalidate(std::string_view directory) {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        for (auto it = _levels.begin(); it != _levels.end();) {
+            std::string_view relative;
+            if (it->first == directory || relativeTo(it->first, directory, relative)) {
+                it = _levels.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
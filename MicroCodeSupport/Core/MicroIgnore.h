@@ -0,0 +1,117 @@
+//
+//  MicroIgnore.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// MARK: - MicroFiles (C++)
+// .gitignore / .ignore matching with git's semantics: the last matching line of
+// the deepest file decides, '!' re-includes, a trailing '/' only matches
+// directories, and a pattern with an inner '/' is anchored to its file's
+// directory. Globs support '*', '?', '**', bracket classes and escapes.
+//
+// Each file is compiled once into a dispatch table rather than a list of globs
+// tried in order: exact names and "*.ext" patterns become hash lookups, and
+// only the remaining globs are run, newest first, until one can no longer beat
+// the best match found so far. Used as a scan filter, whole ignored subtrees
+// are never opened.
+
+namespace MicroFiles {
+
+    /// The compiled rules of one ignore file.
+    class IgnoreRules {
+    public:
+        enum class Match : uint8_t { None, Ignore, Include };
+
+        /// Adds the lines of an ignore file; later lines take precedence.
+        void parse(std::string_view text);
+        void addPattern(std::string_view line);
+
+        /// `relativePath` is relative to the ignore file's directory and `name` is
+        /// its last component.
+        Match match(std::string_view relativePath, std::string_view name, bool isDirectory) const;
+
+        bool empty() const { return _rules.empty(); }
+        size_t size() const { return _rules.size(); }
+
+        /// Glob match with git's wildmatch rules ('*' and '?' stop at '/').
+        static bool globMatch(std::string_view pattern, std::string_view text);
+
+    private:
+        struct Rule {
+            std::string pattern;
+            bool negated;
+            bool directoryOnly;
+        };
+
+        bool better(uint32_t rule, bool isDirectory, int64_t best) const {
+            return (int64_t)rule > best && (!_rules[rule].directoryOnly || isDirectory);
+        }
+
+        std::vector<Rule> _rules;
+        std::unordered_map<std::string, std::vector<uint32_t>> _names;      // Exact basenames
+        std::unordered_map<std::string, std::vector<uint32_t>> _extensions; // "*.ext" -> ".ext"
+        std::unordered_map<std::string, std::vector<uint32_t>> _paths;      // Exact anchored paths
+        std::vector<uint32_t> _nameGlobs;                                  // Against the basename
+        std::vector<uint32_t> _pathGlobs;                                  // Against the relative path
+    };
+
+    struct IgnoreOptions {
+        bool gitignore = true;      // .gitignore in every directory
+        bool ignoreFiles = true;    // .ignore (ripgrep and friends); beats .gitignore
+        bool gitExclude = true;     // <root>/.git/info/exclude
+        /// Lowest precedence, relative to the root ("node_modules/", "*.o").
+        std::vector<std::string> extraPatterns;
+    };
+
+    /// Ignore state of a workspace. Ignore files are read the first time their
+    /// directory is consulted. Thread-safe.
+    class IgnoreMatcher {
+    public:
+        explicit IgnoreMatcher(std::string root, IgnoreOptions options = IgnoreOptions());
+
+        /// Whether `path` (absolute, below the root) is ignored, itself or through
+        /// one of its directories.
+        bool isIgnored(std::string_view path, bool isDirectory) const;
+
+        /// Whether `path` is ignored, assuming its directories are not. This is what
+        /// a scan needs: ignored directories were never entered.
+        bool isExcluded(std::string_view path, bool isDirectory) const;
+
+        /// isExcluded() as a ScanOptions::exclude predicate. The matcher must
+        /// outlive the scan.
+        std::function<bool(std::string_view, bool)> scanFilter() const;
+
+        /// Forget the rules of `directory` and below, after an ignore file there
+        /// changed.
+        void invalidate(std::string_view directory);
+
+    private:
+        struct Level {
+            std::string directory;
+            IgnoreRules rules;
+            std::shared_ptr<const Level> parent; // Null at the root
+        };
+
+        std::shared_ptr<const Level> levelFor(std::string_view directory) const;
+        std::shared_ptr<const Level> loadLevel(const std::string& directory) const;
+
+        std::string _root;
+        IgnoreOptions _options;
+        mutable std::shared_mutex _mutex;
+        mutable std::unordered_map<std::string_view, std::shared_ptr<const Level>> _levels; // Keys view Level::directory
+    };
+}
@@ -0,0 +1,833 @@
+//
+//  MicroImportGraph.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroImportGraph.h"
+#include "MicroLexer.h"
+#include "MicroMappedFile.h"
+
+#include <algorithm>
+#include <sys/stat.h>
+#include <unordered_set>
+
+namespace MicroIndex {
+
+    using MicroLexer::Token;
+    using MicroLexer::TokenType;
+
+    namespace {
+
+        // Sources beyond this size are generated or minified; their imports are not read.
+        constexpr size_t kMaxScannedFileBytes = 4 * 1024 * 1024;
+
+        // Import::extensions indexes this table; "" tries the path as written.
+        enum : uint8_t { kExtNone, kExtScript, kExtPython, kExtRust, kExtRuby, kExtJvm };
+        const std::vector<std::vector<const char *>>& extensionLists() {
+            static const std::vector<std::vector<const char *>> lists = {
+                {""},
+                {"", ".ts", ".tsx", ".js", ".jsx", ".mjs", ".cjs", "/index.ts", "/index.tsx", "/index.js", "/index.jsx"},
+                {".py", "/__init__.py"},
+                {".rs", "/mod.rs"},
+                {".rb", ""},
+                {".java", ".kt"}
+            };
+            return lists;
+        }
+
+        std::string_view fileName(std::string_view path) {
+            size_t slash = path.find_last_of('/');
+            return slash == std::string_view::npos ? path : path.substr(slash + 1);
+        }
+
+        std::string_view directoryOf(std::string_view path) {
+            size_t slash = path.find_last_of('/');
+            return slash == std::string_view::npos ? std::string_view() : path.substr(0, slash);
+        }
+
+        bool hasPathSuffix(std::string_view path, std::string_view suffix) {
+            if (path.size() < suffix.size() || path.compare(path.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                return false;
+            }
+            return path.size() == suffix.size() || path[path.size() - suffix.size() - 1] == '/';
+        }
+
+        size_t commonPrefix(std::string_view a, std::string_view b) {
+            size_t n = 0;
+            while (n < a.size() && n < b.size() && a[n] == b[n]) n++;
+            return n;
+        }
+
+        // Collapses "." and ".." segments and repeated slashes.
+        std::string normalizePath(std::string_view path) {
+            std::vector<std::string_view> parts;
+            size_t i = 0;
+            while (i <= path.size()) {
+                size_t next = path.find('/', i);
+                if (next == std::string_view::npos) next = path.size();
+                std::string_view part = path.substr(i, next - i);
+                if (part == "..") {
+                    if (!parts.empty() && parts.back() != "..") parts.pop_back();
+                    else parts.push_back(part);
+                } else if (!part.empty() && part != ".") {
+                    parts.push_back(part);
+                }
+                i = next + 1;
+            }
+            std::string out = (!path.empty() && path[0] == '/') ? "/" : "";
+            for (size_t p = 0; p < parts.size(); p++) {
+                if (p > 0) out += '/';
+                out.append(parts[p].data(), parts[p].size());
+            }
+            return out;
+        }
+
+        std::string dotsToSlashes(std::string_view dotted) {
+            std::string out(dotted);
+            std::replace(out.begin(), out.end(), '.', '/');
+            return out;
+        }
+
+        std::string_view unquote(std::string_view text) {
+            if (text.size() >= 2 && (text[0] == '"' || text[0] == '\'' || text[0] == '`') && text.back() == text[0]) {
+                return text.substr(1, text.size() - 2);
+            }
+            return text;
+        }
+
+        bool statFile(const std::string& path, int64_t& mtime, uint64_t& size) {
+            struct stat sb;
+            if (stat(path.c_str(), &sb) != 0 || !S_ISREG(sb.st_mode)) return false;
+#ifdef __APPLE__
+            int64_t nanos = sb.st_mtimespec.tv_nsec;
+#else
+            int64_t nanos = sb.st_mtim.tv_nsec;
+#endif
+            mtime = (int64_t)sb.st_mtime * 1000000000LL + nanos;
+            size = (uint64_t)sb.st_size;
+            return true;
+        }
+
+        /// Token cursor with the helpers the per-language scanners share.
+        struct Tokens {
+            std::string_view source;
+            const std::vector<Token>& tokens;
+
+            size_t size() const { return tokens.size(); }
+            std::string_view text(size_t i) const {
+                return i < tokens.size() ? source.substr(tokens[i].start, tokens[i].length) : std::string_view();
+            }
+            bool is(size_t i, std::string_view value) const { return i < tokens.size() && text(i) == value; }
+            bool isType(size_t i, TokenType type) const { return i < tokens.size() && tokens[i].type == type; }
+            bool startsLine(size_t i) const {
+                for (size_t p = tokens[i].start; p > 0; p--) {
+                    char c = source[p - 1];
+                    if (c == '\n') return true;
+                    if (c != ' ' && c != '\t') return false;
+                }
+                return true;
+            }
+            bool startsStatement(size_t i) const { return startsLine(i) || (i > 0 && is(i - 1, ";")); }
+            // Dotted name starting at i ("a.b.c"); i ends past it.
+            std::string dotted(size_t& i) const {
+                std::string out;
+                while (i < tokens.size() && tokens[i].type != TokenType::Punctuation && tokens[i].type != TokenType::String) {
+                    out.append(text(i));
+                    if (!is(i + 1, ".") || startsLine(i + 1)) {
+                        i++;
+                        break;
+                    }
+                    out += '.';
+                    i += 2;
+                }
+                return out;
+            }
+        };
+
+        void scanDirective(std::string_view text, std::vector<Import>& out) {
+            size_t p = 1;
+            while (p < text.size() && (text[p] == ' ' || text[p] == '\t')) p++;
+            size_t word = p;
+            while (p < text.size() && ((text[p] >= 'a' && text[p] <= 'z') || text[p] == '_')) p++;
+            std::string_view directive = text.substr(word, p - word);
+            if (directive != "include" && directive != "import" && directive != "include_next") return;
+            while (p < text.size() && (text[p] == ' ' || text[p] == '\t')) p++;
+            if (p >= text.size()) return;
+            char close = text[p] == '"' ? '"' : (text[p] == '<' ? '>' : 0);
+            size_t end = close ? text.find(close, p + 1) : std::string_view::npos;
+            if (end == std::string_view::npos || end == p + 1) return;
+            std::string path(text.substr(p + 1, end - p - 1));
+            if (close == '"') out.push_back({std::move(path), ImportKind::Relative, kExtNone, true});
+            else out.push_back({std::move(path), ImportKind::Suffix, kExtNone, false});
+        }
+
+        void scanPython(const Tokens& t, size_t i, std::vector<Import>& out) {
+            if (t.is(i, "import")) {
+                // import a.b as c, d
+                i++;
+                while (i < t.size() && !t.startsLine(i)) {
+                    std::string name = t.dotted(i);
+                    if (name.empty()) break;
+                    out.push_back({dotsToSlashes(name), ImportKind::Suffix, kExtPython, false});
+                    if (t.is(i, "as")) i += 2;
+                    if (!t.is(i, ",")) break;
+                    i++;
+                }
+                return;
+            }
+            // from ..a.b import c / from . import c, d
+            size_t dots = 0;
+            for (i++; t.is(i, ".") || t.is(i, ".."); i++) dots += t.text(i).size();
+            std::string module = t.startsLine(i) || t.is(i, "import") ? std::string() : t.dotted(i);
+            if (dots == 0) {
+                if (!module.empty()) out.push_back({dotsToSlashes(module), ImportKind::Suffix, kExtPython, false});
+                return;
+            }
+            std::string base;
+            for (size_t d = 1; d < dots; d++) base += "../";
+            if (!module.empty()) {
+                out.push_back({base + dotsToSlashes(module), ImportKind::Relative, kExtPython, false});
+                return;
+            }
+            // Names imported from the package itself are usually its submodules.
+            if (!t.is(i, "import")) return;
+            bool parenthesized = t.is(++i, "(");
+            if (parenthesized) i++;
+            while (i < t.size() && (parenthesized || !t.startsLine(i)) && t.isType(i, TokenType::Identifier)) {
+                out.push_back({base + std::string(t.text(i)), ImportKind::Relative, kExtPython, false});
+                i++;
+                if (t.is(i, "as")) i += 2;
+                if (!t.is(i, ",")) break;
+                i++;
+            }
+        }
+    }
+
+    // MARK: - Extraction
+
+    std::vector<Import> ImportGraph::extractImports(std::string_view source, const std::string& language) {
+        std::vector<Import> out;
+        const std::string lang = MicroLexer::LanguageSpec::canonicalLanguage(language);
+        const std::vector<Token> tokens = MicroLexer::Engine(lang).tokenize(source);
+        const Tokens t{source, tokens};
+
+        for (size_t i = 0; i < t.size(); i++) {
+            std::string_view text = t.text(i);
+
+            if (lang == "cpp" || lang == "objc") {
+                if (text.size() > 1 && text[0] == '#') {
+                    scanDirective(text, out);
+                } else if ((text == "@import" || (text == "@" && t.is(i + 1, "import"))) && lang == "objc") {
+                    size_t j = i + (text == "@" ? 2 : 1);
+                    std::string module = t.dotted(j);
+                    if (!module.empty()) out.push_back({module, ImportKind::Module, kExtNone, false});
+                }
+            } else if (lang == "python") {
+                if ((text == "import" || text == "from") && t.startsStatement(i)) {
+                    scanPython(t, i, out);
+                }
+            } else if (lang == "javascript") {
+                // import x from 'y' / import 'y' / export * from 'y' / require('y') / import('y')
+                if (t.tokens[i].type != TokenType::String) continue;
+                bool byKeyword = i > 0 && (t.is(i - 1, "from") || t.is(i - 1, "import"));
+                bool byCall = i > 1 && t.is(i - 1, "(") && (t.is(i - 2, "require") || t.is(i - 2, "import")) && t.is(i + 1, ")");
+                if (!byKeyword && !byCall) continue;
+                std::string path(unquote(text));
+                if (path.empty()) continue;
+                bool relative = path[0] == '.' || path[0] == '/';
+                out.push_back({std::move(path), relative ? ImportKind::Relative : ImportKind::Module, kExtScript, false});
+            } else if (lang == "rust") {
+                // mod name; (a `mod name { ... }` block is inline)
+                if (text == "mod" && t.isType(i + 1, TokenType::Identifier) && t.is(i + 2, ";")) {
+                    out.push_back({std::string(t.text(i + 1)), ImportKind::Relative, kExtRust, false});
+                }
+            } else if (lang == "go") {
+                if (text != "import") continue;
+                size_t j = i + 1;
+                bool group = t.is(j, "(");
+                if (group) j++;
+                for (; j < t.size() && !t.is(j, ")"); j++) {
+                    if (t.tokens[j].type == TokenType::String) {
+                        std::string path(unquote(t.text(j)));
+                        if (!path.empty()) out.push_back({std::move(path), ImportKind::Package, kExtNone, false});
+                        if (!group) break;
+                    } else if (!group && t.tokens[j].type != TokenType::Identifier && !t.is(j, ".") && !t.is(j, "_")) {
+                        break;
+                    }
+                }
+            } else if (lang == "java" || lang == "kotlin") {
+                if (text != "import" || !t.startsStatement(i)) continue;
+                size_t j = i + 1;
+                bool isStatic = t.is(j, "static");
+                if (isStatic) j++;
+                std::string name = t.dotted(j);
+                if (name.empty()) continue;
+                if (t.is(j, "*") || (name.size() > 1 && name.back() == '*')) {
+                    if (name.back() == '.' || name.back() == '*') name.erase(name.find_last_not_of(".*") + 1);
+                    out.push_back({dotsToSlashes(name), ImportKind::Package, kExtNone, false});
+                    continue;
+                }
+                if (isStatic && name.find('.') != std::string::npos) name.erase(name.rfind('.')); // Member of a class
+                out.push_back({dotsToSlashes(name), ImportKind::Suffix, kExtJvm, false});
+            } else if (lang == "ruby") {
+                if (text != "require" && text != "require_relative" && text != "load") continue;
+                size_t j = t.is(i + 1, "(") ? i + 2 : i + 1;
+                if (!t.isType(j, TokenType::String)) continue;
+                std::string path(unquote(t.text(j)));
+                if (path.empty()) continue;
+                bool relative = text == "require_relative" || path[0] == '.';
+                out.push_back({std::move(path), relative ? ImportKind::Relative : ImportKind::Suffix, kExtRuby, false});
+            } else if (lang == "julia" || lang == "r") {
+                // include("x.jl") / source("x.R")
+                if ((text == "include" || text == "source") && t.is(i + 1, "(") && t.isType(i + 2, TokenType::String)) {
+                    std::string path(unquote(t.text(i + 2)));
+                    if (!path.empty()) out.push_back({std::move(path), ImportKind::Relative, kExtNone, false});
+                }
+            } else if (lang == "swift") {
+                if (text != "import" || (!t.startsStatement(i) && !(i > 1 && t.is(i - 2, "@")))) continue; // @testable import
+                size_t j = i + 1;
+                static const std::unordered_set<std::string_view> kDeclarationKinds = {
+                    "struct", "class", "enum", "protocol", "typealias", "func", "let", "var"
+                };
+                if (kDeclarationKinds.count(t.text(j))) j++;
+                std::string module = t.dotted(j);
+                if (!module.empty()) out.push_back({module.substr(0, module.find('.')), ImportKind::Module, kExtNone, false});
+            }
+        }
+        return out;
+    }
+
+    bool ImportGraph::scanFile(const std::string& path, Scanned& out) {
+        out.path = path;
+        out.imports.clear();
+        if (!statFile(path, out.mtime, out.size)) return false;
+
+        std::string language = MicroLexer::LanguageSpec::languageForPath(path);
+        if (language.empty() || out.size > kMaxScannedFileBytes) return true;
+        MicroCore::MappedFile file;
+        if (file.open(path)) {
+            out.imports = extractImports(std::string_view(reinterpret_cast<const char *>(file.data()), file.size()), language);
+        }
+        return true;
+    }
+
+    // MARK: - Files
+
+    uint32_t ImportGraph::idFor(const std::string& path) const {
+        auto it = _ids.find(path);
+        return it != _ids.end() ? it->second : kNoFile;
+    }
+
+    uint32_t ImportGraph::addFileLocked(const std::string& path) {
+        uint32_t id;
+        if (!_freeIds.empty()) {
+            id = _freeIds.back();
+            _freeIds.pop_back();
+        } else {
+            id = static_cast<uint32_t>(_files.size());
+            _files.emplace_back();
+        }
+        File& file = _files[id];
+        file.path = path;
+        file.live = true;
+        _ids.emplace(path, id);
+        _byName[std::string(fileName(path))].push_back(id);
+
+        std::string directory(directoryOf(path));
+        auto& inDirectory = _byDirectory[directory];
+        if (inDirectory.empty()) {
+            _dirsByName[std::string(fileName(directory))].push_back(directory);
+        }
+        inDirectory.push_back(id);
+        return id;
+    }
+
+    void ImportGraph::removeFileLocked(uint32_t id) {
+        File& file = _files[id];
+        setEdgesLocked(id, {});
+        _ids.erase(file.path);
+
+        auto eraseId = [id](std::vector<uint32_t>& ids) {
+            ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        };
+        std::string name(fileName(file.path));
+        eraseId(_byName[name]);
+        if (_byName[name].empty()) _byName.erase(name);
+
+        std::string directory(directoryOf(file.path));
+        eraseId(_byDirectory[directory]);
+        if (_byDirectory[directory].empty()) {
+            _byDirectory.erase(directory);
+            std::string directoryName(fileName(directory));
+            auto& directories = _dirsByName[directoryName];
+            directories.erase(std::remove(directories.begin(), directories.end(), directory), directories.end());
+            if (directories.empty()) _dirsByName.erase(directoryName);
+        }
+
+        // Keep the span for reuse by the next file in this slot.
+        uint32_t offset = file.edgeOffset;
+        uint32_t capacity = file.edgeCapacity;
+        file = File();
+        file.edgeOffset = offset;
+        file.edgeCapacity = capacity;
+        _freeIds.push_back(id);
+    }
+
+    void ImportGraph::collectDependentsLocked(uint32_t id, std::vector<uint32_t>& out) {
+        ensureReverse();
+        out.insert(out.end(), _inEdges.begin() + _inOffsets[id], _inEdges.begin() + _inOffsets[id + 1]);
+    }
+
+    void ImportGraph::applyLocked(Scanned&& scanned, std::vector<uint32_t>& added, std::vector<uint32_t>& changed) {
+        uint32_t id = idFor(scanned.path);
+        if (id == kNoFile) {
+            id = addFileLocked(scanned.path);
+            added.push_back(id);
+        }
+        File& file = _files[id];
+        file.mtime = scanned.mtime;
+        file.size = scanned.size;
+        file.imports = std::move(scanned.imports);
+        changed.push_back(id);
+    }
+
+    void ImportGraph::finishLocked(const std::vector<uint32_t>& added, std::vector<uint32_t>& changed) {
+        if (!added.empty()) {
+            for (uint32_t id = 0; id < _files.size(); id++) {
+                if (_files[id].live && _files[id].unresolvedCount > 0) changed.push_back(id);
+            }
+            collectOutrankedLocked(added, changed);
+        }
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+        for (uint32_t id : changed) {
+            if (_files[id].live) resolveLocked(id);
+        }
+    }
+
+    void ImportGraph::collectOutrankedLocked(const std::vector<uint32_t>& added, std::vector<uint32_t>& out) {
+        // An import whose match a new file can beat already points at a file of
+        // the same name (nearer suffix match, #include "x.h" next to the importer),
+        // a sibling (earlier extension, another package member) or a member of the
+        // directory named like the new file without extension (a/b.py before
+        // a/b/__init__.py). Package imports can also move to a nearer directory of
+        // the same name.
+        std::vector<char> seen(_files.size(), 0);
+        std::vector<uint32_t> near;      // All their importers are retried
+        std::vector<uint32_t> packages;  // Only their package importers are retried
+        auto take = [&](const std::vector<uint32_t>& ids, std::vector<uint32_t>& into) {
+            for (uint32_t id : ids) {
+                if (!seen[id]) {
+                    seen[id] = 1;
+                    into.push_back(id);
+                }
+            }
+        };
+        for (uint32_t id : added) {
+            const std::string& path = _files[id].path;
+            std::string_view name = fileName(path);
+            std::string directory(directoryOf(path));
+
+            auto byName = _byName.find(std::string(name));
+            if (byName != _byName.end()) take(byName->second, near);
+            auto byDirectory = _byDirectory.find(directory);
+            if (byDirectory != _byDirectory.end()) take(byDirectory->second, near);
+            size_t dot = name.find_last_of('.');
+            if (dot != std::string_view::npos && dot > 0) {
+                auto byStem = _byDirectory.find(path.substr(0, path.size() - (name.size() - dot)));
+                if (byStem != _byDirectory.end()) take(byStem->second, near);
+            }
+            auto sameName = _dirsByName.find(std::string(fileName(directory)));
+            if (sameName != _dirsByName.end()) {
+                for (const std::string& other : sameName->second) {
+                    if (other != directory) take(_byDirectory.at(other), packages);
+                }
+            }
+        }
+
+        for (uint32_t id : near) collectDependentsLocked(id, out);
+        std::vector<uint32_t> importers;
+        for (uint32_t id : packages) collectDependentsLocked(id, importers);
+        for (uint32_t id : importers) {
+            const auto& imports = _files[id].imports;
+            bool package = std::any_of(imports.begin(), imports.end(), [](const Import& import) {
+                return import.kind == ImportKind::Package;
+            });
+            if (package) out.push_back(id);
+        }
+    }
+
+    // MARK: - Resolution
+
+    uint32_t ImportGraph::resolveSuffix(const File& importer, const std::string& suffix) const {
+        auto it = _byName.find(std::string(fileName(suffix)));
+        if (it == _byName.end()) return kNoFile;
+        uint32_t best = kNoFile;
+        size_t bestShared = 0;
+        for (uint32_t candidate : it->second) {
+            const std::string& path = _files[candidate].path;
+            if (!hasPathSuffix(path, suffix)) continue;
+            size_t shared = commonPrefix(path, importer.path);
+            if (best == kNoFile || shared > bestShared) {
+                best = candidate;
+                bestShared = shared;
+            }
+        }
+        return best;
+    }
+
+    void ImportGraph::resolveLocked(uint32_t id) {
+        File& file = _files[id];
+        std::vector<uint32_t> targets;
+        file.resolved.assign(file.imports.size(), false);
+        file.unresolvedCount = 0;
+
+        std::string_view directory = directoryOf(file.path);
+        for (size_t n = 0; n < file.imports.size(); n++) {
+            const Import& import = file.imports[n];
+            const auto& extensions = extensionLists()[import.extensions < extensionLists().size() ? import.extensions : size_t(kExtNone)];
+            size_t before = targets.size();
+
+            if (import.kind == ImportKind::Relative) {
+                // Rust: `mod x;` in a/b.rs lives in a/b/x.rs, in a/lib.rs in a/x.rs.
+                std::string base(directory);
+                std::string_view name = fileName(file.path);
+                if (import.extensions == kExtRust && name != "lib.rs" && name != "main.rs" && name != "mod.rs") {
+                    base = file.path.substr(0, file.path.size() - (name.size() - name.find_last_of('.')));
+                }
+                std::string candidate = normalizePath(import.path[0] == '/' ? import.path : base + "/" + import.path);
+                for (const char *extension : extensions) {
+                    uint32_t target = idFor(candidate + extension);
+                    if (target != kNoFile) {
+                        targets.push_back(target);
+                        break;
+                    }
+                }
+            }
+            if (import.kind == ImportKind::Suffix || (import.orSuffix && targets.size() == before)) {
+                for (const char *extension : extensions) {
+                    uint32_t target = resolveSuffix(file, import.path + extension);
+                    if (target != kNoFile) {
+                        targets.push_back(target);
+                        break;
+                    }
+                }
+            }
+            if (import.kind == ImportKind::Package) {
+                // Module-qualified paths (github.com/org/repo/pkg) only share their tail
+                // with the checkout, so retry with leading segments dropped.
+                std::string_view suffix = import.path;
+                const std::string *best = nullptr;
+                while (!best && !suffix.empty()) {
+                    auto it = _dirsByName.find(std::string(fileName(suffix)));
+                    size_t bestShared = 0;
+                    if (it != _dirsByName.end()) {
+                        for (const std::string& candidate : it->second) {
+                            if (!hasPathSuffix(candidate, suffix)) continue;
+                            size_t shared = commonPrefix(candidate, file.path);
+                            if (!best || shared > bestShared) {
+                                best = &candidate;
+                                bestShared = shared;
+                            }
+                        }
+                    }
+                    size_t slash = suffix.find('/');
+                    if (slash == std::string_view::npos || suffix.find('/', slash + 1) == std::string_view::npos) break;
+                    suffix = suffix.substr(slash + 1);
+                }
+                if (best) {
+                    const auto& members = _byDirectory.at(*best);
+                    targets.insert(targets.end(), members.begin(), members.end());
+                }
+            }
+
+            if (targets.size() > before) {
+                file.resolved[n] = true;
+            } else {
+                file.unresolvedCount++;
+            }
+        }
+
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+        targets.erase(std::remove(targets.begin(), targets.end(), id), targets.end());
+        setEdgesLocked(id, targets);
+    }
+
+    // MARK: - Edges
+
+    void ImportGraph::setEdgesLocked(uint32_t id, const std::vector<uint32_t>& targets) {
+        File& file = _files[id];
+        _liveEdges = _liveEdges - file.edgeCount + targets.size();
+        if (targets.size() > file.edgeCapacity) {
+            file.edgeOffset = static_cast<uint32_t>(_edges.size());
+            file.edgeCapacity = static_cast<uint32_t>(targets.size());
+            _edges.resize(_edges.size() + targets.size());
+        }
+        std::copy(targets.begin(), targets.end(), _edges.begin() + file.edgeOffset);
+        file.edgeCount = static_cast<uint32_t>(targets.size());
+        _reverseValid = false;
+
+        if (_edges.size() > 4096 && _edges.size() > 2 * _liveEdges) {
+            compactEdgesLocked();
+        }
+    }
+
+    void ImportGraph::compactEdgesLocked() {
+        std::vector<uint32_t> packed;
+        packed.reserve(_liveEdges);
+        for (File& file : _files) {
+            uint32_t offset = static_cast<uint32_t>(packed.size());
+            packed.insert(packed.end(), _edges.begin() + file.edgeOffset, _edges.begin() + file.edgeOffset + file.edgeCount);
+            file.edgeOffset = offset;
+            file.edgeCapacity = file.edgeCount;
+        }
+        _edges.swap(packed);
+    }
+
+    void ImportGraph::ensureReverse() const {
+        if (_reverseValid) return;
+        const size_t count = _files.size();
+        _inOffsets.assign(count + 1, 0);
+        for (const File& file : _files) {
+            for (uint32_t e = 0; e < file.edgeCount; e++) {
+                _inOffsets[_edges[file.edgeOffset + e] + 1]++;
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            _inOffsets[i + 1] += _inOffsets[i];
+        }
+        _inEdges.resize(_inOffsets[count]);
+        std::vector<uint32_t> cursor(_inOffsets.begin(), _inOffsets.end() - 1);
+        for (uint32_t id = 0; id < count; id++) {
+            const File& file = _files[id];
+            for (uint32_t e = 0; e < file.edgeCount; e++) {
+                _inEdges[cursor[_edges[file.edgeOffset + e]]++] = id;
+            }
+        }
+        _reverseValid = true;
+    }
+
+    // MARK: - Updates
+
+    size_t ImportGraph::indexFiles(const std::vector<std::string>& paths, MicroCore::ThreadPool& pool) {
+        std::vector<Scanned> scanned(paths.size());
+        std::vector<char> changed(paths.size(), 0);
+        std::vector<char> missing(paths.size(), 0); // Gone since it was listed
+
+        pool.parallelFor(paths.size(), 64, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                int64_t mtime;
+                uint64_t size;
+                if (!statFile(paths[i], mtime, size)) {
+                    missing[i] = 1;
+                    continue;
+                }
+                {
+                    std::shared_lock<std::shared_mutex> lock(_mutex);
+                    uint32_t id = idFor(paths[i]);
+                    if (id != kNoFile && _files[id].mtime == mtime && _files[id].size == size) continue;
+                }
+                changed[i] = scanFile(paths[i], scanned[i]) ? 1 : 0;
+                missing[i] = !changed[i];
+            }
+        });
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        std::vector<uint32_t> added;
+        std::vector<uint32_t> affected;
+
+        // Files no longer listed, or deleted after being listed: their importers
+        // are re-resolved below.
+        std::unordered_set<std::string_view> listed;
+        listed.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!missing[i]) listed.insert(paths[i]);
+        }
+        std::vector<uint32_t> stale;
+        for (uint32_t id = 0; id < _files.size(); id++) {
+            if (_files[id].live && !listed.count(_files[id].path)) stale.push_back(id);
+        }
+        for (uint32_t id : stale) collectDependentsLocked(id, affected);
+        for (uint32_t id : stale) removeFileLocked(id);
+
+        size_t scannedCount = 0;
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!changed[i]) continue;
+            applyLocked(std::move(scanned[i]), added, affected);
+            scannedCount++;
+        }
+        finishLocked(added, affected);
+        return scannedCount;
+    }
+
+    void ImportGraph::updateFile(const std::string& path) {
+        Scanned scanned;
+        if (!scanFile(path, scanned)) {
+            removeFile(path);
+            return;
+        }
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        std::vector<uint32_t> added;
+        std::vector<uint32_t> changed;
+        applyLocked(std::move(scanned), added, changed);
+        finishLocked(added, changed);
+    }
+
+    void ImportGraph::removeFile(const std::string& path) {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        uint32_t id = idFor(path);
+        if (id == kNoFile) return;
+        std::vector<uint32_t> affected;
+        collectDependentsLocked(id, affected);
+        removeFileLocked(id);
+        finishLocked({}, affected);
+    }
+
+    // MARK: - Queries
+
+    size_t ImportGraph::fileCount() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return _ids.size();
+    }
+
+    size_t ImportGraph::edgeCount() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return _liveEdges;
+    }
+
+    std::vector<std::string> ImportGraph::pathsFor(const uint32_t *ids, size_t count) const {
+        std::vector<std::string> paths;
+        paths.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            paths.push_back(_files[ids[i]].path);
+        }
+        return paths;
+    }
+
+    std::vector<std::string> ImportGraph::dependencies(const std::string& path) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        uint32_t id = idFor(path);
+        if (id == kNoFile) return {};
+        const File& file = _files[id];
+        std::vector<std::string> paths = pathsFor(_edges.data() + file.edgeOffset, file.edgeCount);
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    std::vector<std::string> ImportGraph::dependents(const std::string& path) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        uint32_t id = idFor(path);
+        if (id == kNoFile) return {};
+        std::lock_guard<std::mutex> queryLock(_queryMutex);
+        ensureReverse();
+        std::vector<std::string> paths = pathsFor(_inEdges.data() + _inOffsets[id], _inOffsets[id + 1] - _inOffsets[id]);
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    std::vector<std::string> ImportGraph::traverse(uint32_t from, bool forward, uint32_t maxDepth) const {
+        std::lock_guard<std::mutex> queryLock(_queryMutex);
+        if (!forward) ensureReverse();
+        _visited.resize(_files.size(), 0);
+        if (++_visitStamp == 0) {
+            std::fill(_visited.begin(), _visited.end(), 0);
+            _visitStamp = 1;
+        }
+
+        // Breadth-first, one level per hop.
+        std::vector<uint32_t> order = {from};
+        _visited[from] = _visitStamp;
+        size_t levelStart = 0;
+        for (uint32_t depth = 0; levelStart < order.size() && (maxDepth == 0 || depth < maxDepth); depth++) {
+            size_t levelEnd = order.size();
+            for (size_t i = levelStart; i < levelEnd; i++) {
+                const uint32_t id = order[i];
+                const uint32_t *next = forward ? _edges.data() + _files[id].edgeOffset : _inEdges.data() + _inOffsets[id];
+                const uint32_t count = forward ? _files[id].edgeCount : _inOffsets[id + 1] - _inOffsets[id];
+                for (uint32_t e = 0; e < count; e++) {
+                    if (_visited[next[e]] != _visitStamp) {
+                        _visited[next[e]] = _visitStamp;
+                        order.push_back(next[e]);
+                    }
+                }
+            }
+            levelStart = levelEnd;
+        }
+        return pathsFor(order.data() + 1, order.size() - 1);
+    }
+
+    std::vector<std::string> ImportGraph::transitiveDependencies(const std::string& path, uint32_t maxDepth) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        uint32_t id = idFor(path);
+        return id == kNoFile ? std::vector<std::string>() : traverse(id, true, maxDepth);
+    }
+
+    std::vector<std::string> ImportGraph::transitiveDependents(const std::string& path, uint32_t maxDepth) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        uint32_t id = idFor(path);
+        return id == kNoFile ? std::vector<std::string>() : traverse(id, false, maxDepth);
+    }
+
+    std::vector<std::string> ImportGraph::buildOrder(const std::vector<std::string>& paths) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        std::lock_guard<std::mutex> queryLock(_queryMutex);
+        _visited.resize(_files.size(), 0);
+        if (++_visitStamp == 0) {
+            std::fill(_visited.begin(), _visited.end(), 0);
+            _visitStamp = 1;
+        }
+
+        // Iterative depth-first search; a file is emitted after everything it imports.
+        std::vector<uint32_t> order;
+        std::vector<std::pair<uint32_t, uint32_t>> stack; // File, next edge
+        for (const std::string& path : paths) {
+            uint32_t root = idFor(path);
+            if (root == kNoFile || _visited[root] == _visitStamp) continue;
+            _visited[root] = _visitStamp;
+            stack.push_back({root, 0});
+            while (!stack.empty()) {
+                auto& top = stack.back();
+                const File& file = _files[top.first];
+                if (top.second < file.edgeCount) {
+                    uint32_t next = _edges[file.edgeOffset + top.second++];
+                    if (_visited[next] != _visitStamp) {
+                        _visited[next] = _visitStamp;
+                        stack.push_back({next, 0});
+                    }
+                } else {
+                    order.push_back(top.first);
+                    stack.pop_back();
+                }
+            }
+        }
+        return pathsFor(order.data(), order.size());
+    }
+
+    std::vector<std::string> ImportGraph::unresolvedImports(const std::string& path) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        uint32_t id = idFor(path);
+        std::vector<std::string> imports;
+        if (id == kNoFile) return imports;
+        const File& file = _files[id];
+        for (size_t n = 0; n < file.imports.size(); n++) {
+            if (n >= file.resolved.size() || !file.resolved[n]) imports.push_back(file.imports[n].path);
+        }
+        return imports;
+    }
+
+    size_t ImportGraph::memoryFootprint() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        size_t bytes = _files.capacity() * sizeof(File)
+            + (_edges.capacity() + _inOffsets.capacity() + _inEdges.capacity() + _visited.capacity() + _freeIds.capacity()) * sizeof(uint32_t)
+            + (_ids.size() + _byName.size() + _byDirectory.size() + _dirsByName.size()) * (sizeof(std::string) + 4 * sizeof(void *));
+        for (const File& file : _files) {
+            bytes += file.path.capacity() * 2 + file.imports.capacity() * sizeof(Import) + file.resolved.capacity() / 8;
+            for (const Import& import : file.imports) bytes += import.path.capacity();
+        }
+        return bytes;
+    }
+}
@@ -0,0 +1,152 @@
+//
+//  MicroImportGraph.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroThreadPool.h"
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// MARK: - MicroIndex (C++)
+// Workspace import graph: which source file pulls in which. Files are lexed on a
+// thread pool and their import statements (#include/#import, import/from,
+// require, mod, ...) are resolved against the workspace's own paths:
+//
+//   - relative specifiers against the importing file's directory,
+//   - header, module and class paths by path suffix (nearest match wins),
+//   - Go and wildcard Java packages to every file of the matching directory.
+//
+// Anything else (system headers, third-party modules) stays an unresolved import.
+//
+// Outgoing edges live in one packed array, a span per file; a changed file only
+// rewrites its own span. Incoming edges are a CSR (compressed sparse row) built
+// from those spans on the first reverse query after a change.
+
+namespace MicroIndex {
+
+    enum class ImportKind : uint8_t {
+        Relative, // Path from the importing file's directory ("./x", #include "x.h", require_relative)
+        Suffix,   // Workspace path ending in `path` plus an extension (<a/b.h>, a.b.c -> a/b/c.py)
+        Package,  // Every file directly in a directory ending in `path` (Go, Java `.*`)
+        Module    // Named module outside the file system (Swift, Objective-C @import)
+    };
+
+    struct Import {
+        std::string path;     // Normalized to '/' separators, without quotes
+        ImportKind kind;
+        uint8_t extensions;   // Candidate extension list for the language (see MicroImportGraph.cpp)
+        bool orSuffix;        // Relative import that falls back to a suffix match (#include "x.h")
+    };
+
+    class ImportGraph {
+    public:
+        /// Import statements in `source`, in order. `language` is a MicroLexer
+        /// language id (aliases accepted).
+        static std::vector<Import> extractImports(std::string_view source, const std::string& language);
+
+        /// Re-reads every path whose size or mtime changed, drops files that are no
+        /// longer listed and re-resolves what that affects. Returns the number of
+        /// files read.
+        size_t indexFiles(const std::vector<std::string>& paths,
+                          MicroCore::ThreadPool& pool = MicroCore::ThreadPool::shared());
+
+        /// File-change hooks. An edited file only has its own imports re-resolved;
+        /// adding one also retries every unresolved import and every import it
+        /// could now be a better match for, and removing one re-resolves the
+        /// files that imported it.
+        void updateFile(const std::string& path);
+        void removeFile(const std::string& path);
+
+        size_t fileCount() const;
+        size_t edgeCount() const;
+
+        /// Files `path` imports directly / that import it directly, sorted.
+        std::vector<std::string> dependencies(const std::string& path) const;
+        std::vector<std::string> dependents(const std::string& path) const;
+
+        /// Everything reachable through imports (or reverse imports) from `path`,
+        /// nearest first, up to `maxDepth` hops (0: unlimited). `path` is excluded.
+        std::vector<std::string> transitiveDependencies(const std::string& path, uint32_t maxDepth = 0) const;
+        std::vector<std::string> transitiveDependents(const std::string& path, uint32_t maxDepth = 0) const;
+
+        /// `paths` and everything they import, dependencies before the files that
+        /// import them. Cycles are broken at the edge that closes them.
+        std::vector<std::string> buildOrder(const std::vector<std::string>& paths) const;
+
+        /// Imports of `path` that resolved to no workspace file (system headers,
+        /// packages), in source order.
+        std::vector<std::string> unresolvedImports(const std::string& path) const;
+
+        size_t memoryFootprint() const;
+
+    private:
+        static constexpr uint32_t kNoFile = UINT32_MAX;
+
+        struct File {
+            std::string path;
+            int64_t mtime = 0;
+            uint64_t size = 0;
+            bool live = false;
+            std::vector<Import> imports;
+            std::vector<bool> resolved;  // Per import
+            uint32_t unresolvedCount = 0;
+            uint32_t edgeOffset = 0;     // Span in _edges
+            uint32_t edgeCount = 0;
+            uint32_t edgeCapacity = 0;
+        };
+
+        struct Scanned {
+            std::string path;
+            int64_t mtime;
+            uint64_t size;
+            std::vector<Import> imports;
+        };
+
+        static bool scanFile(const std::string& path, Scanned& out);
+
+        uint32_t idFor(const std::string& path) const;
+        uint32_t addFileLocked(const std::string& path);
+        void removeFileLocked(uint32_t id);
+        void collectDependentsLocked(uint32_t id, std::vector<uint32_t>& out);
+        void applyLocked(Scanned&& scanned, std::vector<uint32_t>& added, std::vector<uint32_t>& changed);
+        void finishLocked(const std::vector<uint32_t>& added, std::vector<uint32_t>& changed);
+        void collectOutrankedLocked(const std::vector<uint32_t>& added, std::vector<uint32_t>& out);
+        void resolveLocked(uint32_t id);
+        uint32_t resolveSuffix(const File& importer, const std::string& suffix) const;
+        void setEdgesLocked(uint32_t id, const std::vector<uint32_t>& targets);
+        void compactEdgesLocked();
+        void ensureReverse() const;
+        std::vector<std::string> traverse(uint32_t from, bool forward, uint32_t maxDepth) const;
+        std::vector<std::string> pathsFor(const uint32_t *ids, size_t count) const;
+
+        mutable std::shared_mutex _mutex;
+        std::vector<File> _files;
+        std::vector<uint32_t> _freeIds;
+        std::unordered_map<std::string, uint32_t> _ids;
+        std::unordered_map<std::string, std::vector<uint32_t>> _byName;      // File name -> files
+        std::unordered_map<std::string, std::vector<uint32_t>> _byDirectory;  // Directory -> files directly in it
+        std::unordered_map<std::string, std::vector<std::string>> _dirsByName; // Directory name -> directories
+
+        std::vector<uint32_t> _edges;  // Outgoing spans, see File; compacted when half is unused
+        size_t _liveEdges = 0;
+
+        // Reverse CSR and traversal scratch, guarded by _queryMutex under a shared lock.
+        mutable std::mutex _queryMutex;
+        mutable bool _reverseValid = false;
+        mutable std::vector<uint32_t> _inOffsets; // _files.size() + 1 entries
+        mutable std::vector<uint32_t> _inEdges;
+        mutable std::vector<uint32_t> _visited;   // Traversal stamp per file
+        mutable uint32_t _visitStamp = 0;
+    };
+}
@@ -0,0 +1,159 @@
+//
+//  MicroIncrementalLexer.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroIncrementalLexer.h"
+
+#include <algorithm>
+
+namespace MicroLexer {
+
+    namespace {
+        /// Replaces vec[begin, end) with `replacement`.
+        template <typename T>
+        void splice(std::vector<T>& vec, size_t begin, size_t end, const std::vector<T>& replacement) {
+            size_t removed = end - begin;
+            size_t common = std::min(removed, replacement.size());
+            std::copy(replacement.begin(), replacement.begin() + common, vec.begin() + begin);
+            if (replacement.size() > removed) {
+                vec.insert(vec.begin() + end, replacement.begin() + common, replacement.end());
+            } else {
+                vec.erase(vec.begin() + begin + common, vec.begin() + end);
+            }
+        }
+    }
+
+    IncrementalLexer::IncrementalLexer(const std::string& lang) : _engine(lang) {
+        reset("");
+    }
+
+    size_t IncrementalLexer::lineEnd(size_t line) const {
+        return (line + 1 < _lineStarts.size()) ? _lineStarts[line + 1] - 1 : _source.size();
+    }
+
+    size_t IncrementalLexer::lineForOffset(size_t offset) const {
+        auto it = std::upper_bound(_lineStarts.begin(), _lineStarts.end(), static_cast<uint32_t>(offset));
+        return static_cast<size_t>(it - _lineStarts.begin()) - 1;
+    }
+
+    void IncrementalLexer::reset(std::string_view source) {
+        _source.assign(source.data(), source.size());
+        _tokens.clear();
+        _lineStarts.clear();
+        _lineFirstToken.clear();
+        _lineEndState.clear();
+
+        State state = State::Normal;
+        size_t lineStart = 0;
+        while (true) {
+            size_t newline = _source.find('\n', lineStart);
+            size_t lineEnd = (newline == std::string::npos) ? _source.size() : newline;
+            _lineStarts.push_back(static_cast<uint32_t>(lineStart));
+            _lineFirstToken.push_back(static_cast<uint32_t>(_tokens.size()));
+            state = _engine.tokenizeLine(_source, lineStart, lineEnd, state, _tokens);
+            _lineEndState.push_back(state);
+            if (newline == std::string::npos) break;
+            lineStart = newline + 1;
+        }
+        _lineFirstToken.push_back(static_cast<uint32_t>(_tokens.size()));
+    }
+
+    void IncrementalLexer::adopt(std::string_view source, std::vector<Token> tokens, std::vector<uint32_t> lineStarts,
+                                 std::vector<uint32_t> lineFirstToken, std::vector<State> lineEndState) {
+        _source.assign(source.data(), source.size());
+        _tokens = std::move(tokens);
+        _lineStarts = std::move(lineStarts);
+        _lineFirstToken = std::move(lineFirstToken);
+        _lineEndState = std::move(lineEndState);
+    }
+
+    EditResult IncrementalLexer::applyEdit(size_t start, size_t removedLength, std::string_view inserted) {
+        start = std::min(start, _source.size());
+        removedLength = std::min(removedLength, _source.size() - start);
+
+        const size_t oldLines = lineCount();
+        const size_t firstLine = lineForOffset(start);
+        const size_t lastOldLine = lineForOffset(start + removedLength);
+        const size_t oldRegionEnd = lineEnd(lastOldLine);
+        const int64_t byteDelta = static_cast<int64_t>(inserted.size()) - static_cast<int64_t>(removedLength);
+
+        _source.replace(start, removedLength, inserted.data(), inserted.size());
+
+        // 1. Line starts of the edited region; later lines only move by byteDelta.
+        const size_t regionStart = _lineStarts[firstLine];
+        const size_t newRegionEnd = static_cast<size_t>(static_cast<int64_t>(oldRegionEnd) + byteDelta);
+        _freshLineStarts.clear();
+        _freshLineStarts.push_back(static_cast<uint32_t>(regionStart));
+        for (size_t pos = _source.find('\n', regionStart); pos != std::string::npos && pos < newRegionEnd;
+             pos = _source.find('\n', pos + 1)) {
+            _freshLineStarts.push_back(static_cast<uint32_t>(pos + 1));
+        }
+        for (size_t line = lastOldLine + 1; line < oldLines; line++) {
+            _lineStarts[line] = static_cast<uint32_t>(static_cast<int64_t>(_lineStarts[line]) + byteDelta);
+        }
+        splice(_lineStarts, firstLine, lastOldLine + 1, _freshLineStarts);
+        const int64_t lineDelta = static_cast<int64_t>(_freshLineStarts.size()) - static_cast<int64_t>(lastOldLine + 1 - firstLine);
+
+        // 2. Relex the region, then keep going while the end state differs from
+        //    what the old line ended in (the next line would start differently).
+        //    _lineFirstToken/_lineEndState are still in old numbering here.
+        const size_t firstToken = _lineFirstToken[firstLine];
+        _freshTokens.clear();
+        _freshFirstToken.clear();
+        _freshEndState.clear();
+
+        State state = firstLine > 0 ? _lineEndState[firstLine - 1] : State::Normal;
+        auto relexLine = [&](size_t newLine) {
+            _freshFirstToken.push_back(static_cast<uint32_t>(firstToken + _freshTokens.size()));
+            state = _engine.tokenizeLine(_source, _lineStarts[newLine], lineEnd(newLine), state, _freshTokens);
+            _freshEndState.push_back(state);
+        };
+        for (size_t i = 0; i < _freshLineStarts.size(); i++) {
+            relexLine(firstLine + i);
+        }
+        size_t oldLine = lastOldLine;
+        while (oldLine + 1 < oldLines && state != _lineEndState[oldLine]) {
+            oldLine++;
+            relexLine(static_cast<size_t>(static_cast<int64_t>(oldLine) + lineDelta));
+        }
+
+        // 3. Splice tokens, shifting everything after the relexed lines.
+        const size_t oldTokenEnd = _lineFirstToken[oldLine + 1];
+        for (size_t i = oldTokenEnd; i < _tokens.size(); i++) {
+            _tokens[i].start = static_cast<uint32_t>(static_cast<int64_t>(_tokens[i].start) + byteDelta);
+        }
+        splice(_tokens, firstToken, oldTokenEnd, _freshTokens);
+        const int64_t tokenDelta = static_cast<int64_t>(_freshTokens.size()) - static_cast<int64_t>(oldTokenEnd - firstToken);
+
+        for (size_t line = oldLine + 1; line <= oldLines; line++) {
+            _lineFirstToken[line] = static_cast<uint32_t>(static_cast<int64_t>(_lineFirstToken[line]) + tokenDelta);
+        }
+        splice(_lineFirstToken, firstLine, oldLine + 1, _freshFirstToken);
+        splice(_lineEndState, firstLine, oldLine + 1, _freshEndState);
+
+        EditResult result;
+        result.firstLine = firstLine;
+        result.oldLineCount = oldLine + 1 - firstLine;
+        result.newLineCount = _freshEndState.size();
+        result.lineDelta = lineDelta;
+        result.byteDelta = byteDelta;
+        result.firstToken = firstToken;
+        result.oldTokenCount = oldTokenEnd - firstToken;
+        result.newTokenCount = _freshTokens.size();
+        return result;
+    }
+
+    size_t IncrementalLexer::memoryFootprint() const {
+        return _source.capacity()
+            + _tokens.capacity() * sizeof(Token)
+            + (_lineStarts.capacity() + _lineFirstToken.capacity()) * sizeof(uint32_t)
+            + _lineEndState.capacity() * sizeof(State)
+            + _freshTokens.capacity() * sizeof(Token)
+            + (_freshLineStarts.capacity() + _freshFirstToken.capacity()) * sizeof(uint32_t)
+            + _freshEndState.capacity() * sizeof(State);
+    }
+}
@@ -0,0 +1,88 @@
+//
+//  MicroIncrementalLexer.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroLexer.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - MicroLexer Incremental (C++)
+// Owns a document's UTF-8 text and its tokens, grouped by line. Every line records
+// the lexer state it ends in, so an edit only relexes the lines it touches plus
+// the following lines whose start state changed (e.g. after typing an opening
+// slash-star). Tokens past the relexed region are shifted, not relexed.
+
+namespace MicroLexer {
+
+    /// Lines affected by the last edit, in post-edit numbering. Lines before
+    /// `firstLine` are untouched; lines from `firstLine + newLineCount` on were
+    /// only renumbered by `lineDelta` and shifted by `byteDelta`.
+    struct EditResult {
+        size_t firstLine = 0;
+        size_t oldLineCount = 0;  // Lines replaced ...
+        size_t newLineCount = 0;  // ... by this many relexed lines
+        int64_t lineDelta = 0;
+        int64_t byteDelta = 0;
+        size_t firstToken = 0;    // Relexed tokens are [firstToken, firstToken + newTokenCount)
+        size_t oldTokenCount = 0;
+        size_t newTokenCount = 0;
+    };
+
+    class IncrementalLexer {
+    public:
+        explicit IncrementalLexer(const std::string& lang);
+
+        /// Replaces the whole text and relexes everything.
+        void reset(std::string_view source);
+
+        /// Installs previously computed line tables and tokens for `source` without
+        /// lexing (see MicroParseCache). `lineFirstToken` has one entry per line plus
+        /// a final one equal to the token count. The caller has validated the tables.
+        void adopt(std::string_view source, std::vector<Token> tokens, std::vector<uint32_t> lineStarts,
+                   std::vector<uint32_t> lineFirstToken, std::vector<State> lineEndState);
+
+        /// Replaces `removedLength` bytes at `start` with `inserted`.
+        EditResult applyEdit(size_t start, size_t removedLength, std::string_view inserted);
+
+        const std::string& source() const { return _source; }
+        const std::vector<Token>& tokens() const { return _tokens; }
+        const Engine& engine() const { return _engine; }
+
+        size_t lineCount() const { return _lineStarts.size(); }
+        size_t lineStart(size_t line) const { return _lineStarts[line]; }
+        /// End of the line's text, excluding the newline.
+        size_t lineEnd(size_t line) const;
+        /// Line containing byte `offset` (binary search).
+        size_t lineForOffset(size_t offset) const;
+
+        /// The line's tokens are tokens()[firstTokenOfLine(line) .. firstTokenOfLine(line + 1)).
+        size_t firstTokenOfLine(size_t line) const { return _lineFirstToken[line]; }
+        State lineEndState(size_t line) const { return _lineEndState[line]; }
+
+        /// Heap bytes held (text, tokens and line tables).
+        size_t memoryFootprint() const;
+
+    private:
+        Engine _engine;
+        std::string _source;
+        std::vector<Token> _tokens;           // Absolute byte offsets
+        std::vector<uint32_t> _lineStarts;
+        std::vector<uint32_t> _lineFirstToken; // lineCount() + 1 entries
+        std::vector<State> _lineEndState;
+
+        // Scratch reused across edits.
+        std::vector<Token> _freshTokens;
+        std::vector<uint32_t> _freshLineStarts;
+        std::vector<uint32_t> _freshFirstToken;
+        std::vector<State> _freshEndState;
+    };
+}
@@ -0,0 +1,330 @@
+//
+//  MicroLexer.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroLexer.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace MicroLexer {
+
+    namespace {
+
+        enum CharClass : uint8_t {
+            ClassOther = 0,
+            ClassSpace,
+            ClassDigit,
+            ClassAlpha,     // [A-Za-z_]
+            ClassPunct
+        };
+
+        // Byte classification shared by every language. Non-ASCII bytes are
+        // ClassOther, matching the previous isalpha()/ispunct() behaviour.
+        struct CharTable {
+            uint8_t classes[256];
+            CharTable() {
+                for (int c = 0; c < 256; c++) {
+                    uint8_t k = ClassOther;
+                    if (c == ' ' || (c >= '\t' && c <= '\r')) k = ClassSpace;
+                    else if (c >= '0' && c <= '9') k = ClassDigit;
+                    else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') k = ClassAlpha;
+                    else if (c > 32 && c < 127) k = ClassPunct;
+                    classes[c] = k;
+                }
+            }
+        };
+
+        const CharTable kCharTable;
+
+        inline uint8_t classOf(char c) {
+            return kCharTable.classes[static_cast<unsigned char>(c)];
+        }
+
+        struct Delimiters {
+            std::string_view open;
+            std::string_view close;
+        };
+        constexpr Delimiters kBlockComment = {"/*", "*/"};
+        constexpr std::string_view kTripleDouble = "\"\"\"";
+        constexpr std::string_view kTripleSingle = "'''";
+
+        inline bool isWordChar(char c) {
+            uint8_t k = classOf(c);
+            return k == ClassAlpha || k == ClassDigit;
+        }
+
+        void fillSpec(LanguageSpec& spec) {
+            const std::string& lang = spec.language;
+            if (lang == "swift") {
+                spec.keywords = {"if", "else", "return", "import", "extension", "guard", "switch", "case", "try", "catch", "throw", "throws", "async", "await", "do", "repeat", "while", "break", "continue", "defer", "init", "deinit", "subscript", "static", "class", "get", "set", "willSet", "didSet"};
+                spec.declarationKeywords = {"func", "var", "let", "class", "struct", "enum", "protocol", "public", "private", "fileprivate", "internal", "open", "typealias", "associatedtype", "actor", "macro"};
+            } else if (lang == "python") {
+                spec.keywords = {"return", "if", "else", "elif", "for", "while", "import", "from", "as", "try", "except", "pass", "None", "True", "False", "lambda", "with", "raise", "finally", "assert", "del", "global", "nonlocal", "yield", "break", "continue"};
+                spec.declarationKeywords = {"def", "class"};
+            } else if (lang == "r") {
+                spec.keywords = {"if", "else", "for", "while", "repeat", "break", "next", "return", "in", "function", "TRUE", "FALSE", "NULL", "NA", "NaN", "Inf", "library", "require", "source", "print", "cat"};
+                spec.declarationKeywords = {"function", "library", "require", "data.frame", "matrix", "list", "vector", "factor", "tibble"};
+            } else if (lang == "rust") {
+                spec.keywords = {"if", "else", "return", "match", "loop", "while", "for", "in", "break", "continue", "unsafe", "async", "await", "move", "ref", "mut", "static", "const", "trait", "impl", "type", "crate", "mod", "pub", "use", "extern", "self", "super", "where", "dyn"};
+                spec.declarationKeywords = {"fn", "let", "struct", "enum", "union", "const", "static", "type"};
+            } else if (lang == "go") {
+                spec.keywords = {"break", "case", "chan", "const", "continue", "default", "defer", "else", "fallthrough", "for", "func", "go", "goto", "if", "import", "interface", "map", "package", "range", "return", "select", "struct", "switch", "type", "var"};
+                spec.declarationKeywords = {"func", "var", "const", "type", "package", "import"};
+            } else if (lang == "javascript") {
+                spec.keywords = {"if", "else", "return", "for", "while", "do", "switch", "case", "default", "break", "continue", "try", "catch", "finally", "throw", "new", "this", "super", "import", "export", "from", "as", "await", "async", "yield", "void", "typeof", "instanceof", "delete", "in", "of", "null", "undefined", "true", "false", "NaN", "Infinity"};
+                spec.declarationKeywords = {"function", "var", "let", "const", "class", "enum", "interface", "type", "namespace", "module"};
+            } else if (lang == "java") {
+                spec.keywords = {"if", "else", "return", "for", "while", "do", "switch", "case", "default", "break", "continue", "try", "catch", "finally", "throw", "new", "this", "super", "import", "package", "null", "true", "false", "synchronized", "volatile", "transient", "native", "strictfp"};
+                spec.declarationKeywords = {"class", "interface", "enum", "record", "extends", "implements", "public", "private", "protected", "static", "final", "abstract", "void", "int", "boolean", "char", "byte", "short", "long", "float", "double"};
+            } else if (lang == "kotlin") {
+                spec.keywords = {"if", "else", "when", "for", "while", "do", "break", "continue", "return", "throw", "try", "catch", "finally", "package", "import", "package", "this", "super", "null", "true", "false", "is", "in", "as", "fun", "val", "var"};
+                spec.declarationKeywords = {"class", "interface", "object", "enum", "annotation", "data", "sealed", "open", "final", "public", "private", "protected", "internal", "override", "abstract", "companion", "init", "constructor", "get", "set", "field", "it"};
+            } else if (lang == "objc") {
+                spec.keywords = {"if", "else", "for", "while", "do", "switch", "case", "default", "break", "continue", "return", "try", "catch", "throw", "finally", "import", "include", "YES", "NO", "nil", "NULL", "self", "super", "new", "alloc", "init", "copy", "retain", "release", "autorelease", "strong", "weak", "readonly", "readwrite", "nonatomic", "atomic", "assign", "copy", "getter", "setter"};
+                spec.declarationKeywords = {"@interface", "@implementation", "@end", "@protocol", "@property", "@synthesize", "@dynamic", "@class", "@selector", "@try", "@catch", "@finally", "@throw", "@synchronized", "@autoreleasepool", "int", "float", "double", "char", "void", "bool", "long", "short", "id", "instancetype", "BOOL", "NSInteger", "NSUInteger", "CGFloat", "NSString", "NSArray", "NSDictionary"};
+            } else if (lang == "sql") {
+                spec.keywords = {"SELECT", "FROM", "WHERE", "INSERT", "INTO", "UPDATE", "DELETE", "CREATE", "DROP", "ALTER", "TABLE", "INDEX", "VIEW", "JOIN", "INNER", "LEFT", "RIGHT", "OUTER", "ON", "GROUP", "BY", "ORDER", "HAVING", "LIMIT", "OFFSET", "UNION", "ALL", "DISTINCT", "AS", "AND", "OR", "NOT", "NULL", "IS", "IN", "BETWEEN", "LIKE", "EXISTS", "CASE", "WHEN", "THEN", "ELSE", "END"};
+                spec.declarationKeywords = {"INT", "VARCHAR", "TEXT", "DATE", "DATETIME", "TIMESTAMP", "BOOLEAN", "FLOAT", "DECIMAL", "PRIMARY", "KEY", "FOREIGN", "REFERENCES", "DEFAULT", "UNIQUE"};
+            } else if (lang == "ruby") {
+                spec.keywords = {"if", "else", "elsif", "unless", "return", "while", "until", "for", "in", "break", "next", "redo", "retry", "begin", "rescue", "ensure", "end", "case", "when", "then", "def", "class", "module", "self", "super", "yield", "alias", "and", "or", "not", "true", "false", "nil"};
+                spec.declarationKeywords = {"def", "class", "module", "attr_reader", "attr_writer", "attr_accessor"};
+            } else if (lang == "julia") {
+                spec.keywords = {"if", "else", "elseif", "for", "while", "return", "break", "continue", "try", "catch", "finally", "throw", "import", "using", "export", "module", "baremodule", "quote", "do", "begin", "end", "true", "false", "nothing", "NaN", "Inf"};
+                spec.declarationKeywords = {"function", "macro", "struct", "mutable", "abstract", "primitive", "type", "const", "global", "local"};
+            } else {
+                // C/C++ Default
+                spec.keywords = {"return", "if", "else", "for", "while", "do", "switch", "case", "default", "break", "continue", "goto", "try", "catch", "throw", "new", "delete", "using", "namespace", "include", "import", "define", "ifdef", "ifndef", "endif", "pragma", "nullptr", "true", "false"};
+                spec.declarationKeywords = {"int", "float", "double", "char", "void", "bool", "long", "short", "unsigned", "signed", "class", "struct", "union", "enum", "public", "private", "protected", "virtual", "friend", "static", "const", "mutable", "volatile", "register", "auto", "extern", "template", "typename", "typedef", "operator"};
+            }
+        }
+    }
+
+    std::string LanguageSpec::canonicalLanguage(const std::string& lang) {
+        if (lang == "swift") return "swift";
+        if (lang == "python") return "python";
+        if (lang == "r") return "r";
+        if (lang == "rust") return "rust";
+        if (lang == "go" || lang == "golang") return "go";
+        if (lang == "javascript" || lang == "js" || lang == "typescript" || lang == "ts" || lang == "jsx" || lang == "tsx") return "javascript";
+        if (lang == "java") return "java";
+        if (lang == "kotlin" || lang == "kt") return "kotlin";
+        if (lang == "objective-c" || lang == "objc" || lang == "m" || lang == "objective-cpp" || lang == "objcpp" || lang == "mm") return "objc";
+        if (lang == "sql") return "sql";
+        if (lang == "ruby" || lang == "rb") return "ruby";
+        if (lang == "julia" || lang == "jl") return "julia";
+        return "cpp";
+    }
+
+    std::string LanguageSpec::languageForPath(std::string_view path) {
+        size_t slash = path.find_last_of('/');
+        size_t dot = path.find_last_of('.');
+        if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash)) {
+            return "";
+        }
+        std::string ext(path.substr(dot + 1));
+        for (auto& ch : ext) {
+            if (ch >= 'A' && ch <= 'Z') ch = (char)(ch - 'A' + 'a');
+        }
+
+        static const std::unordered_map<std::string, std::string> kExtensions = {
+            {"swift", "swift"}, {"py", "python"}, {"r", "r"}, {"rs", "rust"}, {"go", "go"},
+            {"js", "javascript"}, {"jsx", "javascript"}, {"mjs", "javascript"}, {"cjs", "javascript"},
+            {"ts", "typescript"}, {"tsx", "typescript"}, {"java", "java"}, {"kt", "kotlin"}, {"kts", "kotlin"},
+            {"m", "objc"}, {"mm", "objc"}, {"sql", "sql"}, {"rb", "ruby"}, {"jl", "julia"},
+            {"c", "c"}, {"h", "cpp"}, {"cc", "cpp"}, {"cpp", "cpp"}, {"cxx", "cpp"}, {"hpp", "cpp"}, {"hh", "cpp"}
+        };
+        auto it = kExtensions.find(ext);
+        return it != kExtensions.end() ? it->second : "";
+    }
+
+    std::shared_ptr<const LanguageSpec> LanguageSpec::forLanguage(const std::string& lang) {
+        static std::mutex mutex;
+        static std::unordered_map<std::string, std::shared_ptr<const LanguageSpec>> cache;
+
+        std::string canonical = canonicalLanguage(lang);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find(canonical);
+        if (it != cache.end()) {
+            return it->second;
+        }
+        auto spec = std::make_shared<LanguageSpec>();
+        spec->language = canonical;
+        fillSpec(*spec);
+        spec->blockComments = !(canonical == "python" || canonical == "r" || canonical == "ruby" || canonical == "julia");
+        spec->tripleQuotes = (canonical == "python" || canonical == "swift" || canonical == "kotlin" ||
+                              canonical == "julia" || canonical == "java");
+        spec->tripleSingleQuotes = (canonical == "python");
+        cache.emplace(canonical, spec);
+        return spec;
+    }
+
+    Engine::Engine(const std::string& lang) : _spec(LanguageSpec::forLanguage(lang)) {}
+
+    std::vector<Token> Engine::tokenize(std::string_view source) const {
+        std::vector<Token> tokens;
+        tokens.reserve(source.size() / 6);
+        tokenize(source, tokens);
+        return tokens;
+    }
+
+    void Engine::tokenize(std::string_view source, std::vector<Token>& tokens) const {
+        tokens.clear();
+        State state = State::Normal;
+        size_t lineStart = 0;
+        while (lineStart <= source.size()) {
+            size_t newline = source.find('\n', lineStart);
+            size_t lineEnd = (newline == std::string_view::npos) ? source.size() : newline;
+            state = tokenizeLine(source, lineStart, lineEnd, state, tokens);
+            if (newline == std::string_view::npos) break;
+            lineStart = newline + 1;
+        }
+    }
+
+    State Engine::tokenizeLine(std::string_view source, size_t lineStart, size_t lineEnd, State state, std::vector<Token>& tokens) const {
+        size_t i = lineStart;
+        const size_t len = lineEnd;
+        const std::string_view line = source.substr(0, len);
+
+        auto push = [&tokens](TokenType type, size_t start, size_t length, uint8_t flags = TokenFlagNone) {
+            tokens.push_back({type, flags, static_cast<uint32_t>(start), static_cast<uint32_t>(length)});
+        };
+
+        // Offset just past `close` in [from, len), or npos.
+        auto findClose = [&line](size_t from, std::string_view close) -> size_t {
+            size_t at = line.find(close, from);
+            return at == std::string_view::npos ? at : at + close.size();
+        };
+
+        // 0. Constructs continued from the previous line
+        if (state == State::InCommentBlock || state == State::InStringTripleDouble || state == State::InStringTripleSingle) {
+            std::string_view close = kBlockComment.close;
+            if (state == State::InStringTripleDouble) close = kTripleDouble;
+            if (state == State::InStringTripleSingle) close = kTripleSingle;
+            TokenType type = (state == State::InCommentBlock) ? TokenType::Comment : TokenType::String;
+            size_t end = findClose(i, close);
+            if (end == std::string_view::npos) {
+                if (len > i) push(type, i, len - i, TokenFlagContinued);
+                return state;
+            }
+            push(type, i, end - i, TokenFlagContinued);
+            i = end;
+            state = State::Normal;
+        }
+
+        while (i < len) {
+            char c = source[i];
+            uint8_t k = classOf(c);
+
+            // Whitespace
+            if (k == ClassSpace) {
+                i++;
+                continue;
+            }
+
+            // Multi-line strings (""" and, for Python, three single quotes)
+            if (_spec->tripleQuotes && (c == '"' || (c == '\'' && _spec->tripleSingleQuotes)) &&
+                i + 2 < len && source[i+1] == c && source[i+2] == c) {
+                std::string_view close = (c == '"') ? kTripleDouble : kTripleSingle;
+                size_t end = findClose(i + 3, close);
+                if (end == std::string_view::npos) {
+                    push(TokenType::String, i, len - i, TokenFlagOpensBlock);
+                    return (c == '"') ? State::InStringTripleDouble : State::InStringTripleSingle;
+                }
+                push(TokenType::String, i, end - i);
+                i = end;
+                continue;
+            }
+
+            // Strings (end at the line break when unterminated)
+            if (c == '"' || c == '\'') {
+                size_t start = i;
+                char quote = c;
+                i++;
+                while (i < len && source[i] != quote) {
+                    if (source[i] == '\\' && i + 1 < len) i++; // Skip escape
+                    i++;
+                }
+                uint8_t flags = TokenFlagNone;
+                if (i < len) {
+                    i++; // Consume closing quote
+                } else {
+                    flags = TokenFlagUnterminated;
+                }
+                push(TokenType::String, start, i - start, flags);
+                continue;
+            }
+
+            // Comments (Block) /* */
+            if (_spec->blockComments && c == '/' && i + 1 < len && source[i+1] == '*') {
+                size_t end = findClose(i + 2, kBlockComment.close);
+                if (end == std::string_view::npos) {
+                    push(TokenType::Comment, i, len - i, TokenFlagOpensBlock);
+                    return State::InCommentBlock;
+                }
+                push(TokenType::Comment, i, end - i);
+                i = end;
+                continue;
+            }
+
+            // Comments (Line) // and # (Python, R, Ruby, Shell)
+            if ((c == '/' && i + 1 < len && source[i+1] == '/') || c == '#') {
+                push(TokenType::Comment, i, len - i);
+                i = len;
+                continue;
+            }
+
+            // Numbers
+            if (k == ClassDigit) {
+                size_t start = i;
+                while (i < len && (classOf(source[i]) == ClassDigit || source[i] == '.')) {
+                    i++;
+                }
+                push(TokenType::Number, start, i - start);
+                continue;
+            }
+
+            // Identifiers / Keywords
+            if (k == ClassAlpha) {
+                size_t start = i;
+                while (i < len && isWordChar(source[i])) {
+                    i++;
+                }
+                std::string_view word = source.substr(start, i - start);
+
+                if (_spec->declarationKeywords.count(word)) {
+                    push(TokenType::KeywordDeclaration, start, i - start);
+                } else if (_spec->keywords.count(word)) {
+                    push(TokenType::Keyword, start, i - start);
+                } else if (word[0] >= 'A' && word[0] <= 'Z') {
+                    // Heuristic for types (start with uppercase)
+                    push(TokenType::Type, start, i - start);
+                } else {
+                    // Check for function call (same line only, so lines lex independently)
+                    size_t nextC = i;
+                    while (nextC < len && classOf(source[nextC]) == ClassSpace) nextC++;
+                    if (nextC < len && source[nextC] == '(') {
+                        push(TokenType::Function, start, i - start);
+                    } else {
+                        push(TokenType::Identifier, start, i - start);
+                    }
+                }
+                continue;
+            }
+
+            // Operators / Punctuation
+            if (k == ClassPunct) {
+                push(TokenType::Punctuation, i, 1);
+                i++;
+                continue;
+            }
+
+            i++; // Fallback
+        }
+        return State::Normal;
+    }
+}
@@ -0,0 +1,108 @@
+//
+//  MicroLexer.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// MARK: - C++ Core Lexer
+// Foundation-free so it can run on worker threads and on non-Apple platforms.
+
+namespace MicroLexer {
+
+    // Values mirror AuthenticTokenType (AuthenticSyntaxEngine.h) one-to-one.
+    enum class TokenType : uint8_t {
+        Unknown = 0,
+        Keyword,
+        KeywordDeclaration,
+        Identifier,
+        String,
+        Number,
+        Comment,
+        Type,
+        Function,
+        Operator,
+        Punctuation,
+        Preprocessor,
+        URL,
+        KeywordControl,
+        KeywordModifier
+    };
+
+    /// Lexer state carried from the end of one line to the start of the next.
+    enum class State : uint8_t {
+        Normal,
+        InStringDouble,
+        InStringSingle,
+        InCommentLine,
+        InCommentBlock,
+        InStringTripleDouble,
+        InStringTripleSingle
+    };
+
+    enum TokenFlags : uint8_t {
+        TokenFlagNone = 0,
+        TokenFlagUnterminated = 1 << 0, // Quote not closed before the end of the line
+        TokenFlagOpensBlock = 1 << 1,   // Block comment / multi-line string continues on the next line
+        TokenFlagContinued = 1 << 2     // Continuation of a construct opened on an earlier line
+    };
+
+    /// Byte-offset token. 12 bytes so a 100k-token file stays around 1 MB.
+    struct Token {
+        TokenType type;
+        uint8_t flags;
+        uint32_t start;
+        uint32_t length;
+    };
+
+    /// Immutable per-language tables. One instance per language is shared by
+    /// every Engine (and every open document) for the lifetime of the process.
+    /// Keyword views point at string literals, so lookups never allocate.
+    struct LanguageSpec {
+        std::string language; // Canonical id ("swift", "python", "cpp", ...)
+        std::unordered_set<std::string_view> keywords;
+        std::unordered_set<std::string_view> declarationKeywords;
+        bool blockComments = true;       // Slash-star comments
+        bool tripleQuotes = false;       // Triple-quoted multi-line strings
+        bool tripleSingleQuotes = false; // Python's single-quote variant
+
+        /// Returns the shared spec for `lang`, building it on first use. Thread-safe.
+        static std::shared_ptr<const LanguageSpec> forLanguage(const std::string& lang);
+
+        /// Maps aliases ("js", "golang", "mm", ...) to the canonical id.
+        static std::string canonicalLanguage(const std::string& lang);
+
+        /// Language id for a file path based on its extension, or "" if it is not source code.
+        static std::string languageForPath(std::string_view path);
+    };
+
+    class Engine {
+    public:
+        explicit Engine(const std::string& lang);
+
+        std::vector<Token> tokenize(std::string_view source) const;
+
+        /// Same as tokenize(), reusing `tokens`' capacity.
+        void tokenize(std::string_view source, std::vector<Token>& tokens) const;
+
+        /// Appends the tokens of the line [lineStart, lineEnd) (lineEnd excludes the
+        /// newline) to `tokens`, with offsets into `source`. Returns the state the
+        /// next line starts in. A line's tokens depend only on its text and `state`.
+        State tokenizeLine(std::string_view source, size_t lineStart, size_t lineEnd, State state, std::vector<Token>& tokens) const;
+
+        const LanguageSpec& spec() const { return *_spec; }
+
+    private:
+        std::shared_ptr<const LanguageSpec> _spec;
+    };
+}
@@ -0,0 +1,137 @@
+//
+//  MicroLineIndex.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroLineIndex.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MICRO_LINES_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MICRO_LINES_NEON 1
+#endif
+
+namespace MicroCore {
+
+    namespace {
+
+        // Calls `emit(i)` for every '\n' at units[i], in order. Blocks of eight
+        // units without one are skipped with a single compare.
+        template <typename Emit>
+        void forEachNewline(const char16_t *units, size_t count, Emit&& emit) {
+            size_t i = 0;
+#if MICRO_LINES_SSE2
+            const __m128i newline = _mm_set1_epi16('\n');
+            for (; i + 8 <= count; i += 8) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(units + i));
+                unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(block, newline));
+                while (mask) {
+                    // Two mask bits per 16-bit unit
+                    emit(i + (size_t)__builtin_ctz(mask) / 2);
+                    mask &= mask - 1;
+                    mask &= mask - 1;
+                }
+            }
+#elif MICRO_LINES_NEON
+            const uint16x8_t newline = vdupq_n_u16('\n');
+            for (; i + 8 <= count; i += 8) {
+                uint16x8_t hits = vceqq_u16(vld1q_u16(reinterpret_cast<const uint16_t *>(units + i)), newline);
+                uint64x2_t halves = vreinterpretq_u64_u16(hits);
+                if ((vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) == 0) continue;
+                for (size_t j = i; j < i + 8; j++) {
+                    if (units[j] == u'\n') emit(j);
+                }
+            }
+#endif
+            for (; i < count; i++) {
+                if (units[i] == u'\n') emit(i);
+            }
+        }
+    }
+
+    void LineIndex::clear() {
+        _lineStarts.assign(1, 0);
+        _length = 0;
+    }
+
+    size_t LineIndex::countNewlines(const char16_t *units, size_t count) {
+        size_t newlines = 0;
+        size_t i = 0;
+#if MICRO_LINES_SSE2
+        const __m128i newline = _mm_set1_epi16('\n');
+        for (; i + 8 <= count; i += 8) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(units + i));
+            newlines += (size_t)__builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(block, newline))) / 2;
+        }
+#elif MICRO_LINES_NEON
+        const uint16x8_t newline = vdupq_n_u16('\n');
+        for (; i + 8 <= count; i += 8) {
+            // Matching lanes are all ones; shifting leaves 1 per match.
+            uint16x8_t hits = vshrq_n_u16(vceqq_u16(vld1q_u16(reinterpret_cast<const uint16_t *>(units + i)), newline), 15);
+            newlines += vaddvq_u16(hits);
+        }
+#endif
+        for (; i < count; i++) {
+            if (units[i] == u'\n') newlines++;
+        }
+        return newlines;
+    }
+
+    void LineIndex::append(const char16_t *units, size_t count) {
+        if (count == 0) return;
+        _lineStarts.reserve(_lineStarts.size() + countNewlines(units, count));
+        const size_t base = _length;
+        forEachNewline(units, count, [this, base](size_t i) {
+            _lineStarts.push_back((uint32_t)(base + i + 1));
+        });
+        _length += count;
+    }
+
+    void LineIndex::applyEdit(size_t start, size_t removedLength, const char16_t *inserted, size_t insertedLength) {
+        start = std::min(start, _length);
+        removedLength = std::min(removedLength, _length - start);
+        const size_t end = start + removedLength;
+
+        // Lines starting in (start, end] began after a removed newline.
+        auto first = std::upper_bound(_lineStarts.begin(), _lineStarts.end(), (uint32_t)start);
+        auto last = std::upper_bound(first, _lineStarts.end(), (uint32_t)end);
+
+        _fresh.clear();
+        forEachNewline(inserted, insertedLength, [this, start](size_t i) {
+            _fresh.push_back((uint32_t)(start + i + 1));
+        });
+
+        const int64_t delta = (int64_t)insertedLength - (int64_t)removedLength;
+        if (delta != 0) {
+            for (auto it = last; it != _lineStarts.end(); ++it) {
+                *it = (uint32_t)((int64_t)*it + delta);
+            }
+        }
+
+        const size_t firstIndex = (size_t)(first - _lineStarts.begin());
+        const size_t replaced = (size_t)(last - first);
+        if (_fresh.size() > replaced) {
+            _lineStarts.insert(last, _fresh.size() - replaced, 0);
+        } else if (_fresh.size() < replaced) {
+            _lineStarts.erase(first + (ptrdiff_t)_fresh.size(), last);
+        }
+        std::copy(_fresh.begin(), _fresh.end(), _lineStarts.begin() + (ptrdiff_t)firstIndex);
+        _length = (size_t)((int64_t)_length + delta);
+    }
+
+    size_t LineIndex::lineForOffset(size_t offset) const {
+        auto it = std::upper_bound(_lineStarts.begin(), _lineStarts.end(), (uint32_t)std::min(offset, _length));
+        return (size_t)(it - _lineStarts.begin()) - 1;
+    }
+
+    size_t LineIndex::memoryFootprint() const {
+        return (_lineStarts.capacity() + _fresh.capacity()) * sizeof(uint32_t);
+    }
+}
@@ -0,0 +1,58 @@
+//
+//  MicroLineIndex.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// MARK: - MicroCore Line Index (C++)
+// Line starts of a UTF-16 document, in the code units AppKit's NSString ranges use,
+// so an offset -> line lookup costs the same anywhere in the file. The index is
+// built with a vectorized newline scan and patched in place on every edit: starts
+// inside the edited range are replaced and later ones shifted. Only the edit's
+// inserted text is needed, not the document.
+
+namespace MicroCore {
+
+    class LineIndex {
+    public:
+        LineIndex() { clear(); }
+
+        /// Back to an empty document (one empty line).
+        void clear();
+
+        /// Appends text to the end of the document; call repeatedly to index a
+        /// document in chunks.
+        void append(const char16_t *units, size_t count);
+
+        /// Replaces `removedLength` units at `start` with `inserted`. Out-of-range
+        /// edits are clamped to the document.
+        void applyEdit(size_t start, size_t removedLength, const char16_t *inserted, size_t insertedLength);
+
+        /// Document length in code units.
+        size_t length() const { return _length; }
+
+        size_t lineCount() const { return _lineStarts.size(); }
+        size_t lineStart(size_t line) const { return _lineStarts[line]; }
+
+        /// 0-based line containing `offset` (the last line past the end). O(log n).
+        size_t lineForOffset(size_t offset) const;
+
+        /// Number of '\n' units in `units`.
+        static size_t countNewlines(const char16_t *units, size_t count);
+
+        size_t memoryFootprint() const;
+
+    private:
+        std::vector<uint32_t> _lineStarts; // Starts with 0
+        std::vector<uint32_t> _fresh;      // Scratch for applyEdit()
+        size_t _length = 0;
+    };
+}
@@ -0,0 +1,80 @@
+//
+//  MicroMappedFile.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroMappedFile.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace MicroCore {
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)) {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+        }
+        return *this;
+    }
+
+    bool MappedFile::open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct stat sb;
+        if (fstat(fd, &sb) != 0 || sb.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void *addr = mmap(nullptr, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps the file alive
+        if (addr == MAP_FAILED) return false;
+
+        _data = static_cast<const uint8_t *>(addr);
+        _size = (size_t)sb.st_size;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (_data) {
+            munmap(const_cast<uint8_t *>(_data), _size);
+            _data = nullptr;
+            _size = 0;
+        }
+    }
+
+    bool writeFileAtomically(const std::string& path, const void *data, size_t size) {
+        std::string tmpPath = path + ".tmp";
+        int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+
+        const uint8_t *cursor = static_cast<const uint8_t *>(data);
+        size_t remaining = size;
+        while (remaining > 0) {
+            ssize_t written = ::write(fd, cursor, remaining);
+            if (written <= 0) {
+                ::close(fd);
+                ::unlink(tmpPath.c_str());
+                return false;
+            }
+            cursor += written;
+            remaining -= (size_t)written;
+        }
+        ::close(fd);
+        return ::rename(tmpPath.c_str(), path.c_str()) == 0;
+    }
+}
@@ -0,0 +1,44 @@
+//
+//  MicroMappedFile.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace MicroCore {
+
+    /// Read-only memory mapping of a whole file. Move-only.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// Returns false if the file is missing, empty or cannot be mapped.
+        bool open(const std::string& path);
+        void close();
+
+        bool isOpen() const { return _data != nullptr; }
+        const uint8_t *data() const { return _data; }
+        size_t size() const { return _size; }
+
+    private:
+        const uint8_t *_data = nullptr;
+        size_t _size = 0;
+    };
+
+    /// Writes to "<path>.tmp" and renames over `path`, so readers that still map
+    /// the old file keep a consistent view.
+    bool writeFileAtomically(const std::string& path, const void *data, size_t size);
+}
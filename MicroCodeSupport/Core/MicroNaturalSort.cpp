@@ -0,0 +1,281 @@
+//
+//  MicroNaturalSort.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroNaturalSort.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace MicroFiles {
+
+    namespace {
+
+        // Primary classes. Every byte of a letter's UTF-8 is >= 0x41, so letter runs
+        // need their class byte only once: a following class byte already sorts
+        // below any letter.
+        constexpr char kEnd = 0x00;
+        constexpr char kPunctuation = 0x01;
+        constexpr char kNumber = 0x02;
+        constexpr char kLetters = 0x03;
+
+        // Parallel sorting only pays off past this many names.
+        constexpr size_t kParallelThreshold = 16384;
+
+        // CLDR root order of the ASCII whitespace, punctuation and symbols.
+        constexpr char kPunctuationOrder[] =
+            "\t\n\v\f\r _-,;:!?.'\"()[]{}@*/\\&#%`^+<=>|~$";
+
+        struct PunctuationRanks {
+            uint8_t rank[128] = {};
+            PunctuationRanks() {
+                for (size_t i = 0; i + 1 < sizeof(kPunctuationOrder); i++) {
+                    rank[(uint8_t)kPunctuationOrder[i]] = (uint8_t)(i + 1);
+                }
+            }
+        };
+
+        const PunctuationRanks& punctuationRanks() {
+            static const PunctuationRanks ranks;
+            return ranks;
+        }
+
+        // Base letters of U+00C0...U+00FF; '*' marks the two symbols (U+00D7 and
+        // U+00F7) and a space marks letters that have no base. ß, Æ and æ are
+        // expanded by the caller.
+        constexpr char kLatin1Base[] =
+            "aaaaaaaceeeeiiiidnooooo*ouuuuy s"
+            "aaaaaaaceeeeiiiidnooooo*ouuuuy y";
+
+        struct Folded {
+            uint32_t codePoint;
+            bool accented;
+            bool upper;
+            bool symbol;
+        };
+
+        Folded fold(uint32_t c) {
+            if (c < 0x80) {
+                bool upper = c >= 'A' && c <= 'Z';
+                return {upper ? c + 0x20 : c, false, upper, false};
+            }
+            if (c >= 0xC0 && c <= 0xFF) {
+                char base = kLatin1Base[c - 0xC0];
+                if (base == '*') return {c, false, false, true};
+                bool upper = c < 0xDF;
+                if (base == ' ') return {upper ? c + 0x20 : c, false, upper, false};
+                return {(uint32_t)base, true, upper, false};
+            }
+            if (c >= 0x391 && c <= 0x3A9) return {c + 0x20, false, true, false};  // Greek
+            if (c >= 0x410 && c <= 0x42F) return {c + 0x20, false, true, false};  // Cyrillic
+            if (c >= 0x400 && c <= 0x40F) return {c + 0x50, false, true, false};
+            return {c, false, false, false};
+        }
+
+        /// Decodes one code point; invalid bytes decode as themselves.
+        uint32_t decode(const unsigned char *s, size_t length, size_t& consumed) {
+            unsigned char c = s[0];
+            consumed = 1;
+            if (c < 0x80) return c;
+            size_t need;
+            uint32_t cp;
+            if (c >= 0xC2 && c <= 0xDF) { need = 2; cp = c & 0x1F; }
+            else if (c >= 0xE0 && c <= 0xEF) { need = 3; cp = c & 0x0F; }
+            else if (c >= 0xF0 && c <= 0xF4) { need = 4; cp = c & 0x07; }
+            else return c;
+            if (length < need) return c;
+            for (size_t i = 1; i < need; i++) {
+                if ((s[i] & 0xC0) != 0x80) return c;
+                cp = (cp << 6) | (s[i] & 0x3F);
+            }
+            consumed = need;
+            return cp;
+        }
+
+        void appendUTF8(uint32_t c, std::string& out) {
+            if (c < 0x80) {
+                out.push_back((char)c);
+            } else if (c < 0x800) {
+                out.push_back((char)(0xC0 | (c >> 6)));
+                out.push_back((char)(0x80 | (c & 0x3F)));
+            } else if (c < 0x10000) {
+                out.push_back((char)(0xE0 | (c >> 12)));
+                out.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+                out.push_back((char)(0x80 | (c & 0x3F)));
+            } else {
+                out.push_back((char)(0xF0 | (c >> 18)));
+                out.push_back((char)(0x80 | ((c >> 12) & 0x3F)));
+                out.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+                out.push_back((char)(0x80 | (c & 0x3F)));
+            }
+        }
+
+        struct Item {
+            uint64_t prefix;   // First 8 key bytes, big-endian, zero padded
+            uint32_t index;
+            uint32_t offset;   // Key in the pool of the name's block
+            uint32_t length;
+            bool directory;
+        };
+
+        uint64_t prefixOf(const char *key, size_t length) {
+            uint64_t prefix = 0;
+            for (size_t i = 0; i < 8; i++) {
+                prefix = (prefix << 8) | (i < length ? (uint8_t)key[i] : 0);
+            }
+            return prefix;
+        }
+    }
+
+    void appendNaturalKey(std::string_view name, std::string& key) {
+        const PunctuationRanks& ranks = punctuationRanks();
+        const unsigned char *s = reinterpret_cast<const unsigned char *>(name.data());
+        size_t length = name.size();
+
+        std::string accents;  // Secondary level
+        std::string cases;    // Tertiary level
+        key.reserve(key.size() + length * 3 + 4);
+
+        bool inLetters = false;
+        for (size_t i = 0; i < length;) {
+            if (s[i] >= '0' && s[i] <= '9') {
+                size_t start = i;
+                while (i < length && s[i] == '0') i++;
+                size_t zeros = i - start;
+                size_t digits = i;
+                while (i < length && s[i] >= '0' && s[i] <= '9') i++;
+                size_t significant = i - digits;
+
+                key.push_back(kNumber);
+                key.push_back((char)std::min<size_t>(significant, 0xFF));
+                key.append(name.data() + digits, significant);
+                cases.push_back((char)std::min<size_t>(zeros + 1, 0xFF));
+                inLetters = false;
+                continue;
+            }
+
+            size_t consumed;
+            uint32_t c = decode(s + i, length - i, consumed);
+            i += consumed;
+            bool stray = consumed == 1 && c >= 0x80;
+            if (c >= 0x300 && c <= 0x36F) {
+                // Combining mark (decomposed names, as HFS+ stores them): an accent on
+                // the previous letter, not a letter of its own.
+                if (!accents.empty()) accents.back() = 2;
+                continue;
+            }
+            Folded folded = stray ? Folded{c, false, false, false} : fold(c);
+
+            if (folded.symbol || (c < 0x80 && ranks.rank[c] != 0) || c < 0x20) {
+                key.push_back(kPunctuation);
+                key.push_back((char)(c < 0x80 && ranks.rank[c] ? ranks.rank[c] : 0x7F));
+                inLetters = false;
+                continue;
+            }
+
+            if (!inLetters) key.push_back(kLetters);
+            inLetters = true;
+            if (!stray && (c == 0xDF || c == 0xC6 || c == 0xE6)) {
+                // ß, Æ and æ expand to two letters, as in the system collation.
+                key.append(c == 0xDF ? "ss" : "ae");
+                accents.append("\x01\x02");
+                cases.append(c == 0xC6 ? "\x02\x02" : "\x01\x01");
+                continue;
+            }
+            if (stray) {
+                // A stray byte: keep it, above every valid letter of the same lead.
+                key.push_back((char)0xF8);
+                key.push_back((char)c);
+            } else {
+                appendUTF8(folded.codePoint, key);
+            }
+            accents.push_back(folded.accented ? 2 : 1);
+            cases.push_back(folded.upper ? 2 : 1);
+        }
+
+        key.push_back(kEnd);
+        key.append(accents);
+        key.push_back(kEnd);
+        key.append(cases);
+        key.push_back(kEnd);
+        key.append(name.data(), length);
+    }
+
+    std::vector<uint32_t> naturalOrder(const std::vector<std::string_view>& names,
+                                       const std::vector<bool> *directories,
+                                       MicroCore::ThreadPool *pool) {
+        size_t count = names.size();
+        bool parallel = pool && pool->size() > 1 && count >= kParallelThreshold;
+
+        // Keys are built into one pool per block of names, so comparisons that get
+        // past the prefix read nearby memory.
+        constexpr size_t kBlock = 1024;
+        size_t blocks = (count + kBlock - 1) / kBlock;
+        std::vector<std::string> pools(blocks);
+        std::vector<Item> items(count);
+        auto keyBlocks = [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; b++) {
+                std::string& keys = pools[b];
+                size_t last = std::min(count, (b + 1) * kBlock);
+                for (size_t i = b * kBlock; i < last; i++) {
+                    uint32_t offset = (uint32_t)keys.size();
+                    appendNaturalKey(names[i], keys);
+                    items[i] = {0, (uint32_t)i, offset, (uint32_t)(keys.size() - offset),
+                                directories && (*directories)[i]};
+                }
+                // Prefixes only once the pool stops moving.
+                for (size_t i = b * kBlock; i < last; i++) {
+                    items[i].prefix = prefixOf(keys.data() + items[i].offset, items[i].length);
+                }
+            }
+        };
+
+        auto keyOf = [&](const Item& item) {
+            return std::string_view(pools[item.index / kBlock].data() + item.offset, item.length);
+        };
+        auto before = [&](const Item& a, const Item& b) {
+            if (a.directory != b.directory) return a.directory;
+            if (a.prefix != b.prefix) return a.prefix < b.prefix;
+            return keyOf(a) < keyOf(b);
+        };
+
+        if (!parallel) {
+            keyBlocks(0, blocks);
+            std::sort(items.begin(), items.end(), before);
+        } else {
+            pool->parallelFor(blocks, 1, keyBlocks);
+
+            // Sort one run per worker, then merge runs pairwise.
+            size_t runs = pool->size() + 1;
+            size_t runLength = (count + runs - 1) / runs;
+            pool->parallelFor(runs, 1, [&](size_t begin, size_t end) {
+                for (size_t r = begin; r < end; r++) {
+                    size_t from = std::min(count, r * runLength);
+                    size_t to = std::min(count, from + runLength);
+                    std::sort(items.begin() + from, items.begin() + to, before);
+                }
+            });
+            for (size_t width = runLength; width < count; width *= 2) {
+                size_t merges = (count + 2 * width - 1) / (2 * width);
+                pool->parallelFor(merges, 1, [&](size_t begin, size_t end) {
+                    for (size_t m = begin; m < end; m++) {
+                        size_t from = m * 2 * width;
+                        size_t middle = std::min(count, from + width);
+                        size_t to = std::min(count, from + 2 * width);
+                        std::inplace_merge(items.begin() + from, items.begin() + middle, items.begin() + to, before);
+                    }
+                });
+            }
+        }
+
+        std::vector<uint32_t> order(count);
+        for (size_t i = 0; i < count; i++) {
+            order[i] = items[i].index;
+        }
+        return order;
+    }
+}
@@ -0,0 +1,51 @@
+//
+//  MicroNaturalSort.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroThreadPool.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - MicroFiles (C++)
+// Finder-style ("natural") ordering of file names, computed once per name as a
+// binary collation key so sorting is a memcmp per comparison instead of a
+// localized compare. Keys compare in three levels, like the system collation:
+//
+//   1. Primary: whitespace and punctuation (in CLDR root order) before numbers
+//      before letters. Digit runs compare by magnitude (significant digit count,
+//      then digits); letters are case-folded with Latin-1 accents and combining
+//      marks removed, so precomposed and decomposed names sort alike.
+//   2. Accents: unaccented before accented, left to right.
+//   3. Case and zeros: lowercase before uppercase, fewer leading zeros first.
+//
+// The raw bytes break any remaining tie, so the order is total. Names that are
+// not valid UTF-8 sort their stray bytes as letters.
+
+namespace MicroFiles {
+
+    /// Appends the collation key of the UTF-8 `name` to `key`.
+    void appendNaturalKey(std::string_view name, std::string& key);
+
+    /// Collation key of `name`.
+    inline std::string naturalKey(std::string_view name) {
+        std::string key;
+        appendNaturalKey(name, key);
+        return key;
+    }
+
+    /// Natural order of `names`, directories first when `directories` is given
+    /// (one flag per name). Returns the permutation: result[i] is the index of
+    /// the i-th name. With a pool, large inputs are keyed and sorted in parallel.
+    std::vector<uint32_t> naturalOrder(const std::vector<std::string_view>& names,
+                                       const std::vector<bool> *directories = nullptr,
+                                       MicroCore::ThreadPool *pool = nullptr);
+}
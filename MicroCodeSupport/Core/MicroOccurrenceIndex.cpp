@@ -0,0 +1,243 @@
+//
+//  MicroOccurrenceIndex.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroOccurrenceIndex.h"
+
+#include <algorithm>
+
+namespace MicroIndex {
+
+    using MicroLexer::IncrementalLexer;
+    using MicroLexer::Token;
+    using MicroLexer::TokenType;
+
+    bool OccurrenceIndex::isIdentifierToken(const Token& token) {
+        return token.type == TokenType::Identifier || token.type == TokenType::Function || token.type == TokenType::Type;
+    }
+
+    // MARK: - Interning
+
+    uint32_t OccurrenceIndex::intern(std::string_view name) {
+        auto it = _ids.find(name);
+        if (it != _ids.end()) {
+            return it->second;
+        }
+        uint32_t identifier;
+        if (!_freeIds.empty()) {
+            identifier = _freeIds.back();
+            _freeIds.pop_back();
+            _names[identifier].assign(name.data(), name.size());
+        } else {
+            identifier = static_cast<uint32_t>(_names.size());
+            _names.emplace_back(name);
+            _lists.emplace_back();
+        }
+        _ids.emplace(_names[identifier], identifier);
+        return identifier;
+    }
+
+    void OccurrenceIndex::release(uint32_t identifier) {
+        _ids.erase(_names[identifier]);
+        _names[identifier].clear();
+        _lists[identifier].shrink_to_fit();
+        _freeIds.push_back(identifier);
+    }
+
+    uint32_t OccurrenceIndex::identifierNamed(std::string_view name) const {
+        auto it = _ids.find(name);
+        return it != _ids.end() ? it->second : kNoIdentifier;
+    }
+
+    // MARK: - Building
+
+    uint32_t OccurrenceIndex::allocateKey(uint32_t line) {
+        uint32_t key;
+        if (!_freeKeys.empty()) {
+            key = _freeKeys.back();
+            _freeKeys.pop_back();
+        } else {
+            key = static_cast<uint32_t>(_keyLines.size());
+            _keyLines.push_back(0);
+            _keyEntries.emplace_back();
+        }
+        _keyLines[key] = line;
+        return key;
+    }
+
+    void OccurrenceIndex::collectLine(const IncrementalLexer& lexer, size_t line, uint32_t key) {
+        const std::string& source = lexer.source();
+        const size_t lineStart = lexer.lineStart(line);
+        std::vector<LineEntry>& entries = _keyEntries[key];
+        for (size_t i = lexer.firstTokenOfLine(line); i < lexer.firstTokenOfLine(line + 1); i++) {
+            const Token& t = lexer.tokens()[i];
+            if (!isIdentifierToken(t)) continue;
+            uint32_t identifier = intern(std::string_view(source.data() + t.start, t.length));
+            uint32_t column = static_cast<uint32_t>(t.start - lineStart);
+            entries.push_back({identifier, column});
+            _fresh.push_back({identifier, {key, column}});
+        }
+    }
+
+    void OccurrenceIndex::reset(const IncrementalLexer& lexer) {
+        _names.clear();
+        _ids.clear();
+        _lists.clear();
+        _freeIds.clear();
+        _lineKeys.clear();
+        _keyLines.clear();
+        _keyEntries.clear();
+        _freeKeys.clear();
+        _fresh.clear();
+
+        for (size_t line = 0; line < lexer.lineCount(); line++) {
+            uint32_t key = allocateKey(static_cast<uint32_t>(line));
+            _lineKeys.push_back(key);
+            collectLine(lexer, line, key);
+        }
+        // Collected in document order, so every list comes out sorted.
+        for (const auto& item : _fresh) {
+            _lists[item.first].push_back(item.second);
+        }
+        _fresh.clear();
+    }
+
+    size_t OccurrenceIndex::lowerBound(const std::vector<Entry>& list, uint32_t line) const {
+        auto it = std::lower_bound(list.begin(), list.end(), line, [this](const Entry& entry, uint32_t value) {
+            return _keyLines[entry.key] < value;
+        });
+        return static_cast<size_t>(it - list.begin());
+    }
+
+    void OccurrenceIndex::applyEdit(const IncrementalLexer& lexer, const MicroLexer::EditResult& edit) {
+        if (_lineKeys.size() != lexer.lineCount() - edit.lineDelta) {
+            reset(lexer);
+            return;
+        }
+        const uint32_t firstLine = static_cast<uint32_t>(edit.firstLine);
+        const uint32_t oldEnd = static_cast<uint32_t>(edit.firstLine + edit.oldLineCount);
+
+        // 1. Drop the replaced lines' occurrences (old numbering): one contiguous
+        //    block per affected identifier.
+        _touched.clear();
+        for (uint32_t line = firstLine; line < oldEnd; line++) {
+            for (const LineEntry& entry : _keyEntries[_lineKeys[line]]) {
+                _touched.push_back(entry.identifier);
+            }
+        }
+        std::sort(_touched.begin(), _touched.end());
+        _touched.erase(std::unique(_touched.begin(), _touched.end()), _touched.end());
+        for (uint32_t identifier : _touched) {
+            std::vector<Entry>& list = _lists[identifier];
+            list.erase(list.begin() + lowerBound(list, firstLine), list.begin() + lowerBound(list, oldEnd));
+        }
+        for (uint32_t line = firstLine; line < oldEnd; line++) {
+            uint32_t key = _lineKeys[line];
+            _keyEntries[key].clear();
+            _freeKeys.push_back(key);
+        }
+
+        // 2. New keys for the relexed lines; later lines are only renumbered.
+        const size_t newEnd = edit.firstLine + edit.newLineCount;
+        if (edit.newLineCount > edit.oldLineCount) {
+            _lineKeys.insert(_lineKeys.begin() + oldEnd, edit.newLineCount - edit.oldLineCount, 0);
+        } else {
+            _lineKeys.erase(_lineKeys.begin() + newEnd, _lineKeys.begin() + oldEnd);
+        }
+        for (size_t line = edit.firstLine; line < newEnd; line++) {
+            _lineKeys[line] = allocateKey(static_cast<uint32_t>(line));
+        }
+        if (edit.lineDelta != 0) {
+            for (size_t line = newEnd; line < _lineKeys.size(); line++) {
+                _keyLines[_lineKeys[line]] = static_cast<uint32_t>(line);
+            }
+        }
+
+        // 3. Insert the relexed lines' occurrences, again as one block per identifier.
+        _fresh.clear();
+        for (size_t line = edit.firstLine; line < newEnd; line++) {
+            collectLine(lexer, line, _lineKeys[line]);
+        }
+        std::stable_sort(_fresh.begin(), _fresh.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (size_t i = 0; i < _fresh.size();) {
+            uint32_t identifier = _fresh[i].first;
+            size_t end = i;
+            while (end < _fresh.size() && _fresh[end].first == identifier) end++;
+
+            std::vector<Entry>& list = _lists[identifier];
+            size_t at = lowerBound(list, firstLine);
+            list.insert(list.begin() + at, end - i, Entry());
+            for (size_t j = i; j < end; j++) {
+                list[at + (j - i)] = _fresh[j].second;
+            }
+            i = end;
+        }
+        _fresh.clear();
+
+        // 4. Forget identifiers that no longer occur.
+        for (uint32_t identifier : _touched) {
+            if (_lists[identifier].empty()) {
+                release(identifier);
+            }
+        }
+    }
+
+    // MARK: - Queries
+
+    uint32_t OccurrenceIndex::identifierAt(const IncrementalLexer& lexer, size_t offset) const {
+        size_t line = lexer.lineForOffset(std::min(offset, lexer.source().size()));
+        for (size_t i = lexer.firstTokenOfLine(line); i < lexer.firstTokenOfLine(line + 1); i++) {
+            const Token& t = lexer.tokens()[i];
+            if (t.start > offset) break;
+            if (offset <= t.start + t.length && isIdentifierToken(t)) {
+                return identifierNamed(std::string_view(lexer.source().data() + t.start, t.length));
+            }
+        }
+        return kNoIdentifier;
+    }
+
+    size_t OccurrenceIndex::occurrenceCount(uint32_t identifier) const {
+        return identifier < _lists.size() ? _lists[identifier].size() : 0;
+    }
+
+    OccurrenceIndex::Occurrence OccurrenceIndex::occurrenceFor(const IncrementalLexer& lexer, uint32_t identifier, const Entry& entry) const {
+        uint32_t line = _keyLines[entry.key];
+        return {line, entry.column, static_cast<uint32_t>(lexer.lineStart(line) + entry.column),
+                static_cast<uint32_t>(_names[identifier].size())};
+    }
+
+    void OccurrenceIndex::occurrences(const IncrementalLexer& lexer, uint32_t identifier, std::vector<Occurrence>& out) const {
+        out.clear();
+        if (identifier >= _lists.size()) return;
+        out.reserve(_lists[identifier].size());
+        for (const Entry& entry : _lists[identifier]) {
+            out.push_back(occurrenceFor(lexer, identifier, entry));
+        }
+    }
+
+    void OccurrenceIndex::occurrencesInLines(const IncrementalLexer& lexer, uint32_t identifier,
+                                             size_t firstLine, size_t lastLine, std::vector<Occurrence>& out) const {
+        out.clear();
+        if (identifier >= _lists.size()) return;
+        const std::vector<Entry>& list = _lists[identifier];
+        for (size_t i = lowerBound(list, static_cast<uint32_t>(firstLine)); i < list.size(); i++) {
+            if (_keyLines[list[i].key] > lastLine) break;
+            out.push_back(occurrenceFor(lexer, identifier, list[i]));
+        }
+    }
+
+    size_t OccurrenceIndex::memoryFootprint() const {
+        size_t bytes = (_lineKeys.capacity() + _keyLines.capacity() + _freeKeys.capacity() + _freeIds.capacity()) * sizeof(uint32_t)
+            + _lists.capacity() * sizeof(std::vector<Entry>)
+            + _keyEntries.capacity() * sizeof(std::vector<LineEntry>)
+            + _ids.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void *))
+            + _names.size() * sizeof(std::string);
+        for (const auto& list : _lists) bytes += list.capacity() * sizeof(Entry);
+        for (const auto& entries : _keyEntries) bytes += entries.capacity() * sizeof(LineEntry);
+        return bytes;
+    }
+}
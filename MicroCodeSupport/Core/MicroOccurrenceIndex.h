@@ -0,0 +1,100 @@
+//
+//  MicroOccurrenceIndex.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroIncrementalLexer.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// MARK: - MicroIndex Occurrences (C++)
+// Per-document inverted index: identifier id -> occurrences in document order,
+// built from the lexer's identifier tokens (so strings and comments never match).
+//
+// Occurrences are stored as (line key, column). A line key is a stable handle for
+// a line, so inserting or deleting lines elsewhere only renumbers the key -> line
+// table and leaves every list sorted. An edit removes and re-adds the occurrences
+// of the lines it relexed; those form one contiguous block in each affected list.
+
+namespace MicroIndex {
+
+    class OccurrenceIndex {
+    public:
+        static constexpr uint32_t kNoIdentifier = UINT32_MAX;
+
+        struct Occurrence {
+            uint32_t line;   // 0-based
+            uint32_t column; // Bytes from the line start
+            uint32_t start;  // Byte offset
+            uint32_t length;
+        };
+
+        /// Rebuilds the index from every line of `lexer`.
+        void reset(const MicroLexer::IncrementalLexer& lexer);
+
+        /// Re-indexes the lines `edit` relexed.
+        void applyEdit(const MicroLexer::IncrementalLexer& lexer, const MicroLexer::EditResult& edit);
+
+        /// Id of the identifier token covering `offset` (or ending at it), or kNoIdentifier.
+        uint32_t identifierAt(const MicroLexer::IncrementalLexer& lexer, size_t offset) const;
+        uint32_t identifierNamed(std::string_view name) const;
+        std::string_view name(uint32_t identifier) const { return _names[identifier]; }
+
+        size_t occurrenceCount(uint32_t identifier) const;
+
+        /// Every occurrence, in document order. O(occurrences).
+        void occurrences(const MicroLexer::IncrementalLexer& lexer, uint32_t identifier, std::vector<Occurrence>& out) const;
+
+        /// Occurrences on lines [firstLine, lastLine] (e.g. one scope, for a local
+        /// rename). O(log occurrences + results).
+        void occurrencesInLines(const MicroLexer::IncrementalLexer& lexer, uint32_t identifier,
+                                size_t firstLine, size_t lastLine, std::vector<Occurrence>& out) const;
+
+        size_t memoryFootprint() const;
+
+    private:
+        struct Entry {
+            uint32_t key;
+            uint32_t column;
+        };
+
+        struct LineEntry {
+            uint32_t identifier;
+            uint32_t column;
+        };
+
+        static bool isIdentifierToken(const MicroLexer::Token& token);
+
+        uint32_t intern(std::string_view name);
+        void release(uint32_t identifier);
+        uint32_t allocateKey(uint32_t line);
+        void collectLine(const MicroLexer::IncrementalLexer& lexer, size_t line, uint32_t key);
+        size_t lowerBound(const std::vector<Entry>& list, uint32_t line) const;
+        Occurrence occurrenceFor(const MicroLexer::IncrementalLexer& lexer, uint32_t identifier, const Entry& entry) const;
+
+        // Interned names; a deque keeps the map's string_view keys valid.
+        std::deque<std::string> _names;
+        std::unordered_map<std::string_view, uint32_t> _ids;
+        std::vector<std::vector<Entry>> _lists; // By identifier, sorted by (line, column)
+        std::vector<uint32_t> _freeIds;
+
+        std::vector<uint32_t> _lineKeys;                 // Line -> key
+        std::vector<uint32_t> _keyLines;                 // Key -> line
+        std::vector<std::vector<LineEntry>> _keyEntries; // Key -> identifiers on that line
+        std::vector<uint32_t> _freeKeys;
+
+        // Scratch for applyEdit()
+        std::vector<uint32_t> _touched;
+        std::vector<std::pair<uint32_t, Entry>> _fresh;
+    };
+}
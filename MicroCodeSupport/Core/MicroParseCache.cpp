@@ -0,0 +1,413 @@
+//
+//  MicroParseCache.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroParseCache.h"
+#include "MicroMappedFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+namespace MicroCache {
+
+    using MicroLexer::State;
+    using MicroLexer::Token;
+    using MicroLexer::TokenType;
+
+    namespace {
+
+        constexpr char kMagic[8] = {'M', 'C', 'P', 'A', 'R', 'S', 'E', 'C'};
+        // Bump whenever the lexer or parser output changes for the same text.
+        constexpr uint32_t kVersion = 4;
+        constexpr uint32_t kNoName = UINT32_MAX; // Scope name not in the source ("Global", "Anonymous")
+        constexpr const char *kExtension = ".mcparse";
+
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t tokenCount;
+            uint64_t contentHash;
+            uint64_t sourceSize;
+            uint32_t lineCount;
+            uint32_t scopeCount;
+            uint32_t variableCount;
+            uint32_t importCount;
+            char language[16];
+        };
+
+        struct ScopeRecord {
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            int64_t start;
+            int64_t end;
+            uint32_t firstVariable;
+            uint32_t variableCount;
+            uint8_t kind;
+            uint8_t padding[3];
+            int32_t parent;
+        };
+
+        struct VariableRecord {
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            int64_t line;
+        };
+
+        struct ImportRecord {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        static_assert(sizeof(Header) == 64 && sizeof(ScopeRecord) == 40 && sizeof(VariableRecord) == 16 &&
+                      sizeof(ImportRecord) == 8 && sizeof(Token) == 12,
+                      "On-disk records must keep their size");
+        static_assert(std::is_trivially_copyable<Token>::value, "Tokens are stored by memcpy");
+
+        struct Layout {
+            size_t tokens, lineStarts, lineFirstTokens, lineStates, scopes, variables, imports, total;
+        };
+
+        size_t align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+
+        Layout layoutFor(const Header& h) {
+            Layout l;
+            l.tokens = sizeof(Header);
+            l.lineStarts = align8(l.tokens + (size_t)h.tokenCount * sizeof(Token));
+            l.lineFirstTokens = align8(l.lineStarts + (size_t)h.lineCount * sizeof(uint32_t));
+            l.lineStates = align8(l.lineFirstTokens + ((size_t)h.lineCount + 1) * sizeof(uint32_t));
+            l.scopes = align8(l.lineStates + (size_t)h.lineCount * sizeof(State));
+            l.variables = l.scopes + (size_t)h.scopeCount * sizeof(ScopeRecord);
+            l.imports = l.variables + (size_t)h.variableCount * sizeof(VariableRecord);
+            l.total = l.imports + (size_t)h.importCount * sizeof(ImportRecord);
+            return l;
+        }
+
+        template <typename T>
+        void appendAt(std::string& blob, size_t offset, const T *items, size_t count) {
+            blob.resize(offset, '\0');
+            blob.append(reinterpret_cast<const char *>(items), count * sizeof(T));
+        }
+
+        template <typename T>
+        std::vector<T> readArray(const uint8_t *base, size_t offset, size_t count) {
+            std::vector<T> items(count);
+            if (count) memcpy(items.data(), base + offset, count * sizeof(T));
+            return items;
+        }
+
+        /// Offset of `view` in `source`, or kNoName if it points elsewhere.
+        uint32_t offsetIn(std::string_view view, std::string_view source) {
+            if (view.data() < source.data() || view.data() + view.size() > source.data() + source.size()) {
+                return kNoName;
+            }
+            return static_cast<uint32_t>(view.data() - source.data());
+        }
+
+        bool inSource(uint32_t offset, uint32_t length, size_t sourceSize) {
+            return (uint64_t)offset + length <= sourceSize;
+        }
+
+        void copyLanguage(char (&out)[16], const std::string& language) {
+            memset(out, 0, sizeof(out));
+            memcpy(out, language.data(), std::min(language.size(), sizeof(out) - 1));
+        }
+
+        bool validHeader(const MicroCore::MappedFile& mapping, std::string_view source, uint64_t contentHash,
+                         const std::string& language, Header& h) {
+            if (mapping.size() < sizeof(Header)) return false;
+            memcpy(&h, mapping.data(), sizeof(Header));
+            char expected[16];
+            copyLanguage(expected, language);
+            return memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 && h.version == kVersion &&
+                   h.contentHash == contentHash && h.sourceSize == source.size() &&
+                   memcmp(h.language, expected, sizeof(expected)) == 0 &&
+                   layoutFor(h).total == mapping.size();
+        }
+
+        bool makeDirectories(const std::string& path) {
+            for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+                std::string prefix = path.substr(0, slash);
+                if (::mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) return false;
+                if (slash == std::string::npos) return true;
+            }
+        }
+    }
+
+    ParseCache::ParseCache(std::string directory, uint64_t capacityBytes)
+        : _directory(std::move(directory)), _capacity(capacityBytes) {
+        while (_directory.size() > 1 && _directory.back() == '/') _directory.pop_back();
+        makeDirectories(_directory);
+    }
+
+    std::string ParseCache::pathFor(uint64_t contentHash, const std::string& language) const {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx-", (unsigned long long)contentHash);
+        return _directory + "/" + name + MicroLexer::LanguageSpec::canonicalLanguage(language) + kExtension;
+    }
+
+    // MARK: - Encode
+
+    std::string ParseCache::encode(uint64_t contentHash, const std::string& language,
+                                   const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser) {
+        const std::string_view source(lexer.source());
+        const size_t lines = lexer.lineCount();
+
+        std::vector<uint32_t> lineStarts(lines);
+        std::vector<uint32_t> lineFirstTokens(lines + 1);
+        std::vector<State> lineStates(lines);
+        for (size_t line = 0; line < lines; line++) {
+            lineStarts[line] = static_cast<uint32_t>(lexer.lineStart(line));
+            lineFirstTokens[line] = static_cast<uint32_t>(lexer.firstTokenOfLine(line));
+            lineStates[line] = lexer.lineEndState(line);
+        }
+        lineFirstTokens[lines] = static_cast<uint32_t>(lexer.firstTokenOfLine(lines));
+
+        std::vector<ScopeRecord> scopes;
+        std::vector<VariableRecord> variables;
+        scopes.reserve(parser.scopes.size());
+        for (const auto& scope : parser.scopes) {
+            ScopeRecord record = {};
+            record.nameOffset = offsetIn(scope.name, source);
+            record.nameLength = static_cast<uint32_t>(scope.name.size());
+            record.start = scope.startLine;
+            record.end = scope.endLine;
+            record.firstVariable = static_cast<uint32_t>(variables.size());
+            record.variableCount = scope.variableCount;
+            record.kind = static_cast<uint8_t>(scope.kind);
+            record.parent = scope.parent;
+            for (const MicroParser::Symbol *v = scope.variables; v; v = v->next) {
+                variables.push_back({offsetIn(v->name, source), static_cast<uint32_t>(v->name.size()), v->line});
+            }
+            scopes.push_back(record);
+        }
+
+        std::vector<ImportRecord> imports;
+        imports.reserve(parser.imports.size());
+        for (const auto& imp : parser.imports) {
+            imports.push_back({offsetIn(imp, source), static_cast<uint32_t>(imp.size())});
+        }
+
+        Header header = {};
+        memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.tokenCount = static_cast<uint32_t>(lexer.tokens().size());
+        header.contentHash = contentHash;
+        header.sourceSize = source.size();
+        header.lineCount = static_cast<uint32_t>(lines);
+        header.scopeCount = static_cast<uint32_t>(scopes.size());
+        header.variableCount = static_cast<uint32_t>(variables.size());
+        header.importCount = static_cast<uint32_t>(imports.size());
+        copyLanguage(header.language, MicroLexer::LanguageSpec::canonicalLanguage(language));
+
+        Layout layout = layoutFor(header);
+        std::string blob;
+        blob.reserve(layout.total);
+        blob.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        appendAt(blob, layout.tokens, lexer.tokens().data(), lexer.tokens().size());
+        appendAt(blob, layout.lineStarts, lineStarts.data(), lineStarts.size());
+        appendAt(blob, layout.lineFirstTokens, lineFirstTokens.data(), lineFirstTokens.size());
+        appendAt(blob, layout.lineStates, lineStates.data(), lineStates.size());
+        appendAt(blob, layout.scopes, scopes.data(), scopes.size());
+        appendAt(blob, layout.variables, variables.data(), variables.size());
+        appendAt(blob, layout.imports, imports.data(), imports.size());
+        return blob;
+    }
+
+    // MARK: - Load
+
+    bool ParseCache::load(std::string_view source, uint64_t contentHash, const std::string& language,
+                          MicroLexer::IncrementalLexer& lexer, MicroParser::Engine& parser) const {
+        const std::string canonical = MicroLexer::LanguageSpec::canonicalLanguage(language);
+        const std::string path = pathFor(contentHash, canonical);
+        MicroCore::MappedFile mapping;
+        Header h;
+        if (!mapping.open(path) || !validHeader(mapping, source, contentHash, canonical, h)) {
+            return false;
+        }
+        const uint8_t *base = mapping.data();
+        const Layout layout = layoutFor(h);
+        const size_t size = source.size();
+
+        // 1. Line table: starts right after each newline, and every newline is covered.
+        std::vector<uint32_t> lineStarts = readArray<uint32_t>(base, layout.lineStarts, h.lineCount);
+        if (lineStarts.empty() || lineStarts[0] != 0) return false;
+        for (size_t i = 1; i < lineStarts.size(); i++) {
+            if (lineStarts[i] <= lineStarts[i - 1] || lineStarts[i] > size || source[lineStarts[i] - 1] != '\n') return false;
+        }
+        if ((size_t)std::count(source.begin(), source.end(), '\n') != lineStarts.size() - 1) return false;
+
+        std::vector<State> lineStates = readArray<State>(base, layout.lineStates, h.lineCount);
+        for (State state : lineStates) {
+            if (state > State::InStringTripleSingle) return false;
+        }
+
+        // 2. Tokens stay inside their line.
+        std::vector<uint32_t> lineFirstTokens = readArray<uint32_t>(base, layout.lineFirstTokens, (size_t)h.lineCount + 1);
+        std::vector<Token> tokens = readArray<Token>(base, layout.tokens, h.tokenCount);
+        if (lineFirstTokens[0] != 0 || lineFirstTokens.back() != h.tokenCount) return false;
+        for (size_t line = 0; line < h.lineCount; line++) {
+            if (lineFirstTokens[line + 1] < lineFirstTokens[line]) return false;
+            uint64_t lineEnd = (line + 1 < h.lineCount) ? lineStarts[line + 1] - 1 : size;
+            for (uint32_t i = lineFirstTokens[line]; i < lineFirstTokens[line + 1]; i++) {
+                const Token& t = tokens[i];
+                if (t.start < lineStarts[line] || (uint64_t)t.start + t.length > lineEnd ||
+                    t.type > TokenType::KeywordModifier) return false;
+            }
+        }
+
+        // 3. Scope tree
+        const auto *scopes = reinterpret_cast<const ScopeRecord *>(base + layout.scopes);
+        const auto *variables = reinterpret_cast<const VariableRecord *>(base + layout.variables);
+        const auto *imports = reinterpret_cast<const ImportRecord *>(base + layout.imports);
+        for (uint32_t i = 0; i < h.scopeCount; i++) {
+            ScopeRecord s;
+            memcpy(&s, &scopes[i], sizeof(s));
+            if (s.kind > (uint8_t)MicroParser::ScopeKind::Block ||
+                (s.nameOffset != kNoName && !inSource(s.nameOffset, s.nameLength, size)) ||
+                (uint64_t)s.firstVariable + s.variableCount > h.variableCount ||
+                (i == 0 ? s.parent != -1 : (s.parent < 0 || (uint32_t)s.parent >= i))) return false;
+        }
+        for (uint32_t i = 0; i < h.variableCount; i++) {
+            VariableRecord v;
+            memcpy(&v, &variables[i], sizeof(v));
+            if (!inSource(v.nameOffset, v.nameLength, size)) return false;
+        }
+        for (uint32_t i = 0; i < h.importCount; i++) {
+            ImportRecord r;
+            memcpy(&r, &imports[i], sizeof(r));
+            if (!inSource(r.offset, r.length, size)) return false;
+        }
+
+        // 4. Adopt. Parser names are views into the lexer's copy of the source.
+        lexer.adopt(source, std::move(tokens), std::move(lineStarts), std::move(lineFirstTokens), std::move(lineStates));
+        const std::string_view text(lexer.source());
+
+        parser.clear();
+        for (uint32_t i = 0; i < h.scopeCount; i++) {
+            ScopeRecord s;
+            memcpy(&s, &scopes[i], sizeof(s));
+            auto kind = static_cast<MicroParser::ScopeKind>(s.kind);
+            std::string_view name = (s.nameOffset != kNoName) ? text.substr(s.nameOffset, s.nameLength)
+                                  : (kind == MicroParser::ScopeKind::Global ? "Global" : "Anonymous");
+            parser.scopes.push_back({name, kind, s.start, s.end, nullptr, nullptr, 0, s.parent});
+            for (uint32_t j = 0; j < s.variableCount; j++) {
+                VariableRecord v;
+                memcpy(&v, &variables[s.firstVariable + j], sizeof(v));
+                parser.addVariable(i, text.substr(v.nameOffset, v.nameLength), v.line);
+            }
+        }
+        for (uint32_t i = 0; i < h.importCount; i++) {
+            ImportRecord r;
+            memcpy(&r, &imports[i], sizeof(r));
+            parser.imports.push_back(text.substr(r.offset, r.length));
+        }
+
+        ::utimes(path.c_str(), nullptr); // Most recently used
+        return true;
+    }
+
+    // MARK: - Store / Verify / Evict
+
+    bool ParseCache::store(uint64_t contentHash, const std::string& language, const std::string& blob) {
+        if (blob.size() > _capacity / 2) {
+            return false;
+        }
+        if (!MicroCore::writeFileAtomically(pathFor(contentHash, language), blob.data(), blob.size())) {
+            return false;
+        }
+        trim();
+        return true;
+    }
+
+    bool ParseCache::verify(std::string_view source, uint64_t contentHash, const std::string& language) {
+        const std::string canonical = MicroLexer::LanguageSpec::canonicalLanguage(language);
+        MicroCore::MappedFile mapping;
+        Header h;
+        if (!mapping.open(pathFor(contentHash, canonical)) || !validHeader(mapping, source, contentHash, canonical, h)) {
+            return false;
+        }
+
+        MicroLexer::IncrementalLexer lexer(canonical);
+        lexer.reset(source);
+        bool same = lexer.tokens().size() == h.tokenCount && lexer.lineCount() == h.lineCount;
+        if (same) {
+            const Layout layout = layoutFor(h);
+            std::vector<Token> stored = readArray<Token>(mapping.data(), layout.tokens, h.tokenCount);
+            for (size_t i = 0; same && i < stored.size(); i++) {
+                const Token& a = stored[i];
+                const Token& b = lexer.tokens()[i];
+                same = a.type == b.type && a.flags == b.flags && a.start == b.start && a.length == b.length;
+            }
+            const auto *states = reinterpret_cast<const State *>(mapping.data() + layout.lineStates);
+            for (size_t line = 0; same && line < h.lineCount; line++) {
+                same = states[line] == lexer.lineEndState(line);
+            }
+        }
+        if (same) {
+            MicroParser::Engine parser;
+            parser.parse(lexer.tokens(), lexer.source(), canonical);
+            same = parser.scopes.size() == h.scopeCount && parser.imports.size() == h.importCount;
+        }
+        if (!same) {
+            mapping.close();
+            remove(contentHash, canonical);
+        }
+        return same;
+    }
+
+    void ParseCache::remove(uint64_t contentHash, const std::string& language) {
+        ::unlink(pathFor(contentHash, language).c_str());
+    }
+
+    uint64_t ParseCache::trim() {
+        std::lock_guard<std::mutex> lock(_trimMutex);
+
+        struct Entry {
+            std::string path;
+            uint64_t size;
+            int64_t mtime;
+        };
+        std::vector<Entry> entries;
+        uint64_t total = 0;
+
+        DIR *dir = ::opendir(_directory.c_str());
+        if (!dir) return 0;
+        const size_t extensionLength = strlen(kExtension);
+        while (struct dirent *entry = ::readdir(dir)) {
+            size_t length = strlen(entry->d_name);
+            if (length <= extensionLength || strcmp(entry->d_name + length - extensionLength, kExtension) != 0) continue;
+            std::string path = _directory + "/" + entry->d_name;
+            struct stat sb;
+            if (::stat(path.c_str(), &sb) != 0) continue;
+            entries.push_back({std::move(path), (uint64_t)sb.st_size, (int64_t)sb.st_mtime});
+            total += (uint64_t)sb.st_size;
+        }
+        ::closedir(dir);
+
+        if (total <= _capacity) {
+            return total;
+        }
+        // Evict down to 3/4 of the cap so the next few stores do not rescan.
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.mtime < b.mtime; });
+        const uint64_t target = _capacity / 4 * 3;
+        for (const Entry& entry : entries) {
+            if (total <= target) break;
+            if (::unlink(entry.path.c_str()) == 0) {
+                total -= entry.size;
+            }
+        }
+        return total;
+    }
+}
@@ -0,0 +1,77 @@
+//
+//  MicroParseCache.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroIncrementalLexer.h"
+#include "MicroParser.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// MARK: - MicroCache (C++)
+// Content-addressed cache of lexer and parser output, so reopening a large file
+// skips tokenizing and parsing. Entries are keyed by the XXH64 of the UTF-8 text
+// plus the language:
+//
+//   <directory>/<hash>-<language>.mcparse
+//   [Header][Token x n][line starts][line first tokens][line end states]
+//   [ScopeRecord x n][VariableRecord x n][ImportRecord x n]
+//
+// Names are stored as offsets into the source text, which the caller has anyway.
+// A load bounds-checks every table before adopting it, so a stale or damaged
+// entry is rejected rather than trusted. verify() re-lexes and compares; run it
+// off the main thread after a hit to catch lexer changes that forgot to bump
+// kVersion. The directory is kept under a size cap, evicting the least recently
+// used entries (a hit refreshes the entry's mtime).
+
+namespace MicroCache {
+
+    class ParseCache {
+    public:
+        /// Sources below this size lex faster than a cache lookup.
+        static constexpr size_t kMinSourceBytes = 32 * 1024;
+
+        explicit ParseCache(std::string directory, uint64_t capacityBytes = 256ull * 1024 * 1024);
+
+        const std::string& directory() const { return _directory; }
+        uint64_t capacityBytes() const { return _capacity; }
+
+        /// Restores `lexer` and `parser` for `source` from the cache. Returns false
+        /// on a miss or if the entry does not validate.
+        bool load(std::string_view source, uint64_t contentHash, const std::string& language,
+                  MicroLexer::IncrementalLexer& lexer, MicroParser::Engine& parser) const;
+
+        /// Serializes the current state. Cheap (copies arrays); do it on the thread
+        /// that owns `lexer`, then hand the blob to store() on any thread.
+        static std::string encode(uint64_t contentHash, const std::string& language,
+                                  const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser);
+
+        /// Writes the entry atomically and evicts old entries past the size cap.
+        bool store(uint64_t contentHash, const std::string& language, const std::string& blob);
+
+        /// Re-lexes `source` and compares with the stored tokens. Removes the entry
+        /// and returns false on any difference.
+        bool verify(std::string_view source, uint64_t contentHash, const std::string& language);
+
+        void remove(uint64_t contentHash, const std::string& language);
+
+        /// Evicts least recently used entries until the directory is within 3/4 of
+        /// the cap (if it exceeds the cap). Returns the bytes left on disk.
+        uint64_t trim();
+
+    private:
+        std::string pathFor(uint64_t contentHash, const std::string& language) const;
+
+        std::string _directory;
+        uint64_t _capacity;
+        std::mutex _trimMutex;
+    };
+}
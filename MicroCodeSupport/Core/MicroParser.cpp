@@ -0,0 +1,267 @@
+//
+//  MicroParser.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroParser.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace MicroParser {
+
+    using MicroLexer::Token;
+    using MicroLexer::TokenType;
+
+    static constexpr int64_t kOpenEnd = std::numeric_limits<int64_t>::max();
+
+    static Scope makeScope(std::string_view name, ScopeKind kind, int64_t start, int32_t parent) {
+        return {name, kind, start, kOpenEnd, nullptr, nullptr, 0, parent};
+    }
+
+    void Engine::clear() {
+        scopes.clear();
+        imports.clear();
+        _scopeStack.clear();
+        _arena.reset();
+    }
+
+    void Engine::addVariable(size_t scopeIndex, std::string_view name, int64_t line) {
+        Symbol *varSym = _arena.make<Symbol>();
+        varSym->name = name;
+        varSym->kind = SymbolKind::Variable;
+        varSym->line = line;
+        varSym->next = nullptr;
+
+        Scope& scope = scopes[scopeIndex];
+        if (scope.lastVariable) {
+            scope.lastVariable->next = varSym;
+        } else {
+            scope.variables = varSym;
+        }
+        scope.lastVariable = varSym;
+        scope.variableCount++;
+    }
+
+    void Engine::parse(const std::vector<Token>& tokens, std::string_view source, const std::string& lang) {
+        clear();
+
+        // Basic global scope
+        scopes.push_back(makeScope("Global", ScopeKind::Global, 0, -1));
+
+        const std::string language = MicroLexer::LanguageSpec::canonicalLanguage(lang);
+        bool isSwift = (language == "swift");
+        bool isCpp = (language == "cpp" || language == "objc");
+        // Languages whose functions may be declared without a keyword: `Type name(...) {`
+        bool isCFamily = isCpp || language == "java" || language == "javascript";
+        // Languages whose types have braced bodies
+        bool hasTypeBodies = isSwift || isCFamily || language == "rust" || language == "go" || language == "kotlin";
+        // Keyword introducing a function declaration, beyond C's `void`/`int`
+        std::string_view functionKeyword = isSwift || language == "go" ? "func"
+            : language == "rust" ? "fn"
+            : language == "kotlin" ? "fun"
+            : language == "javascript" ? "function" : "";
+
+        auto textOf = [source](const Token& t) {
+            return source.substr(t.start, t.length);
+        };
+        auto isPunct = [source](const Token& t, char c) {
+            return t.type == TokenType::Punctuation && t.length == 1 && source[t.start] == c;
+        };
+
+        // Index of the token after the parenthesized group opening at `open`, or
+        // tokens.size() if it never closes.
+        auto skipParens = [&tokens, &isPunct](size_t open) {
+            int depth = 0;
+            for (size_t j = open; j < tokens.size(); j++) {
+                if (isPunct(tokens[j], '(')) depth++;
+                else if (isPunct(tokens[j], ')') && --depth == 0) return j + 1;
+            }
+            return tokens.size();
+        };
+
+        // Whether `name(` at `i` is a definition: its parameter list is followed,
+        // past qualifiers, a trailing return type or an initializer list, by '{'.
+        auto opensBody = [&](size_t i) {
+            if (i + 1 >= tokens.size() || !isPunct(tokens[i + 1], '(')) return false;
+            int depth = 0;
+            const size_t after = skipParens(i + 1);
+            const size_t limit = std::min(tokens.size(), after + 64);
+            for (size_t j = after; j < limit; j++) {
+                const Token& next = tokens[j];
+                if (next.type == TokenType::Keyword || next.type == TokenType::KeywordControl) return false;
+                if (isPunct(next, '(')) depth++;
+                else if (isPunct(next, ')')) depth--;
+                else if (depth == 0 && isPunct(next, '{')) return true;
+                else if (depth == 0 && (isPunct(next, ';') || isPunct(next, '}') || isPunct(next, '='))) return false;
+            }
+            return false;
+        };
+
+        // Keyword introducing a type, extension or implementation block.
+        auto isTypeKeyword = [&language](std::string_view text) {
+            return text == "class" || text == "struct" || text == "enum" || text == "union" || text == "interface" ||
+                   text == "protocol" || text == "extension" || text == "actor" || text == "trait" || text == "impl" ||
+                   text == "object" || text == "record" || (language == "go" && text == "type");
+        };
+
+        // Whether the type named at `i` has a body: '{' comes before anything that
+        // makes it a forward declaration, a variable or return type (`struct stat st;`,
+        // `struct node *next(...)`) or a template parameter (`template <class T>`).
+        auto opensTypeBody = [&](size_t i) {
+            int angles = 0;
+            const size_t limit = std::min(tokens.size(), i + 64);
+            for (size_t j = i + 1; j < limit; j++) {
+                const Token& next = tokens[j];
+                if (isPunct(next, '{')) return true;
+                if (next.type == TokenType::Keyword || next.type == TokenType::KeywordDeclaration) {
+                    std::string_view word = textOf(next);
+                    bool goTypeBody = language == "go" && (word == "struct" || word == "interface"); // type Name struct {
+                    if (word == functionKeyword || word == "if" || word == "while" || word == "return" ||
+                        (isTypeKeyword(word) && !goTypeBody)) {
+                        return false;
+                    }
+                }
+                if (isPunct(next, '<')) angles++;
+                else if (isPunct(next, '>') && --angles < 0) return false;
+                else if (isPunct(next, '(') && !isCFamily) j = skipParens(j) - 1; // Kotlin's primary constructor
+                else if (isPunct(next, ';') || isPunct(next, '}') || isPunct(next, '=') || isPunct(next, '(') || isPunct(next, ')')) return false;
+                else if (isCFamily && (isPunct(next, '*') || isPunct(next, '&'))) return false;
+            }
+            return false;
+        };
+
+        _scopeStack.push_back(0); // Index of global scope
+        size_t pendingScope = 0; // Function or type declared but its '{' not seen yet (0: none)
+
+        // A declaration without a body (protocol requirement, prototype) gets an
+        // empty range so it never contains later code.
+        auto abandonPending = [this, &pendingScope]() {
+            if (pendingScope != 0) {
+                scopes[pendingScope].endLine = scopes[pendingScope].startLine;
+                pendingScope = 0;
+            }
+        };
+
+        for (size_t i = 0; i < tokens.size(); i++) {
+            const Token& t = tokens[i];
+            std::string_view text = textOf(t);
+
+            // 1. Detect Functions (Very naive for now, but fast)
+            if (t.type == TokenType::KeywordDeclaration || t.type == TokenType::Keyword) {
+                if ((!functionKeyword.empty() && text == functionKeyword) || (isCpp && (text == "void" || text == "int"))) {
+                    // Look ahead for name, past a Go method receiver
+                    size_t name = i + 1;
+                    if (language == "go" && name < tokens.size() && isPunct(tokens[name], '(')) {
+                        name = skipParens(name);
+                    }
+                    if (name < tokens.size()) {
+                        const Token& nameToken = tokens[name];
+                        // C's `int x` is a variable unless a parameter list follows.
+                        bool isName = isCpp && (text == "void" || text == "int")
+                            ? nameToken.type == TokenType::Function
+                            : nameToken.type == TokenType::Identifier || nameToken.type == TokenType::Function ||
+                              nameToken.type == TokenType::Type;
+                        if (isName) {
+                            // Create new scope
+                            abandonPending();
+                            scopes.push_back(makeScope(textOf(nameToken), ScopeKind::Function, t.start,
+                                                       static_cast<int32_t>(_scopeStack.back()))); // Approximation
+                            pendingScope = scopes.size() - 1;
+                            // Note: Real parser would push to stack only on '{'
+                        }
+                    }
+                } else if (hasTypeBodies && isTypeKeyword(text) && i + 1 < tokens.size()) {
+                    // `struct Name ... {`: the type's body is its scope, so members nest under it
+                    const Token& nameToken = tokens[i + 1];
+                    bool isName = nameToken.type == TokenType::Identifier || nameToken.type == TokenType::Type ||
+                                  nameToken.type == TokenType::Function;
+                    if (isName && opensTypeBody(i + 1)) {
+                        abandonPending();
+                        scopes.push_back(makeScope(textOf(nameToken), ScopeKind::Class, t.start,
+                                                   static_cast<int32_t>(_scopeStack.back())));
+                        pendingScope = scopes.size() - 1;
+                    }
+                }
+            } else if (isCFamily && pendingScope == 0 && (t.type == TokenType::Function || t.type == TokenType::Type) &&
+                       opensBody(i)) {
+                // Keyword-less definition (`Foo::bar(int x) const {`, a constructor, a Java or JS method)
+                scopes.push_back(makeScope(text, ScopeKind::Function, t.start, static_cast<int32_t>(_scopeStack.back())));
+                pendingScope = scopes.size() - 1;
+            }
+
+            // 2. Detect Variables
+            if (t.type == TokenType::KeywordDeclaration) { // var, let, auto
+                if ((isSwift && (text == "var" || text == "let")) || (isCpp && text == "auto")) {
+                    // A Swift signature never declares a variable: the function had no body.
+                    if (isSwift) abandonPending();
+                    if (i + 1 < tokens.size()) {
+                        const Token& nameToken = tokens[i+1];
+                        if (nameToken.type == TokenType::Identifier) {
+                            // Add to current scope (top of stack); line is line-ish
+                            addVariable(_scopeStack.back(), textOf(nameToken), t.start);
+                        }
+                    }
+                }
+            }
+
+            // 3. Detect Imports
+            if (t.type == TokenType::Keyword) {
+                if (text == "import" || text == "#include") {
+                    if (i + 1 < tokens.size()) {
+                        imports.push_back(textOf(tokens[i+1]));
+                    }
+                }
+            }
+
+            // 4. Bracket Scope Management (Crucial for "Am I in function X?")
+            if (text == "{") {
+                // In a real parser, we'd link this '{' to the recently declared function
+                // For now, if we just saw a func declaration, we assume this opens it.
+                // This is "heuristic parsing".
+                if (pendingScope != 0) {
+                    // Assume this brace belongs to the last detected symbol scope
+                    _scopeStack.push_back(pendingScope);
+                    pendingScope = 0;
+                } else {
+                    // Anonymous scope
+                    scopes.push_back(makeScope("Anonymous", ScopeKind::Block, t.start, static_cast<int32_t>(_scopeStack.back())));
+                    _scopeStack.push_back(scopes.size() - 1);
+                }
+            } else if (text == "}") {
+                abandonPending();
+                if (_scopeStack.size() > 1) { // Don't pop global
+                    size_t endingScopeIdx = _scopeStack.back();
+                    scopes[endingScopeIdx].endLine = t.start + t.length;
+                    _scopeStack.pop_back();
+                }
+            } else if (text == ";") {
+                abandonPending();
+            }
+        }
+        abandonPending();
+    }
+
+    size_t Engine::scopeAt(int64_t offset) const {
+        auto it = std::upper_bound(scopes.begin() + 1, scopes.end(), offset, [](int64_t value, const Scope& scope) {
+            return value < scope.startLine;
+        });
+        size_t index = static_cast<size_t>(it - scopes.begin()) - 1;
+        // Every ancestor starts at or before `offset`; the first one still open there
+        // is innermost. Bodiless declarations contain nothing.
+        while (index != 0 && (scopes[index].isEmpty() || offset >= scopes[index].endLine)) {
+            index = static_cast<size_t>(scopes[index].parent);
+        }
+        return index;
+    }
+
+    size_t Engine::memoryFootprint() const {
+        return scopes.capacity() * sizeof(Scope)
+            + imports.capacity() * sizeof(std::string_view)
+            + _scopeStack.capacity() * sizeof(size_t)
+            + _arena.bytesReserved();
+    }
+}
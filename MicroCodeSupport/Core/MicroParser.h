@@ -0,0 +1,95 @@
+//
+//  MicroParser.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroArena.h"
+#include "MicroLexer.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - MicroParser (C++)
+// A lightweight, fault-tolerant parser to extract structure from tokens.
+//
+// Parse output is allocated from a per-parse arena and names are string_views
+// into the parsed source, so the source buffer must outlive the result (until the
+// next parse()). Reparsing releases everything in one step; once the arena and
+// vectors have grown to the document's size, parse() performs no heap allocation.
+
+namespace MicroParser {
+
+    enum class SymbolKind : uint8_t {
+        Function,
+        Class,
+        Variable
+    };
+
+    enum class ScopeKind : uint8_t {
+        Global,
+        Function,
+        Class,
+        Block
+    };
+
+    struct Symbol {
+        std::string_view name;
+        std::string_view signature;
+        SymbolKind kind;
+        int64_t line;
+        const Symbol *next; // Next variable in the same scope
+    };
+
+    struct Scope {
+        std::string_view name; // Function or Class name
+        ScopeKind kind;
+        int64_t startLine;
+        int64_t endLine;
+        const Symbol *variables; // Arena-allocated list, in declaration order
+        Symbol *lastVariable;
+        uint32_t variableCount;
+        int32_t parent; // Enclosing scope's index; -1 for Global
+
+        bool isNamed() const { return kind == ScopeKind::Function || kind == ScopeKind::Class; }
+        /// A declaration without a body (prototype, protocol requirement): it has a
+        /// name and start but contains no code.
+        bool isEmpty() const { return endLine <= startLine; }
+    };
+
+    class Engine {
+    public:
+        std::vector<Scope> scopes;
+        std::vector<std::string_view> imports;
+
+        Engine() {}
+
+        /// `tokens` must come from MicroLexer over the same `source` bytes.
+        void parse(const std::vector<MicroLexer::Token>& tokens, std::string_view source, const std::string& language);
+
+        /// Empties the result, releasing the previous parse's variables.
+        void clear();
+
+        /// Innermost scope containing byte `offset` (0, Global, if none). Scopes
+        /// are sorted by start and properly nested, so this is a binary search
+        /// plus a walk up `parent`: O(log n + depth). Requires a parse result.
+        size_t scopeAt(int64_t offset) const;
+
+        /// Appends a variable to scopes[scopeIndex]. Used by parse() and when
+        /// restoring a cached result.
+        void addVariable(size_t scopeIndex, std::string_view name, int64_t line);
+
+        /// Approximate heap bytes held by the parse result.
+        size_t memoryFootprint() const;
+
+    private:
+        MicroCore::Arena _arena;
+        std::vector<size_t> _scopeStack;
+    };
+}
@@ -0,0 +1,339 @@
+//
+//  MicroPathFinder.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroPathFinder.h"
+#include "MicroFuzzy.h"
+
+#include <algorithm>
+
+namespace MicroFiles {
+
+    namespace {
+
+        constexpr int32_t kScoreMatch = 16;
+        constexpr int32_t kGapStart = -3;
+        constexpr int32_t kGapExtension = -1;
+        constexpr int32_t kBonusSegment = 10;     // After '/' or at the start
+        constexpr int32_t kBonusBoundary = 8;     // After '_', '-', '.', ' ' and the like
+        constexpr int32_t kBonusCamel = 7;
+        constexpr int32_t kBonusConsecutive = 4;
+        constexpr int32_t kBonusBasename = 3;     // Every match inside the basename
+        constexpr int32_t kBonusFirstCharMultiplier = 2;
+        constexpr int32_t kBonusExactCase = 1;
+        constexpr int32_t kNoMatch = -1000000;
+
+        // Paths longer than this are scored on their last kMaxPathLength bytes.
+        constexpr size_t kMaxPathLength = 512;
+        constexpr size_t kMaxQueryLength = 64;
+
+        // Paths per parallel chunk.
+        constexpr size_t kChunkSize = 16384;
+
+        // Remembered match lists; typing past this keeps narrowing from the last one.
+        constexpr size_t kMaxNarrowingLevels = 16;
+
+        inline char fold(char c) {
+            return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+        }
+
+        enum CharKind { KindOther, KindLower, KindUpper, KindDigit };
+
+        inline CharKind kindOf(char c) {
+            if (c >= 'a' && c <= 'z') return KindLower;
+            if (c >= 'A' && c <= 'Z') return KindUpper;
+            if (c >= '0' && c <= '9') return KindDigit;
+            return KindOther;
+        }
+
+        inline int32_t bonusAt(std::string_view path, size_t j) {
+            if (j == 0 || path[j - 1] == '/') return kBonusSegment;
+            CharKind cur = kindOf(path[j]);
+            if (cur == KindOther) return 0;
+            CharKind prev = kindOf(path[j - 1]);
+            if (prev == KindOther) return kBonusBoundary;
+            if (prev == KindLower && cur == KindUpper) return kBonusCamel;
+            if (prev != KindDigit && cur == KindDigit) return kBonusCamel;
+            return 0;
+        }
+
+        inline bool isSubsequence(std::string_view text, std::string_view foldedQuery) {
+            size_t qi = 0;
+            for (size_t j = 0; j < text.size() && qi < foldedQuery.size(); j++) {
+                if (fold(text[j]) == foldedQuery[qi]) qi++;
+            }
+            return qi == foldedQuery.size();
+        }
+
+        struct Scratch {
+            int32_t previous[kMaxPathLength + 1];
+            int32_t current[kMaxPathLength + 1];
+        };
+
+        Scratch& scratch() {
+            static thread_local Scratch buffer;
+            return buffer;
+        }
+
+        /// MicroFuzzy's affine-gap DP with path-aware bonuses. `nameStart` is the
+        /// offset of the basename in `path`.
+        int32_t scorePath(std::string_view path, size_t nameStart, std::string_view query, std::string_view folded) {
+            if (path.size() > kMaxPathLength) {
+                size_t cut = path.size() - kMaxPathLength;
+                path = path.substr(cut);
+                nameStart = nameStart > cut ? nameStart - cut : 0;
+            }
+            const size_t n = folded.size();
+            const size_t m = path.size();
+            if (m < n) return kNoMatch;
+
+            Scratch& s = scratch();
+            int32_t *prev = s.previous;
+            int32_t *cur = s.current;
+            for (size_t i = 0; i < n; i++) {
+                int32_t gapRun = kNoMatch;
+                for (size_t j = 0; j < m; j++) {
+                    if (i > 0 && j >= 2) {
+                        gapRun = std::max(gapRun + kGapExtension, prev[j - 2] + kGapStart);
+                    }
+                    int32_t value = kNoMatch;
+                    if (j >= i && fold(path[j]) == folded[i]) {
+                        int32_t bonus = bonusAt(path, j);
+                        int32_t base;
+                        if (i == 0) {
+                            base = 0;
+                            bonus *= kBonusFirstCharMultiplier;
+                        } else {
+                            int32_t diagonal = (j >= 1 && prev[j - 1] > kNoMatch) ? prev[j - 1] + kBonusConsecutive : kNoMatch;
+                            base = std::max(diagonal, gapRun);
+                        }
+                        if (base > kNoMatch / 2) {
+                            value = base + kScoreMatch + bonus + (j >= nameStart ? kBonusBasename : 0) +
+                                    (path[j] == query[i] ? kBonusExactCase : 0);
+                        }
+                    }
+                    cur[j] = value;
+                }
+                std::swap(prev, cur);
+            }
+
+            int32_t best = kNoMatch;
+            for (size_t j = n - 1; j < m; j++) best = std::max(best, prev[j]);
+            return best;
+        }
+
+        /// Highest score any path can reach for a query of `n` characters without
+        /// fitting in the basename; basename matches can add kBonusWholeName.
+        constexpr int32_t scoreCeiling(size_t n) {
+            if (n == 0) return 0;
+            int32_t first = kScoreMatch + kBonusSegment * kBonusFirstCharMultiplier + kBonusBasename + kBonusExactCase;
+            int32_t rest = kScoreMatch + kBonusConsecutive + kBonusSegment + kBonusBasename + kBonusExactCase;
+            return first + (int32_t)(n - 1) * rest;
+        }
+
+        // Lowest score of any match: each skipped byte costs at most -kGapStart.
+        constexpr int32_t kScoreFloor = (int32_t)kMaxPathLength * kGapStart;
+
+        // Added when the query fits in the basename alone. It exceeds the widest
+        // gap between two scores of the longest query, so such a match ranks above
+        // every match that spans directories.
+        constexpr int32_t kBonusWholeName = scoreCeiling(kMaxQueryLength) - kScoreFloor + 1;
+
+        std::string foldQuery(std::string_view query, std::string& raw) {
+            raw.clear();
+            std::string folded;
+            for (char c : query) {
+                if (c == ' ') continue;
+                if (raw.size() == kMaxQueryLength) break;
+                raw.push_back(c);
+                folded.push_back(fold(c));
+            }
+            return folded;
+        }
+
+        struct Ranked {
+            int32_t score;
+            uint32_t index;
+            std::string_view path;
+        };
+
+        /// Strict "a ranks above b". Paths break ties so results do not depend on
+        /// the order the scanner found them in.
+        inline bool ranksAbove(const Ranked& a, const Ranked& b) {
+            if (a.score != b.score) return a.score > b.score;
+            if (a.path.size() != b.path.size()) return a.path.size() < b.path.size();
+            int order = a.path.compare(b.path);
+            return order != 0 ? order < 0 : a.index < b.index;
+        }
+
+        /// Bounded heap whose top is the worst kept entry.
+        class TopK {
+        public:
+            explicit TopK(size_t limit) : _limit(limit) { _heap.reserve(limit); }
+
+            void offer(const Ranked& entry) {
+                if (_heap.size() < _limit) {
+                    _heap.push_back(entry);
+                    std::push_heap(_heap.begin(), _heap.end(), ranksAbove);
+                } else if (ranksAbove(entry, _heap.front())) {
+                    std::pop_heap(_heap.begin(), _heap.end(), ranksAbove);
+                    _heap.back() = entry;
+                    std::push_heap(_heap.begin(), _heap.end(), ranksAbove);
+                }
+            }
+
+            /// False when nothing scoring at most `bestPossible` with this length could be kept.
+            bool accepts(int32_t bestPossible, size_t length) const {
+                if (_heap.size() < _limit) return true;
+                const Ranked& worst = _heap.front();
+                return bestPossible > worst.score || (bestPossible == worst.score && length <= worst.path.size());
+            }
+
+            std::vector<Ranked>& entries() { return _heap; }
+
+        private:
+            size_t _limit;
+            std::vector<Ranked> _heap;
+        };
+    }
+
+    void PathFinder::clear() {
+        _bytes.clear();
+        _offsets.clear();
+        _lengths.clear();
+        _nameOffsets.clear();
+        _masks.clear();
+        _narrowing.clear();
+    }
+
+    void PathFinder::reserve(size_t paths, size_t bytes) {
+        _bytes.reserve(bytes);
+        _offsets.reserve(paths);
+        _lengths.reserve(paths);
+        _nameOffsets.reserve(paths);
+        _masks.reserve(paths);
+    }
+
+    uint32_t PathFinder::add(std::string_view relativePath) {
+        if (relativePath.size() > 0xFFFF) relativePath = relativePath.substr(relativePath.size() - 0xFFFF);
+        size_t slash = relativePath.find_last_of('/');
+        uint32_t index = (uint32_t)_offsets.size();
+        _offsets.push_back((uint32_t)_bytes.size());
+        _lengths.push_back((uint16_t)relativePath.size());
+        _nameOffsets.push_back((uint16_t)(slash == std::string_view::npos ? 0 : slash + 1));
+        _masks.push_back(MicroFuzzy::characterMask(relativePath));
+        _bytes.append(relativePath.data(), relativePath.size());
+        _narrowing.clear();
+        return index;
+    }
+
+    size_t PathFinder::scan(const std::string& root, const ScanOptions& options) {
+        clear();
+        size_t prefix = root.size() + (!root.empty() && root.back() == '/' ? 0 : 1);
+        scanDirectory(root, options, [&](const Entry *entries, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                const Entry& entry = entries[i];
+                if (entry.type == EntryType::Directory || entry.linksToDirectory) continue;
+                if (entry.path.size() > prefix) add(std::string_view(entry.path).substr(prefix));
+            }
+            return true;
+        }, _pool);
+        return size();
+    }
+
+    std::vector<PathMatch> PathFinder::search(std::string_view query, size_t limit) const {
+        std::vector<PathMatch> results;
+        std::string raw;
+        std::string folded = foldQuery(query, raw);
+        if (limit == 0 || folded.empty() || size() == 0) return results;
+
+        std::lock_guard<std::mutex> lock(_searchMutex);
+
+        // Narrow from the longest remembered query that the new one extends.
+        while (!_narrowing.empty() && folded.compare(0, _narrowing.back().query.size(), _narrowing.back().query) != 0) {
+            _narrowing.pop_back();
+        }
+        const std::vector<uint32_t> *domain = _narrowing.empty() ? nullptr : &_narrowing.back().matches;
+        bool remember = !domain || _narrowing.back().query != folded;
+
+        const uint64_t queryMask = MicroFuzzy::characterMask(folded);
+        const int32_t ceiling = scoreCeiling(folded.size());
+        const size_t count = domain ? domain->size() : size();
+
+        const bool nameOnly = folded.find('/') == std::string::npos;
+
+        std::vector<std::vector<uint32_t>> chunkMatches((count + kChunkSize - 1) / kChunkSize);
+        std::mutex mergeMutex;
+        TopK global(limit);
+
+        _pool.parallelFor(count, kChunkSize, [&](size_t begin, size_t end) {
+            static thread_local std::vector<uint32_t> spanning;
+            spanning.clear();
+            std::vector<uint32_t>& matches = chunkMatches[begin / kChunkSize];
+            TopK local(limit);
+
+            // Basename matches first: they outrank everything else, so once the heap
+            // holds `limit` of them the paths that need the full DP are skipped.
+            for (size_t k = begin; k < end; k++) {
+                uint32_t index = domain ? (*domain)[k] : (uint32_t)k;
+                if ((_masks[index] & queryMask) != queryMask) continue;
+                std::string_view candidate = path(index);
+                if (!isSubsequence(candidate, folded)) continue;
+                if (remember) matches.push_back(index);
+                std::string_view basename = candidate.substr(_nameOffsets[index]);
+                if (!nameOnly || !isSubsequence(basename, folded)) {
+                    spanning.push_back(index);
+                    continue;
+                }
+                if (!local.accepts(ceiling + kBonusWholeName, candidate.size())) continue;
+                int32_t value = scorePath(basename, 0, raw, folded);
+                if (value <= kNoMatch / 2) continue;
+                local.offer({value + kBonusWholeName, index, candidate});
+            }
+            for (uint32_t index : spanning) {
+                std::string_view candidate = path(index);
+                // Once the heap is full, skip the DP for paths that cannot displace its worst entry.
+                if (!local.accepts(ceiling, candidate.size())) continue;
+                int32_t value = scorePath(candidate, _nameOffsets[index], raw, folded);
+                if (value <= kNoMatch / 2) continue;
+                local.offer({value, index, candidate});
+            }
+
+            std::lock_guard<std::mutex> mergeLock(mergeMutex);
+            for (const auto& entry : local.entries()) global.offer(entry);
+        });
+
+        if (remember) {
+            Narrowing level;
+            level.query = folded;
+            size_t total = 0;
+            for (const auto& matches : chunkMatches) total += matches.size();
+            level.matches.reserve(total);
+            for (const auto& matches : chunkMatches) {
+                level.matches.insert(level.matches.end(), matches.begin(), matches.end());
+            }
+            if (_narrowing.size() == kMaxNarrowingLevels) _narrowing.erase(_narrowing.begin());
+            _narrowing.push_back(std::move(level));
+        }
+
+        std::vector<Ranked>& best = global.entries();
+        std::sort(best.begin(), best.end(), ranksAbove);
+        results.reserve(best.size());
+        for (const auto& entry : best) results.push_back({entry.index, entry.score});
+        return results;
+    }
+
+    std::vector<uint32_t> PathFinder::matchPositions(uint32_t index, std::string_view query) const {
+        if (index >= size()) return {};
+        // Highlight inside the basename when the whole query fits there.
+        uint32_t nameStart = _nameOffsets[index];
+        std::vector<uint32_t> positions = MicroFuzzy::matchPositions(name(index), query);
+        if (positions.empty()) return MicroFuzzy::matchPositions(path(index), query);
+        for (uint32_t& position : positions) position += nameStart;
+        return positions;
+    }
+}
@@ -0,0 +1,87 @@
+//
+//  MicroPathFinder.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroDirectoryScanner.h"
+#include "MicroThreadPool.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - MicroFiles (C++)
+// Quick-open path matching over every file of a workspace.
+//
+// Relative paths live back to back in one arena with their basename offset and a
+// character-presence mask (MicroFuzzy::characterMask). A query is a
+// case-insensitive subsequence of the path, scored with MicroFuzzy's affine-gap
+// DP plus path bonuses: the start of a segment beats other word boundaries, and
+// matches inside the basename earn extra. A query that fits in the basename
+// alone is scored on the basename and ranks above any match that spans
+// directories, so "mpf" finds Core/MicroPathFinder.h before m/p/foo.txt. Scoring
+// runs in chunks on the thread pool, each keeping a bounded heap of its best
+// results; basename matches are scored first so that a full heap lets a chunk
+// skip the longer whole-path DP.
+//
+// Typing usually extends the query, and a path that matches "abc" also matches
+// "ab", so each search remembers which paths matched and the next, longer query
+// only looks at those. Deleting characters falls back to the longest remembered
+// prefix of the new query.
+
+namespace MicroFiles {
+
+    struct PathMatch {
+        uint32_t index;
+        int32_t score;
+    };
+
+    class PathFinder {
+    public:
+        explicit PathFinder(MicroCore::ThreadPool& pool = MicroCore::ThreadPool::shared()) : _pool(pool) {}
+
+        /// Replaces the paths with every file below `root` (directories are not
+        /// listed), relative to it. Returns the number of files.
+        size_t scan(const std::string& root, const ScanOptions& options = ScanOptions());
+
+        void clear();
+        void reserve(size_t paths, size_t bytes);
+        uint32_t add(std::string_view relativePath);
+
+        size_t size() const { return _offsets.size(); }
+        std::string_view path(uint32_t index) const {
+            return std::string_view(_bytes.data() + _offsets[index], _lengths[index]);
+        }
+        std::string_view name(uint32_t index) const { return path(index).substr(_nameOffsets[index]); }
+
+        /// Best `limit` matches, highest score first (ties: shorter path, then
+        /// bytewise). Spaces in the query are ignored. One search at a time.
+        std::vector<PathMatch> search(std::string_view query, size_t limit) const;
+
+        /// Byte offsets in path(index) matched by `query`, for highlighting.
+        std::vector<uint32_t> matchPositions(uint32_t index, std::string_view query) const;
+
+    private:
+        struct Narrowing {
+            std::string query;               // Folded
+            std::vector<uint32_t> matches;   // Every path containing `query`, ascending
+        };
+
+        MicroCore::ThreadPool& _pool;
+        std::string _bytes;
+        std::vector<uint32_t> _offsets;
+        std::vector<uint16_t> _lengths;
+        std::vector<uint16_t> _nameOffsets;
+        std::vector<uint64_t> _masks;
+
+        mutable std::mutex _searchMutex;
+        mutable std::vector<Narrowing> _narrowing; // Each entry's query extends the previous one
+    };
+}
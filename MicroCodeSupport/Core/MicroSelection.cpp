@@ -0,0 +1,302 @@
+//
+//  MicroSelection.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroSelection.h"
+
+#include <algorithm>
+
+namespace MicroSelection {
+
+    using MicroLexer::IncrementalLexer;
+    using MicroLexer::Token;
+    using MicroLexer::TokenType;
+
+    namespace {
+        char closingBracket(char open) {
+            switch (open) {
+                case '(': return ')';
+                case '[': return ']';
+                case '{': return '}';
+                default: return 0;
+            }
+        }
+
+        bool isQuote(char c) {
+            return c == '"' || c == '\'' || c == '`';
+        }
+
+        // Braces and the document hold statements; parentheses and brackets hold lists.
+        bool splitsLines(const char close) {
+            return close == '}' || close == 0;
+        }
+    }
+
+    // MARK: - Building
+
+    void Tree::addNode(uint32_t start, uint32_t end) {
+        if (end > start) {
+            _nodes.push_back({start, end, -1});
+        }
+    }
+
+    void Tree::addToStatement(Container& container, uint32_t start, uint32_t end, uint32_t indent) {
+        if (!container.inStatement) {
+            container.inStatement = true;
+            container.statement = {start, end, end, indent};
+        }
+        container.statement.end = end;
+        container.statement.groupEnd = end;
+        if (!container.hasContent) {
+            container.hasContent = true;
+            container.contentStart = start;
+        }
+        container.contentEnd = end;
+    }
+
+    void Tree::endStatement(Container& container) {
+        if (container.inStatement) {
+            _statements.push_back(container.statement);
+            container.inStatement = false;
+        }
+    }
+
+    void Tree::closeContainer(Container& container, bool matched, uint32_t closeEnd) {
+        endStatement(container);
+
+        // A statement followed by more-indented ones also forms a block with them
+        // (Python bodies, `if (x)` without braces, wrapped call chains).
+        _stack.clear();
+        auto pop = [this]() {
+            const Statement& statement = _statements[_stack.back()];
+            _stack.pop_back();
+            addNode(statement.start, statement.end);
+            addNode(statement.start, statement.groupEnd);
+            if (!_stack.empty()) {
+                Statement& parent = _statements[_stack.back()];
+                parent.groupEnd = std::max(parent.groupEnd, statement.groupEnd);
+            }
+        };
+        for (size_t i = container.firstStatement; i < _statements.size(); i++) {
+            while (!_stack.empty() && _statements[_stack.back()].indent >= _statements[i].indent) {
+                pop();
+            }
+            _stack.push_back(i);
+        }
+        while (!_stack.empty()) {
+            pop();
+        }
+        _statements.resize(container.firstStatement);
+
+        if (matched) {
+            addNode(container.open, closeEnd);
+            if (container.hasContent) {
+                addNode(container.contentStart, container.contentEnd);
+            }
+        }
+    }
+
+    void Tree::rebuild(const IncrementalLexer& lexer, const MicroParser::Engine& parser) {
+        const std::string& source = lexer.source();
+        const std::vector<Token>& tokens = lexer.tokens();
+        const uint32_t size = static_cast<uint32_t>(source.size());
+
+        _nodes.clear();
+        _statements.clear();
+        _containers.clear();
+        addNode(0, size);
+
+        auto openContainer = [this](uint32_t open, char close) {
+            Container container = {};
+            container.open = open;
+            container.close = close;
+            container.firstStatement = _statements.size();
+            _containers.push_back(container);
+        };
+        openContainer(0, 0);
+
+        // 1. Strings, brackets and statements, in one pass over the tokens
+        for (size_t line = 0; line < lexer.lineCount(); line++) {
+            const size_t first = lexer.firstTokenOfLine(line);
+            const size_t last = lexer.firstTokenOfLine(line + 1);
+            if (splitsLines(_containers.back().close)) {
+                endStatement(_containers.back());
+            }
+            if (first == last) continue;
+            const uint32_t indent = static_cast<uint32_t>(tokens[first].start - lexer.lineStart(line));
+
+            for (size_t i = first; i < last; i++) {
+                const Token& t = tokens[i];
+                const uint32_t end = t.start + t.length;
+                const char c = (t.type == TokenType::Punctuation && t.length == 1) ? source[t.start] : 0;
+
+                if (closingBracket(c)) {
+                    addToStatement(_containers.back(), t.start, end, indent);
+                    openContainer(t.start, closingBracket(c));
+                    continue;
+                }
+                if (c == ')' || c == ']' || c == '}') {
+                    size_t match = _containers.size() - 1;
+                    while (match > 0 && _containers[match].close != c) match--;
+                    if (match > 0) {
+                        // Brackets left open inside this pair end here, unmatched.
+                        while (_containers.size() - 1 > match) {
+                            closeContainer(_containers.back(), false, 0);
+                            _containers.pop_back();
+                        }
+                        closeContainer(_containers.back(), true, end);
+                        _containers.pop_back();
+                    }
+                    addToStatement(_containers.back(), t.start, end, indent);
+                    continue;
+                }
+
+                Container& container = _containers.back();
+                if (c == ',' && !splitsLines(container.close)) {
+                    endStatement(container);
+                    continue;
+                }
+                addToStatement(container, t.start, end, indent);
+                if (c == ';' && splitsLines(container.close)) {
+                    endStatement(container);
+                }
+
+                if (t.type == TokenType::String && t.length >= 2) {
+                    // Contents inside the quotes, after any prefix (@"", r"", f'', b"")
+                    uint32_t quote = t.start;
+                    while (quote < end && quote < t.start + 2 && !isQuote(source[quote])) quote++;
+                    if (quote < end && isQuote(source[quote]) && source[end - 1] == source[quote] && end - quote >= 2) {
+                        uint32_t run = (end - quote >= 6 && source[quote + 1] == source[quote] && source[quote + 2] == source[quote] &&
+                                        source[end - 2] == source[quote] && source[end - 3] == source[quote]) ? 3 : 1;
+                        addNode(quote + run, end - run);
+                        addNode(t.start, end);
+                    }
+                }
+            }
+        }
+        while (_containers.size() > 1) {
+            closeContainer(_containers.back(), false, 0);
+            _containers.pop_back();
+        }
+        closeContainer(_containers.back(), false, 0);
+        _containers.pop_back();
+
+        // 2. Declarations the parser found (e.g. a C function whose '{' is on its own line)
+        for (size_t i = 1; i < parser.scopes.size(); i++) {
+            const MicroParser::Scope& scope = parser.scopes[i];
+            if (scope.isNamed() && !scope.isEmpty() && scope.endLine <= size) {
+                addNode(static_cast<uint32_t>(scope.startLine), static_cast<uint32_t>(scope.endLine));
+            }
+        }
+
+        // 3. Sort outer-first, drop duplicates and any range crossing an earlier one, link parents.
+        std::sort(_nodes.begin(), _nodes.end(), [](const Node& a, const Node& b) {
+            return a.start != b.start ? a.start < b.start : a.end > b.end;
+        });
+        _stack.clear();
+        size_t kept = 0;
+        for (size_t i = 0; i < _nodes.size(); i++) {
+            Node node = _nodes[i];
+            if (kept > 0 && node.start == _nodes[kept - 1].start && node.end == _nodes[kept - 1].end) continue;
+            while (!_stack.empty() && _nodes[_stack.back()].end <= node.start) _stack.pop_back();
+            if (!_stack.empty() && node.end > _nodes[_stack.back()].end) continue;
+            node.parent = _stack.empty() ? -1 : static_cast<int32_t>(_stack.back());
+            _nodes[kept] = node;
+            _stack.push_back(kept++);
+        }
+        _nodes.resize(kept);
+        _valid = true;
+    }
+
+    void Tree::ensure(const IncrementalLexer& lexer, const MicroParser::Engine& parser) {
+        if (!_valid) {
+            rebuild(lexer, parser);
+        }
+    }
+
+    // MARK: - Queries
+
+    bool Tree::tokenAt(const IncrementalLexer& lexer, uint32_t offset, Range& out) const {
+        const std::vector<Token>& tokens = lexer.tokens();
+        auto it = std::upper_bound(tokens.begin(), tokens.end(), offset, [](uint32_t value, const Token& t) {
+            return value < t.start;
+        });
+        // The token starting at `offset`, else the one ending there (a cursor right
+        // after a word); brackets and separators are not worth selecting alone.
+        for (int k = 0; k < 2 && it != tokens.begin(); k++) {
+            const Token& t = *--it;
+            if (offset > t.start + t.length) break;
+            if (t.type != TokenType::Punctuation) {
+                out = {t.start, t.start + t.length};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Range Tree::expand(const IncrementalLexer& lexer, const MicroParser::Engine& parser, Range selection) {
+        ensure(lexer, parser);
+        if (_nodes.empty()) {
+            return selection;
+        }
+        auto it = std::upper_bound(_nodes.begin(), _nodes.end(), selection.start, [](uint32_t value, const Node& node) {
+            return value < node.start;
+        });
+        // Every node containing the selection is an ancestor of (or is) the last node
+        // starting at or before it.
+        int32_t i = it == _nodes.begin() ? 0 : static_cast<int32_t>(it - _nodes.begin()) - 1;
+        while (i > 0 && _nodes[i].end < selection.end) i = _nodes[i].parent;
+        if (_nodes[i].start == selection.start && _nodes[i].end == selection.end) {
+            if (_nodes[i].parent < 0) {
+                return selection;
+            }
+            i = _nodes[i].parent;
+        }
+        Range best = {_nodes[i].start, _nodes[i].end};
+
+        Range token;
+        if (tokenAt(lexer, selection.start, token) && token.start <= selection.start && selection.end <= token.end &&
+            token != selection && token.end - token.start < best.end - best.start) {
+            best = token;
+        }
+        return best;
+    }
+
+    Range Tree::shrink(const IncrementalLexer& lexer, const MicroParser::Engine& parser, Range selection) {
+        ensure(lexer, parser);
+        if (selection.end <= selection.start) {
+            return selection;
+        }
+        auto inside = [&selection](Range range) {
+            return range.start >= selection.start && range.end <= selection.end && range != selection;
+        };
+        const size_t begin = static_cast<size_t>(std::lower_bound(_nodes.begin(), _nodes.end(), selection.start,
+            [](const Node& node, uint32_t value) { return node.start < value; }) - _nodes.begin());
+
+        // Outer nodes come first among those with the same start; failing that, the
+        // first node inside (the nodes skipped on the way all cross selection.end,
+        // so they are its ancestors), and only then the token at the start.
+        for (size_t j = begin; j < _nodes.size() && _nodes[j].start < selection.end; j++) {
+            Range range = {_nodes[j].start, _nodes[j].end};
+            if (inside(range)) {
+                return range;
+            }
+        }
+        Range token;
+        if (tokenAt(lexer, selection.start, token) && token.start == selection.start && inside(token)) {
+            return token;
+        }
+        return selection;
+    }
+
+    size_t Tree::memoryFootprint() const {
+        return _nodes.capacity() * sizeof(Node)
+            + _containers.capacity() * sizeof(Container)
+            + _statements.capacity() * sizeof(Statement)
+            + _stack.capacity() * sizeof(size_t);
+    }
+}
@@ -0,0 +1,96 @@
+//
+//  MicroSelection.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroIncrementalLexer.h"
+#include "MicroParser.h"
+
+#include <cstdint>
+#include <vector>
+
+// MARK: - MicroSelection (C++)
+// Structural selection ("Expand / Shrink Selection") for one document.
+//
+// The syntactic ranges of a document form one tree: string contents and strings,
+// bracket contents and brackets, statements (split at ';' and line ends inside
+// braces, at ',' inside parentheses and square brackets), statements grouped with
+// the more-indented lines under them, and named MicroParser scopes. Other tokens
+// are the leaves and are looked up in the lexer rather than stored.
+//
+// Nodes nest properly and are sorted by start with a parent link, so expanding
+// is a binary search plus a walk up the enclosing nodes. The tree is rebuilt
+// from the tokens on the first query after a parse; edits only mark it stale, so
+// typing never pays for it and repeated expands reuse it.
+
+namespace MicroSelection {
+
+    struct Range {
+        uint32_t start;
+        uint32_t end;
+
+        bool operator==(const Range& other) const { return start == other.start && end == other.end; }
+        bool operator!=(const Range& other) const { return !(*this == other); }
+    };
+
+    class Tree {
+    public:
+        /// Call after every parse.
+        void invalidate() { _valid = false; }
+
+        /// Smallest syntactic range strictly containing `selection`, up to the whole
+        /// document; `selection` itself when it already covers the document.
+        /// O(log n + depth) once the tree is built.
+        Range expand(const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser, Range selection);
+
+        /// Outermost syntactic range strictly inside `selection`, preferring one that
+        /// starts where it does; `selection` itself when there is none.
+        Range shrink(const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser, Range selection);
+
+        size_t memoryFootprint() const;
+
+    private:
+        struct Node {
+            uint32_t start;
+            uint32_t end;
+            int32_t parent; // -1 for the document
+        };
+
+        struct Statement {
+            uint32_t start;
+            uint32_t end;
+            uint32_t groupEnd; // End of the last more-indented statement under this one
+            uint32_t indent;
+        };
+
+        struct Container {
+            uint32_t open;          // Offset of the opening bracket
+            char close;             // Expected closing bracket; 0 for the document
+            bool inStatement;
+            bool hasContent;
+            Statement statement;    // Open statement, valid while inStatement
+            uint32_t contentStart;  // First and last token inside the brackets
+            uint32_t contentEnd;
+            size_t firstStatement;  // This container's statements in _statements
+        };
+
+        void ensure(const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser);
+        void rebuild(const MicroLexer::IncrementalLexer& lexer, const MicroParser::Engine& parser);
+        void addToStatement(Container& container, uint32_t start, uint32_t end, uint32_t indent);
+        void endStatement(Container& container);
+        void closeContainer(Container& container, bool matched, uint32_t closeEnd);
+        void addNode(uint32_t start, uint32_t end);
+        bool tokenAt(const MicroLexer::IncrementalLexer& lexer, uint32_t offset, Range& out) const;
+
+        bool _valid = false;
+        std::vector<Node> _nodes;
+        std::vector<Container> _containers; // Scratch for rebuild()
+        std::vector<Statement> _statements;
+        std::vector<size_t> _stack;
+    };
+}
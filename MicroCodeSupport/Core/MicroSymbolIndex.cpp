@@ -0,0 +1,524 @@
+//
+//  MicroSymbolIndex.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroSymbolIndex.h"
+#include "MicroLexer.h"
+#include "MicroParser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <mutex>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+
+namespace MicroIndex {
+
+    namespace {
+
+        constexpr char kMagic[8] = {'M', 'C', 'S', 'Y', 'M', 'I', 'D', 'X'};
+        constexpr uint32_t kVersion = 2;
+
+        // Generated or minified files beyond this size are not worth indexing.
+        constexpr size_t kMaxIndexedFileBytes = 4 * 1024 * 1024;
+
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t fileCount;
+            uint32_t symbolCount;
+            uint32_t reserved;
+            uint64_t stringPoolSize;
+        };
+
+        struct FileRecord {
+            uint32_t pathOffset;
+            uint32_t pathLength;
+            int64_t mtime;
+            uint64_t size;
+            uint32_t firstSymbol;
+            uint32_t symbolCount;
+        };
+
+        struct SymbolRecord {
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            uint32_t file;
+            uint32_t start;
+            uint32_t end;
+            uint32_t line;
+            int32_t parent;
+            uint8_t kind;
+            uint8_t padding[3];
+        };
+
+        static_assert(sizeof(Header) == 32 && sizeof(FileRecord) == 32 && sizeof(SymbolRecord) == 32,
+                      "On-disk records must keep their size");
+
+        struct Table {
+            const Header *header = nullptr;
+            const FileRecord *files = nullptr;
+            const SymbolRecord *symbols = nullptr;
+            const char *pool = nullptr;
+            uint64_t poolSize = 0;
+
+            std::string_view string(uint32_t offset, uint32_t length) const {
+                if ((uint64_t)offset + length > poolSize) return {};
+                return std::string_view(pool + offset, length);
+            }
+        };
+
+        Table tableFor(const MicroCore::MappedFile& mapping) {
+            Table table;
+            if (!mapping.isOpen()) return table;
+            const uint8_t *base = mapping.data();
+            table.header = reinterpret_cast<const Header *>(base);
+            table.files = reinterpret_cast<const FileRecord *>(base + sizeof(Header));
+            table.symbols = reinterpret_cast<const SymbolRecord *>(table.files + table.header->fileCount);
+            table.pool = reinterpret_cast<const char *>(table.symbols + table.header->symbolCount);
+            table.poolSize = table.header->stringPoolSize;
+            return table;
+        }
+
+        bool readFile(const std::string& path, size_t size, std::string& out) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return false;
+            out.resize(size);
+            size_t total = 0;
+            while (total < size) {
+                ssize_t n = ::read(fd, &out[total], size - total);
+                if (n <= 0) break;
+                total += (size_t)n;
+            }
+            ::close(fd);
+            out.resize(total);
+            return true;
+        }
+
+        SymbolHit hitFor(const SymbolView& view, int32_t score) {
+            return {std::string(view.name), std::string(view.file), view.kind,
+                    view.start, view.end, view.line, view.parent, score};
+        }
+
+        bool containsIgnoringCase(std::string_view haystack, std::string_view lowerNeedle) {
+            if (lowerNeedle.empty()) return true;
+            if (haystack.size() < lowerNeedle.size()) return false;
+            for (size_t i = 0; i + lowerNeedle.size() <= haystack.size(); i++) {
+                size_t j = 0;
+                while (j < lowerNeedle.size()) {
+                    char c = haystack[i + j];
+                    if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+                    if (c != lowerNeedle[j]) break;
+                    j++;
+                }
+                if (j == lowerNeedle.size()) return true;
+            }
+            return false;
+        }
+    }
+
+    SymbolIndex::SymbolIndex(std::string indexPath) : _indexPath(std::move(indexPath)) {}
+
+    bool SymbolIndex::open() {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        _overlay.clear();
+        _basePaths.clear();
+        _shadowed.clear();
+        _baseLookupBuilt = false;
+        _generation++;
+
+        if (!_mapping.open(_indexPath)) return false;
+        if (!validateMapping()) {
+            _mapping.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool SymbolIndex::validateMapping() const {
+        if (_mapping.size() < sizeof(Header)) return false;
+        const Header *header = reinterpret_cast<const Header *>(_mapping.data());
+        if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion) return false;
+        uint64_t expected = sizeof(Header)
+            + (uint64_t)header->fileCount * sizeof(FileRecord)
+            + (uint64_t)header->symbolCount * sizeof(SymbolRecord)
+            + header->stringPoolSize;
+        return expected == _mapping.size();
+    }
+
+    void SymbolIndex::buildBaseLookup() {
+        if (_baseLookupBuilt) return;
+        _baseLookupBuilt = true;
+        Table table = tableFor(_mapping);
+        if (!table.header) return;
+        _basePaths.reserve(table.header->fileCount);
+        _shadowed.assign(table.header->fileCount, false);
+        for (uint32_t i = 0; i < table.header->fileCount; i++) {
+            _basePaths.emplace(table.string(table.files[i].pathOffset, table.files[i].pathLength), i);
+        }
+    }
+
+    bool SymbolIndex::baseStamp(const std::string& path, FileStamp& stamp, uint32_t& fileIndex) const {
+        auto it = _basePaths.find(path);
+        if (it == _basePaths.end()) return false;
+        const FileRecord& record = tableFor(_mapping).files[it->second];
+        stamp = {record.mtime, record.size};
+        fileIndex = it->second;
+        return true;
+    }
+
+    bool SymbolIndex::statFile(const std::string& path, FileStamp& stamp) {
+        struct stat sb;
+        if (stat(path.c_str(), &sb) != 0 || !S_ISREG(sb.st_mode)) return false;
+#ifdef __APPLE__
+        int64_t nanos = sb.st_mtimespec.tv_nsec;
+#else
+        int64_t nanos = sb.st_mtim.tv_nsec;
+#endif
+        stamp.mtime = (int64_t)sb.st_mtime * 1000000000LL + nanos;
+        stamp.size = (uint64_t)sb.st_size;
+        return true;
+    }
+
+    SymbolIndex::FileSymbols SymbolIndex::parseFile(const std::string& path, const FileStamp& stamp) {
+        FileSymbols result;
+        result.path = path;
+        result.mtime = stamp.mtime;
+        result.size = stamp.size;
+
+        std::string language = MicroLexer::LanguageSpec::languageForPath(path);
+        if (language.empty() || stamp.size > kMaxIndexedFileBytes) return result;
+
+        std::string source;
+        if (!readFile(path, (size_t)stamp.size, source)) return result;
+
+        MicroLexer::Engine lexer(language);
+        std::vector<MicroLexer::Token> tokens = lexer.tokenize(source);
+        MicroParser::Engine parser;
+        parser.parse(tokens, source, language);
+
+        std::vector<uint32_t> lineStarts;
+        lineStarts.push_back(0);
+        for (size_t i = 0; i < source.size(); i++) {
+            if (source[i] == '\n') lineStarts.push_back((uint32_t)(i + 1));
+        }
+        auto lineOf = [&lineStarts](int64_t offset) -> uint32_t {
+            auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), (uint32_t)offset);
+            return (uint32_t)(it - lineStarts.begin() - 1);
+        };
+        auto clampEnd = [&source](int64_t end) -> uint32_t {
+            return (uint32_t)std::min<int64_t>(end, (int64_t)source.size());
+        };
+
+        // Scopes first so variables can point at their enclosing function. Bodiless
+        // declarations are left to the definitions they announce. A scope's parent
+        // comes before it, so its nearest enclosing symbol is already known.
+        std::vector<int32_t> scopeSymbol(parser.scopes.size(), -1); // Nearest enclosing symbol, the scope's own if any
+        for (size_t i = 1; i < parser.scopes.size(); i++) {
+            const MicroParser::Scope& scope = parser.scopes[i];
+            int32_t container = scope.parent > 0 ? scopeSymbol[(size_t)scope.parent] : -1;
+            scopeSymbol[i] = container;
+            if (scope.isEmpty()) continue;
+            SymbolKind kind;
+            if (scope.kind == MicroParser::ScopeKind::Function) kind = SymbolKind::Function;
+            else if (scope.kind == MicroParser::ScopeKind::Class) kind = SymbolKind::Class;
+            else continue;
+            scopeSymbol[i] = (int32_t)result.symbols.size();
+            result.symbols.push_back({std::string(scope.name), kind, (uint32_t)scope.startLine, clampEnd(scope.endLine),
+                                      lineOf(scope.startLine), container});
+        }
+        for (size_t i = 0; i < parser.scopes.size(); i++) {
+            for (const MicroParser::Symbol *var = parser.scopes[i].variables; var; var = var->next) {
+                result.symbols.push_back({std::string(var->name), SymbolKind::Variable, (uint32_t)var->line, (uint32_t)var->line,
+                                          lineOf(var->line), scopeSymbol[i]});
+            }
+        }
+        return result;
+    }
+
+    void SymbolIndex::applyLocked(FileSymbols&& file) {
+        buildBaseLookup();
+        _generation++;
+        auto it = _basePaths.find(file.path);
+        if (it != _basePaths.end()) {
+            _shadowed[it->second] = true;
+        } else if (file.removed) {
+            _overlay.erase(file.path);
+            return;
+        }
+        std::string key = file.path;
+        _overlay[key] = std::move(file);
+    }
+
+    size_t SymbolIndex::indexFiles(const std::vector<std::string>& paths, MicroCore::ThreadPool& pool) {
+        {
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            buildBaseLookup();
+        }
+
+        std::vector<FileSymbols> parsed(paths.size());
+        std::vector<char> changed(paths.size(), 0);
+        std::vector<char> missing(paths.size(), 0); // Gone since it was listed
+
+        pool.parallelFor(paths.size(), 64, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                FileStamp stamp;
+                if (!statFile(paths[i], stamp)) {
+                    missing[i] = 1;
+                    continue;
+                }
+
+                bool upToDate = false;
+                {
+                    std::shared_lock<std::shared_mutex> lock(_mutex);
+                    auto it = _overlay.find(paths[i]);
+                    FileStamp known;
+                    uint32_t fileIndex;
+                    if (it != _overlay.end()) {
+                        upToDate = !it->second.removed && it->second.mtime == stamp.mtime && it->second.size == stamp.size;
+                    } else if (baseStamp(paths[i], known, fileIndex)) {
+                        upToDate = known.mtime == stamp.mtime && known.size == stamp.size;
+                    }
+                }
+                if (upToDate) continue;
+
+                parsed[i] = parseFile(paths[i], stamp);
+                changed[i] = 1;
+            }
+        });
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        size_t parsedCount = 0;
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!changed[i]) continue;
+            applyLocked(std::move(parsed[i]));
+            parsedCount++;
+        }
+
+        // Files that are indexed but no longer part of the workspace, or were
+        // deleted after being listed.
+        std::unordered_set<std::string_view> listed;
+        listed.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!missing[i]) listed.insert(paths[i]);
+        }
+        std::vector<std::string> stale;
+        for (const auto& entry : _basePaths) {
+            if (!_shadowed[entry.second] && !listed.count(entry.first)) stale.emplace_back(entry.first);
+        }
+        for (const auto& entry : _overlay) {
+            if (!entry.second.removed && !listed.count(entry.first)) stale.push_back(entry.first);
+        }
+        for (auto& path : stale) {
+            FileSymbols removed;
+            removed.path = std::move(path);
+            removed.removed = true;
+            applyLocked(std::move(removed));
+        }
+        return parsedCount;
+    }
+
+    void SymbolIndex::updateFile(const std::string& path) {
+        FileStamp stamp;
+        if (!statFile(path, stamp)) {
+            removeFile(path);
+            return;
+        }
+        FileSymbols file = parseFile(path, stamp);
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        applyLocked(std::move(file));
+    }
+
+    void SymbolIndex::removeFile(const std::string& path) {
+        FileSymbols file;
+        file.path = path;
+        file.removed = true;
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        applyLocked(std::move(file));
+    }
+
+    bool SymbolIndex::save() {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        Table table = tableFor(_mapping);
+
+        std::vector<FileRecord> files;
+        std::vector<SymbolRecord> symbols;
+        std::string pool;
+        std::unordered_map<std::string, uint32_t> interned;
+
+        auto intern = [&](std::string_view text) -> uint32_t {
+            auto it = interned.find(std::string(text));
+            if (it != interned.end()) return it->second;
+            uint32_t offset = (uint32_t)pool.size();
+            pool.append(text.data(), text.size());
+            interned.emplace(std::string(text), offset);
+            return offset;
+        };
+
+        if (table.header) {
+            for (uint32_t f = 0; f < table.header->fileCount; f++) {
+                if (!_shadowed.empty() && _shadowed[f]) continue;
+                const FileRecord& src = table.files[f];
+                if ((uint64_t)src.firstSymbol + src.symbolCount > table.header->symbolCount) continue;
+                std::string_view path = table.string(src.pathOffset, src.pathLength);
+                FileRecord record = {(uint32_t)pool.size(), (uint32_t)path.size(), src.mtime, src.size,
+                                     (uint32_t)symbols.size(), src.symbolCount};
+                pool.append(path.data(), path.size());
+                for (uint32_t s = 0; s < src.symbolCount; s++) {
+                    SymbolRecord sym = table.symbols[src.firstSymbol + s];
+                    std::string_view name = table.string(sym.nameOffset, sym.nameLength);
+                    sym.nameOffset = intern(name);
+                    sym.nameLength = (uint32_t)name.size();
+                    sym.file = (uint32_t)files.size();
+                    symbols.push_back(sym);
+                }
+                files.push_back(record);
+            }
+        }
+
+        for (const auto& entry : _overlay) {
+            const FileSymbols& file = entry.second;
+            if (file.removed) continue;
+            FileRecord record = {(uint32_t)pool.size(), (uint32_t)file.path.size(), file.mtime, file.size,
+                                 (uint32_t)symbols.size(), (uint32_t)file.symbols.size()};
+            pool.append(file.path);
+            for (const auto& sym : file.symbols) {
+                SymbolRecord out = {};
+                out.nameOffset = intern(sym.name);
+                out.nameLength = (uint32_t)sym.name.size();
+                out.file = (uint32_t)files.size();
+                out.start = sym.start;
+                out.end = sym.end;
+                out.line = sym.line;
+                out.parent = sym.parent;
+                out.kind = (uint8_t)sym.kind;
+                symbols.push_back(out);
+            }
+            files.push_back(record);
+        }
+
+        if (pool.size() > std::numeric_limits<uint32_t>::max()) return false;
+
+        Header header = {};
+        memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.fileCount = (uint32_t)files.size();
+        header.symbolCount = (uint32_t)symbols.size();
+        header.stringPoolSize = pool.size();
+
+        std::string blob;
+        blob.reserve(sizeof(Header) + files.size() * sizeof(FileRecord) + symbols.size() * sizeof(SymbolRecord) + pool.size());
+        blob.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        blob.append(reinterpret_cast<const char *>(files.data()), files.size() * sizeof(FileRecord));
+        blob.append(reinterpret_cast<const char *>(symbols.data()), symbols.size() * sizeof(SymbolRecord));
+        blob.append(pool);
+
+        if (!MicroCore::writeFileAtomically(_indexPath, blob.data(), blob.size())) return false;
+
+        // As in CallGraph::save(): an unvalidated table is never queried.
+        MicroCore::MappedFile previous = std::move(_mapping);
+        if (!_mapping.open(_indexPath) || !validateMapping()) {
+            _mapping = std::move(previous);
+            return false;
+        }
+        _overlay.clear();
+        _basePaths.clear();
+        _shadowed.clear();
+        _baseLookupBuilt = false;
+        _generation++;
+        return true;
+    }
+
+    size_t SymbolIndex::symbolCount() const {
+        size_t count = 0;
+        forEachSymbol([&count](const SymbolView&) { count++; });
+        return count;
+    }
+
+    size_t SymbolIndex::fileCount() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        Table table = tableFor(_mapping);
+        size_t count = 0;
+        if (table.header) {
+            for (uint32_t f = 0; f < table.header->fileCount; f++) {
+                if (_shadowed.empty() || !_shadowed[f]) count++;
+            }
+        }
+        for (const auto& entry : _overlay) {
+            if (!entry.second.removed) count++;
+        }
+        return count;
+    }
+
+    void SymbolIndex::forEachSymbol(const std::function<void(const SymbolView&)>& visit) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        forEachSymbolLocked(visit);
+    }
+
+    void SymbolIndex::forEachSymbolLocked(const std::function<void(const SymbolView&)>& visit) const {
+        Table table = tableFor(_mapping);
+        if (table.header) {
+            for (uint32_t f = 0; f < table.header->fileCount; f++) {
+                if (!_shadowed.empty() && _shadowed[f]) continue;
+                const FileRecord& file = table.files[f];
+                if ((uint64_t)file.firstSymbol + file.symbolCount > table.header->symbolCount) continue;
+                std::string_view path = table.string(file.pathOffset, file.pathLength);
+                for (uint32_t s = 0; s < file.symbolCount; s++) {
+                    const SymbolRecord& sym = table.symbols[file.firstSymbol + s];
+                    visit({table.string(sym.nameOffset, sym.nameLength), path, (SymbolKind)sym.kind,
+                           sym.start, sym.end, sym.line, sym.parent});
+                }
+            }
+        }
+        for (const auto& entry : _overlay) {
+            const FileSymbols& file = entry.second;
+            if (file.removed) continue;
+            for (const auto& sym : file.symbols) {
+                visit({sym.name, file.path, sym.kind, sym.start, sym.end, sym.line, sym.parent});
+            }
+        }
+    }
+
+    std::vector<SymbolHit> SymbolIndex::search(std::string_view query, size_t limit) const {
+        std::string needle(query);
+        for (auto& ch : needle) {
+            if (ch >= 'A' && ch <= 'Z') ch = (char)(ch - 'A' + 'a');
+        }
+        std::vector<SymbolHit> results;
+        if (limit == 0) return results;
+        forEachSymbol([&](const SymbolView& symbol) {
+            if (results.size() < limit && containsIgnoringCase(symbol.name, needle)) {
+                results.push_back(hitFor(symbol, 0));
+            }
+        });
+        return results;
+    }
+
+    std::vector<SymbolHit> SymbolIndex::fuzzySearch(std::string_view query, size_t limit) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        std::lock_guard<std::mutex> fuzzyLock(_fuzzyMutex);
+
+        if (_fuzzyGeneration != _generation) {
+            _fuzzyCorpus.clear();
+            _fuzzyViews.clear();
+            forEachSymbolLocked([this](const SymbolView& symbol) {
+                _fuzzyCorpus.add(symbol.name);
+                _fuzzyViews.push_back(symbol);
+            });
+            _fuzzyGeneration = _generation;
+        }
+
+        std::vector<SymbolHit> results;
+        for (const auto& match : MicroFuzzy::Matcher().topMatches(_fuzzyCorpus, query, limit)) {
+            results.push_back(hitFor(_fuzzyViews[match.index], match.score));
+        }
+        return results;
+    }
+}
@@ -0,0 +1,151 @@
+//
+//  MicroSymbolIndex.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroFuzzy.h"
+#include "MicroMappedFile.h"
+#include "MicroThreadPool.h"
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// MARK: - MicroIndex (C++)
+// Workspace-wide symbol table. Files are lexed and parsed on a thread pool and the
+// result is persisted as a flat, memory-mappable table:
+//
+//   [Header][FileRecord x fileCount][SymbolRecord x symbolCount][string pool]
+//
+// Opening an existing index only maps it, so symbol search is available before any
+// file is re-parsed. Changed files are re-indexed into an in-memory overlay that
+// shadows their mapped records until the next save().
+
+namespace MicroIndex {
+
+    enum class SymbolKind : uint8_t {
+        Function = 1,
+        Class = 2,
+        Variable = 3
+    };
+
+    /// View of one symbol. Strings point into the mapping or the overlay and stay
+    /// valid until the next mutating call (indexFiles/updateFile/removeFile/save).
+    struct SymbolView {
+        std::string_view name;
+        std::string_view file;
+        SymbolKind kind;
+        uint32_t start;   // Byte offset
+        uint32_t end;     // Byte offset (exclusive)
+        uint32_t line;    // 0-based
+        int32_t parent;   // Index of the parent symbol within the same file, or -1
+    };
+
+    /// Owned copy of a symbol, safe to keep across mutations.
+    struct SymbolHit {
+        std::string name;
+        std::string file;
+        SymbolKind kind;
+        uint32_t start;
+        uint32_t end;
+        uint32_t line;
+        int32_t parent;
+        int32_t score; // Fuzzy score, 0 for substring search
+    };
+
+    class SymbolIndex {
+    public:
+        explicit SymbolIndex(std::string indexPath);
+
+        /// Maps the on-disk table. Returns false if it is missing or unreadable,
+        /// in which case the index starts empty.
+        bool open();
+
+        /// Re-indexes every path whose size or mtime differs from the indexed copy
+        /// and drops indexed files that are no longer listed. Returns the number of
+        /// files parsed.
+        size_t indexFiles(const std::vector<std::string>& paths,
+                          MicroCore::ThreadPool& pool = MicroCore::ThreadPool::shared());
+
+        /// File-change hooks. Cheap; the index does not watch files itself, so
+        /// whoever owns it forwards its watcher's events here.
+        void updateFile(const std::string& path);
+        void removeFile(const std::string& path);
+
+        /// Writes the merged table atomically and re-maps it.
+        bool save();
+
+        size_t symbolCount() const;
+        size_t fileCount() const;
+
+        void forEachSymbol(const std::function<void(const SymbolView&)>& visit) const;
+
+        /// Case-insensitive substring search over names; at most `limit` results.
+        std::vector<SymbolHit> search(std::string_view query, size_t limit) const;
+
+        /// Best `limit` fuzzy matches (see MicroFuzzy). The name corpus is rebuilt
+        /// lazily after the index changes.
+        std::vector<SymbolHit> fuzzySearch(std::string_view query, size_t limit) const;
+
+    private:
+        struct OwnedSymbol {
+            std::string name;
+            SymbolKind kind;
+            uint32_t start;
+            uint32_t end;
+            uint32_t line;
+            int32_t parent;
+        };
+
+        struct FileSymbols {
+            std::string path;
+            int64_t mtime = 0;
+            uint64_t size = 0;
+            bool removed = false;
+            std::vector<OwnedSymbol> symbols;
+        };
+
+        struct FileStamp {
+            int64_t mtime;
+            uint64_t size;
+        };
+
+        static bool statFile(const std::string& path, FileStamp& stamp);
+        static FileSymbols parseFile(const std::string& path, const FileStamp& stamp);
+
+        bool validateMapping() const;
+        void buildBaseLookup();
+        bool baseStamp(const std::string& path, FileStamp& stamp, uint32_t& fileIndex) const;
+        void applyLocked(FileSymbols&& file);
+        void forEachSymbolLocked(const std::function<void(const SymbolView&)>& visit) const;
+
+        std::string _indexPath;
+        MicroCore::MappedFile _mapping;
+        mutable std::shared_mutex _mutex;
+
+        // Base (mapped) table; lookup is built lazily on the first mutation.
+        std::unordered_map<std::string_view, uint32_t> _basePaths;
+        bool _baseLookupBuilt = false;
+        std::vector<bool> _shadowed;
+
+        // Overlay of files changed since the mapping was written.
+        std::unordered_map<std::string, FileSymbols> _overlay;
+
+        // Bumped on every mutation; invalidates the fuzzy corpus.
+        uint64_t _generation = 0;
+        mutable std::mutex _fuzzyMutex;
+        mutable uint64_t _fuzzyGeneration = UINT64_MAX;
+        mutable MicroFuzzy::Corpus _fuzzyCorpus;
+        mutable std::vector<SymbolView> _fuzzyViews;
+    };
+}
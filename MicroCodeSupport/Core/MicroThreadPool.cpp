@@ -0,0 +1,61 @@
+//
+//  MicroThreadPool.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroThreadPool.h"
+
+namespace MicroCore {
+
+    ThreadPool::ThreadPool(size_t threads) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        _workers.reserve(threads);
+        for (size_t i = 0; i < threads; i++) {
+            _workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _cv.notify_all();
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool& ThreadPool::shared() {
+        // Leaked on purpose: workers must outlive static destructors of callers.
+        static ThreadPool *pool = new ThreadPool();
+        return *pool;
+    }
+
+    void ThreadPool::submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queue.push_back(std::move(task));
+        }
+        _cv.notify_one();
+    }
+
+    void ThreadPool::workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(lock, [this] { return _stopping || !_queue.empty(); });
+                if (_stopping && _queue.empty()) return;
+                task = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            task();
+        }
+    }
+}
@@ -0,0 +1,97 @@
+//
+//  MicroThreadPool.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MicroCore {
+
+    /// Fixed-size worker pool shared by the indexers and matchers.
+    class ThreadPool {
+    public:
+        /// `threads == 0` uses one worker per hardware thread.
+        explicit ThreadPool(size_t threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// Process-wide pool.
+        static ThreadPool& shared();
+
+        size_t size() const { return _workers.size(); }
+
+        void submit(std::function<void()> task);
+
+        /// Runs fn(begin, end) over [0, count) in chunks of `grain`, on the pool
+        /// and on the calling thread. Blocks until every chunk has run. Safe to
+        /// call from inside a pool task: the caller never waits on queued helpers.
+        template <class Fn>
+        void parallelFor(size_t count, size_t grain, Fn&& fn);
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> _workers;
+        std::deque<std::function<void()>> _queue;
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        bool _stopping = false;
+    };
+
+    template <class Fn>
+    void ThreadPool::parallelFor(size_t count, size_t grain, Fn&& fn) {
+        if (count == 0) return;
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (count + grain - 1) / grain;
+        if (chunks == 1 || _workers.empty()) {
+            fn(size_t(0), count);
+            return;
+        }
+
+        struct State {
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            std::mutex mutex;
+            std::condition_variable cv;
+        };
+        auto state = std::make_shared<State>();
+
+        // Helpers that start after the work is drained simply return.
+        auto run = [state, count, grain, chunks, &fn]() {
+            size_t c;
+            while ((c = state->next.fetch_add(1)) < chunks) {
+                size_t begin = c * grain;
+                fn(begin, std::min(count, begin + grain));
+                if (state->done.fetch_add(1) + 1 == chunks) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->cv.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min(chunks - 1, _workers.size());
+        for (size_t h = 0; h < helpers; h++) {
+            submit(run);
+        }
+        run();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait(lock, [&] { return state->done.load() == chunks; });
+    }
+}
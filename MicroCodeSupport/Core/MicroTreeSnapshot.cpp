@@ -0,0 +1,531 @@
+//
+//  MicroTreeSnapshot.cpp
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#include "MicroTreeSnapshot.h"
+#include "MicroHash.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace MicroFiles {
+
+    namespace {
+
+        constexpr char kMagic[8] = {'M', 'C', 'F', 'T', 'R', 'E', 'E', 'S'};
+        constexpr uint32_t kVersion = 2;
+        constexpr uint32_t kNoNode = TreeSnapshot::kNoNode;
+
+        constexpr uint8_t kLinksToDirectory = 1;
+
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t nodeCount;
+            uint32_t rootOffset;
+            uint32_t rootLength;
+            uint32_t reserved[2];
+            uint64_t stringPoolSize;
+        };
+
+        struct NodeRecord {
+            uint32_t nameOffset;
+            uint16_t nameLength;
+            uint8_t type;        // EntryType
+            uint8_t flags;       // kLinksToDirectory
+            uint32_t parent;
+            uint32_t firstChild;
+            uint32_t childCount;
+            uint32_t filterStamp; // Directories: see filterStampOf()
+            uint64_t size;
+            int64_t mtime;
+        };
+
+        static_assert(sizeof(Header) == 40 && sizeof(NodeRecord) == 40, "On-disk records must keep their size");
+
+        struct Table {
+            const Header *header = nullptr;
+            const NodeRecord *nodes = nullptr;
+            const char *pool = nullptr;
+            uint64_t poolSize = 0;
+
+            std::string_view string(uint32_t offset, uint32_t length) const {
+                if ((uint64_t)offset + length > poolSize) return {};
+                return std::string_view(pool + offset, length);
+            }
+
+            std::string_view name(uint32_t node) const {
+                return string(nodes[node].nameOffset, nodes[node].nameLength);
+            }
+
+            /// Children of `node`, clamped to the table.
+            void children(uint32_t node, uint32_t& begin, uint32_t& end) const {
+                uint32_t count = header->nodeCount;
+                begin = std::min(nodes[node].firstChild, count);
+                end = (uint32_t)std::min<uint64_t>((uint64_t)begin + nodes[node].childCount, count);
+            }
+        };
+
+        Table tableFor(const MicroCore::MappedFile& mapping) {
+            Table table;
+            if (!mapping.isOpen()) return table;
+            const uint8_t *base = mapping.data();
+            table.header = reinterpret_cast<const Header *>(base);
+            table.nodes = reinterpret_cast<const NodeRecord *>(base + sizeof(Header));
+            table.pool = reinterpret_cast<const char *>(table.nodes + table.header->nodeCount);
+            table.poolSize = table.header->stringPoolSize;
+            return table;
+        }
+
+        // The tree as it is assembled before being written.
+        struct DraftNode {
+            std::string name;
+            uint32_t parent;
+            EntryType type;
+            bool linksToDirectory;
+            uint64_t size;
+            int64_t mtime;
+            std::vector<uint32_t> children;
+            uint32_t filterStamp = 0;
+            bool stamped = false;  // filterStamp is current
+        };
+
+        using Draft = std::vector<DraftNode>;
+
+        uint32_t addNode(Draft& draft, uint32_t parent, std::string name, EntryType type,
+                         bool linksToDirectory, uint64_t size, int64_t mtime) {
+            uint32_t index = (uint32_t)draft.size();
+            draft.push_back(DraftNode{std::move(name), parent, type, linksToDirectory, size, mtime, {}});
+            draft[parent].children.push_back(index);
+            return index;
+        }
+
+        int64_t mtimeOf(const struct stat& sb) {
+#ifdef __APPLE__
+            int64_t nanos = sb.st_mtimespec.tv_nsec;
+#else
+            int64_t nanos = sb.st_mtim.tv_nsec;
+#endif
+            return (int64_t)sb.st_mtime * 1000000000LL + nanos;
+        }
+
+        /// mtime of the directory at `path`; false if it is gone or not a directory.
+        /// Only the root is followed through a symlink, as in scanDirectory().
+        bool directoryMtime(const std::string& path, bool follow, int64_t& mtime) {
+            struct stat sb;
+            int result = follow ? stat(path.c_str(), &sb) : lstat(path.c_str(), &sb);
+            if (result != 0 || !S_ISDIR(sb.st_mode)) return false;
+            mtime = mtimeOf(sb);
+            return true;
+        }
+
+        std::string joinPath(const std::string& directory, std::string_view name) {
+            std::string path = directory;
+            if (path.empty() || path.back() != '/') path.push_back('/');
+            path.append(name);
+            return path;
+        }
+
+        /// Hash of the size and mtime of the filter files present in `directory`;
+        /// 0 if there are none.
+        uint32_t filterStampOf(const std::string& directory, bool isRoot, const FilterFiles& filterFiles) {
+            uint64_t hash = 0;
+            auto add = [&](const std::vector<std::string>& names, uint64_t list) {
+                for (size_t i = 0; i < names.size(); i++) {
+                    struct stat sb;
+                    if (stat(joinPath(directory, names[i]).c_str(), &sb) != 0) continue;
+                    const int64_t record[3] = {(int64_t)(list << 32 | i), (int64_t)sb.st_size, mtimeOf(sb)};
+                    hash = MicroCore::hash64(record, sizeof(record), hash);
+                }
+            };
+            add(filterFiles.everyDirectory, 0);
+            if (isRoot) add(filterFiles.rootOnly, 1);
+            return (uint32_t)(hash ^ (hash >> 32));
+        }
+
+        bool hasFilterFiles(const FilterFiles& filterFiles) {
+            return !filterFiles.everyDirectory.empty() || !filterFiles.rootOnly.empty();
+        }
+
+        /// Stamps every directory of the draft that is not stamped yet.
+        void stampDraft(Draft& draft, const std::string& root, const FilterFiles& filterFiles,
+                        MicroCore::ThreadPool& pool) {
+            if (!hasFilterFiles(filterFiles)) return;
+            std::vector<std::pair<uint32_t, std::string>> pending;
+            std::vector<std::pair<uint32_t, std::string>> stack{{0, root}};
+            while (!stack.empty()) {
+                auto [index, path] = std::move(stack.back());
+                stack.pop_back();
+                for (uint32_t child : draft[index].children) {
+                    if (draft[child].type == EntryType::Directory) stack.emplace_back(child, joinPath(path, draft[child].name));
+                }
+                if (!draft[index].stamped) pending.emplace_back(index, std::move(path));
+            }
+            pool.parallelFor(pending.size(), 64, [&](size_t begin, size_t end) {
+                for (size_t k = begin; k < end; k++) {
+                    DraftNode& node = draft[pending[k].first];
+                    node.filterStamp = filterStampOf(pending[k].second, pending[k].first == 0, filterFiles);
+                    node.stamped = true;
+                }
+            });
+        }
+
+        ScanOptions snapshotOptions(const ScanOptions& options) {
+            ScanOptions scan = options;
+            scan.statEntries = true;
+            scan.maxDepth = UINT32_MAX;
+            return scan;
+        }
+
+        /// Crawls `path` and hangs everything below it under draft[index].
+        void attachScan(Draft& draft, uint32_t index, const std::string& path,
+                        const ScanOptions& options, MicroCore::ThreadPool& pool) {
+            std::vector<Entry> entries;
+            scanDirectory(path, options, [&](const Entry *batch, size_t count) {
+                entries.insert(entries.end(), batch, batch + count);
+                return true;
+            }, pool);
+
+            // Batches arrive in no particular order, so parents are found by path.
+            uint32_t base = (uint32_t)draft.size();
+            std::unordered_map<std::string_view, uint32_t> directories;
+            draft.reserve(draft.size() + entries.size());
+            for (size_t i = 0; i < entries.size(); i++) {
+                const Entry& entry = entries[i];
+                draft.push_back(DraftNode{std::string(entry.name()), kNoNode, entry.type, entry.linksToDirectory,
+                                          entry.size, entry.mtime, {}});
+                if (entry.type == EntryType::Directory) directories.emplace(entry.path, base + (uint32_t)i);
+            }
+            for (size_t i = 0; i < entries.size(); i++) {
+                const Entry& entry = entries[i];
+                uint32_t parent = index;
+                if (entry.depth > 0) {
+                    auto it = directories.find(std::string_view(entry.path).substr(0, entry.nameOffset - 1));
+                    if (it == directories.end()) continue; // Unreachable; not written
+                    parent = it->second;
+                }
+                draft[base + i].parent = parent;
+                draft[parent].children.push_back(base + (uint32_t)i);
+            }
+        }
+
+        /// Lays the draft out breadth first from node 0 and writes it atomically.
+        bool writeDraft(const Draft& draft, const std::string& root, const std::string& snapshotPath, size_t *nodeCount) {
+            std::vector<NodeRecord> records;
+            std::vector<uint32_t> order{0};
+            std::string pool = root;
+            records.reserve(draft.size());
+            order.reserve(draft.size());
+            pool.reserve(root.size() + draft.size() * 12);
+
+            std::vector<uint32_t> children;
+            for (size_t i = 0; i < order.size(); i++) {
+                const DraftNode& node = draft[order[i]];
+                children = node.children;
+                std::sort(children.begin(), children.end(), [&](uint32_t a, uint32_t b) {
+                    return draft[a].name < draft[b].name;
+                });
+
+                NodeRecord record = {};
+                record.nameOffset = (uint32_t)pool.size();
+                record.nameLength = (uint16_t)std::min<size_t>(node.name.size(), UINT16_MAX);
+                record.type = (uint8_t)node.type;
+                record.flags = node.linksToDirectory ? kLinksToDirectory : 0;
+                record.parent = kNoNode; // Set below for all but the root
+                record.firstChild = (uint32_t)order.size();
+                record.childCount = (uint32_t)children.size();
+                record.filterStamp = node.filterStamp;
+                record.size = node.size;
+                record.mtime = node.mtime;
+                pool.append(node.name, 0, record.nameLength);
+                records.push_back(record);
+
+                order.insert(order.end(), children.begin(), children.end());
+            }
+            for (uint32_t i = 0; i < records.size(); i++) {
+                for (uint32_t c = 0; c < records[i].childCount; c++) {
+                    records[records[i].firstChild + c].parent = i;
+                }
+            }
+            if (nodeCount) *nodeCount = records.size();
+
+            Header header = {};
+            memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.nodeCount = (uint32_t)records.size();
+            header.rootOffset = 0;
+            header.rootLength = (uint32_t)root.size();
+            header.stringPoolSize = pool.size();
+
+            std::vector<uint8_t> buffer(sizeof(Header) + records.size() * sizeof(NodeRecord) + pool.size());
+            uint8_t *out = buffer.data();
+            memcpy(out, &header, sizeof(Header));
+            memcpy(out + sizeof(Header), records.data(), records.size() * sizeof(NodeRecord));
+            memcpy(out + sizeof(Header) + records.size() * sizeof(NodeRecord), pool.data(), pool.size());
+            return MicroCore::writeFileAtomically(snapshotPath, buffer.data(), buffer.size());
+        }
+
+        std::string normalizedRoot(const std::string& root) {
+            std::string path = root;
+            while (path.size() > 1 && path.back() == '/') path.pop_back();
+            return path;
+        }
+    }
+
+    // MARK: - Reading
+
+    bool TreeSnapshot::open() {
+        _mapping.close();
+        if (!_mapping.open(_snapshotPath)) return false;
+
+        // Checks stop at the header so mapping stays O(1); accessors clamp instead.
+        const Header *header = reinterpret_cast<const Header *>(_mapping.data());
+        bool valid = _mapping.size() >= sizeof(Header) &&
+                     memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+                     header->version == kVersion && header->nodeCount > 0 &&
+                     sizeof(Header) + (uint64_t)header->nodeCount * sizeof(NodeRecord) + header->stringPoolSize == _mapping.size() &&
+                     (uint64_t)header->rootOffset + header->rootLength <= header->stringPoolSize;
+        if (!valid) _mapping.close();
+        return valid;
+    }
+
+    std::string_view TreeSnapshot::root() const {
+        Table table = tableFor(_mapping);
+        if (!table.header) return {};
+        return table.string(table.header->rootOffset, table.header->rootLength);
+    }
+
+    size_t TreeSnapshot::nodeCount() const {
+        return _mapping.isOpen() ? tableFor(_mapping).header->nodeCount : 0;
+    }
+
+    bool TreeSnapshot::node(uint32_t index, TreeNode& out) const {
+        Table table = tableFor(_mapping);
+        if (!table.header || index >= table.header->nodeCount) return false;
+        const NodeRecord& record = table.nodes[index];
+        uint32_t begin, end;
+        table.children(index, begin, end);
+        out.name = table.name(index);
+        out.parent = record.parent < table.header->nodeCount ? record.parent : kNoNode;
+        out.firstChild = begin;
+        out.childCount = end - begin;
+        out.type = record.type <= (uint8_t)EntryType::Other ? (EntryType)record.type : EntryType::Other;
+        out.linksToDirectory = (record.flags & kLinksToDirectory) != 0;
+        out.size = record.size;
+        out.mtime = record.mtime;
+        return true;
+    }
+
+    uint32_t TreeSnapshot::find(std::string_view path) const {
+        Table table = tableFor(_mapping);
+        if (!table.header) return kNoNode;
+        std::string_view rootPath = root();
+        if (path.size() > 1 && path.back() == '/') path.remove_suffix(1);
+        if (path.compare(0, rootPath.size(), rootPath) != 0) return kNoNode;
+        std::string_view rest = path.substr(rootPath.size());
+        if (!rest.empty() && rest.front() != '/' && rootPath != "/") return kNoNode;
+
+        uint32_t current = 0;
+        while (!rest.empty()) {
+            while (!rest.empty() && rest.front() == '/') rest.remove_prefix(1);
+            if (rest.empty()) break;
+            size_t slash = rest.find('/');
+            std::string_view component = rest.substr(0, slash);
+            rest = slash == std::string_view::npos ? std::string_view() : rest.substr(slash);
+
+            uint32_t begin, end;
+            table.children(current, begin, end);
+            while (begin < end) {
+                uint32_t mid = begin + (end - begin) / 2;
+                if (table.name(mid) < component) begin = mid + 1;
+                else end = mid;
+            }
+            uint32_t last = std::min(table.nodes[current].firstChild + table.nodes[current].childCount, table.header->nodeCount);
+            if (begin >= last || table.name(begin) != component) return kNoNode;
+            current = begin;
+        }
+        return current;
+    }
+
+    std::string TreeSnapshot::path(uint32_t index) const {
+        Table table = tableFor(_mapping);
+        if (!table.header || index >= table.header->nodeCount) return std::string();
+
+        std::vector<std::string_view> components;
+        // Bounded by the node count so a damaged parent chain cannot loop.
+        for (uint32_t node = index, steps = 0; node != 0 && steps < table.header->nodeCount; steps++) {
+            components.push_back(table.name(node));
+            node = table.nodes[node].parent;
+            if (node >= table.header->nodeCount) return std::string();
+        }
+
+        std::string result(root());
+        for (auto it = components.rbegin(); it != components.rend(); ++it) {
+            if (result.empty() || result.back() != '/') result.push_back('/');
+            result.append(*it);
+        }
+        return result;
+    }
+
+    // MARK: - Writing
+
+    bool TreeSnapshot::build(const std::string& root, const ScanOptions& options, const FilterFiles& filterFiles,
+                             MicroCore::ThreadPool& pool) const {
+        std::string rootPath = normalizedRoot(root);
+        int64_t mtime;
+        if (!directoryMtime(rootPath, true, mtime)) return false;
+
+        Draft draft;
+        draft.push_back(DraftNode{std::string(), kNoNode, EntryType::Directory, false, 0, mtime, {}});
+        attachScan(draft, 0, rootPath, snapshotOptions(options), pool);
+        stampDraft(draft, rootPath, filterFiles, pool);
+        return writeDraft(draft, rootPath, _snapshotPath, nullptr);
+    }
+
+    bool TreeSnapshot::revalidate(const ScanOptions& options, const FilterFiles& filterFiles, RevalidateStats *stats,
+                                  MicroCore::ThreadPool& pool) const {
+        Table table = tableFor(_mapping);
+        if (!table.header) return false;
+        uint32_t count = table.header->nodeCount;
+        std::string rootPath(root());
+        ScanOptions scan = snapshotOptions(options);
+
+        // Paths of every directory. Breadth-first order puts parents first.
+        std::vector<uint32_t> slotOf(count, kNoNode);
+        std::vector<uint32_t> directories;
+        std::vector<std::string> paths;
+        for (uint32_t i = 0; i < count; i++) {
+            if (i == 0) {
+                slotOf[0] = 0;
+                directories.push_back(0);
+                paths.push_back(rootPath);
+                continue;
+            }
+            const NodeRecord& record = table.nodes[i];
+            if (record.type != (uint8_t)EntryType::Directory || record.parent >= i || slotOf[record.parent] == kNoNode) continue;
+            slotOf[i] = (uint32_t)directories.size();
+            directories.push_back(i);
+            paths.push_back(joinPath(paths[slotOf[record.parent]], table.name(i)));
+        }
+
+        // Which directories changed, in parallel: one lstat each, plus a stat per
+        // filter file. Refiltered directories are crawled again, whole.
+        enum : uint8_t { Unchanged, Changed, Refiltered, Gone };
+        const bool filtered = hasFilterFiles(filterFiles);
+        std::vector<uint8_t> status(directories.size());
+        std::vector<int64_t> mtimes(directories.size());
+        std::vector<uint32_t> stamps(directories.size(), 0);
+        pool.parallelFor(directories.size(), 64, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; s++) {
+                const NodeRecord& record = table.nodes[directories[s]];
+                if (!directoryMtime(paths[s], s == 0, mtimes[s])) {
+                    status[s] = Gone;
+                    continue;
+                }
+                if (filtered) stamps[s] = filterStampOf(paths[s], s == 0, filterFiles);
+                if (stamps[s] != record.filterStamp) status[s] = Refiltered;
+                else status[s] = mtimes[s] == record.mtime ? Unchanged : Changed;
+            }
+        });
+        if (status[0] == Gone) return false;
+
+        // Re-list the changed ones, also in parallel.
+        std::vector<uint32_t> changed;
+        std::vector<uint32_t> listingOf(directories.size(), kNoNode);
+        size_t refiltered = 0;
+        for (uint32_t s = 0; s < directories.size(); s++) {
+            if (status[s] == Changed) {
+                listingOf[s] = (uint32_t)changed.size();
+                changed.push_back(s);
+            }
+            if (status[s] == Refiltered) refiltered++;
+        }
+        std::vector<std::vector<Entry>> listings(changed.size());
+        pool.parallelFor(changed.size(), 4, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++) {
+                listDirectory(paths[changed[k]], scan, listings[k]);
+            }
+        });
+
+        // Rebuild top down, copying unchanged directories from the mapping.
+        Draft draft;
+        draft.reserve(count);
+        draft.push_back(DraftNode{std::string(), kNoNode, EntryType::Directory, false, 0, mtimes[0], {}});
+        std::vector<std::pair<uint32_t, uint32_t>> stack;     // (mapped node, draft node)
+        std::vector<std::pair<uint32_t, std::string>> crawls; // New or refiltered directories
+        if (status[0] == Refiltered) crawls.emplace_back(0, rootPath);
+        else stack.emplace_back(0, 0);
+        while (!stack.empty()) {
+            auto [mapped, index] = stack.back();
+            stack.pop_back();
+            uint32_t slot = slotOf[mapped];
+            uint32_t begin, end;
+            table.children(mapped, begin, end);
+            draft[index].filterStamp = stamps[slot];
+            draft[index].stamped = true;
+
+            if (status[slot] == Unchanged) {
+                for (uint32_t c = begin; c < end; c++) {
+                    const NodeRecord& record = table.nodes[c];
+                    EntryType type = record.type <= (uint8_t)EntryType::Other ? (EntryType)record.type : EntryType::Other;
+                    if (type != EntryType::Directory) {
+                        addNode(draft, index, std::string(table.name(c)), type, (record.flags & kLinksToDirectory) != 0,
+                                record.size, record.mtime);
+                        continue;
+                    }
+                    uint32_t childSlot = slotOf[c];
+                    if (childSlot == kNoNode || status[childSlot] == Gone) continue;
+                    uint32_t child = addNode(draft, index, std::string(table.name(c)), type, false, record.size, mtimes[childSlot]);
+                    if (status[childSlot] == Refiltered) crawls.emplace_back(child, paths[childSlot]);
+                    else stack.emplace_back(c, child);
+                }
+                continue;
+            }
+
+            for (Entry& entry : listings[listingOf[slot]]) {
+                std::string_view name = entry.name();
+                uint32_t child = addNode(draft, index, std::string(name), entry.type, entry.linksToDirectory,
+                                         entry.size, entry.mtime);
+                if (entry.type != EntryType::Directory) continue;
+
+                // Existing directories keep their own (possibly unchanged) subtree.
+                uint32_t low = begin, high = end;
+                while (low < high) {
+                    uint32_t mid = low + (high - low) / 2;
+                    if (table.name(mid) < name) low = mid + 1;
+                    else high = mid;
+                }
+                if (low < end && table.name(low) == name && slotOf[low] != kNoNode &&
+                    status[slotOf[low]] != Gone && status[slotOf[low]] != Refiltered) {
+                    stack.emplace_back(low, child);
+                } else {
+                    crawls.emplace_back(child, std::move(entry.path));
+                }
+            }
+        }
+
+        for (auto& crawl : crawls) {
+            attachScan(draft, crawl.first, crawl.second, scan, pool);
+        }
+        stampDraft(draft, rootPath, filterFiles, pool);
+
+        size_t nodes = 0;
+        bool written = writeDraft(draft, rootPath, _snapshotPath, &nodes);
+        if (stats) {
+            stats->directoriesChecked = directories.size();
+            stats->directoriesRelisted = changed.size();
+            stats->directoriesCrawled = crawls.size();
+            stats->directoriesRefiltered = refiltered;
+            stats->nodes = nodes;
+        }
+        return written;
+    }
+}
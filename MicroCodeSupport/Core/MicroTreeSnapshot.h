@@ -0,0 +1,115 @@
+//
+//  MicroTreeSnapshot.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include "MicroDirectoryScanner.h"
+#include "MicroMappedFile.h"
+#include "MicroThreadPool.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - MicroFiles (C++)
+// Persistent snapshot of a workspace's file tree, so a launch can show the whole
+// tree (and feed quick-open) straight from disk instead of crawling first:
+//
+//   [Header][NodeRecord x nodeCount][string pool]
+//
+// Nodes are stored breadth first. Node 0 is the root; every directory's children
+// are contiguous and sorted by name (bytewise), so a path resolves with one
+// binary search per component. Each node keeps its parent, size and mtime.
+//
+// open() only maps the file and checks the header, so it is O(1); accessors
+// bounds-check instead. revalidate() brings a snapshot up to date in the
+// background: it lstat()s every directory, re-lists only those whose mtime
+// changed (and crawls directories that are new), copies everything else from
+// the mapping and writes the result. A file edited in place does not touch its
+// directory's mtime, so its size and mtime are refreshed only when the
+// directory is re-listed; the tree itself is always current.
+//
+// Nor does editing a .gitignore in place, although it changes what the whole
+// subtree below it contains. Each directory therefore also keeps a stamp of its
+// FilterFiles (size and mtime); a directory whose stamp changed is crawled
+// again instead of being copied or re-listed.
+
+namespace MicroFiles {
+
+    /// One node, pointing into the mapping.
+    struct TreeNode {
+        std::string_view name;  // Empty for the root
+        uint32_t parent;        // TreeSnapshot::kNoNode for the root
+        uint32_t firstChild;
+        uint32_t childCount;
+        EntryType type;
+        bool linksToDirectory;
+        uint64_t size;
+        int64_t mtime;          // Nanoseconds since the epoch
+    };
+
+    /// Files that decide what a directory's subtree contains, e.g. the ignore
+    /// files behind ScanOptions::exclude. Paths are relative to the directory.
+    struct FilterFiles {
+        std::vector<std::string> everyDirectory; // ".gitignore"
+        std::vector<std::string> rootOnly;       // ".git/info/exclude"
+    };
+
+    struct RevalidateStats {
+        size_t directoriesChecked = 0;
+        size_t directoriesRelisted = 0;
+        size_t directoriesCrawled = 0;     // New since the snapshot was written, or refiltered
+        size_t directoriesRefiltered = 0;  // FilterFiles changed
+        size_t nodes = 0;
+    };
+
+    /// Read-only view of a snapshot file. Views returned by the accessors stay
+    /// valid until the next open() or close(); build() and revalidate() only write
+    /// the file, so call open() again to see their result.
+    class TreeSnapshot {
+    public:
+        static constexpr uint32_t kNoNode = UINT32_MAX;
+
+        explicit TreeSnapshot(std::string snapshotPath) : _snapshotPath(std::move(snapshotPath)) {}
+
+        /// Maps the snapshot. Returns false if it is missing or not a snapshot.
+        bool open();
+        void close() { _mapping.close(); }
+        bool isOpen() const { return _mapping.isOpen(); }
+
+        /// Crawls `root` and writes a fresh snapshot. `options.statEntries` is
+        /// implied; `maxDepth` and `batchSize` are ignored.
+        bool build(const std::string& root, const ScanOptions& options = ScanOptions(),
+                   const FilterFiles& filterFiles = FilterFiles(),
+                   MicroCore::ThreadPool& pool = MicroCore::ThreadPool::shared()) const;
+
+        /// Writes an up-to-date snapshot of the mapped one's root (see above). Pass
+        /// the options and filter files it was built with. Returns false if
+        /// nothing is mapped or the root is gone.
+        bool revalidate(const ScanOptions& options = ScanOptions(), const FilterFiles& filterFiles = FilterFiles(),
+                        RevalidateStats *stats = nullptr,
+                        MicroCore::ThreadPool& pool = MicroCore::ThreadPool::shared()) const;
+
+        std::string_view root() const;
+        size_t nodeCount() const;
+
+        /// Returns false if `index` is out of range.
+        bool node(uint32_t index, TreeNode& out) const;
+
+        /// Node at `path` (the root itself or anything below it), or kNoNode.
+        uint32_t find(std::string_view path) const;
+
+        /// Full path of a node; empty if `index` is out of range.
+        std::string path(uint32_t index) const;
+
+    private:
+        std::string _snapshotPath;
+        MicroCore::MappedFile _mapping;
+    };
+}
@@ -0,0 +1,64 @@
+//
+//  AuthenticCallGraph.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// One call to a function.
+@interface AuthenticCallSite : NSObject
+@property (nonatomic, copy) NSString *caller; // Enclosing function; empty for top-level code
+@property (nonatomic, copy) NSString *callee;
+@property (nonatomic, copy) NSString *path;
+@property (nonatomic, assign) NSUInteger byteOffset;
+@property (nonatomic, assign) NSInteger line; // 0-based
+@end
+
+/// A function (or a file's top-level code) that reaches another through calls.
+@interface AuthenticImpactEntry : NSObject
+@property (nonatomic, copy) NSString *function; // Empty for top-level code
+@property (nonatomic, copy) NSString *path;
+@property (nonatomic, assign) NSUInteger depth; // 1: direct caller
+@end
+
+/// Workspace call graph ("Find callers", impact analysis for AI edits).
+/// Parsing runs on a native thread pool; the graph is persisted to a memory-mapped
+/// file, so callers can be listed as soon as a workspace is reopened.
+@interface AuthenticCallGraph : NSObject
+
+- (instancetype)initWithIndexPath:(NSString *)indexPath;
+
+/// Maps the persisted graph. Instant; returns NO if there is none yet.
+- (BOOL)open;
+
+/// Re-indexes changed files under `rootPath` in the background, drops deleted
+/// ones and saves. Completion runs on the main queue.
+- (void)indexWorkspace:(NSString *)rootPath completion:(nullable void (^)(NSUInteger parsedFiles))completion;
+
+/// File-change hooks (e.g. from a file watcher). Call `save` to persist.
+- (void)fileDidChange:(NSString *)path;
+- (void)fileWasRemoved:(NSString *)path;
+
+- (BOOL)save;
+
+/// Whether the workspace defines a function with this name.
+- (BOOL)isFunctionDefined:(NSString *)function;
+
+- (NSArray<AuthenticCallSite *> *)callersOfFunction:(NSString *)function limit:(NSUInteger)limit;
+
+/// Names called by functions named `function`, sorted.
+- (NSArray<NSString *> *)calleesOfFunction:(NSString *)function;
+
+/// Transitive callers, nearest first; `maxDepth` 0 is unlimited.
+- (NSArray<AuthenticImpactEntry *> *)impactOfFunction:(NSString *)function maxDepth:(NSUInteger)maxDepth limit:(NSUInteger)limit;
+
+@property (nonatomic, readonly) NSUInteger callCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -32,6 +32,28 @@ NS_ASSUME_NONNULL_BEGIN
 /// Load contents asynchronously
 - (void)loadContentsOfDirectory:(NSString *)path completion:(void (^)(NSArray<AuthenticFileNode *> * _Nullable nodes, NSError * _Nullable error))completion;
 
+/// Recursively scan everything below `path` on the shared worker pool. Batches of
+/// nodes (with `depth` set, unsorted, `children` empty) are delivered on the main
+/// queue as they are found; return NO from `batchHandler` to stop the scan.
+/// Hidden entries and anything matched by .gitignore or .ignore files are skipped;
+/// symlinks are reported but never followed.
+- (void)scanDirectoryRecursively:(NSString *)path
+                    batchHandler:(BOOL (^)(NSArray<AuthenticFileNode *> *batch))batchHandler
+                      completion:(void (^)(NSUInteger entryCount, NSError * _Nullable error))completion;
+
+/// Map the saved tree snapshot of `root` at `snapshotPath` so `cachedContentsOfDirectory:`
+/// answers immediately, then refresh it in the background (only directories whose
+/// mtime changed are re-listed; a missing snapshot is crawled). Ignored entries are
+/// left out, as in `scanDirectoryRecursively:`. `completion` runs on the main queue
+/// once the refreshed snapshot is mapped. Main thread only.
+- (BOOL)loadSnapshotAtPath:(NSString *)snapshotPath
+                   forRoot:(NSString *)root
+                completion:(nullable void (^)(BOOL refreshed))completion;
+
+/// Children of `path` from the loaded snapshot, sorted like `contentsOfDirectory:error:`,
+/// or nil if no snapshot covers it. Main thread only.
+- (nullable NSArray<AuthenticFileNode *> *)cachedContentsOfDirectory:(NSString *)path;
+
 /// Check if a path is a directory (Fast stat)
 - (BOOL)isDirectory:(NSString *)path;
 
@@ -40,4 +62,41 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/// Flattened navigator outline for a view-based table: the visible rows are one
+/// array in display order, so any row is a direct lookup however large the tree.
+/// Directories are listed the first time they are expanded; expanding or collapsing
+/// returns the rows to insert or remove. Hidden entries are skipped, as in
+/// `contentsOfDirectory:error:`. Main thread only.
+@interface AuthenticFileOutline : NSObject
+
+- (instancetype)initWithRootPath:(NSString *)rootPath;
+
+@property (nonatomic, readonly, copy) NSString *rootPath;
+@property (nonatomic, readonly) NSUInteger numberOfRows;
+
+- (NSString *)nameAtRow:(NSUInteger)row;
+- (NSString *)pathAtRow:(NSUInteger)row;
+- (NSInteger)depthAtRow:(NSUInteger)row; // 0 for the root's children
+- (BOOL)isDirectoryAtRow:(NSUInteger)row;
+- (BOOL)isExpandedAtRow:(NSUInteger)row;
+
+/// NSNotFound if `path` is not loaded or is inside a collapsed directory.
+- (NSUInteger)rowForPath:(NSString *)path;
+/// NSNotFound for the root's children.
+- (NSUInteger)parentRowOfRow:(NSUInteger)row;
+
+/// The rows inserted below `row`; nested folders that were expanded before stay so.
+- (NSRange)expandRow:(NSUInteger)row;
+/// The rows removed below `row`.
+- (NSRange)collapseRow:(NSUInteger)row;
+
+/// Re-lists `directory` after it changed on disk, keeping the expansion state of
+/// what is still there. `removed` rows were replaced by `inserted` rows at the same
+/// location (both empty if the directory is not visible).
+- (BOOL)reloadDirectory:(NSString *)directory
+            removedRows:(nullable NSRange *)removed
+           insertedRows:(nullable NSRange *)inserted;
+
+@end
+
 NS_ASSUME_NONNULL_END
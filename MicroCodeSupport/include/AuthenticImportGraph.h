@@ -0,0 +1,45 @@
+//
+//  AuthenticImportGraph.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Workspace import graph: which files each source file imports, and which files
+/// import it. Scanning runs on a native thread pool; a changed file only has its
+/// own imports re-read. Used for AI context selection, test impact and build order.
+@interface AuthenticImportGraph : NSObject
+
+/// Scans changed source files under `rootPath` in the background and drops deleted
+/// ones. Completion runs on the main queue.
+- (void)indexWorkspace:(NSString *)rootPath completion:(nullable void (^)(NSUInteger scannedFiles))completion;
+
+/// File-change hooks (e.g. from a file watcher).
+- (void)fileDidChange:(NSString *)path;
+- (void)fileWasRemoved:(NSString *)path;
+
+/// Direct imports / direct importers of `path`, sorted.
+- (NSArray<NSString *> *)dependenciesOfFile:(NSString *)path;
+- (NSArray<NSString *> *)dependentsOfFile:(NSString *)path;
+
+/// Transitive closure, nearest first; `maxDepth` 0 is unlimited.
+- (NSArray<NSString *> *)transitiveDependenciesOfFile:(NSString *)path maxDepth:(NSUInteger)maxDepth;
+- (NSArray<NSString *> *)transitiveDependentsOfFile:(NSString *)path maxDepth:(NSUInteger)maxDepth;
+
+/// `paths` and everything they import, dependencies first.
+- (NSArray<NSString *> *)buildOrderForFiles:(NSArray<NSString *> *)paths;
+
+/// Imports of `path` that are not workspace files (system headers, packages, modules).
+- (NSArray<NSString *> *)unresolvedImportsOfFile:(NSString *)path;
+
+@property (nonatomic, readonly) NSUInteger fileCount;
+@property (nonatomic, readonly) NSUInteger edgeCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -3,6 +3,21 @@
 
 @class AuthenticAIContext;
 
+typedef NS_ENUM(uint8_t, AuthenticScopeKind) {
+    AuthenticScopeKindGlobal = 0,
+    AuthenticScopeKindFunction,
+    AuthenticScopeKindClass,
+    AuthenticScopeKindBlock
+};
+
+/// One enclosing scope, as filled in by the scope chain queries.
+typedef struct {
+    NSRange range;         // Declaration start through the closing brace
+    NSRange nameRange;     // {NSNotFound, 0} for anonymous blocks
+    NSUInteger headerLine; // 0-based line the scope starts on
+    AuthenticScopeKind kind;
+} AuthenticScopeInfo;
+
 /**
  * AuthenticLanguageCore
  *
@@ -18,17 +33,45 @@
  * - Lightweight Semantic Parsing (Symbol Graph)
  * - Diagnostic Management (LSP + Compiler Wrapper)
  * - AI Code Context Provider
+ *
+ * Each core serializes its own methods, so the registry can compact it from
+ * whichever thread triggered an eviction.
  */
 @interface AuthenticLanguageCore : NSObject
 
-/// Shared singleton for global context (if applicable)
+/// Core of the active document (see AuthenticLanguageCoreRegistry).
+/// Falls back to a standalone Swift core when no document is registered.
 + (instancetype)shared;
 
 /// Initialize with a specific language (e.g., "swift", "cpp", "python")
 - (instancetype)initWithLanguage:(NSString *)language;
 
+/// Language this core was created for.
+@property (nonatomic, readonly, copy) NSString *language;
+
+/// Document this core belongs to, or nil for standalone cores.
+@property (nonatomic, readonly, copy) NSString *documentIdentifier;
+
+// MARK: - Memory (The Metabolism)
+
+/// Soft cap for this instance. Derived caches (e.g. materialized `tokens`) are not
+/// retained past this budget. Defaults to 8 MB.
+@property (nonatomic, assign) NSUInteger memoryBudget;
+
+/// Approximate bytes currently held by this instance.
+@property (nonatomic, readonly) NSUInteger estimatedMemoryUsage;
+
+/// NO after `compact`: only the cached summary (symbols, imports) is kept
+/// until the next `updateSource:`.
+@property (nonatomic, readonly, getter=isResident) BOOL resident;
+
+/// Drop source, tokens and parse tree, keeping a compact summary.
+- (void)compact;
+
 /// Update the engine with new source code.
 /// This triggers incremental re-tokenization and semantic parsing.
+/// When a large file is first loaded, tokens and scopes are restored from the
+/// on-disk parse cache if this exact text was parsed before.
 - (void)updateSource:(NSString *)source;
 
 // MARK: - Syntax Layer (The Eyes)
@@ -49,9 +92,103 @@
 /// Get a list of all symbols (classes, functions, variables) in the file.
 - (NSArray<NSString *> *)symbols;
 
+/// Symbols ranked by fzf-style fuzzy match against `query`, best first ("Quick outline").
+- (NSArray<NSString *> *)symbolsMatchingQuery:(NSString *)query limit:(NSUInteger)limit;
+
+// MARK: - Structure Layer (Folding & Guides)
+
+/// Fold ranges that start in, or enclose, the 0-based line range `lines`; enclosing
+/// ranges first, outermost first. Keys: startLine, endLine (inclusive), kind ("block"/"comment").
+- (NSArray<NSDictionary *> *)foldingRangesInLines:(NSRange)lines;
+
+/// Indentation guide level of each line in `lines` (blank lines follow their neighbours).
+- (NSArray<NSNumber *> *)indentGuideLevelsInLines:(NSRange)lines;
+
+// MARK: - Structural Selection
+
+/// Next larger syntactic range around `selection`: word, string contents, string,
+/// bracket contents, brackets, statement, indented block, declaration, ... document.
+- (NSRange)expandedSelectionRange:(NSRange)selection;
+
+/// Next smaller syntactic range inside `selection`, preferring one that starts where
+/// it does; `selection` when there is none. Editors that keep their own expansion
+/// history should retrace it first.
+- (NSRange)shrunkSelectionRange:(NSRange)selection;
+
+// MARK: - Scope Chain (Breadcrumbs & Sticky Scroll)
+// Plain C buffers so they can run on every cursor move and scroll frame without
+// allocating; each is a binary search plus a walk up the scope tree.
+
+/// Scopes enclosing `index`, outermost first, file scope excluded. When the chain
+/// is deeper than `maxCount` the outermost scopes are dropped. Returns the count written.
+- (NSUInteger)getScopeChain:(AuthenticScopeInfo *)chain maxCount:(NSUInteger)maxCount atIndex:(NSUInteger)index;
+
+/// Lines to pin above `firstVisibleLine`: the header line of every scope that opened
+/// above it and is still open there, outermost first, each line once. At most
+/// `maxCount` (the outermost) are written. Returns the count written.
+- (NSUInteger)getStickyHeaderLines:(NSUInteger *)lines maxCount:(NSUInteger)maxCount forFirstVisibleLine:(NSUInteger)firstVisibleLine;
+
+// MARK: - Occurrences
+
+/// Ranges of every occurrence of the identifier at (or just before) `index`, in
+/// document order. Strings and comments are never matched.
+- (NSArray<NSValue *> *)occurrenceRangesOfIdentifierAtIndex:(NSUInteger)index;
+
+/// Ranges a local rename of the identifier at `index` would change: the innermost
+/// enclosing scope that declares it as a variable, otherwise the whole document.
+- (NSArray<NSValue *> *)renameRangesForIdentifierAtIndex:(NSUInteger)index;
+
 // MARK: - Diagnostics Layer (The Immune System)
 
 /// Current diagnostics (errors, warnings) derived from LSP or local checks.
+/// Local checks (unbalanced brackets, unterminated strings and comments, duplicate
+/// declarations, code after `return`) are updated with each `updateSource:`.
+/// Keys: message, severity (1 error, 2 warning), code, source, line, column, range (NSValue).
 @property (nonatomic, readonly) NSArray<NSDictionary *> *diagnostics;
 
 @end
+
+/**
+ * AuthenticLanguageCoreRegistry
+ *
+ * Owns one AuthenticLanguageCore per open document.
+ * Per-language tables (keywords, lexer classes) are shared between cores.
+ * Inactive cores are compacted least-recently-used first, so memory stays
+ * bounded no matter how many tabs are open.
+ */
+@interface AuthenticLanguageCoreRegistry : NSObject
+
++ (instancetype)sharedRegistry;
+
+/// Returns the core for `documentIdentifier`, creating it (or recreating it if
+/// the language changed) as needed. Marks the document most recently used.
+- (AuthenticLanguageCore *)coreForDocument:(NSString *)documentIdentifier language:(NSString *)language;
+
+/// Marks the document as the one being edited. Its core is never compacted.
+- (void)activateDocument:(NSString *)documentIdentifier;
+
+/// Compacts the document's core down to its summary (tab closed or backgrounded).
+- (void)closeDocument:(NSString *)documentIdentifier;
+
+/// Forgets the document entirely, summary included.
+- (void)removeDocument:(NSString *)documentIdentifier;
+
+/// Core of the active document, or nil.
+@property (nonatomic, readonly) AuthenticLanguageCore *activeCore;
+
+/// Total bytes resident cores may hold before LRU compaction. Defaults to 64 MB.
+@property (nonatomic, assign) NSUInteger totalMemoryBudget;
+
+/// Maximum number of fully resident cores. Defaults to 16.
+@property (nonatomic, assign) NSUInteger maxResidentCores;
+
+/// Maximum number of cores kept at all (resident or compacted). Defaults to 512.
+@property (nonatomic, assign) NSUInteger maxCores;
+
+/// Approximate bytes held by all registered cores.
+- (NSUInteger)estimatedMemoryUsage;
+
+/// Re-applies the budgets; called automatically after updates and activation.
+- (void)enforceBudget;
+
+@end
@@ -2,6 +2,18 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+// Gutter marker layers (values match MicroGutter::Layer)
+typedef NS_ENUM(uint8_t, AuthenticGutterMarker) {
+    AuthenticGutterMarkerError = 0,
+    AuthenticGutterMarkerWarning = 1,
+    AuthenticGutterMarkerInfo = 2,
+    AuthenticGutterMarkerGitAdded = 3,
+    AuthenticGutterMarkerGitModified = 4,
+    AuthenticGutterMarkerGitDeleted = 5,
+    AuthenticGutterMarkerBreakpoint = 6,
+    AuthenticGutterMarkerBookmark = 7
+};
+
 @interface AuthenticLineNumberRuler : NSRulerView
 
 // Properties to be set from Swift (Theming)
@@ -13,6 +25,13 @@ NS_ASSUME_NONNULL_BEGIN
 // Init
 - (instancetype)initWithScrollView:(nullable NSScrollView *)scrollView orientation:(NSRulerOrientation)orientation;
 
+// Markers on 0-based lines; they move with their lines as the text is edited.
+- (void)addMarker:(AuthenticGutterMarker)marker atLine:(NSUInteger)line;
+- (void)removeMarker:(AuthenticGutterMarker)marker atLine:(NSUInteger)line;
+// Replaces every line of `marker`, e.g. after a diagnostics or git-diff pass.
+- (void)setMarker:(AuthenticGutterMarker)marker lines:(NSIndexSet *)lines;
+- (NSIndexSet *)linesWithMarker:(AuthenticGutterMarker)marker;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,46 @@
+//
+//  AuthenticQuickOpen.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// One quick-open hit.
+@interface AuthenticQuickOpenResult : NSObject
+@property (nonatomic, copy) NSString *path;
+@property (nonatomic, copy) NSString *relativePath;
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) NSInteger score;
+@property (nonatomic, strong) NSIndexSet *matchedIndexes; // UTF-16 offsets in relativePath
+@end
+
+/// Workspace quick-open ("Go to file"). Every file path of the workspace is kept
+/// in one native arena and matched on the shared thread pool; a query that
+/// extends the previous one only re-checks the paths that already matched.
+@interface AuthenticQuickOpen : NSObject
+
+- (instancetype)initWithRootPath:(NSString *)rootPath;
+
+@property (nonatomic, readonly, copy) NSString *rootPath;
+@property (nonatomic, readonly) NSUInteger fileCount;
+
+/// Crawls the workspace in the background (hidden and .gitignore'd entries are
+/// skipped) and swaps the new paths in on the main queue.
+- (void)indexWorkspaceWithCompletion:(nullable void (^)(NSUInteger fileCount))completion;
+
+/// Same, but first answers from the tree snapshot at `snapshotPath` (see
+/// AuthenticFileTreeController) while the crawl runs, if it covers the root.
+- (void)indexWorkspaceWithSnapshotAtPath:(nullable NSString *)snapshotPath
+                              completion:(nullable void (^)(NSUInteger fileCount))completion;
+
+/// Best matches first. Main thread only.
+- (NSArray<AuthenticQuickOpenResult *> *)search:(NSString *)query limit:(NSUInteger)limit;
+
+@end
+
+NS_ASSUME_NONNULL_END
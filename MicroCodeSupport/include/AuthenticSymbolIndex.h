@@ -0,0 +1,52 @@
+//
+//  AuthenticSymbolIndex.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// One symbol from the workspace index.
+@interface AuthenticWorkspaceSymbol : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, copy) NSString *path;
+@property (nonatomic, copy) NSString *kind; // "function", "class", "variable"
+@property (nonatomic, assign) NSInteger line; // 0-based
+@property (nonatomic, assign) NSRange byteRange;
+@property (nonatomic, assign) NSInteger score; // Fuzzy score; 0 for substring search
+@end
+
+/// Workspace-wide symbol index ("Go to symbol in workspace").
+/// Parsing runs on a native thread pool; the table is persisted to a memory-mapped
+/// file so reopening a workspace can search before anything is re-parsed.
+@interface AuthenticSymbolIndex : NSObject
+
+- (instancetype)initWithIndexPath:(NSString *)indexPath;
+
+/// Maps the persisted index. Instant; returns NO if there is none yet.
+- (BOOL)open;
+
+/// Re-indexes changed files under `rootPath` in the background, drops deleted
+/// ones and saves. Completion runs on the main queue.
+- (void)indexWorkspace:(NSString *)rootPath completion:(nullable void (^)(NSUInteger parsedFiles))completion;
+
+/// File-change hooks (e.g. from a file watcher). Call `save` to persist.
+- (void)fileDidChange:(NSString *)path;
+- (void)fileWasRemoved:(NSString *)path;
+
+- (BOOL)save;
+
+- (NSArray<AuthenticWorkspaceSymbol *> *)searchSymbols:(NSString *)query limit:(NSUInteger)limit;
+
+/// fzf-style ranking, best first. Runs on the native thread pool.
+- (NSArray<AuthenticWorkspaceSymbol *> *)fuzzySearchSymbols:(NSString *)query limit:(NSUInteger)limit;
+
+@property (nonatomic, readonly) NSUInteger symbolCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,51 @@
+//
+//  MicroChunkerFFI.h
+//  CodeTunner
+//
+//  Created by SPU AI CLUB
+//  Copyright © 2026 AIPRENEUR. All rights reserved.
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C entry points to MicroChunker (Core/MicroChunker.h) for the Rust RAG engine.
+
+typedef enum {
+    MCChunkKindOther = 0,
+    MCChunkKindFunction = 1,
+    MCChunkKindType = 2
+} MCChunkKind;
+
+typedef struct {
+    uint32_t start_line;  // 0-based
+    uint32_t end_line;    // Inclusive
+    uint32_t start;       // Byte range of the chunk text in the source
+    uint32_t end;
+    uint32_t name_start;  // Declared name: source[name_start, name_start + name_length)
+    uint32_t name_length;
+    int32_t parent;       // Index of the chunk this one was split out of, or -1
+    uint32_t kind;        // MCChunkKind
+    uint64_t hash;        // XXH64 of the chunk text
+} MCCodeChunk;
+
+typedef struct {
+    MCCodeChunk* chunks;
+    size_t count;
+} MCCodeChunkList;
+
+// Chunks `length` bytes of UTF-8 `source`. The language comes from `path`'s
+// extension; other files are split as text. `max_lines` of 0 uses the default.
+// Returns NULL on invalid arguments. Free the result with mc_free_chunk_list.
+MCCodeChunkList* mc_chunk_source(const char* path, const char* source, size_t length, uint32_t max_lines);
+void mc_free_chunk_list(MCCodeChunkList* list);
+
+#ifdef __cplusplus
+}
+#endif
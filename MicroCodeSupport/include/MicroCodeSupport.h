@@ -5,4 +5,8 @@
 #import "AuthenticSyntaxEngine.h"
 #import "AuthenticLanguageCore.h"
 #import "AuthenticAIContext.h"
+#import "AuthenticSymbolIndex.h"
+#import "AuthenticQuickOpen.h"
+#import "AuthenticImportGraph.h"
+#import "AuthenticCallGraph.h"
 #import "USBDetector.h"
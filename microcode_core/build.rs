@@ -0,0 +1,22 @@
+use std::path::Path;
+
+fn main() {
+    // Compile the native code chunker (MicroCodeSupport) for the RAG engine
+    let core = Path::new("../MicroCodeSupport/Core");
+    println!("cargo:rustc-check-cfg=cfg(native_chunker)");
+    if core.join("MicroChunker.cpp").exists() {
+        cc::Build::new()
+            .cpp(true)
+            .flag("-std=c++17")
+            .files(
+                ["MicroChunker.cpp", "MicroChunkerFFI.cpp", "MicroLexer.cpp", "MicroHash.cpp"]
+                    .iter()
+                    .map(|file| core.join(file)),
+            )
+            .compile("micro_chunker");
+
+        println!("cargo:rustc-cfg=native_chunker");
+        println!("cargo:rerun-if-changed=../MicroCodeSupport/Core");
+        println!("cargo:rerun-if-changed=../MicroCodeSupport/include/MicroChunkerFFI.h");
+    }
+}
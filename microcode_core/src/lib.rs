@@ -16,6 +16,8 @@ use tokio::sync::RwLock;
 
 mod fs_editor;
 mod rag_engine;
+#[cfg(native_chunker)]
+mod native_chunker;
 mod llm_client;
 
 pub use fs_editor::FileEditor;
@@ -0,0 +1,88 @@
+//! Native Chunker - structure-aware chunks from MicroCodeSupport
+//!
+//! Wraps `mc_chunk_source` (MicroCodeSupport/include/MicroChunkerFFI.h), which
+//! build.rs compiles in when the C++ sources are present. Chunks follow
+//! functions and types and carry a hash of their text, so unchanged code keeps
+//! its hash when lines around it move.
+
+use std::ffi::CString;
+use std::os::raw::c_char;
+
+#[repr(C)]
+#[allow(dead_code)] // Mirrors the C layout; not every field is read
+struct MCCodeChunk {
+    start_line: u32,
+    end_line: u32,
+    start: u32,
+    end: u32,
+    name_start: u32,
+    name_length: u32,
+    parent: i32,
+    kind: u32,
+    hash: u64,
+}
+
+#[repr(C)]
+struct MCCodeChunkList {
+    chunks: *const MCCodeChunk,
+    count: usize,
+}
+
+extern "C" {
+    fn mc_chunk_source(
+        path: *const c_char,
+        source: *const c_char,
+        length: usize,
+        max_lines: u32,
+    ) -> *mut MCCodeChunkList;
+    fn mc_free_chunk_list(list: *mut MCCodeChunkList);
+}
+
+/// One chunk; `start..end` is a byte range of the chunked source on line boundaries.
+pub struct NativeChunk {
+    pub start_line: u32, // 0-based
+    pub end_line: u32,   // Inclusive
+    pub start: usize,
+    pub end: usize,
+    pub hash: u64,
+}
+
+/// Chunks `source`, picking the language from `path`'s extension.
+/// Returns None if the native side rejects the input.
+pub fn chunk_source(path: &str, source: &str, max_lines: u32) -> Option<Vec<NativeChunk>> {
+    let c_path = CString::new(path).ok()?;
+
+    // SAFETY: `source` outlives the call and its length is passed explicitly;
+    // the returned list is owned by us until mc_free_chunk_list.
+    unsafe {
+        let list = mc_chunk_source(
+            c_path.as_ptr(),
+            source.as_ptr() as *const c_char,
+            source.len(),
+            max_lines,
+        );
+        if list.is_null() {
+            return None;
+        }
+
+        let raw = if (*list).count == 0 {
+            &[][..]
+        } else {
+            std::slice::from_raw_parts((*list).chunks, (*list).count)
+        };
+        let chunks = raw
+            .iter()
+            .filter(|c| c.start <= c.end && (c.end as usize) <= source.len())
+            .map(|c| NativeChunk {
+                start_line: c.start_line,
+                end_line: c.end_line,
+                start: c.start as usize,
+                end: c.end as usize,
+                hash: c.hash,
+            })
+            .collect();
+
+        mc_free_chunk_list(list);
+        Some(chunks)
+    }
+}
@@ -5,7 +5,13 @@
 //! - In-memory vector storage
 //!
 //! This enables "Chat with Codebase" functionality.
+//!
+//! Files are split into chunks that follow functions and types (see
+//! native_chunker) and every chunk carries a hash of its text. Re-indexing
+//! reuses the embedding of any chunk whose file and hash are unchanged, so a
+//! small edit only re-embeds the symbols it touched.
 
+use std::collections::HashMap;
 use std::path::{Path, PathBuf};
 use std::time::Instant;
 use anyhow::{Result, Context};
@@ -21,6 +27,7 @@ struct CodeChunk {
     content: String,
     start_line: u32,
     end_line: u32,
+    hash: u64,
     embedding: Vec<f32>,
 }
 
@@ -59,8 +66,12 @@ impl RagEngine {
         
         let gitignore = gitignore_builder.build().ok();
         
-        // Clear existing chunks
-        self.chunks.clear();
+        // Embeddings of the previous pass, reused for chunks whose text is unchanged
+        let mut previous: HashMap<(String, u64), Vec<f32>> = std::mem::take(&mut self.chunks)
+            .into_iter()
+            .map(|chunk| ((chunk.file_path, chunk.hash), chunk.embedding))
+            .collect();
+        let mut embedded = 0usize;
         
         // Collect and process files
         for entry in WalkDir::new(&root)
@@ -94,13 +105,28 @@ impl RagEngine {
             
             // Read and chunk file
             if let Ok(content) = std::fs::read_to_string(file_path) {
-                let new_chunks = chunk_code(&relative_path, &content);
-                self.chunks.extend(new_chunks);
+                for mut chunk in chunk_code(&relative_path, &content) {
+                    let key = (chunk.file_path.clone(), chunk.hash);
+                    chunk.embedding = match previous.remove(&key) {
+                        Some(embedding) => embedding,
+                        None => {
+                            embedded += 1;
+                            text_to_embedding(&chunk.content)
+                        }
+                    };
+                    self.chunks.push(chunk);
+                }
             }
         }
         
         let duration = start_time.elapsed();
-        println!("Indexed {} chunks in {:.2}s", self.chunks.len(), duration.as_secs_f64());
+        println!(
+            "Indexed {} chunks ({} embedded, {} reused) in {:.2}s",
+            self.chunks.len(),
+            embedded,
+            self.chunks.len() - embedded,
+            duration.as_secs_f64()
+        );
         
         Ok(self.chunks.len() as u32)
     }
@@ -179,10 +205,36 @@ fn is_code_file(path: &Path) -> bool {
         .unwrap_or(false)
 }
 
-/// Chunk code into smaller pieces for embedding
+const CHUNK_SIZE: usize = 50; // Max lines per chunk
+
+/// Chunk code along functions and types. Embeddings are filled in by the caller.
+#[cfg(native_chunker)]
+fn chunk_code(file_path: &str, content: &str) -> Vec<CodeChunk> {
+    let Some(chunks) = crate::native_chunker::chunk_source(file_path, content, CHUNK_SIZE as u32) else {
+        return chunk_lines(file_path, content);
+    };
+    chunks
+        .into_iter()
+        .map(|chunk| CodeChunk {
+            file_path: file_path.to_string(),
+            content: content[chunk.start..chunk.end].to_string(),
+            start_line: chunk.start_line + 1,
+            end_line: chunk.end_line + 1,
+            hash: chunk.hash,
+            embedding: Vec::new(),
+        })
+        .collect()
+}
+
+#[cfg(not(native_chunker))]
 fn chunk_code(file_path: &str, content: &str) -> Vec<CodeChunk> {
-    const CHUNK_SIZE: usize = 50; // Lines per chunk
-    const OVERLAP: usize = 10;    // Overlapping lines
+    chunk_lines(file_path, content)
+}
+
+/// Fixed line windows, for builds without the native chunker
+#[cfg_attr(native_chunker, allow(dead_code))]
+fn chunk_lines(file_path: &str, content: &str) -> Vec<CodeChunk> {
+    const OVERLAP: usize = 10; // Overlapping lines
     
     let lines: Vec<&str> = content.lines().collect();
     let mut chunks = Vec::new();
@@ -195,14 +247,14 @@ fn chunk_code(file_path: &str, content: &str) -> Vec<CodeChunk> {
     while start < lines.len() {
         let end = (start + CHUNK_SIZE).min(lines.len());
         let chunk_content = lines[start..end].join("\n");
-        let embedding = text_to_embedding(&chunk_content);
         
         chunks.push(CodeChunk {
             file_path: file_path.to_string(),
+            hash: content_hash(&chunk_content),
             content: chunk_content,
             start_line: (start + 1) as u32,
             end_line: end as u32,
-            embedding,
+            embedding: Vec::new(),
         });
         
         start += CHUNK_SIZE - OVERLAP;
@@ -238,6 +290,15 @@ fn text_to_embedding(text: &str) -> Vec<f32> {
     embedding
 }
 
+/// Hash of a chunk's text (in-memory only, so the std hasher is enough)
+#[cfg_attr(native_chunker, allow(dead_code))]
+fn content_hash(text: &str) -> u64 {
+    use std::hash::{Hash, Hasher};
+    let mut hasher = std::collections::hash_map::DefaultHasher::new();
+    text.hash(&mut hasher);
+    hasher.finish()
+}
+
 /// Simple string hash
 fn simple_hash(s: &str) -> u64 {
     let mut hash: u64 = 5381;
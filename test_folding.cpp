@@ -0,0 +1,81 @@
+// Folding ranges around bodiless declarations (prototypes, protocol requirements).
+//
+//   c++ -std=c++17 -IMicroCodeSupport/Core test_folding.cpp MicroCodeSupport/Core/{MicroFolding,MicroIncrementalLexer,MicroLexer,MicroParser}.cpp -o test_folding && ./test_folding
+
+#include "MicroFolding.h"
+#include "MicroIncrementalLexer.h"
+#include "MicroParser.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static std::vector<MicroFolding::FoldingRange> foldsOf(const std::string& language, const std::string& source) {
+    MicroLexer::IncrementalLexer lexer(language);
+    lexer.reset(source);
+    MicroParser::Engine parser;
+    parser.parse(lexer.tokens(), lexer.source(), language);
+    MicroFolding::Engine folding(language);
+    folding.reset(lexer);
+    std::vector<MicroFolding::FoldingRange> folds;
+    folding.foldsInLines(lexer, parser, 0, lexer.lineCount() - 1, folds);
+    return folds;
+}
+
+static void expectFolds(const char *label, const std::string& language, const std::string& source,
+                        const std::vector<std::pair<uint32_t, uint32_t>>& expected) {
+    std::vector<MicroFolding::FoldingRange> folds = foldsOf(language, source);
+    bool same = folds.size() == expected.size();
+    for (size_t i = 0; same && i < folds.size(); i++) {
+        same = folds[i].startLine == expected[i].first && folds[i].endLine == expected[i].second;
+    }
+    if (!same) {
+        std::printf("FAIL %s:", label);
+        for (const auto& fold : folds) std::printf(" %u-%u", fold.startLine, fold.endLine);
+        std::printf("\n");
+        std::exit(1);
+    }
+}
+
+int main() {
+    // A prototype on the first line folds nothing, not the whole file.
+    expectFolds("leading C prototype", "c",
+                "void f(void);\n"
+                "\n"
+                "void f(void) {\n"
+                "    g();\n"
+                "}\n"
+                "\n"
+                "int x;\n",
+                {{2, 4}});
+    expectFolds("leading Swift requirement", "swift",
+                "func f()\n"
+                "\n"
+                "let x = 1\n"
+                "\n"
+                "func g() {\n"
+                "    h()\n"
+                "}\n",
+                {{4, 6}});
+    // A type after a requirement opens its own scope instead of lending its brace to it.
+    expectFolds("requirement before a type", "swift",
+                "func f()\n"
+                "struct S {\n"
+                "    func g()\n"
+                "    var x: Int { get }\n"
+                "    func h() {\n"
+                "    }\n"
+                "}\n",
+                {{1, 6}, {4, 5}});
+    // Later prototypes do not fold back onto the line before them.
+    expectFolds("prototype after a body", "c",
+                "int a(void) {\n"
+                "    return 1;\n"
+                "}\n"
+                "void b(void);\n"
+                "void c(void);\n",
+                {{0, 2}});
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Line-number gutter layout: widths from the widest cached digit, right-aligned digit runs, wrapped rows.
+//
+//   c++ -std=c++17 -IMicroCodeSupport/Core test_gutter.cpp MicroCodeSupport/Core/{MicroGutter,MicroLineIndex}.cpp -o test_gutter && ./test_gutter
+
+#include "MicroGutter.h"
+#include "MicroLineIndex.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static void expect(const char *label, bool condition) {
+    if (!condition) {
+        std::printf("FAIL %s\n", label);
+        std::exit(1);
+    }
+}
+
+static MicroGutter::DigitMetrics proportionalDigits() {
+    MicroGutter::DigitMetrics metrics = {};
+    for (int digit = 0; digit < 10; digit++) metrics.advances[digit] = 5.0f + (float)digit * 0.5f; // '9' is widest: 9.5
+    metrics.ascent = 8.0f;
+    metrics.descent = 2.0f;
+    return metrics;
+}
+
+int main() {
+    MicroGutter::Layout layout;
+    layout.setMetrics(proportionalDigits());
+    layout.setPadding(4, 6);
+    layout.setMinimumDigits(2);
+
+    // Widths use the widest digit, cached by setMetrics(), whatever digits the lines have.
+    expect("digit count", MicroGutter::Layout::digitCount(0) == 1 && MicroGutter::Layout::digitCount(9) == 1 &&
+                          MicroGutter::Layout::digitCount(10) == 2 && MicroGutter::Layout::digitCount(1000) == 4);
+    expect("minimum digits", layout.widthForLineCount(1) == 29 && layout.widthForLineCount(99) == 29);
+    expect("three digits", layout.widthForLineCount(100) == 39); // ceil(4 + 3 * 9.5 + 6)
+    MicroGutter::DigitMetrics narrower = proportionalDigits();
+    narrower.advances[9] = 5.0f; // Widest is now '8' at 9.0
+    layout.setMetrics(narrower);
+    expect("re-measured", layout.widthForLineCount(100) == 37);
+    layout.setMetrics(proportionalDigits());
+
+    // "a\nbbbb\n" + 10 more lines; line 1 wraps onto a second row.
+    std::u16string text = u"a\nbbbb\n";
+    for (int i = 0; i < 10; i++) text += u"x\n";
+    MicroCore::LineIndex lines;
+    lines.append(text.data(), text.size());
+    const MicroGutter::Row rows[] = {
+        {0, 0, 20},   // Line 0
+        {2, 20, 20},  // Line 1
+        {4, 40, 20},  // Line 1, wrapped
+        {25, 60, 20}, // Line 11
+    };
+    const float width = 40;
+    layout.layout(lines, rows, 4, width);
+
+    const auto& labels = layout.labels();
+    const auto& glyphs = layout.glyphs();
+    expect("label count", labels.size() == 4);
+    expect("line numbers", labels[0].line == 0 && labels[1].line == 1 && labels[2].line == 1 && labels[3].line == 11);
+    expect("continuation", !labels[1].continuation && labels[2].continuation && labels[2].glyphCount == 0);
+    expect("glyph runs", labels[0].glyphCount == 1 && labels[1].glyphCount == 1 && labels[3].glyphCount == 2 &&
+                         labels[3].firstGlyph == 2 && glyphs.size() == 4);
+
+    // "12": most significant first, the last digit flush with the trailing padding.
+    const MicroGutter::Glyph& one = glyphs[labels[3].firstGlyph];
+    const MicroGutter::Glyph& two = glyphs[labels[3].firstGlyph + 1];
+    expect("digits in order", one.digit == 1 && two.digit == 2);
+    expect("right aligned", two.x == width - 6 - 6.0f && one.x == two.x - 5.5f);
+    expect("baseline centered", one.baseline == 60 + (20 - 10) / 2 + 8 && one.baseline == two.baseline);
+    expect("single digit", glyphs[0].digit == 1 && glyphs[0].x == width - 6 - 5.5f);
+    std::printf("ok\n");
+    return 0;
+}